@@ -29,6 +29,22 @@ GridCore::GridCore()
 
 }
 
+void GridCore::resize(int w, int h)
+{
+    coordWidth = w;
+    coordHeight = h;
+    gridItems.resize(w * h);
+    clear();
+}
+
+void GridCore::clear()
+{
+    overlapItems.clear();
+    itemGrids.clear();
+    gridItems.fill(QString());
+    emptyHint = 0;
+}
+
 QStringList GridCore::reloacle(GIndex targetIndex, int emptyBefore, int emptyAfter)
 {
 //    qDebug() << targetIndex << emptyBefore << emptyAfter;
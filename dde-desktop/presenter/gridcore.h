@@ -25,6 +25,8 @@
 #pragma once
 
 #include <QMap>
+#include <QHash>
+#include <QStringList>
 #include <QVector>
 #include <QString>
 #include <QPoint>
@@ -57,59 +59,99 @@ template <> inline bool qMapLessThanKey(const QPoint &key1, const QPoint &key2)
 }
 
 
-// TODO: move all grid calc to GridCore
+// The grid is stored column by column in a flat array addressed by
+// GIndex (x * coordHeight + y), an empty string marks a free cell.
 class GridCore
 {
 public:
 
-    QStringList           overlapItems;
-    QMap<GPos, QString>   gridItems;
-    QMap<QString, GPos>   itemGrids;
-    QVector<bool>         gridStatus;
+    QStringList             overlapItems;
+    QVector<QString>        gridItems;
+    QHash<QString, GIndex>  itemGrids;
 
-    QString               positionProfile;
-
-    int                   coordWidth;
-    int                   coordHeight;
+    int                     coordWidth  = 0;
+    int                     coordHeight = 0;
 
 public:
     GridCore();
 
+    void resize(int w, int h);
+    void clear();
+
+    inline int cellCount() const
+    {
+        return gridItems.size();
+    }
+
+    inline int usedCount() const
+    {
+        return itemGrids.size();
+    }
+
+    inline bool isValid(const GPos &pos) const
+    {
+        return pos.x() >= 0 && pos.x() < coordWidth && pos.y() >= 0 && pos.y() < coordHeight;
+    }
+
+    inline bool isUsed(GIndex index) const
+    {
+        return index >= 0 && index < gridItems.size() && !gridItems.at(index).isEmpty();
+    }
+
+    inline bool contains(const QString &item) const
+    {
+        return itemGrids.contains(item);
+    }
+
+    inline QString item(GIndex index) const
+    {
+        return gridItems.value(index);
+    }
+
+    inline QString item(const GPos &pos) const
+    {
+        return isValid(pos) ? gridItems.at(toIndex(pos)) : QString();
+    }
+
+    // the previous cell of the item is freed, and an item already in the
+    // cell is no longer on the grid
     inline void addItem(GIndex index, const QString &item)
     {
-        Q_ASSERT(index < gridStatus.length());
-        gridStatus[index] = true;
-        auto pos = toPos(index);
-        itemGrids.insert(item, pos);
-        gridItems.insert(pos, item);
+        Q_ASSERT(index < gridItems.length());
+        auto oldIndex = itemGrids.value(item, -1);
+        if (oldIndex >= 0 && oldIndex != index) {
+            gridItems[oldIndex].clear();
+            emptyHint = qMin(emptyHint, oldIndex);
+        }
+
+        const QString oldItem = gridItems.at(index);
+        if (!oldItem.isEmpty() && oldItem != item) {
+            itemGrids.remove(oldItem);
+        }
+
+        gridItems[index] = item;
+        itemGrids.insert(item, index);
     }
 
     inline void removeItem(GPos pos)
     {
-        auto index = toIndex(pos);
-        auto item = gridItems.take(pos);
-        itemGrids.remove(item);
-        Q_ASSERT(index < gridStatus.length());
-        gridStatus[index] = false;
+        removeItem(toIndex(pos));
     }
 
     inline void removeItem(GIndex index)
     {
-        auto pos = toPos(index);
-        auto item = gridItems.take(pos);
-        itemGrids.remove(item);
-        Q_ASSERT(index < gridStatus.length());
-        gridStatus[index] = false;
+        Q_ASSERT(index < gridItems.length());
+        itemGrids.remove(gridItems.at(index));
+        gridItems[index].clear();
+        emptyHint = qMin(emptyHint, index);
     }
 
     inline void removeItem(const QString &item)
     {
-        auto pos = itemGrids.take(item);
-        auto index = toIndex(pos);
-        gridItems.take(pos);
-        Q_ASSERT(index < gridStatus.length());
-        gridStatus[index] = false;
-
+        auto index = itemGrids.value(item, -1);
+        if (index >= 0) {
+            removeItem(index);
+        }
     }
 
     inline GIndex toIndex(const GPos &pos) const
@@ -126,7 +168,23 @@ public:
 
     inline GPos pos(const QString &item) const
     {
-        return itemGrids.value(item);
+        auto index = itemGrids.value(item, -1);
+        return index >= 0 ? toPos(index) : GPos();
+    }
+
+    // the first free cell or -1, amortized O(1) because all cells before
+    // emptyHint are known to be used
+    inline GIndex firstEmpty() const
+    {
+        if (usedCount() >= cellCount()) {
+            return -1;
+        }
+
+        while (!gridItems.at(emptyHint).isEmpty()) {
+            ++emptyHint;
+        }
+
+        return emptyHint;
     }
 
     GIndex findEmptyForward(GIndex index, int emptyCount)
@@ -136,7 +194,7 @@ public:
         }
 
         for (auto i = index; i >= 0; --i) {
-            if (!gridStatus[i]) {
+            if (!isUsed(i)) {
                 --emptyCount;
                 if (0 == emptyCount) {
                     return i;
@@ -150,19 +208,18 @@ public:
     {
         QStringList items;
         for (auto i = start; i <= end; ++i) {
-            auto pos = toPos(i);
-            if (gridItems.contains(pos)) {
-                items << gridItems.value(pos);
-                gridItems.remove(pos);
+            if (isUsed(i)) {
+                items << gridItems.at(i);
+                gridItems[i].clear();
             }
         }
 
         for (auto i = start; i < start + items.length(); ++i) {
-            auto pos = toPos(i);
             auto item = items.value(i - start);
-            gridItems.insert(pos, item);
-            itemGrids.insert(item, pos);
+            gridItems[i] = item;
+            itemGrids.insert(item, i);
         }
+        emptyHint = qMin(emptyHint, qMax(start, 0));
         return items;
     }
 
@@ -172,15 +229,15 @@ public:
             return index;
         }
 
-        for (auto i = index; i < gridStatus.length(); ++i) {
-            if (!gridStatus[i]) {
+        for (auto i = index; i < gridItems.length(); ++i) {
+            if (!isUsed(i)) {
                 --emptyCount;
                 if (0 == emptyCount) {
                     return i;
                 }
             }
         }
-        return gridStatus.length() - 1;
+        return gridItems.length() - 1;
     }
 
     // start < end
@@ -188,23 +245,24 @@ public:
     {
         QStringList items;
         for (auto i = end; i >= start; --i) {
-            auto pos = toPos(i);
-            if (gridItems.contains(pos)) {
-                items << gridItems.value(pos);
-                gridItems.remove(pos);
+            if (isUsed(i)) {
+                items << gridItems.at(i);
+                gridItems[i].clear();
             }
         }
 
         for (auto i = end; i > end - items.length(); --i) {
-            auto pos = toPos(i);
             auto item = items.value(end - i);
-            gridItems.insert(pos, item);
-            itemGrids.insert(item, pos);
+            gridItems[i] = item;
+            itemGrids.insert(item, i);
         }
+        emptyHint = qMin(emptyHint, qMax(start, 0));
         return items;
     }
 
 
     QStringList reloacle(GIndex index, int emptyBefore, int emptyAfter);
-};
 
+private:
+    mutable GIndex          emptyHint   = 0;
+};
@@ -12,6 +12,7 @@
 #include <QPoint>
 #include <QRect>
 #include <QDebug>
+#include <QSet>
 
 #include "dfileinfo.h"
 #include "apppresenter.h"
@@ -27,41 +28,34 @@ public:
         positionProfile = settings->value(Config::keyProfile).toString();
         autoArrang = settings->value(Config::keyAutoAlign).toBool();
         settings->endGroup();
-
-        coordWidth = 0;
-        coordHeight = 0;
     }
 
     inline int cellCount() const
     {
-        return  coordHeight * coordWidth;
+        return core.cellCount();
     }
 
     inline void clear()
     {
-        m_itemGrids.clear();
-        m_gridItems.clear();
-        m_overlapItems.clear();
+        core.clear();
 
-        for (int i = 0; i < m_cellStatus.length(); ++i) {
-            m_cellStatus[i] = false;
-        }
+        // the profile no longer matches the saved one
+        profileDirty = true;
+        dirtyCells.clear();
     }
 
     QStringList rangeItems()
     {
         QStringList sortItems;
 
-        auto inUsePos = m_gridItems.keys();
-        qSort(inUsePos.begin(), inUsePos.end(), qQPointLessThanKey);
-
-        for (int index = 0; index < inUsePos.length(); ++index) {
-            auto gridPos = inUsePos.value(index);
-            auto item = m_gridItems.value(gridPos);
-            sortItems << item;
+        // the cells are stored in position order
+        for (int index = 0; index < cellCount(); ++index) {
+            if (core.isUsed(index)) {
+                sortItems << core.item(index);
+            }
         }
 
-        sortItems << m_overlapItems;
+        sortItems << core.overlapItems;
         return sortItems;
     }
 
@@ -69,16 +63,13 @@ public:
     {
         QStringList sortItems;
 
-        auto inUsePos = m_gridItems.keys();
-        qSort(inUsePos.begin(), inUsePos.end(), qQPointLessThanKey);
-
-        for (int index = 0; index < inUsePos.length(); ++index) {
-            auto gridPos = inUsePos.value(index);
-            auto item = m_gridItems.value(gridPos);
-            sortItems << item;
+        for (int index = 0; index < cellCount(); ++index) {
+            if (core.isUsed(index)) {
+                sortItems << core.item(index);
+            }
         }
 
-        auto overlapItems = m_overlapItems;
+        auto overlapItems = core.overlapItems;
 
         auto emptyCellCount = cellCount() - sortItems.length();
         for (int i = 0; i < emptyCellCount; ++i) {
@@ -94,21 +85,21 @@ public:
             add(empty_pos, item);
         }
 
-        m_overlapItems = overlapItems;
+        core.overlapItems = overlapItems;
     }
 
     void createProfile()
     {
-        m_cellStatus.resize(coordWidth * coordHeight);
+        core.resize(coordWidth, coordHeight);
         clear();
     }
 
     void loadProfile(const QStringList &localFileLis)
     {
-        QMap<QString, int> existItems;
+        QSet<QString> existItems;
 
         for (auto &item : localFileLis) {
-            existItems.insert(item, 0);
+            existItems.insert(item);
         }
 
         auto settings = Config::instance()->settings();
@@ -130,16 +121,21 @@ public:
             arrange();
         }
 
-        for (auto &item : existItems.keys()) {
+        auto newItems = existItems.toList();
+        qSort(newItems);
+
+        for (auto &item : newItems) {
             QPoint empty_pos{ takeEmptyPos() };
             add(empty_pos, item);
         }
+
+        // drop the items that no longer exist from the saved profile
+        profileDirty = true;
     }
 
     inline bool isValid(QPoint pos) const
     {
-        QRect rect(0, 0, coordWidth, coordHeight);
-        return rect.contains(pos);
+        return core.isValid(pos);
     }
 
     inline QPoint overlapPos() const
@@ -149,102 +145,140 @@ public:
 
     inline QPoint gridPosAt(int index) const
     {
-        auto x = index / coordHeight;
-        auto y = index % coordHeight;
-        return QPoint(x, y);
+        return core.toPos(index);
     }
 
     inline int indexOfGridPos(const QPoint &pos) const
     {
-        return pos.x() * coordHeight + pos.y();
+        return core.toIndex(pos);
     }
 
     inline QPoint emptyPos() const
     {
-        for (int i = 0; i < m_cellStatus.size(); ++i) {
-            if (!m_cellStatus[i]) {
-                return gridPosAt(i);
-            }
-        }
-        return overlapPos();
+        auto index = core.firstEmpty();
+        return index >= 0 ? gridPosAt(index) : overlapPos();
     }
 
     inline QPoint takeEmptyPos()
     {
-        for (int i = 0; i < m_cellStatus.size(); ++i) {
-            if (!m_cellStatus[i]) {
-                m_cellStatus[i] = true;
-                return gridPosAt(i);
-            }
+        return emptyPos();
+    }
+
+    inline void markDirty(int index)
+    {
+        if (!profileDirty) {
+            dirtyCells.insert(index);
         }
-        return overlapPos();
     }
 
     inline bool add(QPoint pos, const QString &itemId)
     {
-        if (m_gridItems.contains(pos)) {
+        if (!isValid(pos)) {
+            qCritical() << "add" << itemId << "failed." << pos << "is out of grid";
+            return false;
+        }
+
+        auto index = indexOfGridPos(pos);
+
+        if (core.isUsed(index)) {
             if (pos != overlapPos()) {
                 qCritical() << "add" << itemId  << "failed."
-                            << pos << "grid exist item" << m_gridItems.value(pos);
+                            << pos << "grid exist item" << core.item(index);
                 return false;
             } else {
-                m_overlapItems << itemId;
+                core.overlapItems << itemId;
                 return false;
             }
         }
 
-
-        m_gridItems.insert(pos, itemId);
-        m_itemGrids.insert(itemId, pos);
-        m_cellStatus[indexOfGridPos(pos)] = true;
+        // the item leaves its previous cell, if any
+        auto oldIndex = core.itemGrids.value(itemId, -1);
+        core.addItem(index, itemId);
+        markDirty(index);
+        if (oldIndex >= 0 && oldIndex != index) {
+            markDirty(oldIndex);
+        }
 
         return true;
     }
 
+    // only write the cells changed since the last sync
     inline void syncProfile()
     {
+        if (profileDirty) {
+            rewriteProfile();
+            return;
+        }
+
+        if (dirtyCells.isEmpty()) {
+            return;
+        }
+
+        QStringList removeKeyList;
         QStringList keyList;
         QVariantList valueList;
-        for (auto pos : m_gridItems.keys()) {
-            keyList << positionKey(pos);
-            valueList << m_gridItems.value(pos);
+        for (auto index : dirtyCells) {
+            auto key = positionKey(gridPosAt(index));
+            if (core.isUsed(index)) {
+                keyList << key;
+                valueList << core.item(index);
+            } else {
+                removeKeyList << key;
+            }
         }
+        dirtyCells.clear();
 
-        if (m_gridItems.size() != m_itemGrids.size()) {
-            qCritical() << "data sync failed";
-            qCritical() << "-----------------------------";
-            qCritical() << m_gridItems << m_itemGrids << keyList;
-            qCritical() << "-----------------------------";
+        if (!removeKeyList.isEmpty()) {
+            emit Presenter::instance()->removeConfigList(positionProfile, removeKeyList);
+        }
+
+        if (!keyList.isEmpty()) {
+            emit Presenter::instance()->setConfigList(positionProfile, keyList, valueList);
+        }
+    }
+
+    inline void rewriteProfile()
+    {
+        QStringList keyList;
+        QVariantList valueList;
+        for (int index = 0; index < cellCount(); ++index) {
+            if (core.isUsed(index)) {
+                keyList << positionKey(gridPosAt(index));
+                valueList << core.item(index);
+            }
         }
 
-        if (keyList.size() != m_gridItems.size()) {
+        if (keyList.size() != core.usedCount()) {
             qCritical() << "data sync failed";
             qCritical() << "-----------------------------";
-            qCritical() << m_gridItems << m_itemGrids << keyList;
+            qCritical() << core.gridItems << core.itemGrids << keyList;
             qCritical() << "-----------------------------";
         }
 
+        profileDirty = false;
+        dirtyCells.clear();
+
         emit Presenter::instance()->removeConfig(positionProfile, "");
         emit Presenter::instance()->setConfigList(positionProfile, keyList, valueList);
     }
 
     inline bool remove(QPoint pos, const QString &id)
     {
-        m_overlapItems.removeAll(id);
-        if (!m_itemGrids.contains(id)) {
+        core.overlapItems.removeAll(id);
+        if (!core.contains(id)) {
             qDebug() << "can not remove" << pos << id;
             return false;
         }
 
-        m_gridItems.remove(pos);
-        m_itemGrids.remove(id);
+        auto usageIndex = core.itemGrids.value(id);
+        pos = gridPosAt(usageIndex);
 
-        auto usageIndex = indexOfGridPos(pos);
-        m_cellStatus[usageIndex] = false;
+        core.removeItem(usageIndex);
+        markDirty(usageIndex);
 
-        if (!m_overlapItems.isEmpty()
+        if (!core.overlapItems.isEmpty()
                 && (pos == overlapPos())) {
-            auto itemId = m_overlapItems.takeFirst();
+            auto itemId = core.overlapItems.takeFirst();
             add(pos, itemId);
         }
         return true;
@@ -274,19 +308,20 @@ public:
         auto oldCellCount = coordHeight * coordWidth;
         auto newCellCount = w * h;
 
-        auto allItems = m_itemGrids;
         QVector<int> preferNewIndex;
         QVector<QString> itemIds;
 
         // record old pos index
-        for (int i = 0; i < m_cellStatus.length(); ++i) {
-            if (m_cellStatus.value(i)) {
+        for (int i = 0; i < cellCount(); ++i) {
+            if (core.isUsed(i)) {
                 auto newIndex = i * newCellCount / oldCellCount;
                 preferNewIndex.push_back(newIndex);
-                itemIds.push_back(m_gridItems.value(gridPosAt(i)));
+                itemIds.push_back(core.item(i));
             }
         }
 
+        auto overlapItems = core.overlapItems;
+
         coordHeight = h;
         coordWidth = w;
 
@@ -299,18 +334,17 @@ public:
 
         for (int i = 0; i < preferNewIndex.length(); ++i) {
             auto index = preferNewIndex.value(i);
-            if (m_cellStatus.size() > index && !m_cellStatus.value(index)) {
+            if (cellCount() > index && !core.isUsed(index)) {
                 QPoint pos{ gridPosAt(index) };
                 add(pos, itemIds.value(i));
             } else {
                 auto freePos = takeEmptyPos();
                 add(freePos, itemIds.value(i));
             }
-            allItems.remove(itemIds.value(i));
         }
 
         // move forward
-        for (auto id : allItems.keys()) {
+        for (auto id : overlapItems) {
             auto freePos = takeEmptyPos();
             add(freePos, id);
         }
@@ -325,22 +359,20 @@ public:
         auto oldCellCount = coordHeight * coordWidth;
         auto newCellCount = w * h;
 
-        auto allItems = m_itemGrids;
-
         auto outCellCount = 0;
-        for (int i = 0; i < m_cellStatus.length(); ++i) {
-            if (i >= newCellCount && m_cellStatus.value(i)) {
+        for (int i = newCellCount; i < cellCount(); ++i) {
+            if (core.isUsed(i)) {
                 outCellCount++;
             }
         }
 
-        auto oldCellStatus = this->m_cellStatus;
+        const GridCore oldCore = core;
 
         // find empty cell count
         auto indexEnd = qMin(oldCellCount, newCellCount);
         auto emptyCellCount = 0;
         for (int i = 0; i < indexEnd; ++i) {
-            if (!oldCellStatus.value(i)) {
+            if (!oldCore.isUsed(i)) {
                 emptyCellCount++;
             }
         }
@@ -349,25 +381,25 @@ public:
             emptyCellCount += (newCellCount - oldCellCount);
         }
 
-        if (emptyCellCount <= outCellCount + m_overlapItems.length()) {
+        if (emptyCellCount <= outCellCount + core.overlapItems.length()) {
 //            qDebug() << "arrange";
             auto sortItems = rangeItems();
             resetGridSize(w, h);
-            for (int i = 0; i < newCellCount; ++i) {
+            for (int i = 0; i < newCellCount && !sortItems.isEmpty(); ++i) {
                 add(takeEmptyPos(), sortItems.takeFirst());
             }
-            m_overlapItems = sortItems;
+            core.overlapItems = sortItems;
         } else {
             // find start pos
-            auto newEmptyCellCount = emptyCellCount - outCellCount + m_overlapItems.length();
+            auto newEmptyCellCount = emptyCellCount - outCellCount + core.overlapItems.length();
             QVector<int> keepPosIndex;
             QVector<QString> keepItems;
 
             auto lastEmptyPosIndex = newCellCount;
-            for (int i = 0; i < oldCellStatus.length(); ++i) {
-                if (oldCellStatus.value(i)) {
+            for (int i = 0; i < oldCore.cellCount(); ++i) {
+                if (oldCore.isUsed(i)) {
                     keepPosIndex.push_back(i);
-                    keepItems.push_back(m_gridItems.value(gridPosAt(i)));
+                    keepItems.push_back(oldCore.item(i));
                 } else {
                     if (newEmptyCellCount <= 0) {
                         lastEmptyPosIndex = i;
@@ -379,20 +411,20 @@ public:
 
             QVector<int> nokeepPosIndex;
             QVector<QString> nokeepItems;
-            for (int i = lastEmptyPosIndex; i < oldCellStatus.length(); ++i) {
-                if (oldCellStatus.value(i)) {
+            for (int i = lastEmptyPosIndex; i < oldCore.cellCount(); ++i) {
+                if (oldCore.isUsed(i)) {
                     nokeepPosIndex.push_back(i);
-                    nokeepItems.push_back(m_gridItems.value(gridPosAt(i)));
+                    nokeepItems.push_back(oldCore.item(i));
                 }
             }
 
-            auto overlapItems = m_overlapItems;
+            auto overlapItems = core.overlapItems;
 
             resetGridSize(w, h);
 
             for (int i = 0; i < keepPosIndex.length(); ++i) {
                 auto index = keepPosIndex.value(i);
-                if (m_cellStatus.size() > index && !m_cellStatus.value(index)) {
+                if (cellCount() > index && !core.isUsed(index)) {
                     QPoint pos{ gridPosAt(index) };
                     add(pos, keepItems.value(i));
                 }
@@ -427,18 +459,9 @@ public:
                      << "to" << w << h;
             changeGridSize(w, h);
 
-            QStringList keyList;
-            QVariantList valueList;
-            for (auto pos : m_gridItems.keys()) {
-                keyList << positionKey(pos);
-                valueList << m_gridItems.value(pos);
-            }
-
-            qDebug() << "updateGridProfile:" << keyList.size()
-                     << m_gridItems.size() << m_itemGrids.size();
+            qDebug() << "updateGridProfile:" << core.usedCount();
 
-            emit Presenter::instance()->removeConfig(positionProfile, "");
-            emit Presenter::instance()->setConfigList(positionProfile, keyList, valueList);
+            rewriteProfile();
 
             return this->autoArrang;
         }
@@ -456,14 +479,16 @@ public:
     }
 
 public:
-    QStringList             m_overlapItems;
-    QMap<QPoint, QString>   m_gridItems;
-    QMap<QString, QPoint>   m_itemGrids;
-    QVector<bool>           m_cellStatus;
+    GridCore                core;
+
+    // cells changed since the last syncProfile, the whole profile is
+    // written again if profileDirty is set
+    QSet<int>               dirtyCells;
+    bool                    profileDirty = true;
 
     QString                 positionProfile;
-    int                     coordWidth;
-    int                     coordHeight;
+    int                     coordWidth = 0;
+    int                     coordHeight = 0;
 
     bool                    autoArrang;
     bool                    hasInited = false;
@@ -505,7 +530,7 @@ bool GridManager::add(const QString &id)
         }
     }
 
-    if (d->m_itemGrids.contains(id)) {
+    if (d->core.contains(id)) {
 //        qDebug() << "item exist item" << d->itemGrids.value(id) << id;
         return false;
     }
@@ -527,27 +552,25 @@ bool GridManager::add(QPoint pos, const QString &id)
 
 bool GridManager::move(const QStringList &selecteds, const QString &current, int x, int y)
 {
-    auto currentPos = d->m_itemGrids.value(current);
+    auto currentPos = d->core.pos(current);
     auto destPos = QPoint(x, y);
     auto offset = destPos - currentPos;
 
-    QList<QPoint> originPosList;
     QList<QPoint> destPosList;
     // check dest is empty;
-    auto destPosMap = d->m_gridItems;
-    auto destUsedGrids = d->m_cellStatus;
+    auto destUsedGrids = d->core.gridItems;
     for (auto &id : selecteds) {
-        auto oldPos = d->m_itemGrids.value(id);
-        originPosList << oldPos;
-        destPosMap.remove(oldPos);
-        destUsedGrids[d->indexOfGridPos(oldPos)] = false;
+        auto oldPos = d->core.pos(id);
+        if (d->core.contains(id)) {
+            destUsedGrids[d->indexOfGridPos(oldPos)].clear();
+        }
         auto destPos = oldPos + offset;
         destPosList << destPos;
     }
 
     bool conflict = false;
     for (auto pos : destPosList) {
-        if (destPosMap.contains(pos) || !d->isValid(pos)) {
+        if (!d->isValid(pos) || !destUsedGrids.at(d->indexOfGridPos(pos)).isEmpty()) {
             conflict = true;
             break;
         }
@@ -562,7 +585,7 @@ bool GridManager::move(const QStringList &selecteds, const QString &current, int
         QList<int> emptyIndexList;
 
         for (int  i = 0; i < d->cellCount(); ++i) {
-            if (false == destUsedGrids.value(i)) {
+            if (destUsedGrids.at(i).isEmpty()) {
                 emptyIndexList << i;
             }
         }
@@ -584,24 +607,25 @@ bool GridManager::move(const QStringList &selecteds, const QString &current, int
 
         startIndex = emptyIndexList.value(startIndex);
         for (int i = startIndex; i < d->cellCount(); ++i) {
-            if (false == destUsedGrids.value(i)) {
+            if (destUsedGrids.at(i).isEmpty()) {
                 destPosList << d->gridPosAt(i);
             }
         }
     }
 
+    // write the profile once for the whole selection
     for (int i = 0; i < selecteds.length(); ++i) {
-        if (contains(selecteds.value(i))) {
-            remove(selecteds.value(i));
-        }
+        d->remove(d->core.pos(selecteds.value(i)), selecteds.value(i));
     }
     for (int i = 0; i < selecteds.length(); ++i) {
         QPoint point{ destPosList.value(i) };
-        add(point, selecteds.value(i));
+        d->add(point, selecteds.value(i));
     }
 
     if (d->autoArrang) {
         reAlign();
+    } else {
+        d->syncProfile();
     }
 
     return true;
@@ -609,7 +633,7 @@ bool GridManager::move(const QStringList &selecteds, const QString &current, int
 
 bool GridManager::remove(const QString &id)
 {
-    auto pos = d->m_itemGrids.value(id);
+    auto pos = d->core.pos(id);
     return remove(pos, id);
 }
 
@@ -639,10 +663,9 @@ bool GridManager::clear()
 
 QString GridManager::firstItemId()
 {
-    for (int i = 0; i < d->m_cellStatus.length(); ++i) {
-        if (d->m_cellStatus.value(i)) {
-            auto pos = d->gridPosAt(i);
-            return  itemId(pos);
+    for (int index = 0; index < d->cellCount(); ++index) {
+        if (d->core.isUsed(index)) {
+            return d->core.item(index);
         }
     }
     return "";
@@ -650,11 +673,9 @@ QString GridManager::firstItemId()
 
 QString GridManager::lastItemId()
 {
-    auto len = d->m_cellStatus.length();
-    for (int i = 0; i < len; ++i) {
-        if (d->m_cellStatus.value(len - 1 - i)) {
-            auto pos = d->gridPosAt(len - 1 - i);
-            return  itemId(pos);
+    for (int index = d->cellCount() - 1; index >= 0; --index) {
+        if (d->core.isUsed(index)) {
+            return d->core.item(index);
         }
     }
     return "";
@@ -663,48 +684,48 @@ QString GridManager::lastItemId()
 QStringList GridManager::itemIds()
 {
     QStringList ids;
-    for (int i = 0; i < d->m_cellStatus.length(); ++i) {
-        if (d->m_cellStatus.value(i)) {
-            auto pos = d->gridPosAt(i);
-            ids.append(itemId(pos));
+    for (int i = 0; i < d->cellCount(); ++i) {
+        if (d->core.isUsed(i)) {
+            ids.append(d->core.item(i));
         }
     }
-    ids << d->m_overlapItems;
+    ids << d->core.overlapItems;
     return ids;
 }
 
 bool GridManager::contains(const QString &id)
 {
-    return d->m_itemGrids.contains(id) || d->m_overlapItems.contains(id);
+    return d->core.contains(id) || d->core.overlapItems.contains(id);
 }
 
 QPoint GridManager::position(const QString &id)
 {
-    if (!d->m_itemGrids.contains(id)) {
+    if (!d->core.contains(id)) {
         return d->overlapPos();
     }
 
-    return d->m_itemGrids.value(id);
+    return d->core.pos(id);
 }
 
 QString GridManager::itemId(int x, int y)
 {
-    return d->m_gridItems.value(QPoint(x, y));
+    return d->core.item(QPoint(x, y));
 }
 
 QString GridManager::itemId(QPoint pos)
 {
-    return d->m_gridItems.value(pos);
+    return d->core.item(pos);
 }
 
 bool GridManager::isEmpty(int x, int y)
 {
-    return !d->m_cellStatus.value(d->indexOfGridPos(QPoint(x, y)));
+    QPoint pos(x, y);
+    return !d->isValid(pos) || !d->core.isUsed(d->indexOfGridPos(pos));
 }
 
 const QStringList &GridManager::overlapItems() const
 {
-    return d->m_overlapItems;
+    return d->core.overlapItems;
 }
 
 bool GridManager::autoAlign()
@@ -727,16 +748,7 @@ void GridManager::toggleAlign()
 void GridManager:: reAlign()
 {
     d->arrange();
-
-    QStringList keyList;
-    QVariantList valueList;
-    for (auto pos : d->m_gridItems.keys()) {
-        keyList << positionKey(pos);
-        valueList << d->m_gridItems.value(pos);
-    }
-
-    emit Presenter::instance()->removeConfig(d->positionProfile, "");
-    emit Presenter::instance()->setConfigList(d->positionProfile, keyList, valueList);
+    d->rewriteProfile();
 }
 
 QPoint GridManager::forwardFindEmpty(QPoint start) const
@@ -776,14 +788,7 @@ void GridManager::updateGridSize(int w, int h)
 
 GridCore *GridManager::core()
 {
-    auto core = new GridCore;
-    core->overlapItems = d->m_overlapItems;
-    core->gridItems = d->m_gridItems;
-    core->itemGrids = d->m_itemGrids;
-    core->gridStatus = d->m_cellStatus;
-    core->coordWidth = d->coordWidth;
-    core->coordHeight = d->coordHeight;
-    return core;
+    return new GridCore(d->core);
 }
 
 void GridManager::setWhetherShowHiddenFiles(bool value) noexcept
@@ -798,12 +803,14 @@ bool GridManager::getWhetherShowHiddenFiles() noexcept
 
 void GridManager::dump()
 {
-    for (auto key : d->m_gridItems.keys()) {
-        qDebug() << key << d->m_gridItems.value(key);
+    for (int i = 0; i < d->cellCount(); ++i) {
+        if (d->core.isUsed(i)) {
+            qDebug() << d->gridPosAt(i) << d->core.item(i);
+        }
     }
 
-    for (auto key : d->m_itemGrids.keys()) {
-        qDebug() << key << d->m_itemGrids.value(key);
+    for (auto key : d->core.itemGrids.keys()) {
+        qDebug() << key << d->core.itemGrids.value(key);
     }
 }
 
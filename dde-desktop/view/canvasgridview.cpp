@@ -28,6 +28,7 @@
 #include <QDir>
 #include <QStandardPaths>
 #include <QPropertyAnimation>
+#include <QSet>
 
 #include <dthememanager.h>
 #include <dscrollbar.h>
@@ -836,7 +837,6 @@ void CanvasGridView::paintEvent(QPaintEvent *event)
 
     QPainter painter(viewport());
     auto repaintRect = event->rect();
-    painter.setRenderHints(QPainter::HighQualityAntialiasing);
 
     auto option = viewOptions();
     option.textElideMode = Qt::ElideMiddle;
@@ -876,9 +876,11 @@ void CanvasGridView::paintEvent(QPaintEvent *event)
         painter.restore();
     }
 
-    DUrlList selecteds;
+    QSet<QString> selecteds;
     if (d->dodgeAnimationing || d->startDodge) {
-        selecteds = selectedUrls();
+        for (const DUrl &url : selectedUrls()) {
+            selecteds << url.toLocalFile();
+        }
     }
 
 //    qDebug() << d->dragIn << d->dodgeAnimationing;
@@ -887,7 +889,7 @@ void CanvasGridView::paintEvent(QPaintEvent *event)
         auto hoverIndex = indexAt(currentMousePos);
         auto url = model()->getUrlByIndex(hoverIndex);
 
-        if (selecteds.contains(url)
+        if (selecteds.contains(url.toLocalFile())
                 || (d->dodgeAnimationing && d->dodgeItems.contains(url.toLocalFile()))) {
 
         } else {
@@ -901,9 +903,18 @@ void CanvasGridView::paintEvent(QPaintEvent *event)
         }
     }
 
+    // only visit the cells intersecting the damaged rect
+    int firstCol = 0, lastCol = -1, firstRow = 0, lastRow = -1;
+    if (d->cellWidth > 0 && d->cellHeight > 0) {
+        firstCol = qMax(0, (repaintRect.left() - d->viewMargins.left()) / d->cellWidth);
+        lastCol = qMin(d->colCount - 1, (repaintRect.right() - d->viewMargins.left()) / d->cellWidth);
+        firstRow = qMax(0, (repaintRect.top() - d->viewMargins.top()) / d->cellHeight);
+        lastRow = qMin(d->rowCount - 1, (repaintRect.bottom() - d->viewMargins.top()) / d->cellHeight);
+    }
+
     QStringList repaintLocalFiles;
-    for (int x = 0; x < d->colCount; ++x) {
-        for (int y = 0; y < d->rowCount; ++y) {
+    for (int x = firstCol; x <= lastCol; ++x) {
+        for (int y = firstRow; y <= lastRow; ++y) {
             auto localFile = GridManager::instance()->itemId(x, y);
             if (!localFile.isEmpty()) {
                 repaintLocalFiles << localFile;
@@ -921,9 +932,8 @@ void CanvasGridView::paintEvent(QPaintEvent *event)
 
 //    int drawCount = 0;
     for (auto &localFile : repaintLocalFiles) {
-        auto url = DUrl::fromLocalFile(localFile);
         // hide selected if draw animation
-        if ((d->dodgeAnimationing || d->startDodge) && selecteds.contains(url)) {
+        if ((d->dodgeAnimationing || d->startDodge) && selecteds.contains(localFile)) {
 //            qDebug() << "skip drag select" << url;
             continue;
         }
@@ -934,30 +944,18 @@ void CanvasGridView::paintEvent(QPaintEvent *event)
             continue;
         }
 
-        auto index = model()->index(url);
+        auto index = model()->index(DUrl::fromLocalFile(localFile));
         if (!index.isValid()) {
 //            qDebug() << "skip index.isValid";
             continue;
         }
         option.rect = visualRect(index);
 
-        bool needflash = false;
-        for (auto &rr : event->region().rects())
-            if (rr.intersects(option.rect)) {
-                needflash = true;
-            }
-
-        if (!needflash) {
+        if (!event->region().intersects(option.rect)) {
 //            qDebug() << "skip !needflash";
             continue;
         }
 
-
-        if (!repaintRect.intersects(option.rect)) {
-//            qDebug() << "skip !repaintRect.intersects(option.rect)";
-            continue;
-        }
-
         option.rect = option.rect.marginsRemoved(d->cellMargins);
         option.state = state;
         if (selections && selections->isSelected(index)) {
@@ -981,45 +979,110 @@ void CanvasGridView::paintEvent(QPaintEvent *event)
         }
         option.state &= ~QStyle::State_MouseOver;
 
-        painter.save();
         if (d->_debug_show_grid) {
+            painter.save();
             for (auto rect : itemPaintGeomertys(index)) {
                 painter.setPen(Qt::red);
                 painter.drawRect(rect);
             }
+            painter.restore();
         }
 
-        this->itemDelegate()->paint(&painter, option, index);
-//        qDebug() << "---  end itemDelegate()->paint";
-        painter.restore();
+        paintItem(&painter, option, index);
     }
 
 // draw dragMove animation
     if (d->dodgeAnimationing) {
+        option.state = state;
         for (auto animatingItem : d->dodgeItems) {
             auto localFile = animatingItem;
             auto index = model()->index(DUrl::fromLocalFile(localFile));
-            if (index.isValid()) {
-                option.rect = visualRect(index).marginsRemoved(d->cellMargins);
+            if (!index.isValid()) {
+                continue;
+            }
+
+            option.rect = dodgeAnimationRect(index, localFile);
+            if (!event->region().intersects(option.rect)) {
+                continue;
             }
 
-            auto gridPos = d->dodgeTargetGrid->pos(localFile);
-            auto x = gridPos.x() * d->cellWidth + d->viewMargins.left();
-            auto y = gridPos.y() * d->cellHeight + d->viewMargins.top();
+            paintItem(&painter, option, index);
+        }
+    }
+}
 
-            QRect end = QRect(x, y, d->cellWidth, d->cellHeight).marginsRemoved(d->cellMargins);
+void CanvasGridView::paintItem(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index)
+{
+    // selected, focused, edited and drop target items change often or own
+    // index widgets, always paint them directly
+    bool cacheable = !d->_debug_show_grid
+                     && !(option.state & (QStyle::State_Selected | QStyle::State_HasFocus | QStyle::State_Editing))
+                     && !indexWidget(index)
+                     && !d->fileViewHelper->isDropTarget(index);
 
-            auto current = dodgeDuration();
-            auto nx = option.rect.x() + (end.x() - option.rect.x()) * current;
-            auto ny = option.rect.y() + (end.y() - option.rect.y()) * current;
-            option.rect.setX(static_cast<int>(nx));
-            option.rect.setY(static_cast<int>(ny));
-            option.rect.setSize(end.size());
-            painter.save();
-            itemDelegate()->paint(&painter, option, index);
-            painter.restore();
+    if (!cacheable) {
+        painter->save();
+        itemDelegate()->paint(painter, option, index);
+        painter->restore();
+        return;
+    }
+
+    // the text shadow is drawn 1px below the label
+    const QRect &rect = option.rect.marginsAdded(QMargins(2, 2, 2, 2));
+    const QString &key = itemPixmapKey(option, index);
+    QPixmap *pixmap = d->itemPixmaps.object(key);
+
+    if (!pixmap) {
+        const qreal ratio = devicePixelRatioF();
+
+        pixmap = new QPixmap(rect.size() * ratio);
+        pixmap->setDevicePixelRatio(ratio);
+        pixmap->fill(Qt::transparent);
+
+        QStyleOptionViewItem opt = option;
+        opt.rect.moveTopLeft(option.rect.topLeft() - rect.topLeft());
+
+        QPainter pa(pixmap);
+        pa.setRenderHints(painter->renderHints());
+        pa.setBrush(painter->brush());
+        itemDelegate()->paint(&pa, opt, index);
+        pa.end();
+
+        // in KB
+        int cost = pixmap->width() * pixmap->height() * pixmap->depth() / 8 / 1024;
+        if (!d->itemPixmaps.insert(key, pixmap, cost)) {
+            itemDelegate()->paint(painter, option, index);
+            return;
         }
     }
+
+    painter->drawPixmap(rect.topLeft(), *pixmap);
+}
+
+QString CanvasGridView::itemPixmapKey(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    // every thing the delegate reads to paint an unselected item
+    const QIcon &icon = qvariant_cast<QIcon>(index.data(Qt::DecorationRole));
+    QString key = QString("%1|%2|%3x%4|%5|%6|%7|%8")
+                  .arg(index.data(Qt::DisplayRole).toString())
+                  .arg(icon.cacheKey())
+                  .arg(option.rect.width())
+                  .arg(option.rect.height())
+                  .arg(iconSize().width())
+                  .arg(static_cast<int>(option.state))
+                  .arg(d->fileViewHelper->isCut(index))
+                  .arg(option.font.key());
+
+    for (const QIcon &additionalIcon : d->fileViewHelper->additionalIcon(index)) {
+        key += QString("|%1").arg(additionalIcon.cacheKey());
+    }
+
+    const QVariantHash &ep = index.data(DFileSystemModel::ExtensionPropertys).toHash();
+    for (const QColor &color : qvariant_cast<QList<QColor>>(ep.value("colored"))) {
+        key += QString("|%1").arg(color.rgba());
+    }
+
+    return key;
 }
 
 void CanvasGridView::resizeEvent(QResizeEvent * /*event*/)
@@ -1667,9 +1730,13 @@ void CanvasGridView::initConnection()
         animation->setStartValue(0.0);
         animation->setEndValue(1.0);
 
+        // only the moving items need to be repainted, from where they
+        // were in the last frame to where they are now
         connect(animation, &QPropertyAnimation::valueChanged,
         this, [ = ]() {
-            update();
+            const QRegion &region = dodgeAnimationRegion();
+            viewport()->update(region + d->dodgeAnimationRegion);
+            d->dodgeAnimationRegion = region;
         });
 
         connect(animation, &QPropertyAnimation::finished,
@@ -1692,6 +1759,7 @@ void CanvasGridView::initConnection()
                 GridManager::instance()->add(d->dodgeTargetGrid->pos(localFile), localFile);
             }
             d->dodgeAnimationing = false;
+            d->dodgeAnimationRegion = QRegion();
             delete d->dodgeTargetGrid;
             d->dodgeTargetGrid = nullptr;
 
@@ -1731,6 +1799,10 @@ void CanvasGridView::initConnection()
         for (auto i = 0; i < selLocalFiles.length(); ++i) {
             grid->addItem(targetIndex - emptyBefore + i, selLocalFiles.value(i));
         }
+
+        // the dodge items leave their cells, repaint all once
+        d->dodgeAnimationRegion = dodgeAnimationRegion();
+        update();
     });
 
 //    d->syncTimer = new QTimer(this);
@@ -1890,6 +1962,11 @@ void CanvasGridView::initConnection()
     });
 
     connect(DFMApplication::instance(), &DFMApplication::previewAttributeChanged, this->model(), &DFileSystemModel::update);
+
+    // the icon pixmaps were rendered with the old theme
+    connect(qApp, &DApplication::iconThemeChanged, this, [ = ]() {
+        d->itemPixmaps.clear();
+    });
 }
 
 void CanvasGridView::updateCanvas()
@@ -1937,6 +2014,7 @@ void CanvasGridView::updateCanvas()
     }
     d->updateCanvasSize(outRect.size(), d->canvasRect.size(), geometryMargins, itemSize);
     GridManager::instance()->updateGridSize(d->colCount, d->rowCount);
+    d->itemPixmaps.clear();
 
     updateEditorGeometries();
 
@@ -1995,6 +2073,40 @@ inline QRect CanvasGridView::gridRectAt(const QPoint &pos) const
     return QRect(x, y, d->cellWidth, d->cellHeight).marginsRemoved(d->cellMargins);
 }
 
+inline QRect CanvasGridView::dodgeAnimationRect(const QModelIndex &index, const QString &localFile) const
+{
+    QRect start = visualRect(index).marginsRemoved(d->cellMargins);
+
+    auto gridPos = d->dodgeTargetGrid->pos(localFile);
+    auto x = gridPos.x() * d->cellWidth + d->viewMargins.left();
+    auto y = gridPos.y() * d->cellHeight + d->viewMargins.top();
+
+    QRect end = QRect(x, y, d->cellWidth, d->cellHeight).marginsRemoved(d->cellMargins);
+
+    auto current = dodgeDuration();
+    auto nx = start.x() + (end.x() - start.x()) * current;
+    auto ny = start.y() + (end.y() - start.y()) * current;
+    return QRect(QPoint(static_cast<int>(nx), static_cast<int>(ny)), end.size());
+}
+
+QRegion CanvasGridView::dodgeAnimationRegion() const
+{
+    QRegion region;
+
+    if (!d->dodgeTargetGrid) {
+        return region;
+    }
+
+    for (auto &localFile : d->dodgeItems) {
+        auto index = model()->index(DUrl::fromLocalFile(localFile));
+        if (index.isValid()) {
+            region += dodgeAnimationRect(index, localFile).marginsAdded(QMargins(2, 2, 2, 2));
+        }
+    }
+
+    return region;
+}
+
 inline QList<QRect> CanvasGridView::itemPaintGeomertys(const QModelIndex &index) const
 {
     QStyleOptionViewItem option = viewOptions();
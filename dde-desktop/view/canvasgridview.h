@@ -153,6 +153,12 @@ private:
     inline QRect gridRectAt(const QPoint &pos) const;
     inline QList<QRect> itemPaintGeomertys(const QModelIndex &index) const;
     inline QRect itemIconGeomerty(const QModelIndex &index) const;
+    inline QRect dodgeAnimationRect(const QModelIndex &index, const QString &localFile) const;
+    QRegion dodgeAnimationRegion() const;
+
+    // unselected items are painted from a pixmap cache
+    void paintItem(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index);
+    QString itemPixmapKey(const QStyleOptionViewItem &option, const QModelIndex &index) const;
 
     inline QModelIndex firstIndex();
     inline QModelIndex lastIndex();
@@ -18,6 +18,9 @@
 #include <QItemSelection>
 #include <QDebug>
 #include <QTimer>
+#include <QCache>
+#include <QPixmap>
+#include <QRegion>
 
 #include <dfilesystemwatcher.h>
 
@@ -53,6 +56,8 @@ public:
         mousePressed = false;
         resortCount = 0;
         dodgeDelayTimer.setInterval(200);
+        // 32MB
+        itemPixmaps.setMaxCost(32 * 1024);
 
         if (qgetenv("_DDE_DESKTOP_DEBUG_SHOW_GRID") == "TRUE") {
             _debug_log = true;
@@ -118,19 +123,23 @@ public:
 
     bool hideItems  = false;
 
-    int rowCount;
-    int colCount;
-    int cellWidth;
-    int cellHeight;
+    int rowCount    = 0;
+    int colCount    = 0;
+    int cellWidth   = 0;
+    int cellHeight  = 0;
 
     QTimer              dodgeDelayTimer;
     QStringList         dodgeItems;
     bool                dodgeAnimationing   = false;
     double              dodgeDuration       = 0;
-    GridCore            *dodgeTargetGrid;
+    GridCore            *dodgeTargetGrid    = nullptr;
+    QRegion             dodgeAnimationRegion;
     bool                startDodge            = false;
     QPoint              dragTargetGrid   = QPoint(-1, -1);
 
+    // key: CanvasGridView::itemPixmapKey, cost: KB
+    QCache<QString, QPixmap> itemPixmaps;
+
     // currentCursorIndex is not the mouse, it's the position move by keybord
     QModelIndex         currentCursorIndex;
 
@@ -28,6 +28,11 @@
 #include <QProcess>
 #include <QDebug>
 #include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSocketNotifier>
+#include <QStorageInfo>
 
 #include <ddialog.h>
 #include <DTrashManager>
@@ -35,6 +40,9 @@
 
 #include <QCoreApplication>
 
+#include <sys/stat.h>
+#include <unistd.h>
+
 DWIDGET_USE_NAMESPACE
 
 const QString TrashDir = QDir::homePath() + "/.local/share/Trash";
@@ -46,9 +54,22 @@ PopupControlWidget::PopupControlWidget(QWidget *parent)
 
       m_empty(false),
 
-      m_fsWatcher(new QFileSystemWatcher(this))
+      m_fsWatcher(new QFileSystemWatcher(this)),
+      m_updateTimer(new QTimer(this)),
+      m_mountsFile(new QFile("/proc/self/mounts", this))
 {
-    connect(m_fsWatcher, &QFileSystemWatcher::directoryChanged, this, &PopupControlWidget::trashStatusChanged, Qt::QueuedConnection);
+    m_updateTimer->setSingleShot(true);
+    m_updateTimer->setInterval(200);
+
+    connect(m_updateTimer, &QTimer::timeout, this, &PopupControlWidget::trashStatusChanged);
+    connect(m_fsWatcher, &QFileSystemWatcher::directoryChanged, m_updateTimer, static_cast<void (QTimer::*)()>(&QTimer::start), Qt::QueuedConnection);
+
+    // the volume trashes come and go with the mounts
+    if (m_mountsFile->open(QIODevice::ReadOnly)) {
+        QSocketNotifier *notifier = new QSocketNotifier(m_mountsFile->handle(), QSocketNotifier::Exception, this);
+
+        connect(notifier, &QSocketNotifier::activated, m_updateTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    }
 
     setObjectName("trash");
     setFixedWidth(80);
@@ -76,6 +97,26 @@ const QString PopupControlWidget::trashDir()
     return TrashDir;
 }
 
+// the home trash and the trashes of the mounted volumes, like
+// DFMStandardPaths::trashPaths of the file manager
+QStringList PopupControlWidget::trashPaths()
+{
+    QStringList paths {TrashDir};
+    const QString uid = QString::number(getuid());
+
+    for (const QStorageInfo &storage : QStorageInfo::mountedVolumes()) {
+        if (!storage.isValid() || !storage.isReady() || storage.isRoot())
+            continue;
+
+        for (const QString &path : {storage.rootPath() + "/.Trash/" + uid, storage.rootPath() + "/.Trash-" + uid}) {
+            if (path != TrashDir && QFileInfo(path + "/files").isDir())
+                paths << path;
+        }
+    }
+
+    return paths;
+}
+
 void PopupControlWidget::openTrashFloder()
 {
     QProcess *proc = new QProcess;
@@ -98,8 +139,10 @@ void PopupControlWidget::clearTrashFloder()
         d.setWindowFlags(d.windowFlags() | Qt::WindowStaysOnTopHint);
     }
 
-    QDir dir(TrashDir + "/files");//QDir::homePath() + "/.local/share/Trash/files");
-    uint count = dir.entryList(ItemsShouldCount).count();
+    // only counts the items again if the files directory was changed
+    trashStatusChanged();
+
+    uint count = m_trashItemsCount;
     int execCode = -1;
 
     if (count > 0) {
@@ -126,6 +169,27 @@ void PopupControlWidget::clearTrashFloder()
         return;
     }
 
+    // DTrashManager only empties the home trash
+    for (const QString &path : trashPaths()) {
+        if (path == TrashDir)
+            continue;
+
+        for (const QString &directory : {path + "/files", path + "/info"}) {
+            QDirIterator iterator(directory, ItemsShouldCount);
+
+            while (iterator.hasNext()) {
+                iterator.next();
+
+                const QFileInfo &info = iterator.fileInfo();
+
+                if (info.isDir() && !info.isSymLink())
+                    QDir(info.absoluteFilePath()).removeRecursively();
+                else
+                    QFile::remove(info.absoluteFilePath());
+            }
+        }
+    }
+
     if (DTrashManager::instance()->cleanTrash()) {
         DDesktopServices::playSystemSoundEffect(DDesktopServices::SSE_EmptyTrash);
     } else {
@@ -141,24 +205,55 @@ int PopupControlWidget::trashItemCount() const
 
 void PopupControlWidget::trashStatusChanged()
 {
-    const bool files = QDir(TrashDir + "/files").exists();
-//    const bool info = QDir(TrashDir + "/info").exists();
+    const QStringList &paths = trashPaths();
+    QHash<QString, QPair<qint64, int>> items;
+    int count = 0;
+
+    for (const QString &path : paths) {
+        const QString files_path = path + "/files";
+        const bool files = QDir(files_path).exists();
+
+        // add monitor paths
+        m_fsWatcher->addPath(path);
+        if (files) {
+            m_fsWatcher->addPath(files_path);
+        } else {
+            continue;
+        }
+
+        struct stat st;
+        qint64 mtime = -1;
 
-    // add monitor paths
-    m_fsWatcher->addPath(TrashDir);
-    if (files) {
-        m_fsWatcher->addPath(TrashDir + "/files");
+        if (::stat(QFile::encodeName(files_path).constData(), &st) == 0)
+            mtime = qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+
+        QPair<qint64, int> item = m_trashItems.value(path, qMakePair(qint64(-1), 0));
+
+        // only counts the items again if the files directory was changed
+        if (mtime < 0 || mtime != item.first) {
+            QDirIterator iterator(files_path, ItemsShouldCount);
+
+            item = qMakePair(mtime, 0);
+
+            while (iterator.hasNext()) {
+                iterator.next();
+                ++item.second;
+            }
+        }
+
+        items[path] = item;
+        count += item.second;
     }
-//    if (info)
-//        m_fsWatcher->addPath(TrashDir + "/info");
 
-    // check empty
-    if (!files) {
-        m_trashItemsCount = 0;
-    } else {
-        m_trashItemsCount = QDir(TrashDir + "/files").entryList(ItemsShouldCount).count();
+    // stop monitoring the trashes of the removed volumes
+    for (const QString &path : m_fsWatcher->directories()) {
+        if (!paths.contains(path) && !paths.contains(QFileInfo(path).path()))
+            m_fsWatcher->removePath(path);
     }
 
+    m_trashItems = items;
+    m_trashItemsCount = count;
+
     const bool empty = m_trashItemsCount == 0;
     if (m_empty == empty) {
         return;
@@ -27,9 +27,13 @@
 
 #include <QWidget>
 #include <QFileSystemWatcher>
+#include <QTimer>
+#include <QHash>
+#include <QPair>
 
 #include <dlinkbutton.h>
 
+class QFile;
 class PopupControlWidget : public QWidget
 {
     Q_OBJECT
@@ -41,6 +45,7 @@ public:
     int trashItems() const;
     QSize sizeHint() const;
     static const QString trashDir();
+    static QStringList trashPaths();
 
 public slots:
     void openTrashFloder();
@@ -58,11 +63,16 @@ private slots:
 private:
     bool m_empty;
     int m_trashItemsCount;
+    // the mtime of the files directory of each trash and its items
+    QHash<QString, QPair<qint64, int>> m_trashItems;
 
 //    Dtk::Widget::DLinkButton *m_openBtn;
 //    Dtk::Widget::DLinkButton *m_clearBtn;
 
     QFileSystemWatcher *m_fsWatcher;
+    // compresses the change notifications of trashing/restoring many files
+    QTimer *m_updateTimer;
+    QFile *m_mountsFile;
 };
 
 #endif // POPUPCONTROLWIDGET_H
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmarkutils.h"
+
+#include "dfileservices.h"
+#include "dfmevent.h"
+#include "dfmglobal.h"
+#include "dfmeventdispatcher.h"
+#include "dfmstandardpaths.h"
+#include "controllers/filecontroller.h"
+#include "shutil/filebatchprocess.h"
+
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+
+#include <functional>
+
+DFM_USE_NAMESPACE
+
+static const QString SUITE = QStringLiteral("batchrename");
+
+static QString journalPath()
+{
+    return DFMStandardPaths::location(DFMStandardPaths::CachePath) + "/undo.journal";
+}
+
+static int journalBatchEntries()
+{
+    QFile file(journalPath());
+
+    if (!file.open(QIODevice::ReadOnly))
+        return 0;
+
+    return file.readAll().count("\"BatchRenameFiles\"");
+}
+
+static QStringList fileNames(const QString &directory)
+{
+    QStringList names = QDir(directory).entryList(QDir::Files | QDir::Hidden | QDir::System);
+
+    names.sort();
+
+    return names;
+}
+
+static QSharedMap<DUrl, DUrl> renameMap(const QString &directory, const QStringList &names,
+                                        std::function<QString(int, const QString &)> newName)
+{
+    QSharedMap<DUrl, DUrl> map(new QMap<DUrl, DUrl>());
+
+    for (int i = 0; i < names.count(); ++i) {
+        map->insert(DUrl::fromLocalFile(directory + "/" + names.at(i)),
+                    DUrl::fromLocalFile(directory + "/" + newName(i, names.at(i))));
+    }
+
+    return map;
+}
+
+// renames the files of the directory in one batch, checks that the batch is one
+// undo entry and that undoing it restores the names
+static void benchmarkBatch(const QString &name, const QString &directory, int iterations,
+                           std::function<QString(int, const QString &)> newName)
+{
+    Benchmark::Samples samples;
+    Benchmark::Samples undo_samples;
+    const QStringList &names = fileNames(directory);
+
+    for (int i = 0; i < iterations; ++i) {
+        const QSharedMap<DUrl, DUrl> &map = renameMap(directory, names, newName);
+        const int journal_entries = journalBatchEntries();
+        QMap<DUrl, DUrl> skipped;
+        QElapsedTimer timer;
+
+        timer.start();
+        const QMap<DUrl, DUrl> &renamed = FileBatchProcess::batchProcessFile(map, &skipped);
+        samples.add(timer.nsecsElapsed());
+
+        Benchmark::check(renamed.count() == map->count() && skipped.isEmpty(),
+                         QString("%1: %2 of %3 files were renamed, %4 skipped").arg(name)
+                         .arg(renamed.count()).arg(map->count()).arg(skipped.count()));
+        Benchmark::check(journalBatchEntries() == journal_entries + 1,
+                         QString("%1: the batch is not one undo entry").arg(name));
+
+        timer.restart();
+        DFMEventDispatcher::instance()->processEvent<DFMRevocationEvent>(nullptr);
+        undo_samples.add(timer.nsecsElapsed());
+
+        Benchmark::check(fileNames(directory) == names, QString("%1: the undo did not restore the names").arg(name));
+    }
+
+    QJsonObject result = Benchmark::toJson(samples, names.count());
+
+    result.insert("undo_p50_ms", undo_samples.percentile(0.5));
+    Benchmark::report(SUITE, name, result);
+}
+
+// one DFileService::renameFile for each file, as before the batch rename
+static void benchmarkReference(const QString &directory, int iterations)
+{
+    Benchmark::Samples samples;
+    const QStringList &names = fileNames(directory);
+
+    for (int i = 0; i < iterations; ++i) {
+        const QSharedMap<DUrl, DUrl> &map = renameMap(directory, names, [] (int index, const QString &name) {
+            return QString("renamed-%1-%2").arg(index).arg(name);
+        });
+        QElapsedTimer timer;
+
+        timer.start();
+
+        for (auto it = map->constBegin(); it != map->constEnd(); ++it)
+            DFileService::instance()->renameFile(nullptr, it.key(), it.value(), true);
+
+        samples.add(timer.nsecsElapsed());
+
+        for (auto it = map->constBegin(); it != map->constEnd(); ++it)
+            QFile::rename(it.value().toLocalFile(), it.key().toLocalFile());
+    }
+
+    Benchmark::report(SUITE, "reference", Benchmark::toJson(samples, names.count()));
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription("Measures renaming many files in one batch and undoing it.");
+    parser.addHelpOption();
+    Benchmark::addCommonOptions(parser);
+    parser.addOptions({
+        {"files", "The files renamed in one batch.", "count", "10000"}
+    });
+    parser.process(app);
+
+    DFileService::dRegisterUrlHandler<FileController>(FILE_SCHEME, "");
+    // the undo journal of the benchmark is in its own cache directory
+    QFile::remove(journalPath());
+    DFMGlobal::initOperatorRevocation();
+
+    Benchmark::TreeOptions options = Benchmark::treeOptions(parser);
+    const QString work_directory = Benchmark::createWorkDirectory(parser);
+    const QString directory = work_directory + "/files";
+    const int iterations = Benchmark::iterations(parser);
+
+    // only the names matter
+    options.minFileSize = 0;
+    options.maxFileSize = 0;
+
+    const Benchmark::TreeInfo &tree = Benchmark::createFlatDirectory(directory, parser.value("files").toInt(), options);
+
+    benchmarkBatch("rename", directory, iterations, [] (int index, const QString &name) {
+        return QString("renamed-%1-%2").arg(index).arg(name);
+    });
+    // every two files swap their names, each pair is a cycle through a temporary name
+    const QStringList &names = fileNames(directory);
+
+    benchmarkBatch("rename-cycles", directory, iterations, [&names] (int index, const QString &name) {
+        if (index % 2 == 0)
+            return index + 1 < names.count() ? names.at(index + 1) : name + ".last";
+
+        return names.at(index - 1);
+    });
+    // the names only change the case, on a case insensitive file system these go through a temporary name
+    benchmarkBatch("rename-case", directory, iterations, [] (int, const QString &name) {
+        if (name.toUpper() != name)
+            return name.toUpper();
+
+        return name.toLower() != name ? name.toLower() : name + ".case";
+    });
+    benchmarkReference(directory, iterations);
+
+    Benchmark::report(SUITE, "tree", Benchmark::toJson(tree));
+
+    QFile::remove(journalPath());
+    Benchmark::removeTree(work_directory);
+
+    return Benchmark::exitCode();
+}
@@ -0,0 +1,31 @@
+include(../common/common.pri)
+
+QT       += core gui widgets dbus concurrent
+
+TEMPLATE = app
+CONFIG   += c++11 console link_pkgconfig
+CONFIG   -= app_bundle
+
+PKGCONFIG += gio-unix-2.0 dtkwidget
+
+CONFIG(DISABLE_ANYTHING) {
+    DEFINES += DISABLE_QUICK_SEARCH
+}
+
+DEFINES += QT_MESSAGELOGCONTEXT
+
+LIBS += -L$$OUT_PWD/../../dde-file-manager-lib -ldde-file-manager
+
+DEPENDPATH += $$PWD/../dde-file-manager-lib
+unix:QMAKE_RPATHDIR += $$OUT_PWD/../../dde-file-manager-lib
+
+INCLUDEPATH += $$PWD/../dde-file-manager-lib $$PWD/.. \
+               $$PWD/../utils \
+               $$PWD/../dde-file-manager-lib/interfaces \
+               $$PWD/common
+
+HEADERS += \
+    $$PWD/common/benchmarkutils.h
+
+SOURCES += \
+    $$PWD/common/benchmarkutils.cpp
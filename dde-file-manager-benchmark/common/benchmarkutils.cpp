@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmarkutils.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <QtMath>
+
+#include <algorithm>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace Benchmark {
+
+static const char *const FILE_SUFFIXES[] = {"", ".txt", ".jpg", ".png", ".pdf", ".cpp", ".mp4", ".tar.gz"};
+// the content of the files, random to not be compressed or deduplicated by the file system
+static const int CONTENT_BLOCK_SIZE = 64 * 1024;
+static int failedChecks = 0;
+
+void Samples::add(qint64 nsecs)
+{
+    m_samples << nsecs;
+}
+
+int Samples::count() const
+{
+    return m_samples.count();
+}
+
+qint64 Samples::total() const
+{
+    qint64 total = 0;
+
+    for (qint64 sample : m_samples)
+        total += sample;
+
+    return total;
+}
+
+double Samples::percentile(double p) const
+{
+    if (m_samples.isEmpty())
+        return 0;
+
+    QVector<qint64> sorted = m_samples;
+
+    std::sort(sorted.begin(), sorted.end());
+
+    // nearest rank
+    const int index = qBound(0, qCeil(p * sorted.count()) - 1, sorted.count() - 1);
+
+    return sorted.at(index) / 1000000.0;
+}
+
+void addCommonOptions(QCommandLineParser &parser)
+{
+    parser.addOptions({
+        {"dir", "The directory of the synthetic trees, the temp path by default.", "path"},
+        {"iterations", "The iterations of every case.", "count", "5"},
+        {"depth", "The depth of the synthetic tree.", "depth", "2"},
+        {"fan-out", "The subdirectories of every directory.", "count", "4"},
+        {"files", "The files of every directory.", "count", "64"},
+        {"min-size", "The minimum size of the files in bytes.", "size", "0"},
+        {"max-size", "The maximum size of the files in bytes.", "size", "65536"},
+        {"names", "The file names: ascii, cjk or mixed.", "style", "mixed"},
+        {"seed", "The seed of the random generator.", "seed", "1"}
+    });
+}
+
+TreeOptions treeOptions(const QCommandLineParser &parser)
+{
+    TreeOptions options;
+
+    options.depth = qMax(0, parser.value("depth").toInt());
+    options.fanOut = qMax(0, parser.value("fan-out").toInt());
+    options.filesPerDirectory = qMax(0, parser.value("files").toInt());
+    options.minFileSize = qMax(0LL, parser.value("min-size").toLongLong());
+    options.maxFileSize = qMax(options.minFileSize, parser.value("max-size").toLongLong());
+    options.seed = parser.value("seed").toUInt();
+
+    const QString &names = parser.value("names");
+
+    if (names == "ascii")
+        options.names = AsciiNames;
+    else if (names == "cjk")
+        options.names = CjkNames;
+    else
+        options.names = MixedNames;
+
+    return options;
+}
+
+int iterations(const QCommandLineParser &parser)
+{
+    return qMax(1, parser.value("iterations").toInt());
+}
+
+QString createWorkDirectory(const QCommandLineParser &parser, const QString &option)
+{
+    const QString base = parser.isSet(option) ? parser.value(option) : QDir::tempPath();
+    const QString path = QString("%1/dfm-benchmark-%2-%3").arg(base).arg(::getpid())
+                         .arg(QDateTime::currentMSecsSinceEpoch());
+
+    if (!QDir().mkpath(path))
+        qFatal("Failed to create the work directory: %s", qPrintable(path));
+
+    return path;
+}
+
+void removeTree(const QString &path)
+{
+    QDir(path).removeRecursively();
+}
+
+QString randomName(std::mt19937 &engine, NameStyle style)
+{
+    if (style == MixedNames)
+        style = std::uniform_int_distribution<int>(0, 1)(engine) ? CjkNames : AsciiNames;
+
+    QString name;
+
+    if (style == CjkNames) {
+        std::uniform_int_distribution<int> length(2, 8);
+        // the cjk unified ideographs
+        std::uniform_int_distribution<ushort> character(0x4e00, 0x9fa5);
+
+        for (int i = length(engine); i > 0; --i)
+            name.append(QChar(character(engine)));
+    } else {
+        static const char characters[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_- .";
+        std::uniform_int_distribution<int> length(4, 24);
+        std::uniform_int_distribution<int> character(0, sizeof(characters) - 2);
+
+        for (int i = length(engine); i > 0; --i)
+            name.append(QLatin1Char(characters[character(engine)]));
+    }
+
+    return name;
+}
+
+static QByteArray contentBlock(quint32 seed)
+{
+    std::mt19937 engine(seed);
+    QByteArray block(CONTENT_BLOCK_SIZE, Qt::Uninitialized);
+
+    for (int i = 0; i < block.size(); ++i)
+        block[i] = static_cast<char>(engine() & 0xff);
+
+    return block;
+}
+
+static bool createFile(const QString &path, qint64 size, const QByteArray &content)
+{
+    QFile file(path);
+
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    for (qint64 written = 0; written < size;) {
+        const qint64 length = qMin(size - written, qint64(content.size()));
+
+        if (file.write(content.constData(), length) != length)
+            return false;
+
+        written += length;
+    }
+
+    return true;
+}
+
+static void createFiles(const QString &directory, int count, const TreeOptions &options,
+                        std::mt19937 &engine, const QByteArray &content, TreeInfo *info)
+{
+    std::uniform_int_distribution<qint64> size(options.minFileSize, options.maxFileSize);
+    std::uniform_int_distribution<int> suffix(0, sizeof(FILE_SUFFIXES) / sizeof(FILE_SUFFIXES[0]) - 1);
+
+    for (int i = 0; i < count; ++i) {
+        // the index keeps the names unique in the directory
+        const QString name = QString("%1-%2%3").arg(randomName(engine, options.names)).arg(i)
+                             .arg(FILE_SUFFIXES[suffix(engine)]);
+        const qint64 file_size = size(engine);
+
+        if (!createFile(directory + "/" + name, file_size, content))
+            qFatal("Failed to create the file: %s/%s", qPrintable(directory), qPrintable(name));
+
+        ++info->files;
+        info->bytes += file_size;
+    }
+}
+
+static void createTree(const QString &directory, int depth, const TreeOptions &options,
+                       std::mt19937 &engine, const QByteArray &content, TreeInfo *info)
+{
+    if (!QDir().mkpath(directory))
+        qFatal("Failed to create the directory: %s", qPrintable(directory));
+
+    ++info->directories;
+    createFiles(directory, options.filesPerDirectory, options, engine, content, info);
+
+    if (depth <= 0)
+        return;
+
+    for (int i = 0; i < options.fanOut; ++i) {
+        const QString name = QString("%1-%2").arg(randomName(engine, options.names)).arg(i);
+
+        createTree(directory + "/" + name, depth - 1, options, engine, content, info);
+    }
+}
+
+TreeInfo createTree(const QString &root, const TreeOptions &options)
+{
+    std::mt19937 engine(options.seed);
+    TreeInfo info;
+
+    createTree(root, options.depth, options, engine, contentBlock(options.seed), &info);
+
+    return info;
+}
+
+TreeInfo createFlatDirectory(const QString &path, int count, const TreeOptions &options)
+{
+    std::mt19937 engine(options.seed);
+    TreeInfo info;
+
+    if (!QDir().mkpath(path))
+        qFatal("Failed to create the directory: %s", qPrintable(path));
+
+    info.directories = 1;
+    createFiles(path, count, options, engine, contentBlock(options.seed), &info);
+
+    return info;
+}
+
+qint64 peakRss()
+{
+    struct rusage usage;
+
+    if (::getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+
+    return usage.ru_maxrss;
+}
+
+QJsonObject toJson(const Samples &samples, qint64 operations)
+{
+    const qint64 total = samples.total();
+    const double seconds = total / 1000000000.0;
+
+    return QJsonObject {
+        {"iterations", samples.count()},
+        {"ops", operations},
+        {"ops_per_s", seconds > 0 ? operations * samples.count() / seconds : 0},
+        {"total_ms", total / 1000000.0},
+        {"min_ms", samples.percentile(0)},
+        {"p50_ms", samples.percentile(0.5)},
+        {"p99_ms", samples.percentile(0.99)},
+        {"max_ms", samples.percentile(1)}
+    };
+}
+
+QJsonObject toJson(const TreeInfo &info)
+{
+    return QJsonObject {
+        {"files", info.files},
+        {"directories", info.directories},
+        {"bytes", info.bytes}
+    };
+}
+
+void report(const QString &suite, const QString &name, const QJsonObject &result)
+{
+    QJsonObject object = result;
+
+    object.insert("suite", suite);
+    object.insert("case", name);
+    object.insert("peak_rss_kb", peakRss());
+
+    QTextStream out(stdout);
+
+    out << QJsonDocument(object).toJson(QJsonDocument::Compact) << endl;
+}
+
+bool check(bool condition, const QString &message)
+{
+    if (!condition) {
+        ++failedChecks;
+        QTextStream(stderr) << "FAIL: " << message << endl;
+    }
+
+    return condition;
+}
+
+int exitCode()
+{
+    return failedChecks > 0 ? 1 : 0;
+}
+
+}
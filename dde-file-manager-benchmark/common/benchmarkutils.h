@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BENCHMARKUTILS_H
+#define BENCHMARKUTILS_H
+
+#include <QCommandLineParser>
+#include <QJsonObject>
+#include <QVector>
+
+#include <random>
+
+// the helpers shared by the benchmarks: synthetic trees, timing samples and
+// the json lines printed on stdout, one object for each case
+namespace Benchmark {
+
+enum NameStyle {
+    AsciiNames,
+    CjkNames,
+    MixedNames
+};
+
+struct TreeOptions
+{
+    int depth = 2;
+    int fanOut = 4;
+    int filesPerDirectory = 64;
+    qint64 minFileSize = 0;
+    qint64 maxFileSize = 64 * 1024;
+    NameStyle names = MixedNames;
+    quint32 seed = 1;
+};
+
+struct TreeInfo
+{
+    int files = 0;
+    int directories = 0;
+    qint64 bytes = 0;
+};
+
+class Samples
+{
+public:
+    void add(qint64 nsecs);
+
+    int count() const;
+    qint64 total() const;
+    // in milliseconds, p is in [0, 1]
+    double percentile(double p) const;
+
+private:
+    QVector<qint64> m_samples;
+};
+
+// --dir, --iterations and the options of the synthetic tree
+void addCommonOptions(QCommandLineParser &parser);
+TreeOptions treeOptions(const QCommandLineParser &parser);
+int iterations(const QCommandLineParser &parser);
+
+// a new empty directory below the path of the option (or the temp path), removed by the caller
+QString createWorkDirectory(const QCommandLineParser &parser, const QString &option = QStringLiteral("dir"));
+void removeTree(const QString &path);
+
+QString randomName(std::mt19937 &engine, NameStyle style);
+TreeInfo createTree(const QString &root, const TreeOptions &options);
+TreeInfo createFlatDirectory(const QString &path, int count, const TreeOptions &options);
+
+// in KB
+qint64 peakRss();
+
+QJsonObject toJson(const Samples &samples, qint64 operations);
+QJsonObject toJson(const TreeInfo &info);
+void report(const QString &suite, const QString &name, const QJsonObject &result);
+
+// for the benchmarks which also verify a behavior, a failed check makes exitCode() non zero
+bool check(bool condition, const QString &message);
+int exitCode();
+
+}
+
+#endif // BENCHMARKUTILS_H
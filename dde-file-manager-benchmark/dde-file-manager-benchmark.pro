@@ -0,0 +1,15 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    fileoperations \
+    pathfilter \
+    settings \
+    delete \
+    trash \
+    textpreview \
+    imagedecode \
+    batchrename
+
+!CONFIG(DISABLE_ANYTHING) {
+    SUBDIRS += quicksearchindex
+}
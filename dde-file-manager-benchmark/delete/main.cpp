@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmarkutils.h"
+
+#include "dfileservices.h"
+#include "controllers/filecontroller.h"
+#include "io/dfilecopymovejob.h"
+#include "io/dlocalfileremover.h"
+
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+
+#include <functional>
+
+DFM_USE_NAMESPACE
+
+static const QString SUITE = QStringLiteral("delete");
+
+// a new tree for every iteration, only the removal is timed
+static void benchmarkRemove(const QString &name, const QString &directory, const Benchmark::TreeOptions &options,
+                            int iterations, const std::function<void(const QString &)> &remove)
+{
+    Benchmark::Samples samples;
+    Benchmark::TreeInfo tree;
+
+    for (int i = 0; i < iterations; ++i) {
+        const QString root = QString("%1/%2-%3").arg(directory).arg(name).arg(i);
+
+        tree = Benchmark::createTree(root, options);
+
+        QElapsedTimer timer;
+
+        timer.start();
+        remove(root);
+        samples.add(timer.nsecsElapsed());
+
+        Benchmark::check(!QFileInfo::exists(root), name + " did not remove " + root);
+        Benchmark::removeTree(root);
+    }
+
+    QJsonObject result = Benchmark::toJson(samples, tree.files + tree.directories);
+
+    result.insert("tree", Benchmark::toJson(tree));
+    Benchmark::report(SUITE, name, result);
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription("Measures the removal of directory trees.");
+    parser.addHelpOption();
+    Benchmark::addCommonOptions(parser);
+    parser.addOptions({
+        {"threads", "The comma separated thread counts of DLocalFileRemover, 0 is decided by the cpu cores.", "counts", "1,2,4,0"}
+    });
+    parser.process(app);
+
+    DFileService::dRegisterUrlHandler<FileController>(FILE_SCHEME, "");
+
+    const int iterations = Benchmark::iterations(parser);
+    Benchmark::TreeOptions options = Benchmark::treeOptions(parser);
+    const QString work_directory = Benchmark::createWorkDirectory(parser);
+
+    // the data size hardly matters to unlink
+    if (!parser.isSet("max-size"))
+        options.maxFileSize = 0;
+
+    benchmarkRemove("reference", work_directory, options, iterations, [] (const QString &path) {
+        QDir(path).removeRecursively();
+    });
+
+    for (const QString &threads : parser.value("threads").split(',', QString::SkipEmptyParts)) {
+        benchmarkRemove("remover-" + threads, work_directory, options, iterations, [&threads] (const QString &path) {
+            DLocalFileRemover remover(threads.toInt());
+
+            remover.start(path);
+            remover.waitForFinished();
+        });
+    }
+
+    // what deleting from the file manager does
+    benchmarkRemove("job", work_directory, options, iterations, [] (const QString &path) {
+        DFileCopyMoveJob job;
+
+        job.start(DUrlList() << DUrl::fromLocalFile(path), DUrl());
+        job.wait();
+    });
+
+    Benchmark::removeTree(work_directory);
+
+    return Benchmark::exitCode();
+}
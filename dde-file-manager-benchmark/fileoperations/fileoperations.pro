@@ -0,0 +1,6 @@
+include(../benchmark.pri)
+
+TARGET = dfm-benchmark-fileoperations
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmarkutils.h"
+
+#include "dfileservices.h"
+#include "controllers/filecontroller.h"
+#include "controllers/jobcontroller.h"
+#include "io/dfilecopymovejob.h"
+#include "io/dfilestatisticsjob.h"
+
+#ifndef DISABLE_QUICK_SEARCH
+#include "quick_search/dquicksearch.h"
+#endif
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QThread>
+
+DFM_USE_NAMESPACE
+
+static const QString SUITE = QStringLiteral("fileoperations");
+
+static void benchmarkCopyMove(const QString &source, const QString &targetDirectory,
+                              const Benchmark::TreeInfo &tree, int iterations)
+{
+    Benchmark::Samples copy_samples;
+    Benchmark::Samples move_samples;
+
+    for (int i = 0; i < iterations; ++i) {
+        const QString copy_target = QString("%1/copy-%2").arg(targetDirectory).arg(i);
+        const QString move_target = QString("%1/move-%2").arg(targetDirectory).arg(i);
+
+        QDir().mkpath(copy_target);
+        QDir().mkpath(move_target);
+
+        QElapsedTimer timer;
+        DFileCopyMoveJob copy_job;
+
+        timer.start();
+        copy_job.start(DUrlList() << DUrl::fromLocalFile(source), DUrl::fromLocalFile(copy_target));
+        copy_job.wait();
+        copy_samples.add(timer.nsecsElapsed());
+
+        Benchmark::check(copy_job.error() == DFileCopyMoveJob::NoError, "copy failed: " + copy_job.errorString());
+
+        // a move in the same file system, only renames
+        DFileCopyMoveJob move_job;
+        const DUrlList copied = DUrlList() << DUrl::fromLocalFile(copy_target + "/" + QFileInfo(source).fileName());
+
+        move_job.setMode(DFileCopyMoveJob::MoveMode);
+        timer.restart();
+        move_job.start(copied, DUrl::fromLocalFile(move_target));
+        move_job.wait();
+        move_samples.add(timer.nsecsElapsed());
+
+        Benchmark::check(move_job.error() == DFileCopyMoveJob::NoError, "move failed: " + move_job.errorString());
+
+        Benchmark::removeTree(copy_target);
+        Benchmark::removeTree(move_target);
+    }
+
+    QJsonObject copy_result = Benchmark::toJson(copy_samples, tree.files);
+    const double copy_seconds = copy_samples.total() / 1000000000.0;
+
+    copy_result.insert("tree", Benchmark::toJson(tree));
+    copy_result.insert("bytes_per_s", copy_seconds > 0 ? tree.bytes * iterations / copy_seconds : 0);
+    Benchmark::report(SUITE, "copy", copy_result);
+
+    QJsonObject move_result = Benchmark::toJson(move_samples, tree.files);
+
+    move_result.insert("tree", Benchmark::toJson(tree));
+    Benchmark::report(SUITE, "move", move_result);
+}
+
+static void benchmarkStatistics(const QString &source, const Benchmark::TreeInfo &tree, int iterations)
+{
+    Benchmark::Samples samples;
+
+    for (int i = 0; i < iterations; ++i) {
+        DFileStatisticsJob job;
+        QElapsedTimer timer;
+
+        timer.start();
+        job.start(DUrlList() << DUrl::fromLocalFile(source));
+        job.wait();
+        samples.add(timer.nsecsElapsed());
+
+        Benchmark::check(job.filesCount() == tree.files, QString("statistics found %1 files of %2")
+                         .arg(job.filesCount()).arg(tree.files));
+    }
+
+    QJsonObject result = Benchmark::toJson(samples, tree.files + tree.directories);
+
+    result.insert("tree", Benchmark::toJson(tree));
+    Benchmark::report(SUITE, "statistics", result);
+}
+
+static void benchmarkModel(const QString &directory, const Benchmark::TreeInfo &tree, int iterations)
+{
+    Benchmark::Samples samples;
+    Benchmark::Samples first_batch_samples;
+    const DUrl url = DUrl::fromLocalFile(directory);
+
+    for (int i = 0; i < iterations; ++i) {
+        const DDirIteratorPointer &iterator = DFileService::instance()->createDirIterator(
+                nullptr, url, QStringList(), QDir::AllEntries | QDir::NoDotAndDotDot | QDir::System | QDir::Hidden);
+        JobController job(url, iterator);
+        QElapsedTimer timer;
+        int count = 0;
+        qint64 first_batch = -1;
+
+        // the same signals DFileSystemModel populates itself from
+        QObject::connect(&job, &JobController::childrenUpdated, [&] (const QList<DAbstractFileInfoPointer> &list) {
+            if (first_batch < 0)
+                first_batch = timer.nsecsElapsed();
+
+            count += list.count();
+        });
+        QObject::connect(&job, &JobController::addChildren, [&] {
+            ++count;
+        });
+
+        timer.start();
+        job.start();
+        job.wait();
+        samples.add(timer.nsecsElapsed());
+        first_batch_samples.add(first_batch < 0 ? timer.nsecsElapsed() : first_batch);
+
+        Benchmark::check(count == tree.files, QString("the model got %1 entries of %2").arg(count).arg(tree.files));
+    }
+
+    QJsonObject result = Benchmark::toJson(samples, tree.files);
+
+    result.insert("tree", Benchmark::toJson(tree));
+    result.insert("first_batch_p50_ms", first_batch_samples.percentile(0.5));
+    result.insert("first_batch_p99_ms", first_batch_samples.percentile(0.99));
+    Benchmark::report(SUITE, "model", result);
+}
+
+#ifndef DISABLE_QUICK_SEARCH
+// the index is built for the mounted partitions, so the keyword is searched in an existing path
+static void benchmarkQuickSearch(const QString &path, const QStringList &keywords, int timeout, int iterations)
+{
+    DQuickSearch *search = DQuickSearch::instance();
+    QElapsedTimer timer;
+
+    timer.start();
+    search->createCache();
+
+    while (!search->whetherPathCached(path)) {
+        if (timer.elapsed() > timeout * 1000) {
+            Benchmark::check(false, "the quick search index was not ready in time");
+
+            return;
+        }
+
+        QThread::msleep(100);
+    }
+
+    Benchmark::report(SUITE, "quick-search-index", QJsonObject {{"ready_ms", timer.elapsed()}});
+
+    for (const QString &keyword : keywords) {
+        Benchmark::Samples samples;
+        Benchmark::Samples first_result_samples;
+        int count = 0;
+
+        for (int i = 0; i < iterations; ++i) {
+            qint64 first_result = -1;
+
+            count = 0;
+            timer.restart();
+            search->search(path, keyword, [&] (const QList<QString> &chunk) {
+                if (first_result < 0)
+                    first_result = timer.nsecsElapsed();
+
+                count += chunk.count();
+
+                return true;
+            });
+            samples.add(timer.nsecsElapsed());
+            first_result_samples.add(first_result < 0 ? timer.nsecsElapsed() : first_result);
+        }
+
+        QJsonObject result = Benchmark::toJson(samples, 1);
+
+        result.insert("keyword", keyword);
+        result.insert("results", count);
+        result.insert("first_result_p50_ms", first_result_samples.percentile(0.5));
+        result.insert("first_result_p99_ms", first_result_samples.percentile(0.99));
+        Benchmark::report(SUITE, "quick-search", result);
+    }
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+    // no window is shown, but the library needs a QApplication
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription("Measures copy/move, statistics, model population and quick search.");
+    parser.addHelpOption();
+    Benchmark::addCommonOptions(parser);
+    parser.addOptions({
+        {"target", "The directory to copy into, on another disk to measure cross-device copies.", "path"},
+        {"model-entries", "The entries of the directory loaded into the model.", "count", "10000"},
+        {"search-path", "The path to search in, quick search is skipped if not set.", "path"},
+        {"search-keywords", "The comma separated keywords of quick search.", "keywords", "a,doc,\xe6\x96\x87\xe4\xbb\xb6"},
+        {"search-timeout", "The seconds to wait for the quick search index.", "seconds", "600"}
+    });
+    parser.process(app);
+
+    DFileService::dRegisterUrlHandler<FileController>(FILE_SCHEME, "");
+
+    const int iterations = Benchmark::iterations(parser);
+    const Benchmark::TreeOptions options = Benchmark::treeOptions(parser);
+    const QString work_directory = Benchmark::createWorkDirectory(parser);
+    const QString target_directory = parser.isSet("target") ? Benchmark::createWorkDirectory(parser, "target")
+                                                                : work_directory;
+    const QString source = work_directory + "/source";
+    const Benchmark::TreeInfo tree = Benchmark::createTree(source, options);
+
+    Benchmark::TreeOptions flat_options = options;
+
+    // only the entries matter to the model
+    flat_options.minFileSize = 0;
+    flat_options.maxFileSize = 0;
+
+    const QString flat = work_directory + "/flat";
+    const Benchmark::TreeInfo flat_tree = Benchmark::createFlatDirectory(flat, parser.value("model-entries").toInt(), flat_options);
+
+    benchmarkCopyMove(source, target_directory, tree, iterations);
+    benchmarkStatistics(source, tree, iterations);
+    benchmarkModel(flat, flat_tree, iterations);
+
+#ifndef DISABLE_QUICK_SEARCH
+    if (parser.isSet("search-path")) {
+        benchmarkQuickSearch(parser.value("search-path"), parser.value("search-keywords").split(',', QString::SkipEmptyParts),
+                             parser.value("search-timeout").toInt(), iterations);
+    }
+#endif
+
+    Benchmark::removeTree(work_directory);
+
+    if (target_directory != work_directory)
+        Benchmark::removeTree(target_directory);
+
+    return Benchmark::exitCode();
+}
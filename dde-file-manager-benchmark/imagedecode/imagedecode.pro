@@ -0,0 +1,6 @@
+include(../benchmark.pri)
+
+TARGET = dfm-benchmark-imagedecode
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmarkutils.h"
+
+#include "interfaces/dfmimagedecoder.h"
+
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QProcess>
+
+#include <functional>
+#include <random>
+
+DFM_USE_NAMESPACE
+
+static const QString SUITE = QStringLiteral("imagedecode");
+
+// photos like jpeg files, a gradient with some noise so that they do not compress too well
+static QStringList createImages(const QString &directory, int count, const QSize &size, quint32 seed)
+{
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<int> colors(0, 255);
+    QStringList files;
+
+    for (int i = 0; i < count; ++i) {
+        QImage image(size, QImage::Format_RGB32);
+        QLinearGradient gradient(0, 0, size.width(), size.height());
+        QPainter painter(&image);
+
+        gradient.setColorAt(0, QColor(colors(engine), colors(engine), colors(engine)));
+        gradient.setColorAt(1, QColor(colors(engine), colors(engine), colors(engine)));
+        painter.fillRect(image.rect(), gradient);
+
+        for (int j = 0; j < 2000; ++j) {
+            painter.fillRect(colors(engine) * size.width() / 256, colors(engine) * size.height() / 256, 16, 16,
+                             QColor(colors(engine), colors(engine), colors(engine)));
+        }
+
+        painter.end();
+
+        files << QString("%1/image-%2.jpg").arg(directory).arg(i);
+        Benchmark::check(image.save(files.last(), "JPG", 90), "failed to write " + files.last());
+    }
+
+    return files;
+}
+
+static void benchmarkDecode(const QString &name, const QStringList &files, const QSize &size, int iterations,
+                            std::function<QList<QImage>(const QStringList &)> decode)
+{
+    Benchmark::Samples samples;
+    QSize decoded_size;
+
+    for (int i = 0; i < iterations; ++i) {
+        QElapsedTimer timer;
+
+        timer.start();
+        const QList<QImage> &images = decode(files);
+        samples.add(timer.nsecsElapsed());
+
+        Benchmark::check(images.count() == files.count(), QString("%1: %2 of %3 images were decoded")
+                         .arg(name).arg(images.count()).arg(files.count()));
+
+        for (const QImage &image : images) {
+            Benchmark::check(!image.isNull(), name + ": an image was not decoded");
+
+            decoded_size = image.size();
+        }
+    }
+
+    Benchmark::check(decoded_size.width() <= qMax(size.width(), size.height()) * 2
+                     && decoded_size.height() <= qMax(size.width(), size.height()) * 2,
+                     QString("%1: the images are decoded to %2x%3 for %4x%5").arg(name)
+                     .arg(decoded_size.width()).arg(decoded_size.height()).arg(size.width()).arg(size.height()));
+
+    QJsonObject result = Benchmark::toJson(samples, files.count());
+
+    result.insert("decoded_width", decoded_size.width());
+    result.insert("decoded_height", decoded_size.height());
+    Benchmark::report(SUITE, name, result);
+}
+
+static void benchmarkCase(const QString &name, const QStringList &files, const QSize &target, int iterations)
+{
+    if (name == "decoder") {
+        benchmarkDecode(name, files, target, iterations, [&] (const QStringList &files) {
+            QList<QImage> images;
+
+            for (const QString &file : files)
+                images << DFMImageDecoder::read(file, target);
+
+            return images;
+        });
+    } else if (name == "decoder-parallel") {
+        benchmarkDecode(name, files, target, iterations, [&] (const QStringList &files) {
+            return DFMImageDecoder::read(files, target);
+        });
+    } else if (name == "reference") {
+        // the full image is decoded and scaled afterwards
+        benchmarkDecode(name, files, target, iterations, [&] (const QStringList &files) {
+            QList<QImage> images;
+
+            for (const QString &file : files)
+                images << QImage(file).scaled(target, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+            return images;
+        });
+    } else {
+        Benchmark::check(false, "unknown case " + name);
+    }
+}
+
+// each case runs in a process of its own, so the peak rss is not the one of
+// writing the images or of the cases before it
+static void runCase(const QString &name, const QString &directory)
+{
+    QProcess process;
+
+    process.setProcessChannelMode(QProcess::ForwardedChannels);
+    process.start(QCoreApplication::applicationFilePath(),
+                  QCoreApplication::arguments().mid(1) + QStringList {"--case", name, "--images-dir", directory});
+
+    Benchmark::check(process.waitForFinished(-1) && process.exitStatus() == QProcess::NormalExit
+                     && process.exitCode() == 0, name + ": the case failed");
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription("Measures decoding large images to thumbnail and preview sizes.");
+    parser.addHelpOption();
+    Benchmark::addCommonOptions(parser);
+    parser.addOptions({
+        {"images", "The number of images.", "count", "16"},
+        {"width", "The width of the images.", "pixels", "4000"},
+        {"height", "The height of the images.", "pixels", "3000"},
+        {"target", "The size the images are decoded for.", "pixels", "256"},
+        {"case", "Runs only this case, on the images of --images-dir.", "name"},
+        {"images-dir", "The directory of the images written before, for --case.", "path"}
+    });
+    parser.process(app);
+
+    const int iterations = Benchmark::iterations(parser);
+    const QSize target(parser.value("target").toInt(), parser.value("target").toInt());
+
+    if (parser.isSet("case")) {
+        const QDir directory(parser.value("images-dir"));
+        QStringList files;
+
+        for (const QString &name : directory.entryList({"image-*.jpg"}, QDir::Files, QDir::Name))
+            files << directory.absoluteFilePath(name);
+
+        if (!Benchmark::check(!files.isEmpty(), "no images in " + directory.path()))
+            return Benchmark::exitCode();
+
+        benchmarkCase(parser.value("case"), files, target, iterations);
+
+        return Benchmark::exitCode();
+    }
+
+    const Benchmark::TreeOptions options = Benchmark::treeOptions(parser);
+    const QString work_directory = Benchmark::createWorkDirectory(parser);
+
+    createImages(work_directory, parser.value("images").toInt(),
+                 QSize(parser.value("width").toInt(), parser.value("height").toInt()), options.seed);
+
+    for (const QString &name : {"decoder", "decoder-parallel", "reference"})
+        runCase(name, work_directory);
+
+    Benchmark::removeTree(work_directory);
+
+    return Benchmark::exitCode();
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmarkutils.h"
+
+#include "controllers/filecontroller.h"
+#include "interfaces/dfmapplication.h"
+#include "interfaces/dfmsettings.h"
+
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRegularExpression>
+
+#include <functional>
+
+DFM_USE_NAMESPACE
+
+static const QString SUITE = QStringLiteral("pathfilter");
+
+struct Entry
+{
+    QString path;
+    QString name;
+};
+
+// the matching of the HiddenFiles group before the patterns were compiled once,
+// a regular expression is built for every pattern on every call
+static bool referenceMatch(const QList<QPair<QString, QString>> &patterns, const QString &path, const QString &name)
+{
+    for (auto pattern : patterns) {
+        QRegularExpression re(QString(), QRegularExpression::MultilineOption);
+
+        if (!pattern.first.isEmpty()) {
+            re.setPattern(pattern.first);
+
+            if (!re.isValid() || !re.match(path).hasMatch())
+                continue;
+        }
+
+        if (pattern.second.isEmpty())
+            return true;
+
+        re.setPattern(pattern.second);
+
+        if (re.isValid() && re.match(name).hasMatch())
+            return true;
+    }
+
+    return false;
+}
+
+// a third of the patterns are bound to a literal directory, a third to a
+// directory expression and the rest apply to every directory, plus one with
+// a backreference for every directory
+static QStringList createPatterns(int count)
+{
+    QStringList patterns;
+
+    for (int i = 0; i < count; ++i) {
+        switch (i % 3) {
+        case 0:
+            patterns << QString("~/dir-%1/.*\\.bak%1$").arg(i);
+            break;
+        case 1:
+            patterns << QString("^/tmp/.*/dir-%1$/^~lock-%1").arg(i);
+            break;
+        default:
+            patterns << QString("^\\.cache-%1$").arg(i);
+            break;
+        }
+    }
+
+    patterns << QString("^(.)\\1-twin$");
+
+    return patterns;
+}
+
+static QList<Entry> createEntries(int directories, int filesPerDirectory, const Benchmark::TreeOptions &options)
+{
+    std::mt19937 engine(options.seed);
+    QList<Entry> entries;
+
+    for (int i = 0; i < directories; ++i) {
+        const QString path = i % 2 ? QString("%1/dir-%2").arg(QDir::homePath()).arg(i)
+                                   : QString("/tmp/%1/dir-%2").arg(Benchmark::randomName(engine, Benchmark::AsciiNames)).arg(i);
+
+        for (int j = 0; j < filesPerDirectory; ++j) {
+            QString name = Benchmark::randomName(engine, options.names);
+
+            // some entries are hidden by the patterns
+            if (j % 16 == 0)
+                name = QString(".cache-%1").arg(j % 64);
+            else if (j % 16 == 1)
+                name += QString(".bak%1").arg(i);
+            else if (j % 16 == 2)
+                name = j % 32 ? "xx-twin" : "xy-twin";
+
+            entries << Entry{path, name};
+        }
+    }
+
+    return entries;
+}
+
+static void benchmarkMatch(const QString &name, const QList<Entry> &entries, int iterations,
+                           const std::function<bool(const Entry &)> &match, int expected)
+{
+    Benchmark::Samples samples;
+    int matched = 0;
+
+    for (int i = 0; i < iterations; ++i) {
+        QElapsedTimer timer;
+
+        matched = 0;
+        timer.start();
+
+        for (const Entry &entry : entries) {
+            if (match(entry))
+                ++matched;
+        }
+
+        samples.add(timer.nsecsElapsed());
+    }
+
+    if (expected >= 0)
+        Benchmark::check(matched == expected, QString("%1 matched %2 entries, the reference %3").arg(name).arg(matched).arg(expected));
+
+    QJsonObject result = Benchmark::toJson(samples, entries.count());
+
+    result.insert("matched", matched);
+    Benchmark::report(SUITE, name, result);
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription("Measures the matching of the hidden/private file patterns.");
+    parser.addHelpOption();
+    Benchmark::addCommonOptions(parser);
+    parser.addOptions({
+        {"patterns", "The patterns of the HiddenFiles group.", "count", "60"},
+        {"directories", "The directories the entries are spread over.", "count", "64"}
+    });
+    parser.process(app);
+
+    const int iterations = Benchmark::iterations(parser);
+    const Benchmark::TreeOptions options = Benchmark::treeOptions(parser);
+    const QString work_directory = Benchmark::createWorkDirectory(parser);
+
+    // the patterns are written to a private configuration, not to the one of the user
+    qputenv("XDG_CONFIG_HOME", QFile::encodeName(work_directory));
+
+    const QStringList &patterns = createPatterns(parser.value("patterns").toInt());
+    QList<QPair<QString, QString>> reference_patterns;
+
+    for (int i = 0; i < patterns.count(); ++i) {
+        const QString &value = patterns.at(i);
+        const int last_dir_split = value.lastIndexOf(QDir::separator());
+        QString path = last_dir_split >= 0 ? value.left(last_dir_split) : QString();
+
+        if (path.startsWith("~/"))
+            path.replace(0, 1, QDir::homePath());
+
+        reference_patterns << qMakePair(path, value.mid(last_dir_split + 1));
+        DFMApplication::genericObtuselySetting()->setValue("HiddenFiles", QString::number(i), value);
+    }
+
+    const QList<Entry> &entries = createEntries(parser.value("directories").toInt(), options.filesPerDirectory, options);
+    QList<Entry> interleaved;
+
+    // the entries of different directories one after another, every match changes the directory
+    for (int j = 0; j < options.filesPerDirectory; ++j) {
+        for (int i = j; i < entries.count(); i += options.filesPerDirectory)
+            interleaved << entries.at(i);
+    }
+
+    int expected = 0;
+
+    for (const Entry &entry : entries) {
+        if (referenceMatch(reference_patterns, entry.path, entry.name))
+            ++expected;
+    }
+
+    benchmarkMatch("reference", entries, iterations, [&] (const Entry &entry) {
+        return referenceMatch(reference_patterns, entry.path, entry.name);
+    }, -1);
+    benchmarkMatch("hidden", entries, iterations, [] (const Entry &entry) {
+        return FileController::customHiddenFileMatch(entry.path, entry.name);
+    }, expected);
+    benchmarkMatch("hidden-interleaved", interleaved, iterations, [] (const Entry &entry) {
+        return FileController::customHiddenFileMatch(entry.path, entry.name);
+    }, expected);
+    // an empty group, the cost of the check for every listed file
+    benchmarkMatch("private-empty", entries, iterations, [] (const Entry &entry) {
+        return FileController::privateFileMatch(entry.path, entry.name);
+    }, 0);
+
+    Benchmark::removeTree(work_directory);
+
+    return Benchmark::exitCode();
+}
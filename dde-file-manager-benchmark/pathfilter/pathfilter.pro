@@ -0,0 +1,6 @@
+include(../benchmark.pri)
+
+TARGET = dfm-benchmark-pathfilter
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmarkutils.h"
+
+#include "quick_search/dquicksearch.h"
+#include "io/dstorageinfo.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QSemaphore>
+#include <QtConcurrent>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static const QString SUITE = QStringLiteral("quicksearchindex");
+
+// every tree stands for a partition, the lft files are written into the trees.
+// returns the time until all trees are ready, to compare the indexing per disk with it
+static double benchmarkIndex(const QStringList &partitions, const Benchmark::TreeInfo &tree, int iterations)
+{
+    Benchmark::Samples samples;
+    Benchmark::Samples first_ready_samples;
+    Benchmark::Samples all_ready_samples;
+
+    for (int i = 0; i < iterations; ++i) {
+        QElapsedTimer timer;
+
+        timer.start();
+
+        for (const QString &partition : partitions) {
+            QElapsedTimer partition_timer;
+
+            partition_timer.start();
+            Benchmark::check(DQuickSearch::instance()->cachePartition(partition), "failed to index " + partition);
+            samples.add(partition_timer.nsecsElapsed());
+
+            if (partition == partitions.first())
+                first_ready_samples.add(timer.nsecsElapsed());
+        }
+
+        all_ready_samples.add(timer.nsecsElapsed());
+    }
+
+    QJsonObject result = Benchmark::toJson(samples, tree.files + tree.directories);
+
+    result.insert("tree", Benchmark::toJson(tree));
+    result.insert("partitions", partitions.count());
+    result.insert("first_ready_p50_ms", first_ready_samples.percentile(0.5));
+    result.insert("all_ready_p50_ms", all_ready_samples.percentile(0.5));
+    Benchmark::report(SUITE, "index", result);
+
+    return all_ready_samples.percentile(0.5);
+}
+
+// every tree is indexed by its own thread, as cache_every_partion does for every disk.
+// the library is used without a lock then, so the lft files must be the same as the ones
+// built one by one
+static void benchmarkPerDiskIndex(const QStringList &partitions, double sequential_ms, int iterations)
+{
+    Benchmark::Samples first_ready_samples;
+    Benchmark::Samples all_ready_samples;
+    QMap<QString, std::size_t> sequential_adler32;
+    int different = 0;
+
+    for (const QString &partition : partitions)
+        sequential_adler32[partition] = DQuickSearch::count_adler32(partition);
+
+    for (int i = 0; i < iterations; ++i) {
+        QElapsedTimer timer;
+        QMutex mutex;
+        qint64 first_ready = -1;
+        std::vector<std::thread> threads;
+
+        timer.start();
+
+        for (const QString &partition : partitions) {
+            threads.emplace_back([&, partition] {
+                const bool ok = DQuickSearch::instance()->cachePartition(partition);
+                QMutexLocker locker(&mutex);
+
+                Benchmark::check(ok, "failed to index " + partition);
+
+                if (first_ready < 0)
+                    first_ready = timer.nsecsElapsed();
+            });
+        }
+
+        for (std::thread &thread : threads)
+            thread.join();
+
+        all_ready_samples.add(timer.nsecsElapsed());
+        first_ready_samples.add(first_ready);
+
+        for (const QString &partition : partitions) {
+            if (DQuickSearch::count_adler32(partition) != sequential_adler32.value(partition))
+                ++different;
+        }
+    }
+
+    Benchmark::check(different == 0, "the lft files built in parallel differ from the ones built one by one");
+
+    QJsonObject result = Benchmark::toJson(all_ready_samples, partitions.count());
+    const double per_disk_ms = all_ready_samples.percentile(0.5);
+
+    result.insert("first_ready_p50_ms", first_ready_samples.percentile(0.5));
+    result.insert("sequential_all_ready_p50_ms", sequential_ms);
+    result.insert("speedup", per_disk_ms > 0 ? sequential_ms / per_disk_ms : 0);
+    result.insert("different_lft_files", different);
+    Benchmark::report(SUITE, "index-per-disk", result);
+}
+
+// the chunks are handed over while the volume is searched, as the daemon sessions get them
+static void benchmarkSearchFirstResult(const QString &path, const QString &keyword, int iterations)
+{
+    Benchmark::Samples samples;
+    Benchmark::Samples first_result_samples;
+    int results = 0;
+
+    for (int i = 0; i < iterations; ++i) {
+        QElapsedTimer timer;
+        qint64 first_result = -1;
+
+        results = 0;
+        timer.start();
+        DQuickSearch::instance()->search(path, keyword, [&] (const QList<QString> &chunk) {
+            if (first_result < 0 && !chunk.isEmpty())
+                first_result = timer.nsecsElapsed();
+
+            results += chunk.count();
+
+            return true;
+        });
+        samples.add(timer.nsecsElapsed());
+
+        if (Benchmark::check(first_result >= 0, "no result of " + keyword + " in " + path))
+            first_result_samples.add(first_result);
+    }
+
+    QJsonObject result = Benchmark::toJson(samples, results);
+
+    result.insert("results", results);
+    result.insert("first_result_p50_ms", first_result_samples.percentile(0.5));
+    result.insert("first_result_p95_ms", first_result_samples.percentile(0.95));
+    Benchmark::report(SUITE, "search-first-result", result);
+}
+
+// cancels the search once it handed over its first chunk, the chunk may be empty if nothing matches.
+// the search waits in the first chunk like a session whose client does not fetch, so the index must
+// not be locked meanwhile
+static void benchmarkSearchCancel(const QString &path, const QString &keyword, const QString &name, int iterations)
+{
+    Benchmark::Samples samples;
+    Benchmark::Samples lock_samples;
+    int completed = 0;
+
+    for (int i = 0; i < iterations; ++i) {
+        std::atomic<bool> canceled(false);
+        QSemaphore started;
+        QSemaphore resume;
+        QElapsedTimer timer;
+
+        QFuture<bool> future = QtConcurrent::run([&] {
+            bool first = true;
+
+            return DQuickSearch::instance()->search(path, keyword, [&] (const QList<QString> &) {
+                if (first) {
+                    first = false;
+                    started.release();
+                    resume.acquire();
+                }
+
+                return !canceled.load();
+            });
+        });
+
+        // the search may finish before it handed over a chunk
+        while (!started.tryAcquire(1, 10)) {
+            if (future.isFinished())
+                break;
+        }
+
+        if (!future.isFinished()) {
+            QElapsedTimer lock_timer;
+
+            lock_timer.start();
+            DQuickSearch::instance()->whetherPathCached(path);
+            lock_samples.add(lock_timer.nsecsElapsed());
+        }
+
+        timer.start();
+        canceled.store(true);
+        resume.release();
+
+        if (future.result())
+            ++completed;
+        else
+            samples.add(timer.nsecsElapsed());
+    }
+
+    QJsonObject result = Benchmark::toJson(samples, 1);
+
+    result.insert("keyword", keyword);
+    result.insert("completed_before_cancel", completed);
+    result.insert("index_lock_p50_ms", lock_samples.percentile(0.5));
+    Benchmark::check(lock_samples.count() == 0 || lock_samples.percentile(0.95) < 1000,
+                     "the index is locked while a search waits for its client");
+    Benchmark::report(SUITE, name, result);
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription("Measures building and searching the quick search indexes.");
+    parser.addHelpOption();
+    Benchmark::addCommonOptions(parser);
+    parser.addOptions({
+        {"partitions", "The synthetic trees indexed as partitions.", "count", "4"},
+        {"search-volume", "Also index the whole volume of --dir and measure the searches in it, "
+                          "the index file is written into the root of the volume, use a small dedicated one."}
+    });
+    parser.process(app);
+
+    const int iterations = Benchmark::iterations(parser);
+    Benchmark::TreeOptions options = Benchmark::treeOptions(parser);
+    const QString work_directory = Benchmark::createWorkDirectory(parser);
+    QStringList partitions;
+    Benchmark::TreeInfo tree;
+
+    // only the entries are indexed
+    options.minFileSize = 0;
+    options.maxFileSize = 0;
+
+    for (int i = parser.value("partitions").toInt(); i > 0; --i) {
+        partitions << QString("%1/partition-%2").arg(work_directory).arg(i);
+        tree = Benchmark::createTree(partitions.last(), options);
+        ++options.seed;
+    }
+
+    // the lft files are part of the trees, so every measured build sees the same entries
+    for (const QString &partition : partitions)
+        Benchmark::check(DQuickSearch::instance()->cachePartition(partition), "failed to index " + partition);
+
+    const double sequential_ms = benchmarkIndex(partitions, tree, iterations);
+
+    benchmarkPerDiskIndex(partitions, sequential_ms, iterations);
+
+    // the searches find the index by the mount point of the searched path, not by the synthetic partitions
+    if (parser.isSet("search-volume")) {
+        const QString volume = DStorageInfo(work_directory).rootPath();
+
+        if (Benchmark::check(DQuickSearch::instance()->cachePartition(volume), "failed to index " + volume)) {
+            benchmarkSearchFirstResult(work_directory, "txt", iterations);
+            benchmarkSearchCancel(work_directory, "txt", "search-cancel-matching", iterations);
+            // without matches the search hands over empty chunks only
+            benchmarkSearchCancel(work_directory, "dfm-benchmark-no-match", "search-cancel-no-match", iterations);
+        }
+    }
+
+    Benchmark::removeTree(work_directory);
+
+    return Benchmark::exitCode();
+}
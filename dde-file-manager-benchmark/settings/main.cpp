@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmarkutils.h"
+
+#include "interfaces/dfmsettings.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QtConcurrent>
+
+DFM_USE_NAMESPACE
+
+static const QString SUITE = QStringLiteral("settings");
+static const QString VIEW_STATE_GROUP = QStringLiteral("FileViewState");
+
+static QVariantMap viewState(int index)
+{
+    return QVariantMap {{"sortRole", 256 + index % 8}, {"sortOrder", index % 2}, {"viewMode", 1 + index % 2}};
+}
+
+// the group of the view state is bounded like in dde-file-manager.obtusely.default.json
+static QString createDefaultFile(const QString &directory, int maxCount)
+{
+    const QString file_path = directory + "/default.json";
+    QFile file(file_path);
+    const QJsonObject metadata {{VIEW_STATE_GROUP, QJsonObject {{"maxCount", maxCount}}}};
+
+    if (!file.open(QFile::WriteOnly) || file.write(QJsonDocument(QJsonObject {{"__metadata__", metadata}}).toJson()) < 0)
+        qFatal("Failed to write %s", qPrintable(file_path));
+
+    return file_path;
+}
+
+// the latency of saving the view state of one directory, with the view state
+// of count directories already stored
+static void benchmarkSave(const QString &directory, const QString &defaultFile, int count, int saves)
+{
+    const QString setting_file = QString("%1/save-%2.json").arg(directory).arg(count);
+    DFMSettings settings(defaultFile, QString(), setting_file);
+
+    for (int i = 0; i < count; ++i)
+        settings.setValue(VIEW_STATE_GROUP, QString("file:///stored/dir-%1").arg(i), viewState(i));
+
+    settings.sync();
+
+    Benchmark::Samples samples;
+
+    for (int i = 0; i < saves; ++i) {
+        QElapsedTimer timer;
+
+        timer.start();
+        settings.setValue(VIEW_STATE_GROUP, QString("file:///visited/dir-%1").arg(i), viewState(i));
+        Benchmark::check(settings.sync(), "failed to save " + setting_file);
+        samples.add(timer.nsecsElapsed());
+    }
+
+    QJsonObject result = Benchmark::toJson(samples, 1);
+
+    result.insert("directories", count);
+    result.insert("setting_file_kb", QFileInfo(setting_file).size() / 1024);
+    result.insert("journal_kb", QFileInfo(setting_file + ".journal").size() / 1024);
+    Benchmark::report(SUITE, "save", result);
+}
+
+// two instances saving the same file at the same time, as two processes do,
+// no value may be lost when one of them compacts the journal
+static void checkConcurrentSaves(const QString &directory, const QString &defaultFile, int saves)
+{
+    const QString setting_file = directory + "/concurrent.json";
+    const QStringList writers {"a", "b"};
+    QElapsedTimer timer;
+
+    timer.start();
+    QtConcurrent::blockingMap(writers, [&] (const QString &writer) {
+        DFMSettings settings(defaultFile, QString(), setting_file);
+
+        for (int i = 0; i < saves; ++i) {
+            // large values, the journal is compacted several times
+            settings.setValue("Concurrent", QString("%1-%2").arg(writer).arg(i), QString(1024, 'x'));
+            settings.sync();
+        }
+    });
+
+    const qint64 elapsed = timer.elapsed();
+    DFMSettings settings(defaultFile, QString(), setting_file);
+    int lost = 0;
+
+    for (const QString &writer : writers) {
+        for (int i = 0; i < saves; ++i) {
+            if (!settings.isRemovable("Concurrent", QString("%1-%2").arg(writer).arg(i)))
+                ++lost;
+        }
+    }
+
+    Benchmark::check(lost == 0, QString("%1 of %2 concurrently saved values are lost").arg(lost).arg(saves * writers.count()));
+    Benchmark::report(SUITE, "concurrent-save", QJsonObject {{"total_ms", elapsed}, {"saves", saves * writers.count()},
+                                                            {"lost", lost}});
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription("Measures the save latency of DFMSettings.");
+    parser.addHelpOption();
+    Benchmark::addCommonOptions(parser);
+    parser.addOptions({
+        {"directories", "The comma separated counts of stored directory view states.", "counts", "100,1000,10000,50000"},
+        {"max-count", "The maxCount of the view state group.", "count", "100000"},
+        {"saves", "The saves measured for every count.", "count", "200"}
+    });
+    parser.process(app);
+
+    const QString work_directory = Benchmark::createWorkDirectory(parser);
+    const QString default_file = createDefaultFile(work_directory, parser.value("max-count").toInt());
+    const int saves = parser.value("saves").toInt();
+
+    for (const QString &count : parser.value("directories").split(',', QString::SkipEmptyParts))
+        benchmarkSave(work_directory, default_file, count.toInt(), saves);
+
+    checkConcurrentSaves(work_directory, default_file, saves);
+
+    Benchmark::removeTree(work_directory);
+
+    return Benchmark::exitCode();
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmarkutils.h"
+
+#include "textpreviewdocument.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+
+#include <random>
+
+DFM_USE_NAMESPACE
+
+static const QString SUITE = QStringLiteral("textpreview");
+// same as the text preview
+static const int WINDOW_LINES = 1000;
+
+// ASCII lines of 0 to 160 characters, returns the number of lines
+static int createTextFile(const QString &path, qint64 size, quint32 seed)
+{
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<int> lengths(0, 160);
+    std::uniform_int_distribution<int> chars('a', 'z');
+    QFile file(path);
+    QByteArray block;
+    qint64 written = 0;
+    int lines = 0;
+
+    if (!file.open(QIODevice::WriteOnly))
+        return 0;
+
+    while (written < size) {
+        block.clear();
+
+        while (block.size() < 1024 * 1024 && written + block.size() < size) {
+            for (int i = lengths(engine); i > 0; --i)
+                block.append(char(chars(engine)));
+
+            block.append('\n');
+            ++lines;
+        }
+
+        file.write(block);
+        written += block.size();
+    }
+
+    return lines;
+}
+
+static void waitForIndex(const TextPreviewDocument &document)
+{
+    while (!document.isIndexed())
+        QThread::msleep(1);
+}
+
+// the time to the first window, to a window near the end before the index is
+// finished, and to the finished index
+static void benchmarkOpen(const QString &path, int lines, int iterations)
+{
+    Benchmark::Samples first_window_samples;
+    Benchmark::Samples jump_samples;
+    Benchmark::Samples index_samples;
+
+    for (int i = 0; i < iterations; ++i) {
+        TextPreviewDocument document;
+        QElapsedTimer timer;
+        int window_lines = 0;
+
+        timer.start();
+        Benchmark::check(document.open(path), "failed to open " + path);
+        document.text(0, WINDOW_LINES, &window_lines);
+        first_window_samples.add(timer.nsecsElapsed());
+
+        Benchmark::check(window_lines == qMin(lines, WINDOW_LINES), QString("the first window has %1 lines").arg(window_lines));
+
+        timer.restart();
+        document.text(qMax(0, document.lineCount() - WINDOW_LINES), WINDOW_LINES);
+        jump_samples.add(timer.nsecsElapsed());
+
+        waitForIndex(document);
+        index_samples.add(timer.nsecsElapsed());
+
+        Benchmark::check(document.lineCount() == lines, QString("%1 of %2 lines were indexed").arg(document.lineCount()).arg(lines));
+    }
+
+    QJsonObject result = Benchmark::toJson(first_window_samples, 1);
+
+    result.insert("size", QFileInfo(path).size());
+    result.insert("lines", lines);
+    Benchmark::report(SUITE, "first-window", result);
+
+    result = Benchmark::toJson(jump_samples, 1);
+    Benchmark::report(SUITE, "jump-to-end", result);
+
+    result = Benchmark::toJson(index_samples, lines);
+    Benchmark::report(SUITE, "index", result);
+}
+
+// the file is truncated while it is previewed, the reads must stop at the new end
+static void checkTruncated(const QString &path, qint64 size, int lines)
+{
+    const QString copy = path + ".truncated";
+
+    QFile::remove(copy);
+    QFile::copy(path, copy);
+
+    TextPreviewDocument document;
+
+    if (!Benchmark::check(document.open(copy), "failed to open " + copy))
+        return;
+
+    QFile::resize(copy, size / 2);
+
+    bool at_end = false;
+    int window_lines = 0;
+
+    document.text(qMax(0, document.lineCount() - WINDOW_LINES), WINDOW_LINES, nullptr, &at_end);
+    Benchmark::check(at_end, "the window past the truncated end is not at the end");
+
+    waitForIndex(document);
+    Benchmark::check(document.lineCount() < lines, QString("%1 lines were indexed in the truncated file").arg(document.lineCount()));
+
+    document.text(qMax(0, document.lineCount() - WINDOW_LINES), WINDOW_LINES, &window_lines);
+    Benchmark::check(window_lines > 0, "the last window of the truncated file is empty");
+
+    QFile::remove(copy);
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription("Measures the windowed preview of large text files.");
+    parser.addHelpOption();
+    Benchmark::addCommonOptions(parser);
+    parser.addOptions({
+        {"size", "The size of the text file in MB.", "MB", "256"}
+    });
+    parser.process(app);
+
+    const Benchmark::TreeOptions options = Benchmark::treeOptions(parser);
+    const QString work_directory = Benchmark::createWorkDirectory(parser);
+    const QString path = work_directory + "/preview.txt";
+    const qint64 size = parser.value("size").toLongLong() * 1024 * 1024;
+    const int lines = createTextFile(path, size, options.seed);
+
+    benchmarkOpen(path, lines, Benchmark::iterations(parser));
+    checkTruncated(path, size, lines);
+
+    Benchmark::removeTree(work_directory);
+
+    return Benchmark::exitCode();
+}
@@ -0,0 +1,14 @@
+include(../benchmark.pri)
+
+TARGET = dfm-benchmark-textpreview
+
+TEXT_PREVIEW_DIR = $$PWD/../../dde-file-manager-plugins/pluginPreview/dde-text-preview-plugin
+
+INCLUDEPATH += $$TEXT_PREVIEW_DIR
+
+HEADERS += \
+    $$TEXT_PREVIEW_DIR/textpreviewdocument.h
+
+SOURCES += \
+    main.cpp \
+    $$TEXT_PREVIEW_DIR/textpreviewdocument.cpp
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmarkutils.h"
+
+#include "dfileservices.h"
+#include "controllers/filecontroller.h"
+#include "interfaces/dfmstandardpaths.h"
+#include "fileoperations/filejob.h"
+
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+
+#include <sys/stat.h>
+
+DFM_USE_NAMESPACE
+
+static const QString SUITE = QStringLiteral("trash");
+
+struct FileId
+{
+    dev_t dev = 0;
+    ino_t ino = 0;
+
+    bool operator==(const FileId &other) const
+    {
+        return dev == other.dev && ino == other.ino;
+    }
+};
+
+static FileId fileId(const QString &path)
+{
+    struct stat st;
+    FileId id;
+
+    if (::lstat(QFile::encodeName(path).constData(), &st) == 0) {
+        id.dev = st.st_dev;
+        id.ino = st.st_ino;
+    }
+
+    return id;
+}
+
+// the files of --dir are moved to the trash of their volume. A trashed file
+// keeping its inode was renamed, not copied and removed
+static void checkMoveToTrash(const QString &directory, int count, const Benchmark::TreeOptions &options, int iterations)
+{
+    Benchmark::Samples samples;
+    Benchmark::TreeInfo tree;
+    int copied = 0;
+    QString trash_path;
+
+    for (int i = 0; i < iterations; ++i) {
+        const QString source = QString("%1/source-%2").arg(directory).arg(i);
+
+        tree = Benchmark::createFlatDirectory(source, count, options);
+
+        DUrlList urls;
+        QList<FileId> ids;
+
+        for (const QFileInfo &info : QDir(source).entryInfoList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot)) {
+            urls << DUrl::fromLocalFile(info.absoluteFilePath());
+            ids << fileId(info.absoluteFilePath());
+        }
+
+        trash_path = DFMStandardPaths::trashPathForFile(source, true);
+
+        FileJob job(FileJob::Trash);
+        QElapsedTimer timer;
+
+        timer.start();
+        const DUrlList &trashed = job.doMoveToTrash(urls);
+        samples.add(timer.nsecsElapsed());
+
+        Benchmark::check(trashed.count() == urls.count(), QString("%1 of %2 files were moved to the trash")
+                         .arg(trashed.count()).arg(urls.count()));
+
+        for (int j = 0; j < trashed.count() && j < ids.count(); ++j) {
+            const QString &trashed_file = trashed.at(j).toLocalFile();
+
+            if (!(fileId(trashed_file) == ids.at(j)))
+                ++copied;
+
+            // only the files of the benchmark are taken out of the trash again
+            Benchmark::removeTree(trashed_file);
+            QFile::remove(QString("%1/info/%2.trashinfo").arg(trash_path).arg(QFileInfo(trashed_file).fileName()));
+        }
+
+        Benchmark::removeTree(source);
+    }
+
+    Benchmark::check(fileId(trash_path).dev == fileId(directory).dev,
+                     QString("the trash %1 is not on the volume of %2").arg(trash_path).arg(directory));
+    Benchmark::check(copied == 0, QString("%1 files were copied to the trash instead of renamed").arg(copied));
+
+    QJsonObject result = Benchmark::toJson(samples, tree.files);
+
+    result.insert("tree", Benchmark::toJson(tree));
+    result.insert("trash", trash_path);
+    result.insert("copied", copied);
+    Benchmark::report(SUITE, "move-to-trash", result);
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription("Checks that moving to the trash of a volume copies no data.");
+    parser.addHelpOption();
+    Benchmark::addCommonOptions(parser);
+    parser.process(app);
+
+    DFileService::dRegisterUrlHandler<FileController>(FILE_SCHEME, "");
+
+    const Benchmark::TreeOptions options = Benchmark::treeOptions(parser);
+    const QString work_directory = Benchmark::createWorkDirectory(parser);
+
+    checkMoveToTrash(work_directory, options.filesPerDirectory, options, Benchmark::iterations(parser));
+
+    Benchmark::removeTree(work_directory);
+
+    return Benchmark::exitCode();
+}
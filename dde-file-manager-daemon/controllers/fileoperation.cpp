@@ -34,10 +34,35 @@
 
 #include <QDBusConnection>
 #include <QDBusVariant>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QDateTime>
 #include <QDebug>
 
 QString FileOperation::ObjectPath = "/com/deepin/filemanager/daemon/Operations";
 
+// keep the summaries of the latest jobs only
+static const int MAX_RECENT_JOB_TRACES = 32;
+static const int MAX_JOB_TRACE_SIZE = 64 * 1024;
+static const int MAX_RUNNING_JOB_TRACES = 64;
+// the snapshots are sent every second, a job not reported for longer has gone with its process
+static const qint64 RUNNING_JOB_TRACE_TIMEOUT = 10 * 1000;
+
+// add the numbers of the source object to the target object, recursively
+static void mergeJobTrace(QJsonObject &target, const QJsonObject &source)
+{
+    for (auto it = source.constBegin(); it != source.constEnd(); ++it) {
+        if (it.value().isDouble()) {
+            target[it.key()] = target.value(it.key()).toDouble() + it.value().toDouble();
+        } else if (it.value().isObject()) {
+            QJsonObject object = target.value(it.key()).toObject();
+
+            mergeJobTrace(object, it.value().toObject());
+            target[it.key()] = object;
+        }
+    }
+}
+
 FileOperation::FileOperation(const QString &servicePath, QObject *parent) :
     QObject(parent)
 {
@@ -130,6 +155,88 @@ DBusInfoRet FileOperation::NewDeleteJob(const QStringList &filelist)
     return result;
 }
 
+void FileOperation::ReportJobTrace(const QString &summary)
+{
+    if (summary.size() > MAX_JOB_TRACE_SIZE) {
+        qWarning() << "The job trace summary is too large:" << summary.size();
+
+        return;
+    }
+
+    const QJsonObject &object = QJsonDocument::fromJson(summary.toUtf8()).object();
+
+    if (object.isEmpty())
+        return;
+
+    const QString &key = QStringLiteral("%1/%2").arg(calledFromDBus() ? message().service() : QString())
+                                                 .arg(object.value("job").toVariant().toULongLong());
+
+    if (object.value("running").toBool()) {
+        // the jobs whose processes died never send their final report
+        if (!m_runningJobTraces.contains(key) && m_runningJobTraces.size() >= MAX_RUNNING_JOB_TRACES)
+            removeStaleJobTraces();
+
+        if (m_runningJobTraces.contains(key) || m_runningJobTraces.size() < MAX_RUNNING_JOB_TRACES) {
+            m_runningJobTraces[key] = qMakePair(QDateTime::currentMSecsSinceEpoch(), object);
+        }
+
+        return;
+    }
+
+    m_runningJobTraces.remove(key);
+
+    QJsonObject total;
+
+    total["phases"] = object.value("phases");
+    total["counters"] = object.value("counters");
+    total["jobs"] = 1;
+    mergeJobTrace(m_jobTraceTotal, total);
+
+    m_recentJobTraces.append(object);
+
+    if (m_recentJobTraces.size() > MAX_RECENT_JOB_TRACES) {
+        m_recentJobTraces.removeFirst();
+    }
+}
+
+void FileOperation::removeStaleJobTraces()
+{
+    const qint64 current_time = QDateTime::currentMSecsSinceEpoch();
+
+    for (auto it = m_runningJobTraces.begin(); it != m_runningJobTraces.end();) {
+        if (current_time - it.value().first > RUNNING_JOB_TRACE_TIMEOUT) {
+            it = m_runningJobTraces.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+QString FileOperation::GetJobTraceSummary()
+{
+    QJsonArray recent;
+
+    for (const QJsonObject &object : m_recentJobTraces) {
+        recent.append(object);
+    }
+
+    QJsonArray running;
+
+    removeStaleJobTraces();
+
+    for (auto it = m_runningJobTraces.constBegin(); it != m_runningJobTraces.constEnd(); ++it) {
+        running.append(it.value().second);
+    }
+
+    QJsonObject summary {
+        {"total", m_jobTraceTotal},
+        {"recent", recent},
+        {"running", running}
+    };
+
+    return QString::fromUtf8(QJsonDocument(summary).toJson(QJsonDocument::Compact));
+}
+
 QString FileOperation::test(const QString &oldFile, const QString &newFile, QDBusObjectPath &result2, bool &result3)
 {
     Q_UNUSED(oldFile)
@@ -27,6 +27,7 @@
 
 #include <QObject>
 #include <QtDBus>
+#include <QJsonObject>
 #include "dbusservice/dbustype/dbusinforet.h"
 
 
@@ -52,10 +53,21 @@ public slots:
     DBusInfoRet NewRenameJob(const QString &oldFile, const QString &newFile);
     DBusInfoRet NewDeleteJob(const QStringList &filelist);
     QString test(const QString &oldFile, const QString &newFile, QDBusObjectPath &result2, bool &result3);
+    // the summaries of the traced file operation jobs of the file manager processes
+    // and snapshots of the running ones, see DFileJobTracer
+    void ReportJobTrace(const QString &summary);
+    QString GetJobTraceSummary();
 
 private:
+    // the snapshots older than RUNNING_JOB_TRACE_TIMEOUT
+    void removeStaleJobTraces();
+
     QString m_servicePath;
     FileOperationAdaptor* m_fileOperationAdaptor;
+    QJsonObject m_jobTraceTotal;
+    QList<QJsonObject> m_recentJobTraces;
+    // the latest snapshot of each running job, by the sender and the job id
+    QHash<QString, QPair<qint64, QJsonObject>> m_runningJobTraces;
 };
 
 typedef QMap<QString, QString> StringMap;
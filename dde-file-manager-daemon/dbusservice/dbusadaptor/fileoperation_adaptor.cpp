@@ -33,6 +33,12 @@ FileOperationAdaptor::~FileOperationAdaptor()
     // destructor
 }
 
+QString FileOperationAdaptor::GetJobTraceSummary()
+{
+    // handle method call com.deepin.filemanager.daemon.Operations.GetJobTraceSummary
+    return parent()->GetJobTraceSummary();
+}
+
 DBusInfoRet FileOperationAdaptor::NewCopyJob(const QStringList &filelist, const QString &targetDir)
 {
     // handle method call com.deepin.filemanager.daemon.Operations.NewCopyJob
@@ -69,6 +75,12 @@ DBusInfoRet FileOperationAdaptor::NewRenameJob(const QString &oldFile, const QSt
     return parent()->NewRenameJob(oldFile, newFile);
 }
 
+void FileOperationAdaptor::ReportJobTrace(const QString &summary)
+{
+    // handle method call com.deepin.filemanager.daemon.Operations.ReportJobTrace
+    parent()->ReportJobTrace(summary);
+}
+
 QString FileOperationAdaptor::test(const QString &oldFile, const QString &newFile, QDBusObjectPath &result2, bool &result3)
 {
     // handle method call com.deepin.filemanager.daemon.Operations.test
@@ -68,6 +68,12 @@ class FileOperationAdaptor: public QDBusAbstractAdaptor
 "      <arg direction=\"out\" type=\"(so)\"/>\n"
 "      <annotation value=\"DBusInfoRet\" name=\"org.qtproject.QtDBus.QtTypeName.Out0\"/>\n"
 "    </method>\n"
+"    <method name=\"ReportJobTrace\">\n"
+"      <arg direction=\"in\" type=\"s\" name=\"summary\"/>\n"
+"    </method>\n"
+"    <method name=\"GetJobTraceSummary\">\n"
+"      <arg direction=\"out\" type=\"s\"/>\n"
+"    </method>\n"
 "    <method name=\"test\">\n"
 "      <arg direction=\"in\" type=\"s\" name=\"oldFile\"/>\n"
 "      <arg direction=\"in\" type=\"s\" name=\"newFile\"/>\n"
@@ -86,12 +92,14 @@ public:
 
 public: // PROPERTIES
 public Q_SLOTS: // METHODS
+    QString GetJobTraceSummary();
     DBusInfoRet NewCopyJob(const QStringList &filelist, const QString &targetDir);
     DBusInfoRet NewCreateFolderJob(const QString &fabspath);
     DBusInfoRet NewCreateTemplateFileJob(const QString &templateFile, const QString &targetDir);
     DBusInfoRet NewDeleteJob(const QStringList &filelist);
     DBusInfoRet NewMoveJob(const QStringList &filelist, const QString &targetDir);
     DBusInfoRet NewRenameJob(const QString &oldFile, const QString &newFile);
+    void ReportJobTrace(const QString &summary);
     QString test(const QString &oldFile, const QString &newFile, QDBusObjectPath &result2, bool &result3);
 Q_SIGNALS: // SIGNALS
 };
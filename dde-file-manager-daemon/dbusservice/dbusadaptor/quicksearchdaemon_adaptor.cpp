@@ -33,6 +33,12 @@ QuickSearchDaemonAdaptor::~QuickSearchDaemonAdaptor()
     // destructor
 }
 
+void QuickSearchDaemonAdaptor::cancelSearch(const QDBusVariant &session)
+{
+    // handle method call com.deepin.filemanager.daemon.QuickSearchDaemon.cancelSearch
+    QMetaObject::invokeMethod(parent(), "cancelSearch", Q_ARG(QDBusVariant, session));
+}
+
 QDBusVariant QuickSearchDaemonAdaptor::createCache()
 {
     // handle method call com.deepin.filemanager.daemon.QuickSearchDaemon.createCache
@@ -41,6 +47,14 @@ QDBusVariant QuickSearchDaemonAdaptor::createCache()
     return result;
 }
 
+QDBusVariant QuickSearchDaemonAdaptor::fetchSearchResults(const QDBusVariant &session, const QDBusVariant &max_count)
+{
+    // handle method call com.deepin.filemanager.daemon.QuickSearchDaemon.fetchSearchResults
+    QDBusVariant result;
+    QMetaObject::invokeMethod(parent(), "fetchSearchResults", Q_RETURN_ARG(QDBusVariant, result), Q_ARG(QDBusVariant, session), Q_ARG(QDBusVariant, max_count));
+    return result;
+}
+
 void QuickSearchDaemonAdaptor::fileWereCreated(const QDBusVariant &file_list)
 {
     // handle method call com.deepin.filemanager.daemon.QuickSearchDaemon.fileWereCreated
@@ -67,6 +81,14 @@ QDBusVariant QuickSearchDaemonAdaptor::search(const QDBusVariant &current_dir, c
     return result;
 }
 
+QDBusVariant QuickSearchDaemonAdaptor::startSearch(const QDBusVariant &current_dir, const QDBusVariant &key_words)
+{
+    // handle method call com.deepin.filemanager.daemon.QuickSearchDaemon.startSearch
+    QDBusVariant result;
+    QMetaObject::invokeMethod(parent(), "startSearch", Q_RETURN_ARG(QDBusVariant, result), Q_ARG(QDBusVariant, current_dir), Q_ARG(QDBusVariant, key_words));
+    return result;
+}
+
 QDBusVariant QuickSearchDaemonAdaptor::whetherCacheCompletely()
 {
     // handle method call com.deepin.filemanager.daemon.QuickSearchDaemon.whetherCacheCompletely
@@ -75,3 +97,11 @@ QDBusVariant QuickSearchDaemonAdaptor::whetherCacheCompletely()
     return result;
 }
 
+QDBusVariant QuickSearchDaemonAdaptor::whetherPathCached(const QDBusVariant &current_dir)
+{
+    // handle method call com.deepin.filemanager.daemon.QuickSearchDaemon.whetherPathCached
+    QDBusVariant result;
+    QMetaObject::invokeMethod(parent(), "whetherPathCached", Q_RETURN_ARG(QDBusVariant, result), Q_ARG(QDBusVariant, current_dir));
+    return result;
+}
+
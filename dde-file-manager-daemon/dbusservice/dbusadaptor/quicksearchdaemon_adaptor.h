@@ -38,12 +38,32 @@ class QuickSearchDaemonAdaptor: public QDBusAbstractAdaptor
 "      <arg direction=\"in\" type=\"v\" name=\"key_words\"/>\n"
 "      <arg direction=\"out\" type=\"v\" name=\"result\"/>\n"
 "    </method>\n"
+"    <method name=\"startSearch\">\n"
+"      <arg direction=\"in\" type=\"v\" name=\"current_dir\"/>\n"
+"      <arg direction=\"in\" type=\"v\" name=\"key_words\"/>\n"
+"      <arg direction=\"out\" type=\"v\" name=\"session\"/>\n"
+"    </method>\n"
+"    <method name=\"fetchSearchResults\">\n"
+"      <arg direction=\"in\" type=\"v\" name=\"session\"/>\n"
+"      <arg direction=\"in\" type=\"v\" name=\"max_count\"/>\n"
+"      <arg direction=\"out\" type=\"v\" name=\"result\"/>\n"
+"    </method>\n"
+"    <method name=\"cancelSearch\">\n"
+"      <arg direction=\"in\" type=\"v\" name=\"session\"/>\n"
+"    </method>\n"
+"    <signal name=\"searchResultsReady\">\n"
+"      <arg type=\"v\" name=\"session\"/>\n"
+"    </signal>\n"
 "    <method name=\"createCache\">\n"
 "      <arg direction=\"out\" type=\"v\" name=\"result\"/>\n"
 "    </method>\n"
 "    <method name=\"whetherCacheCompletely\">\n"
 "      <arg direction=\"out\" type=\"v\" name=\"result\"/>\n"
 "    </method>\n"
+"    <method name=\"whetherPathCached\">\n"
+"      <arg direction=\"in\" type=\"v\" name=\"current_dir\"/>\n"
+"      <arg direction=\"out\" type=\"v\" name=\"result\"/>\n"
+"    </method>\n"
 "    <method name=\"fileWereCreated\">\n"
 "      <arg direction=\"in\" type=\"v\" name=\"file_list\"/>\n"
 "    </method>\n"
@@ -61,13 +81,18 @@ public:
 
 public: // PROPERTIES
 public Q_SLOTS: // METHODS
+    void cancelSearch(const QDBusVariant &session);
     QDBusVariant createCache();
+    QDBusVariant fetchSearchResults(const QDBusVariant &session, const QDBusVariant &max_count);
     void fileWereCreated(const QDBusVariant &file_list);
     void fileWereDeleted(const QDBusVariant &file_list);
     void fileWereRenamed(const QDBusVariant &old_and_new);
     QDBusVariant search(const QDBusVariant &current_dir, const QDBusVariant &key_words);
+    QDBusVariant startSearch(const QDBusVariant &current_dir, const QDBusVariant &key_words);
     QDBusVariant whetherCacheCompletely();
+    QDBusVariant whetherPathCached(const QDBusVariant &current_dir);
 Q_SIGNALS: // SIGNALS
+    void searchResultsReady(const QDBusVariant &session);
 };
 
 #endif
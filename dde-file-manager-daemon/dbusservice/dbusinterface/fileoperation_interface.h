@@ -37,6 +37,12 @@ public:
     ~FileOperationInterface();
 
 public Q_SLOTS: // METHODS
+    inline QDBusPendingReply<QString> GetJobTraceSummary()
+    {
+        QList<QVariant> argumentList;
+        return asyncCallWithArgumentList(QStringLiteral("GetJobTraceSummary"), argumentList);
+    }
+
     inline QDBusPendingReply<DBusInfoRet> NewCopyJob(const QStringList &filelist, const QString &targetDir)
     {
         QList<QVariant> argumentList;
@@ -79,6 +85,13 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QStringLiteral("NewRenameJob"), argumentList);
     }
 
+    inline QDBusPendingReply<> ReportJobTrace(const QString &summary)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(summary);
+        return asyncCallWithArgumentList(QStringLiteral("ReportJobTrace"), argumentList);
+    }
+
     inline QDBusPendingReply<QString, QDBusObjectPath, bool> test(const QString &oldFile, const QString &newFile)
     {
         QList<QVariant> argumentList;
@@ -26,15 +26,81 @@
 
 #include <QDBusMetaType>
 #include <QByteArrayList>
+#include <QElapsedTimer>
+#include <QtConcurrent>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QDBusMessage>
+#include <QTimer>
+#include <QThreadPool>
+
+#include <atomic>
 
 
 static constexpr const char *ObjectPath{"/com/deepin/filemanager/daemon/QuickSearchDaemon"};
+static constexpr const char *InterfaceName{"com.deepin.filemanager.daemon.QuickSearchDaemon"};
+
+///###: the most results in one reply of fetchSearchResults.
+static constexpr const int MAX_FETCH_COUNT{ 1000 };
+///###: the oldest session of a client is canceled if it runs more sessions.
+static constexpr const int MAX_SESSIONS{ 4 };
+///###: the threads of the sessions, a session waits in its thread while the client does not fetch,
+///###: so two stalled clients at least do not hold up the others. the sessions beyond it are queued.
+static constexpr const int MAX_SEARCH_THREADS{ 3 * MAX_SESSIONS };
+///###: a session is canceled if the client did not fetch its results for a while.
+static constexpr const qint64 SESSION_TIMEOUT{ 30 * 1000 };
+///###: the search waits for the client if so many results were not fetched.
+static constexpr const int MAX_BUFFERED_RESULTS{ 10 * MAX_FETCH_COUNT };
+
+
+struct QuickSearchSession
+{
+    ///###: the unique name of the client on the bus, it is empty if not called from D-Bus.
+    QString owner{};
+
+    QMutex mutex{};
+    QWaitCondition bufferFree{};
+    QList<QString> results{};
+    bool finished{ false };
+    ///###: the last fetch got nothing, so the client waits for searchResultsReady.
+    bool waiting{ true };
+
+    std::atomic<bool> canceled{ false };
+
+    ///###: only used in the main thread.
+    QElapsedTimer lastAccess{};
+};
+
+///###: session->mutex must be held.
+static void notifyResultsReady(QuickSearchSession *session, quint64 id)
+{
+    if (!session->waiting || session->owner.isEmpty()) {
+        return;
+    }
+
+    session->waiting = false;
+
+    ///###: a targeted signal, the other clients on the system bus do not see it.
+    QDBusMessage message{ QDBusMessage::createTargetedSignal(session->owner, ObjectPath, InterfaceName,
+                                                             QStringLiteral("searchResultsReady")) };
+    message << QVariant::fromValue(QDBusVariant{ QVariant{ id } });
+
+    QDBusConnection::systemBus().send(message);
+}
 
 
 QuickSearchDaemon::QuickSearchDaemon(QObject *const parent)
     : QObject{parent},
-      adaptor{new QuickSearchDaemonAdaptor{ this }}
+      adaptor{new QuickSearchDaemonAdaptor{ this }},
+      m_idleTimer{new QTimer{ this }},
+      m_searchPool{new QThreadPool{ this }}
 {
+    m_searchPool->setMaxThreadCount(MAX_SEARCH_THREADS);
+
+    ///###: the search of an idle session may wait for its client, do not wait for the next call to cancel it.
+    m_idleTimer->setInterval(SESSION_TIMEOUT / 3);
+    connect(m_idleTimer, &QTimer::timeout, this, &QuickSearchDaemon::removeIdleSessions);
+
     qDBusRegisterMetaType<QByteArrayList>();
     qDBusRegisterMetaType<QPair<QByteArray, QByteArray>>();
     qDBusRegisterMetaType<QList<QPair<QByteArray, QByteArray>>>();
@@ -45,6 +111,14 @@ QuickSearchDaemon::QuickSearchDaemon(QObject *const parent)
     }
 }
 
+QuickSearchDaemon::~QuickSearchDaemon()
+{
+    ///###: the pool waits for its threads, wake up the searches waiting for their clients.
+    for (const quint64 id : m_sessions.keys()) {
+        removeSession(id);
+    }
+}
+
 QDBusVariant QuickSearchDaemon::createCache()
 {
     bool flag{ DQuickSearch::instance()->createCache() };
@@ -61,6 +135,15 @@ QDBusVariant QuickSearchDaemon::whetherCacheCompletely()
     return dbus_var;
 }
 
+QDBusVariant QuickSearchDaemon::whetherPathCached(const QDBusVariant &current_dir)
+{
+    QVariant path_var{ current_dir.variant() };
+    bool flag{ DQuickSearch::instance()->whetherPathCached(path_var.toString()) };
+    QDBusVariant dbus_var{ flag };
+
+    return dbus_var;
+}
+
 QDBusVariant QuickSearchDaemon::search(const QDBusVariant &current_dir, const QDBusVariant &key_words)
 {
     QVariant path_var{ current_dir.variant() };
@@ -76,6 +159,161 @@ QDBusVariant QuickSearchDaemon::search(const QDBusVariant &current_dir, const QD
     return dbus_var;
 }
 
+QDBusVariant QuickSearchDaemon::startSearch(const QDBusVariant &current_dir, const QDBusVariant &key_words)
+{
+    const QString path{ current_dir.variant().toString() };
+    const QString keys{ key_words.variant().toString() };
+    const QString owner{ caller() };
+
+    removeIdleSessions();
+
+    ///###: a client supersedes its own sessions only.
+    forever {
+        quint64 oldest_id{ 0 };
+        qint64 oldest_elapsed{ -1 };
+        int count{ 0 };
+
+        for (auto it = m_sessions.cbegin(); it != m_sessions.cend(); ++it) {
+            if (it.value()->owner != owner) {
+                continue;
+            }
+
+            ++count;
+
+            if (it.value()->lastAccess.elapsed() > oldest_elapsed) {
+                oldest_id = it.key();
+                oldest_elapsed = it.value()->lastAccess.elapsed();
+            }
+        }
+
+        if (count < MAX_SESSIONS) {
+            break;
+        }
+
+        removeSession(oldest_id);
+    }
+
+    const quint64 id{ ++m_lastSessionId };
+    QSharedPointer<QuickSearchSession> session{ new QuickSearchSession };
+
+    session->owner = owner;
+    session->lastAccess.start();
+    m_sessions.insert(id, session);
+
+    if (!m_idleTimer->isActive()) {
+        m_idleTimer->start();
+    }
+
+    QtConcurrent::run(m_searchPool, [session, id, path, keys] {
+        DQuickSearch::instance()->search(path, keys, [&session, id](const QList<QString> &chunk)->bool {
+                QMutexLocker locker{ &session->mutex };
+
+                ///###: the client is slower than the search, wait for it to fetch.
+                while (session->results.size() >= MAX_BUFFERED_RESULTS && !session->canceled.load()) {
+                    session->bufferFree.wait(&session->mutex);
+                }
+
+                if (session->canceled.load()) {
+                    return false;
+                }
+
+                if (chunk.isEmpty()) {
+                    return true;
+                }
+
+                session->results.append(chunk);
+                notifyResultsReady(session.data(), id);
+
+                return true;
+            });
+
+        QMutexLocker locker{ &session->mutex };
+        session->finished = true;
+        notifyResultsReady(session.data(), id);
+    });
+
+    return QDBusVariant{ QVariant{ id } };
+}
+
+QDBusVariant QuickSearchDaemon::fetchSearchResults(const QDBusVariant &session, const QDBusVariant &max_count)
+{
+    const quint64 id{ session.variant().toULongLong() };
+    const int count{ qBound(1, max_count.variant().toInt(), MAX_FETCH_COUNT) };
+    QVariantMap reply{};
+    QStringList files{};
+    bool finished{ true };
+
+    removeIdleSessions();
+
+    const QSharedPointer<QuickSearchSession> s{ m_sessions.value(id) };
+
+    if (s && s->owner == caller()) {
+        QMutexLocker locker{ &s->mutex };
+
+        files = QStringList(s->results.mid(0, count));
+        s->results.erase(s->results.begin(), s->results.begin() + files.size());
+        finished = s->finished && s->results.isEmpty();
+        s->waiting = files.isEmpty();
+        s->lastAccess.restart();
+        s->bufferFree.wakeAll();
+        locker.unlock();
+
+        if (finished) {
+            m_sessions.remove(id);
+
+            if (m_sessions.isEmpty()) {
+                m_idleTimer->stop();
+            }
+        }
+    }
+
+    reply.insert(QStringLiteral("files"), files);
+    reply.insert(QStringLiteral("finished"), finished);
+
+    return QDBusVariant{ QVariant{ reply } };
+}
+
+void QuickSearchDaemon::cancelSearch(const QDBusVariant &session)
+{
+    const quint64 id{ session.variant().toULongLong() };
+    const QSharedPointer<QuickSearchSession> s{ m_sessions.value(id) };
+
+    if (s && s->owner == caller()) {
+        removeSession(id);
+    }
+}
+
+QString QuickSearchDaemon::caller() const
+{
+    return calledFromDBus() ? message().service() : QString{};
+}
+
+void QuickSearchDaemon::removeSession(quint64 id)
+{
+    const QSharedPointer<QuickSearchSession> session{ m_sessions.take(id) };
+
+    if (session) {
+        session->canceled.store(true);
+
+        ///###: wake up the search if it is waiting for the client.
+        QMutexLocker locker{ &session->mutex };
+        session->bufferFree.wakeAll();
+    }
+
+    if (m_sessions.isEmpty()) {
+        m_idleTimer->stop();
+    }
+}
+
+void QuickSearchDaemon::removeIdleSessions()
+{
+    for (const quint64 id : m_sessions.keys()) {
+        if (m_sessions.value(id)->lastAccess.hasExpired(SESSION_TIMEOUT)) {
+            removeSession(id);
+        }
+    }
+}
+
 void QuickSearchDaemon::fileWereCreated(const QDBusVariant &file_list)
 {
     QVariant variant{ file_list.variant() };
@@ -22,29 +22,52 @@
 #define QUICKSEARCHDAEMON_H
 
 #include <QObject>
+#include <QHash>
+#include <QSharedPointer>
 #include <QDBusVariant>
+#include <QDBusContext>
 
 
+class QTimer;
+class QThreadPool;
 class QuickSearchDaemonAdaptor;
-class QuickSearchDaemon : public QObject
+struct QuickSearchSession;
+class QuickSearchDaemon : public QObject, protected QDBusContext
 {
     Q_OBJECT
 public:
     explicit QuickSearchDaemon(QObject *const parent);
-    virtual ~QuickSearchDaemon() = default;
+    virtual ~QuickSearchDaemon();
 
     QuickSearchDaemon(const QuickSearchDaemon &) = delete;
     QuickSearchDaemon &operator=(const QuickSearchDaemon &) = delete;
 
     Q_INVOKABLE QDBusVariant createCache();
     Q_INVOKABLE QDBusVariant whetherCacheCompletely();
+    Q_INVOKABLE QDBusVariant whetherPathCached(const QDBusVariant &current_dir);
     Q_INVOKABLE QDBusVariant search(const QDBusVariant &current_dir, const QDBusVariant &key_words);
+
+    ///###: search in a session, the results are fetched in chunks while the search is running.
+    ///###: only the client started a session can fetch or cancel it, the signal searchResultsReady
+    ///###: is sent to the client alone when the results of its session are ready to be fetched.
+    Q_INVOKABLE QDBusVariant startSearch(const QDBusVariant &current_dir, const QDBusVariant &key_words);
+    Q_INVOKABLE QDBusVariant fetchSearchResults(const QDBusVariant &session, const QDBusVariant &max_count);
+    Q_INVOKABLE void cancelSearch(const QDBusVariant &session);
+
     Q_INVOKABLE void fileWereCreated(const QDBusVariant &file_list);
     Q_INVOKABLE void fileWereDeleted(const QDBusVariant &file_list);
     Q_INVOKABLE void fileWereRenamed(const QDBusVariant &file_list);
 
 private:
+    QString caller() const;
+    void removeSession(quint64 id);
+    void removeIdleSessions();
+
     QuickSearchDaemonAdaptor *adaptor{ nullptr };
+    QTimer *m_idleTimer{ nullptr };
+    QThreadPool *m_searchPool{ nullptr };
+    QHash<quint64, QSharedPointer<QuickSearchSession>> m_sessions{};
+    quint64 m_lastSessionId{ 0 };
 };
 
 
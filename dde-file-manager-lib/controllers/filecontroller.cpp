@@ -68,6 +68,9 @@
 #include <QGuiApplication>
 #include <QUrlQuery>
 #include <QRegularExpression>
+#include <QThreadStorage>
+#include <QMutex>
+#include <QSemaphore>
 
 #include <unistd.h>
 
@@ -206,10 +209,31 @@ class DFMQuickSearchDirIterator : public DDirIterator
 {
 public:
     DFMQuickSearchDirIterator(const QString &path, const QString &keyword)
-        : m_pathForSearching(path)
+        : m_state(new SessionState)
+        , m_pathForSearching(path)
         , m_keyword(keyword)
     {
+        ///###: connected before the session is started, so the first signal of the daemon is not missed.
+        QSharedPointer<SessionState> state{ m_state };
 
+        m_readyConnection = QObject::connect(QuickSearchDaemonController::instance(), &QuickSearchDaemonController::searchResultsReady,
+        [state](quint64 session) {
+            const quint64 current{ state->session.load() };
+
+            ///###: the id is not known until startSearch returned, a wrong wakeup costs one more fetch only.
+            if (current == 0 || current == session) {
+                state->ready.release();
+            }
+        });
+    }
+
+    ~DFMQuickSearchDirIterator() override
+    {
+        QObject::disconnect(m_readyConnection);
+
+        if (!m_finished) {
+            QuickSearchDaemonController::instance()->cancelSearch(m_state->session.load());
+        }
     }
 
     DUrl next() override
@@ -222,23 +246,45 @@ public:
 
     bool hasNext() const override
     {
-        ///###: jundge whether had invoked quick-search and cached results or not.
-        ///###: the result is not empty.
-        if (m_cachedFlag.load(std::memory_order_consume) && !m_searchedResult.isEmpty()) {
+        if (!m_searchedResult.isEmpty()) {
             return true;
         }
 
-        ///###: if quick-search-daemon is not ready last time.
-        ///###: check out the status of quick-searh-daemon again here.
-        ///###: if ready, invoke quick-search-daemon to search files.
-        bool whether_cached_completely{ QuickSearchDaemonController::instance()->whetherCacheCompletely() };
+        if (m_state->session.load() == 0) {
+            ///###: if the partition of m_pathForSearching is not ready, check out the status of
+            ///###: quick-searh-daemon again next time.
+            if (m_closed.load() || !QuickSearchDaemonController::instance()->whetherPathCached(m_pathForSearching)) {
+                return false;
+            }
 
-        if (whether_cached_completely && !m_cachedFlag.load(std::memory_order_consume)) {
-            m_searchedResult = QuickSearchDaemonController::instance()->search(m_pathForSearching, m_keyword);
-            m_cachedFlag.store(true, std::memory_order_release);
+            m_state->session.store(QuickSearchDaemonController::instance()->startSearch(m_pathForSearching, m_keyword));
+
+            if (m_state->session.load() == 0) {
+                m_finished = true;
+            }
         }
 
-        return (m_cachedFlag.load(std::memory_order_consume) && !m_searchedResult.isEmpty());
+        ///###: the results come in chunks while the daemon is searching, show them as soon as possible.
+        while (m_searchedResult.isEmpty() && !m_finished && !m_closed.load()) {
+            m_searchedResult = QuickSearchDaemonController::instance()->fetchSearchResults(m_state->session.load(), FETCH_COUNT, &m_finished);
+
+            if (m_searchedResult.isEmpty() && !m_finished) {
+                ///###: the daemon sends searchResultsReady when there are new results, the timeout
+                ///###: only covers a lost signal. the wakeups before the next fetch are covered by it.
+                m_state->ready.tryAcquire(1, FETCH_TIMEOUT);
+                m_state->ready.tryAcquire(m_state->ready.available());
+            }
+        }
+
+        return !m_searchedResult.isEmpty();
+    }
+
+    void close() override
+    {
+        ///###: the keyword was changed or the view was closed, stop the search in the daemon.
+        m_closed.store(true);
+        m_state->ready.release();
+        QuickSearchDaemonController::instance()->cancelSearch(m_state->session.load());
     }
 
     QString fileName() const override
@@ -266,7 +312,20 @@ public:
     }
 
 private:
-    mutable std::atomic<bool> m_cachedFlag{ false };
+    ///###: the results of one fetch, also the limit of one D-Bus reply.
+    static constexpr const int FETCH_COUNT{ 500 };
+    static constexpr const int FETCH_TIMEOUT{ 1000 };
+
+    ///###: shared with the connection to searchResultsReady, which is called in the main thread.
+    struct SessionState {
+        std::atomic<quint64> session{ 0 };
+        QSemaphore ready{};
+    };
+
+    QSharedPointer<SessionState> m_state;
+    QMetaObject::Connection m_readyConnection{};
+    mutable std::atomic<bool> m_closed{ false };
+    mutable bool m_finished{ false };
     mutable QList<QString> m_searchedResult{};
     QString m_pathForSearching{};
     QString m_keyword;
@@ -913,68 +972,214 @@ DFileHandler *FileController::createFileHandler(const QSharedPointer<DFMUrlBaseE
     return new DLocalFileHandler();
 }
 
+// The patterns of a genericObtuselySetting group in "path regexp/name regexp" form,
+// compiled once and again only after the group was changed. The name patterns
+// sharing a path pattern are joined into one expression, and the expressions
+// that apply to a directory are remembered per thread since the entries of
+// a directory are matched one after another.
 class Match
 {
 public:
-    Match(const QString &group)
+    explicit Match(const QString &group)
+        : group(group)
+    {
+        QObject::connect(DFMApplication::genericObtuselySetting(), &DFMSettings::valueChanged,
+        [this] (const QString &group) {
+            if (group == this->group)
+                changed.storeRelease(1);
+        });
+    }
+
+    bool match(const QString &path, const QString &name)
+    {
+        const QSharedPointer<const Rules> &rules = currentRules();
+
+        if (rules->rules.isEmpty())
+            return false;
+
+        if (!lastDirectory.hasLocalData())
+            lastDirectory.setLocalData(new Directory());
+
+        Directory *directory = lastDirectory.localData();
+
+        if (directory->rules != rules || directory->path != path) {
+            directory->rules = rules;
+            directory->path = path;
+            directory->matchAll = false;
+            directory->nameExpressions.clear();
+
+            for (const Rule &rule : rules->rules) {
+                if (!rule.matchPath(path))
+                    continue;
+
+                if (rule.matchAll) {
+                    directory->matchAll = true;
+                    break;
+                }
+
+                directory->nameExpressions << &rule.names;
+            }
+        }
+
+        if (directory->matchAll)
+            return true;
+
+        for (const QRegularExpression *re : directory->nameExpressions) {
+            if (re->match(name).hasMatch())
+                return true;
+        }
+
+        return false;
+    }
+
+private:
+    struct Rule
+    {
+        // used instead of pathExpression if the pattern has no special characters
+        QString pathLiteral;
+        QRegularExpression pathExpression;
+        QRegularExpression names;
+        bool matchAll = false;
+
+        bool matchPath(const QString &path) const
+        {
+            if (!pathLiteral.isEmpty())
+                return path.contains(pathLiteral);
+
+            return pathExpression.pattern().isEmpty() || pathExpression.match(path).hasMatch();
+        }
+    };
+
+    struct Rules
+    {
+        QList<Rule> rules;
+    };
+
+    struct Directory
+    {
+        QSharedPointer<const Rules> rules;
+        QString path;
+        QList<const QRegularExpression*> nameExpressions;
+        bool matchAll = false;
+    };
+
+    static bool isValid(const QRegularExpression &re)
+    {
+        if (re.isValid())
+            return true;
+
+        qWarning() << re.pattern() << re.errorString();
+
+        return false;
+    }
+
+    QSharedPointer<const Rules> currentRules()
     {
+        if (changed.testAndSetOrdered(1, 0)) {
+            QSharedPointer<const Rules> new_rules(compile());
+            QMutexLocker locker(&mutex);
+
+            rules = new_rules;
+
+            return rules;
+        }
+
+        QMutexLocker locker(&mutex);
+
+        return rules;
+    }
+
+    Rules *compile() const
+    {
+        QList<QString> path_patterns;
+        QHash<QString, QStringList> name_patterns;
+
         for (const QString &key : DFMApplication::genericObtuselySetting()->keys(group)) {
             const QString &value = DFMApplication::genericObtuselySetting()->value(group, key).toString();
 
             int last_dir_split = value.lastIndexOf(QDir::separator());
+            QString path;
+            QString name = value;
 
             if (last_dir_split >= 0) {
-                QString path = value.left(last_dir_split);
+                path = value.left(last_dir_split);
+                name = value.mid(last_dir_split + 1);
 
                 if (path.startsWith("~/")) {
                     path.replace(0, 1, QDir::homePath());
                 }
 
-                patternList << qMakePair(path, value.mid(last_dir_split + 1));
-            } else {
-                patternList << qMakePair(QString(), value);
+                if (!path.isEmpty() && !isValid(QRegularExpression(path)))
+                    continue;
             }
+
+            if (!name.isEmpty() && !isValid(QRegularExpression(name)))
+                continue;
+
+            if (!name_patterns.contains(path))
+                path_patterns << path;
+
+            name_patterns[path] << name;
         }
-    }
 
-    bool match(const QString &path, const QString &name)
-    {
-        for (auto pattern : patternList) {
-            QRegularExpression re(QString(), QRegularExpression::MultilineOption);
+        Rules *rules = new Rules();
+        // the groups are renumbered in the joined expression, so the patterns
+        // referring to a group are compiled on their own
+        const QRegularExpression group_reference("\\\\[1-9gk]|\\(\\?(P[=>]|[+-]?\\d|&|\\||R\\))");
 
-            if (!pattern.first.isEmpty()) {
-                re.setPattern(pattern.first);
+        for (const QString &path : path_patterns) {
+            Rule rule;
+            const QStringList &names = name_patterns.value(path);
 
-                if (!re.isValid()) {
-                    qWarning() << re.errorString();
-                    continue;
-                }
+            if (!path.contains(QRegularExpression("[\\\\^$.|?*+()\\[\\]{}]"))) {
+                rule.pathLiteral = path;
+            } else {
+                rule.pathExpression = QRegularExpression(path, QRegularExpression::MultilineOption);
+                rule.pathExpression.optimize();
+            }
+
+            if (names.contains(QString())) {
+                rule.matchAll = true;
+                rules->rules << rule;
+
+                continue;
+            }
+
+            QStringList alternatives;
+
+            for (const QString &name : names) {
+                if (!name.contains(group_reference)) {
+                    alternatives << QStringLiteral("(?:%1)").arg(name);
 
-                if (!re.match(path).hasMatch()) {
                     continue;
                 }
-            }
 
-            if (pattern.second.isEmpty()) {
-                return true;
+                rule.names = QRegularExpression(name, QRegularExpression::MultilineOption);
+                rule.names.optimize();
+                rules->rules << rule;
             }
 
-            re.setPattern(pattern.second);
+            if (alternatives.isEmpty())
+                continue;
+
+            rule.names = QRegularExpression(alternatives.join('|'), QRegularExpression::MultilineOption);
+            rule.names.optimize();
 
-            if (!re.isValid()) {
-                qWarning() << re.errorString();
+            // should not happen, every pattern is valid on its own
+            if (!isValid(rule.names))
                 continue;
-            }
 
-            if (re.match(name).hasMatch()) {
-                return true;
-            }
+            rules->rules << rule;
         }
 
-        return false;
+        return rules;
     }
 
-    QList<QPair<QString, QString>> patternList;
+    const QString group;
+    QAtomicInt changed{1};
+    QMutex mutex;
+    QSharedPointer<const Rules> rules;
+    QThreadStorage<Directory*> lastDirectory;
 };
 
 bool FileController::customHiddenFileMatch(const QString &absolutePath, const QString &fileName)
@@ -1141,6 +1346,12 @@ bool FileDirIterator::enableIteratorByKeyword(const QString &keyword)
             {
                 bool whether_cached{ QuickSearchDaemonController::instance()->createCache() };
 
+                ///###: the partitions are indexed in parallel, the one of pathForSearching may be ready already.
+                if (!whether_cached)
+                {
+                    whether_cached = QuickSearchDaemonController::instance()->whetherPathCached(pathForSearching);
+                }
+
 #ifdef QT_DEBUG
                 qDebug() << whether_cached;
 #endif //QT_DEBUG
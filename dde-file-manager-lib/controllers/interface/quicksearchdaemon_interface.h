@@ -36,12 +36,26 @@ public:
     ~QuickSearchDaemonInterface();
 
 public Q_SLOTS: // METHODS
+    inline QDBusPendingReply<> cancelSearch(const QDBusVariant &session)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(session);
+        return asyncCallWithArgumentList(QStringLiteral("cancelSearch"), argumentList);
+    }
+
     inline QDBusPendingReply<QDBusVariant> createCache()
     {
         QList<QVariant> argumentList;
         return asyncCallWithArgumentList(QStringLiteral("createCache"), argumentList);
     }
 
+    inline QDBusPendingReply<QDBusVariant> fetchSearchResults(const QDBusVariant &session, const QDBusVariant &max_count)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(session) << QVariant::fromValue(max_count);
+        return asyncCallWithArgumentList(QStringLiteral("fetchSearchResults"), argumentList);
+    }
+
     inline QDBusPendingReply<> fileWereCreated(const QDBusVariant &file_list)
     {
         QList<QVariant> argumentList;
@@ -70,13 +84,28 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QStringLiteral("search"), argumentList);
     }
 
+    inline QDBusPendingReply<QDBusVariant> startSearch(const QDBusVariant &current_dir, const QDBusVariant &key_words)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(current_dir) << QVariant::fromValue(key_words);
+        return asyncCallWithArgumentList(QStringLiteral("startSearch"), argumentList);
+    }
+
     inline QDBusPendingReply<QDBusVariant> whetherCacheCompletely()
     {
         QList<QVariant> argumentList;
         return asyncCallWithArgumentList(QStringLiteral("whetherCacheCompletely"), argumentList);
     }
 
+    inline QDBusPendingReply<QDBusVariant> whetherPathCached(const QDBusVariant &current_dir)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(current_dir);
+        return asyncCallWithArgumentList(QStringLiteral("whetherPathCached"), argumentList);
+    }
+
 Q_SIGNALS: // SIGNALS
+    void searchResultsReady(const QDBusVariant &session);
 };
 
 namespace com {
@@ -20,14 +20,149 @@
  */
 #include "operatorrevocation.h"
 #include "dfmeventdispatcher.h"
+#include "dfileservices.h"
+#include "dfmstandardpaths.h"
 #include "models/trashfileinfo.h"
+#include "app/define.h"
+#include "dialogs/dialogmanager.h"
+#include "dialogs/dtaskdialog.h"
+#include "singleton.h"
+
+#include <QApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QSaveFile>
+#include <QTimer>
+#include <QDebug>
 
 DFM_BEGIN_NAMESPACE
 
+// the oldest operations are dropped once the journal is larger than these,
+// until it is 3/4 of the limits
+static const int MAX_JOURNAL_ENTRIES = 10000;
+static const qint64 MAX_JOURNAL_SIZE = 1024 * 1024;
+// the entries undone in each loop of the event loop while undoing a batch
+static const int BATCH_STEP_COUNT = 20;
+static const QByteArray SPLIT_ENTRY = "{\"split\":true}";
+
 class OperatorRevocationPrivate : public OperatorRevocation
 {public: OperatorRevocationPrivate(){}};
 Q_GLOBAL_STATIC(OperatorRevocationPrivate, _dfm_or)
 
+static QJsonArray urlListToJson(const DUrlList &list)
+{
+    QJsonArray array;
+
+    for (const DUrl &url : list) {
+        array.append(url.toString());
+    }
+
+    return array;
+}
+
+// the reverse of DFMEvent::fromJson for the events used to undo the operations
+static QJsonObject eventToJson(const QSharedPointer<DFMEvent> &event)
+{
+    QJsonObject json;
+
+    switch ((int)event->type()) {
+    case DFMEvent::RenameFile: {
+        const DFMRenameEvent *e = static_cast<const DFMRenameEvent *>(event.data());
+
+        json["from"] = e->fromUrl().toString();
+        json["to"] = e->toUrl().toString();
+        break;
+    }
+    case DFMEvent::BatchRenameFiles: {
+        QJsonArray list;
+
+        for (const QPair<DUrl, DUrl> &rename : static_cast<const DFMBatchRenameEvent *>(event.data())->renameList())
+            list.append(QJsonArray {rename.first.toString(), rename.second.toString()});
+
+        json["renameList"] = list;
+        break;
+    }
+    case DFMEvent::DeleteFiles: {
+        const DFMDeleteEvent *e = static_cast<const DFMDeleteEvent *>(event.data());
+
+        json["urlList"] = urlListToJson(e->urlList());
+        json["silent"] = e->silent();
+        json["force"] = e->force();
+        break;
+    }
+    case DFMEvent::MoveToTrash:
+    case DFMEvent::RestoreFromTrash:
+        json["urlList"] = urlListToJson(static_cast<const DFMUrlListBaseEvent *>(event.data())->urlList());
+        break;
+    case DFMEvent::PasteFile: {
+        const DFMPasteEvent *e = static_cast<const DFMPasteEvent *>(event.data());
+
+        json["urlList"] = urlListToJson(e->urlList());
+        json["action"] = e->action();
+        json["targetUrl"] = e->targetUrl().toString();
+        break;
+    }
+    default:
+        return json;
+    }
+
+    json["eventType"] = DFMEvent::typeToName(event->type());
+
+    return json;
+}
+
+static bool fileExists(const DUrl &url)
+{
+    if (url.isLocalFile()) {
+        const QFileInfo info(url.toLocalFile());
+
+        return info.exists() || info.isSymLink();
+    }
+
+    const DAbstractFileInfoPointer &info = DFileService::instance()->createFileInfo(nullptr, url);
+
+    return info && info->exists();
+}
+
+// remove the files that do not exist anymore from the event, returns false
+// if nothing is left to undo. It is much cheaper than failing file by file.
+static bool verifyEvent(QJsonObject &json)
+{
+    const DFMEvent::Type type = DFMEvent::nameToType(json.value("eventType").toString());
+
+    if (type == DFMEvent::RenameFile) {
+        return fileExists(DUrl::fromUserInput(json.value("from").toString()));
+    }
+
+    // the renames depend on each other, the first one tells if the batch is still there
+    if (type == DFMEvent::BatchRenameFiles) {
+        const QJsonArray &list = json.value("renameList").toArray();
+
+        return !list.isEmpty() && fileExists(DUrl::fromUserInput(list.first().toArray().at(0).toString()));
+    }
+
+    if (type == DFMEvent::PasteFile && !fileExists(DUrl::fromUserInput(json.value("targetUrl").toString()))) {
+        return false;
+    }
+
+    if (!json.contains("urlList")) {
+        return true;
+    }
+
+    QJsonArray list;
+
+    for (const QJsonValue &value : json.value("urlList").toArray()) {
+        if (fileExists(DUrl::fromUserInput(value.toString()))) {
+            list.append(value);
+        }
+    }
+
+    json["urlList"] = list;
+
+    return !list.isEmpty();
+}
+
 OperatorRevocation *OperatorRevocation::instance()
 {
     return _dfm_or;
@@ -45,45 +180,76 @@ bool OperatorRevocation::fmEvent(const QSharedPointer<DFMEvent> &event, QVariant
         if (e->iniaiator() && e->iniaiator()->property("_dfm_is_revocaion_event").toBool())
             return true;
 
-        operatorStack.push(*event.data());
+        QByteArray entry;
+
+        if (e->split()) {
+            entry = SPLIT_ENTRY;
+        } else {
+            const QJsonObject &json = eventToJson(e->event());
+
+            if (json.isEmpty()) {
+                qWarning() << "Can not save the operator to the undo journal:" << *e->event();
+
+                return true;
+            }
+
+            entry = QJsonDocument(QJsonObject {{"event", json}, {"async", e->async()}}).toJson(QJsonDocument::Compact);
+        }
+
+        QMutexLocker locker(&mutex);
+
+        loadJournal();
+
+        if (batchRunning)
+            pendingEntries << entry;
+        else
+            pushEntry(entry);
+
         return true;
     }
     case DFMEvent::Revocation: {
-        bool batch_mode = false;
+        QMutexLocker locker(&mutex);
 
-        batch_revocation:
+        loadJournal();
 
-        if (operatorStack.isEmpty())
+        if (batchRunning || journal.isEmpty())
             return true;
 
-        DFMSaveOperatorEvent e = dfmevent_cast<DFMSaveOperatorEvent>(operatorStack.pop());
+        // continue the undo of a batch interrupted by quitting the application
+        bool batch_mode = splitCount % 2 != 0;
 
-        if (e.split()) {
-            if (batch_mode) {
-                return true;
-            } else {
-                batch_mode = true;
-                goto batch_revocation;
-            }
+        if (journal.last() == SPLIT_ENTRY) {
+            popEntry();
+            batch_mode = true;
         }
 
-        const QSharedPointer<DFMEvent> new_event = e.event();
+        if (!batch_mode) {
+            locker.unlock();
+            revokeNext(false);
+
+            return true;
+        }
 
-        new_event->setProperty("_dfm_is_revocaion_event", true);
+        batchRunning = true;
+        batchRevokedCount = 0;
+        batchEntryCount = 0;
 
-        if (e.async())
-            DFMEventDispatcher::instance()->processEventAsync(new_event);
-        else
-            DFMEventDispatcher::instance()->processEvent(new_event);
+        for (int i = journal.count() - 1; i >= 0 && journal.at(i) != SPLIT_ENTRY; --i)
+            ++batchEntryCount;
 
-        if (batch_mode)
-            goto batch_revocation;
+        locker.unlock();
+        revokeBatch();
 
         return true;
     }
-    case DFMEvent::CleanSaveOperator:
-        operatorStack.clear();
+    case DFMEvent::CleanSaveOperator: {
+        QMutexLocker locker(&mutex);
+
+        loadJournal();
+        clearJournal();
+        pendingEntries.clear();
         break;
+    }
     default:
         break;
     }
@@ -96,4 +262,220 @@ OperatorRevocation::OperatorRevocation()
 
 }
 
+void OperatorRevocation::loadJournal()
+{
+    if (journalLoaded)
+        return;
+
+    journalLoaded = true;
+    journalFile = DFMStandardPaths::location(DFMStandardPaths::CachePath) + "/undo.journal";
+
+    QFile file(journalFile);
+
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    const QByteArray &data = file.readAll();
+    QByteArrayList lines = data.split('\n');
+
+    // the last line was not written completely
+    if (!data.endsWith('\n'))
+        lines.removeLast();
+
+    for (const QByteArray &line : lines) {
+        if (line.isEmpty())
+            continue;
+
+        journal << line;
+        journalSize += line.size() + 1;
+
+        if (line == SPLIT_ENTRY)
+            ++splitCount;
+    }
+
+    if (journalSize != data.size()) {
+        trimJournal();
+    }
+}
+
+void OperatorRevocation::pushEntry(const QByteArray &entry)
+{
+    QFile file(journalFile);
+
+    if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        file.write(entry + '\n');
+    } else {
+        qWarning() << "Failed to write the undo journal:" << file.errorString();
+    }
+
+    journal << entry;
+    journalSize += entry.size() + 1;
+
+    if (entry == SPLIT_ENTRY)
+        ++splitCount;
+
+    if (journal.size() > MAX_JOURNAL_ENTRIES || journalSize > MAX_JOURNAL_SIZE)
+        trimJournal();
+}
+
+QByteArray OperatorRevocation::popEntry()
+{
+    const QByteArray entry = journal.takeLast();
+
+    journalSize -= entry.size() + 1;
+
+    if (entry == SPLIT_ENTRY)
+        --splitCount;
+
+    // the entries before it stay valid if the application quits now
+    QFile::resize(journalFile, journalSize);
+
+    return entry;
+}
+
+void OperatorRevocation::clearJournal()
+{
+    journal.clear();
+    journalSize = 0;
+    splitCount = 0;
+
+    QFile::remove(journalFile);
+}
+
+void OperatorRevocation::trimJournal()
+{
+    int first = 0;
+    qint64 size = journalSize;
+    int split_count = 0;
+
+    // drop whole operations from the front, that is a single entry or a closed
+    // batch from its opening to its closing split. The open batch and the latest
+    // operation are always kept, even if the journal stays above the limits.
+    while (journal.size() - first > MAX_JOURNAL_ENTRIES * 3 / 4 || size > MAX_JOURNAL_SIZE * 3 / 4) {
+        int last = first;
+
+        if (journal.at(first) == SPLIT_ENTRY) {
+            do {
+                ++last;
+            } while (last < journal.size() && journal.at(last) != SPLIT_ENTRY);
+        }
+
+        if (last >= journal.size() - 1)
+            break;
+
+        for (int i = first; i <= last; ++i) {
+            size -= journal.at(i).size() + 1;
+
+            if (journal.at(i) == SPLIT_ENTRY)
+                ++split_count;
+        }
+
+        first = last + 1;
+    }
+
+    journal.erase(journal.begin(), journal.begin() + first);
+    journalSize = size;
+    splitCount -= split_count;
+
+    QSaveFile file(journalFile);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write the undo journal:" << file.errorString();
+
+        return;
+    }
+
+    for (const QByteArray &entry : journal) {
+        file.write(entry + '\n');
+    }
+
+    file.commit();
+}
+
+// returns false if there is nothing more to undo in the batch
+bool OperatorRevocation::revokeNext(bool batchMode)
+{
+    QMutexLocker locker(&mutex);
+
+    if (journal.isEmpty())
+        return false;
+
+    const QByteArray entry = popEntry();
+
+    // the begin of the batch
+    if (entry == SPLIT_ENTRY)
+        return false;
+
+    locker.unlock();
+
+    const QJsonObject &object = QJsonDocument::fromJson(entry).object();
+    QJsonObject json = object.value("event").toObject();
+
+    if (!verifyEvent(json)) {
+        qDebug() << "skip the stale undo entry:" << entry;
+
+        return batchMode;
+    }
+
+    const QSharedPointer<DFMEvent> new_event = DFMEvent::fromJson(json);
+
+    if (!new_event)
+        return batchMode;
+
+    new_event->setProperty("_dfm_is_revocaion_event", true);
+
+    if (object.value("async").toBool())
+        DFMEventDispatcher::instance()->processEventAsync(new_event);
+    else
+        DFMEventDispatcher::instance()->processEvent(new_event);
+
+    return batchMode;
+}
+
+void OperatorRevocation::revokeBatch()
+{
+    // do not block the window while undoing a large batch, the rest of
+    // the batch is undone by the next undo if the application quits now
+    for (int i = 0; i < BATCH_STEP_COUNT; ++i) {
+        if (!revokeNext(true)) {
+            QMutexLocker locker(&mutex);
+
+            batchRunning = false;
+
+            for (const QByteArray &entry : pendingEntries)
+                pushEntry(entry);
+
+            pendingEntries.clear();
+            locker.unlock();
+
+            if (!batchJobDetail.isEmpty()) {
+                dialogManager->taskDialog()->removeTaskImmediately(batchJobDetail);
+                batchJobDetail.clear();
+            }
+
+            return;
+        }
+
+        ++batchRevokedCount;
+    }
+
+    // the batch is shown in the task dialog once it takes more than one step
+    if (batchJobDetail.isEmpty()) {
+        batchJobDetail.insert("jobId", QString::number(quintptr(this), 16));
+        batchJobDetail.insert("type", "undo");
+        dialogManager->taskDialog()->addTask(batchJobDetail);
+    }
+
+    const int progress = batchEntryCount > 0 ? qMin(100, batchRevokedCount * 100 / batchEntryCount) : 0;
+
+    dialogManager->taskDialog()->handleUpdateTaskWidget(batchJobDetail, {
+        {"file", QString("%1/%2").arg(batchRevokedCount).arg(batchEntryCount)},
+        {"progress", QString::number(progress)}
+    });
+
+    QTimer::singleShot(0, qApp, [] {
+        OperatorRevocation::instance()->revokeBatch();
+    });
+}
+
 DFM_END_NAMESPACE
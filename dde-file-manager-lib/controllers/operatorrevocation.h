@@ -24,10 +24,15 @@
 #include "dfmabstracteventhandler.h"
 #include "dfmevent.h"
 
-#include <QStack>
+#include <QByteArrayList>
+#include <QMap>
+#include <QMutex>
 
 DFM_BEGIN_NAMESPACE
 
+// The undo history is kept in a journal file (one json object per line, the
+// latest operation at the end), so it survives a restart. The journal is
+// limited in size, the oldest operations are dropped first.
 class OperatorRevocation : public DFMAbstractEventHandler
 {
 public:
@@ -39,7 +44,31 @@ protected:
     OperatorRevocation();
 
 private:
-    QStack<DFMEvent> operatorStack;
+    void loadJournal();
+    void pushEntry(const QByteArray &entry);
+    QByteArray popEntry();
+    void clearJournal();
+    void trimJournal();
+
+    bool revokeNext(bool batchMode);
+    void revokeBatch();
+
+    QMutex mutex;
+    QString journalFile;
+    QByteArrayList journal;
+    qint64 journalSize = 0;
+    // the count of the split entries, is odd if the undo of a batch was interrupted
+    int splitCount = 0;
+    int batchRevokedCount = 0;
+    // the count of the entries of the batch when its undo started
+    int batchEntryCount = 0;
+    // the entry of the batch in the task dialog, empty until it is shown
+    QMap<QString, QString> batchJobDetail;
+    bool batchRunning = false;
+    // the operations done while a batch is undone, they are pushed after the
+    // batch, so they are not taken as part of it
+    QByteArrayList pendingEntries;
+    bool journalLoaded = false;
 };
 
 DFM_END_NAMESPACE
@@ -106,14 +106,12 @@ QString PathManager::getSystemPathDisplayNameByPath(QString path)
 {
     cleanPath(path);
 
-    if (isSystemPath(path)){
-        foreach (QString key, systemPathsMap().keys()) {
-            if (systemPathsMap().value(key) == path){
-                 return getSystemPathDisplayName(key);
-            }
-        }
-    }
-    return QString();
+    const QString &key = m_systemPathKeys.value(path);
+
+    if (key.isEmpty())
+        return QString();
+
+    return getSystemPathDisplayName(key);
 }
 
 
@@ -128,14 +126,12 @@ QString PathManager::getSystemPathIconNameByPath(QString path)
 {
     cleanPath(path);
 
-    if (isSystemPath(path)){
-        foreach (QString key, systemPathsMap().keys()) {
-            if (systemPathsMap().value(key) == path){
-                 return getSystemPathIconName(key);
-            }
-        }
-    }
-    return QString();
+    const QString &key = m_systemPathKeys.value(path);
+
+    if (key.isEmpty())
+        return QString();
+
+    return getSystemPathIconName(key);
 }
 
 void PathManager::loadSystemPaths()
@@ -153,13 +149,15 @@ void PathManager::loadSystemPaths()
     m_systemPathsMap["UserShare"] = DFMStandardPaths::location(DFMStandardPaths::UserShareRootPath);
     m_systemPathsMap["Computer"] = DFMStandardPaths::location(DFMStandardPaths::ComputerRootPath);
 
-    m_systemPathsSet.reserve(m_systemPathsMap.size());
+    m_systemPathKeys.clear();
+    m_systemPathKeys.reserve(m_systemPathsMap.size());
 
     foreach (const QString &key, m_systemPathsMap.keys()) {
         const QString &path = m_systemPathsMap.value(key);
 
-        if (key != "Trash")
-            m_systemPathsSet << path;
+        // the first key in order wins if some paths are the same
+        if (key != "Trash" && !m_systemPathKeys.contains(path))
+            m_systemPathKeys[path] = key;
 
         if(key == "Desktop" || key == "Videos" || key == "Music" ||
            key == "Pictures" || key == "Documents" || key == "Downloads" ||
@@ -186,7 +184,7 @@ bool PathManager::isSystemPath(QString path) const
 {
     cleanPath(path);
 
-    return m_systemPathsSet.contains(path);
+    return m_systemPathKeys.contains(path);
 }
 
 QMap<QString, QString> PathManager::systemPathsMap() const
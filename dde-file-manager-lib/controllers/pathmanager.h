@@ -27,7 +27,7 @@
 
 #include <QObject>
 #include <QMap>
-#include <QSet>
+#include <QHash>
 
 #include "durl.h"
 
@@ -60,7 +60,8 @@ private:
     QMap<QString, QString> m_systemPathsMap;
     QMap<QString, QString> m_systemPathDisplayNamesMap;
     QMap<QString, QString> m_systemPathIconNamesMap;
-    QSet<QString> m_systemPathsSet;
+    // path -> key, the trash path is not a system path
+    QHash<QString, QString> m_systemPathKeys;
 };
 
 #endif // PATHMANAGER_H
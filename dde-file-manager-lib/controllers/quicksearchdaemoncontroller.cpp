@@ -24,6 +24,7 @@
 #include "quicksearchdaemoncontroller.h"
 
 #include <QDBusMetaType>
+#include <QCoreApplication>
 
 
 static constexpr const  char *const service{ "com.deepin.filemanager.daemon" };
@@ -42,6 +43,15 @@ QuickSearchDaemonController::QuickSearchDaemonController(QObject *const parent)
     interface_ptr = std::unique_ptr<QuickSearchDaemonInterface> { new QuickSearchDaemonInterface{ service, path,
                 QDBusConnection::systemBus(), nullptr }
     };
+
+    ///###: instance() may be called first in a thread without event loop, receive the signals in the main thread.
+    if (qApp) {
+        interface_ptr->moveToThread(qApp->thread());
+    }
+
+    connect(interface_ptr.get(), &QuickSearchDaemonInterface::searchResultsReady, this, [this](const QDBusVariant &session) {
+        emit searchResultsReady(session.variant().toULongLong());
+    }, Qt::DirectConnection);
 }
 
 bool QuickSearchDaemonController::whetherCacheCompletely() const noexcept
@@ -52,6 +62,15 @@ bool QuickSearchDaemonController::whetherCacheCompletely() const noexcept
     return result_var.toBool();
 }
 
+bool QuickSearchDaemonController::whetherPathCached(const QString &path_for_searching) const noexcept
+{
+    QDBusVariant var_local_file{ QVariant{ path_for_searching } };
+    QDBusVariant dbus_var{ interface_ptr->whetherPathCached(var_local_file) };
+    QVariant result_var{ dbus_var.variant() };
+
+    return result_var.toBool();
+}
+
 bool QuickSearchDaemonController::createCache() const noexcept
 {
     QDBusVariant dbus_var{ interface_ptr->createCache() };
@@ -76,6 +95,50 @@ QList<QString> QuickSearchDaemonController::search(const QString &path_for_searc
     return result_list;
 }
 
+quint64 QuickSearchDaemonController::startSearch(const QString &path_for_searching, const QString &key)
+{
+    QFileInfo file_info{ path_for_searching };
+
+    if (!QFileInfo::exists(path_for_searching) || !file_info.isDir()) {
+        return 0;
+    }
+
+    QDBusVariant var_local_file{ QVariant{path_for_searching} };
+    QDBusVariant var_key{QVariant{ key }};
+    QDBusVariant result{interface_ptr->startSearch(var_local_file, var_key)};
+
+    return result.variant().toULongLong();
+}
+
+QList<QString> QuickSearchDaemonController::fetchSearchResults(quint64 session, int max_count, bool *finished)
+{
+    QDBusVariant var_session{ QVariant{ session } };
+    QDBusVariant var_count{ QVariant{ max_count } };
+    QDBusPendingReply<QDBusVariant> reply{ interface_ptr->fetchSearchResults(var_session, var_count) };
+    QVariantMap result_map{};
+
+    reply.waitForFinished();
+
+    if (!reply.isError()) {
+        result_map = qdbus_cast<QVariantMap>(reply.value().variant());
+    }
+
+    ///###: the session is gone if the daemon failed.
+    if (finished) {
+        *finished = reply.isError() || result_map.value(QStringLiteral("finished"), true).toBool();
+    }
+
+    return result_map.value(QStringLiteral("files")).toStringList();
+}
+
+void QuickSearchDaemonController::cancelSearch(quint64 session)
+{
+    if (session > 0) {
+        QDBusVariant var_session{ QVariant{ session } };
+        interface_ptr->cancelSearch(var_session);
+    }
+}
+
 void QuickSearchDaemonController::fileWereDeleted(const QList<QByteArray> &file_list)
 {
     if (!file_list.isEmpty()) {
@@ -48,11 +48,22 @@ public:
 
     bool createCache()const noexcept;
     bool whetherCacheCompletely()const noexcept;
+    bool whetherPathCached(const QString &path_for_searching)const noexcept;
     QList<QString> search(const QString &path_for_searching, const QString &key);
 
+    ///###: returns 0 if the search can not be started.
+    quint64 startSearch(const QString &path_for_searching, const QString &key);
+    QList<QString> fetchSearchResults(quint64 session, int max_count, bool *finished);
+    void cancelSearch(quint64 session);
+
     void fileWereRenamed(const QList<QPair<QByteArray, QByteArray> > &file_list);
     void fileWereCreated(const QList<QByteArray> &file_list);
     void fileWereDeleted(const QList<QByteArray> &file_list);
+
+signals:
+    ///###: emitted in the main thread, the daemon has new results of session or it finished.
+    void searchResultsReady(quint64 session);
+
 private:
     std::unique_ptr<QuickSearchDaemonInterface> interface_ptr{ nullptr };
 };
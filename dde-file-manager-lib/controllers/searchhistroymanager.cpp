@@ -26,8 +26,22 @@
 #include "dfmapplication.h"
 #include "dfmsettings.h"
 
+#include <QDateTime>
+#include <QtMath>
+#include <QTimer>
+#include <QCoreApplication>
+
+#include <algorithm>
+
 DFM_USE_NAMESPACE
 
+#define MAX_HISTORY_COUNT 100
+#define MAX_FRECENCY_COUNT 500
+// the score of a visit is halved every week
+#define FRECENCY_HALF_LIFE (7 * 24 * 3600)
+// the whole map is written, so the visits are saved together
+#define FRECENCY_SAVE_DELAY 5000
+
 SearchHistroyManager::SearchHistroyManager()
 {
 
@@ -35,12 +49,28 @@ SearchHistroyManager::SearchHistroyManager()
 
 SearchHistroyManager::~SearchHistroyManager()
 {
-
+    delete m_saveTimer;
 }
 
 QStringList SearchHistroyManager::toStringList()
 {
-    return DFMApplication::appObtuselySetting()->value("Cache", "SearchHistroy").toStringList();
+    QStringList list = DFMApplication::appObtuselySetting()->value("Cache", "SearchHistroy").toStringList();
+
+    loadFrecency();
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch() / 1000;
+    QHash<QString, qreal> scores;
+
+    for (const QString &keyword : list)
+        scores[keyword] = frecency(m_frecency.value(keyword, Record{0, 0}), now);
+
+    // the list is from the oldest to the latest, the latest wins if the scores are equal
+    std::reverse(list.begin(), list.end());
+    std::stable_sort(list.begin(), list.end(), [&scores] (const QString &a, const QString &b) {
+        return scores.value(a) > scores.value(b);
+    });
+
+    return list;
 }
 
 void SearchHistroyManager::writeIntoSearchHistory(QString keyword)
@@ -48,10 +78,130 @@ void SearchHistroyManager::writeIntoSearchHistory(QString keyword)
     if (keyword.isEmpty())
         return;
 
-    QStringList list = toStringList();
+    QStringList list = DFMApplication::appObtuselySetting()->value("Cache", "SearchHistroy").toStringList();
 
+    list.removeAll(keyword);
     list << keyword;
 
+    while (list.count() > MAX_HISTORY_COUNT)
+        list.removeFirst();
+
     DFMApplication::appObtuselySetting()->setValue("Cache", "SearchHistroy", list);
+
+    bumpFrecency(keyword);
+    // the keywords are rare, save them with the history
+    saveFrecency();
+}
+
+void SearchHistroyManager::recordVisit(const QString &path)
+{
+    if (path.isEmpty())
+        return;
+
+    bumpFrecency(path);
+}
+
+QHash<QString, qreal> SearchHistroyManager::childrenFrecency(const QString &dirPath)
+{
+    loadFrecency();
+
+    QHash<QString, qreal> children;
+    const QString &prefix = dirPath.endsWith('/') ? dirPath : dirPath + '/';
+    const qint64 now = QDateTime::currentMSecsSinceEpoch() / 1000;
+
+    for (auto it = m_frecency.constBegin(); it != m_frecency.constEnd(); ++it) {
+        if (it.key().length() <= prefix.length() || !it.key().startsWith(prefix)
+                || it.key().indexOf('/', prefix.length()) >= 0) {
+            continue;
+        }
+
+        children[it.key().mid(prefix.length())] = frecency(it.value(), now);
+    }
+
+    return children;
+}
+
+void SearchHistroyManager::loadFrecency()
+{
+    if (m_frecencyLoaded)
+        return;
+
+    m_frecencyLoaded = true;
+
+    const QVariantMap &map = DFMApplication::appObtuselySetting()->value("Cache", "Frecency").toMap();
+
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+        const QVariantList &values = it.value().toList();
+
+        if (values.count() == 2)
+            m_frecency[it.key()] = Record{values.first().toReal(), values.last().toLongLong()};
+    }
+}
+
+void SearchHistroyManager::bumpFrecency(const QString &key)
+{
+    loadFrecency();
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch() / 1000;
+
+    m_frecency[key] = Record{frecency(m_frecency.value(key, Record{0, now}), now) + 1, now};
+
+    // forget the least used ones
+    if (m_frecency.count() > MAX_FRECENCY_COUNT) {
+        QList<QPair<qreal, QString>> scores;
+
+        for (auto it = m_frecency.constBegin(); it != m_frecency.constEnd(); ++it)
+            scores << qMakePair(frecency(it.value(), now), it.key());
+
+        std::sort(scores.begin(), scores.end());
+
+        for (int i = 0; i < scores.count() - MAX_FRECENCY_COUNT; ++i)
+            m_frecency.remove(scores.at(i).second);
+    }
+
+    m_frecencyChanged = true;
+
+    if (!m_saveTimer) {
+        m_saveTimer = new QTimer();
+        m_saveTimer->setSingleShot(true);
+        m_saveTimer->setInterval(FRECENCY_SAVE_DELAY);
+
+        QObject::connect(m_saveTimer, &QTimer::timeout, [this] {
+            saveFrecency();
+        });
+
+        if (qApp) {
+            QObject::connect(qApp, &QCoreApplication::aboutToQuit, m_saveTimer, [this] {
+                saveFrecency();
+            });
+        }
+    }
+
+    // not restarted by the next visits, so a visit is saved after the delay at the latest
+    if (!m_saveTimer->isActive())
+        m_saveTimer->start();
+}
+
+void SearchHistroyManager::saveFrecency()
+{
+    if (m_saveTimer)
+        m_saveTimer->stop();
+
+    if (!m_frecencyChanged)
+        return;
+
+    m_frecencyChanged = false;
+
+    QVariantMap map;
+
+    for (auto it = m_frecency.constBegin(); it != m_frecency.constEnd(); ++it)
+        map[it.key()] = QVariantList {it.value().score, it.value().time};
+
+    DFMApplication::appObtuselySetting()->setValue("Cache", "Frecency", map);
+}
+
+qreal SearchHistroyManager::frecency(const Record &record, qint64 now) const
+{
+    return record.score * qPow(0.5, qreal(now - record.time) / FRECENCY_HALF_LIFE);
 }
 
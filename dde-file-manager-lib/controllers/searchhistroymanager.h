@@ -26,6 +26,11 @@
 #define SEARCHHISTROYMANAGER_H
 
 #include <QStringList>
+#include <QHash>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
 
 class SearchHistroyManager
 {
@@ -33,9 +38,32 @@ public:
     explicit SearchHistroyManager();
     ~SearchHistroyManager();
 
+    // ordered by the frecency, the most used one first
     QStringList toStringList();
 
     void writeIntoSearchHistory(QString keyword);
+
+    // the visited directories share the frecency model with the search keywords,
+    // the visits are saved at most every few seconds and when the application quits
+    void recordVisit(const QString &path);
+    // the frecency of the visited sub directories of dirPath, by their names
+    QHash<QString, qreal> childrenFrecency(const QString &dirPath);
+
+private:
+    struct Record {
+        qreal score;
+        qint64 time;
+    };
+
+    void loadFrecency();
+    void bumpFrecency(const QString &key);
+    void saveFrecency();
+    qreal frecency(const Record &record, qint64 now) const;
+
+    bool m_frecencyLoaded = false;
+    bool m_frecencyChanged = false;
+    QHash<QString, Record> m_frecency;
+    QTimer *m_saveTimer = nullptr;
 };
 
 #endif // SEARCHHISTROYMANAGER_H
@@ -28,6 +28,7 @@
 #include "dfileproxywatcher.h"
 #include "dfileinfo.h"
 #include "models/trashfileinfo.h"
+#include "dtrashcatalog.h"
 
 #include "app/define.h"
 #include "app/filesignalmanager.h"
@@ -44,6 +45,8 @@
 #include <QCoreApplication>
 #include <QThread>
 
+DFM_USE_NAMESPACE
+
 class TrashDirIterator : public DDirIterator
 {
 public:
@@ -51,6 +54,7 @@ public:
                      const QStringList &nameFilters,
                      QDir::Filters filter,
                      QDirIterator::IteratorFlags flags = QDirIterator::NoIteratorFlags);
+    ~TrashDirIterator();
 
     DUrl next() Q_DECL_OVERRIDE;
     bool hasNext() const Q_DECL_OVERRIDE;
@@ -61,24 +65,54 @@ public:
     DUrl url() const Q_DECL_OVERRIDE;
 
 private:
-    QDirIterator *iterator;
+    DUrl m_url;
+    QStringList nameFilters;
+    QDir::Filters filters;
+    QDirIterator::IteratorFlags flags;
+    // the root lists the files of the home trash and of all the volume trashes
+    mutable QStringList pendingDirs;
+    mutable QDirIterator *iterator = nullptr;
 };
 
 TrashDirIterator::TrashDirIterator(const DUrl &url, const QStringList &nameFilters,
                                    QDir::Filters filter, QDirIterator::IteratorFlags flags)
     : DDirIterator()
+    , m_url(url)
+    , nameFilters(nameFilters)
+    , filters(filter)
+    , flags(flags)
+{
+    if (url.path().isEmpty() || url.path() == "/") {
+        for (const QString &path : DFMStandardPaths::trashPaths())
+            pendingDirs << path + "/files";
+    } else {
+        pendingDirs << DFMStandardPaths::trashUrlPathToLocal(url.path());
+    }
+
+    iterator = new QDirIterator(pendingDirs.takeFirst(), nameFilters, filter, flags);
+}
+
+TrashDirIterator::~TrashDirIterator()
 {
-    iterator = new QDirIterator(DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath) + url.path(), nameFilters, filter, flags);
+    delete iterator;
 }
 
 DUrl TrashDirIterator::next()
 {
-    return DUrl::fromTrashFile(DUrl::fromLocalFile(iterator->next()).path().remove(DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath)));
+    return DUrl::fromTrashFile(DFMStandardPaths::localToTrashUrlPath(iterator->next()));
 }
 
 bool TrashDirIterator::hasNext() const
 {
-    return iterator->hasNext();
+    while (!iterator->hasNext()) {
+        if (pendingDirs.isEmpty())
+            return false;
+
+        delete iterator;
+        iterator = new QDirIterator(pendingDirs.takeFirst(), nameFilters, filters, flags);
+    }
+
+    return true;
 }
 
 QString TrashDirIterator::fileName() const
@@ -88,7 +122,7 @@ QString TrashDirIterator::fileName() const
 
 DUrl TrashDirIterator::fileUrl() const
 {
-    return DUrl::fromTrashFile(iterator->filePath().remove(DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath)));
+    return DUrl::fromTrashFile(DFMStandardPaths::localToTrashUrlPath(iterator->filePath()));
 }
 
 const DAbstractFileInfoPointer TrashDirIterator::fileInfo() const
@@ -98,7 +132,7 @@ const DAbstractFileInfoPointer TrashDirIterator::fileInfo() const
 
 DUrl TrashDirIterator::url() const
 {
-    return DUrl::fromTrashFile(iterator->path().remove(DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath)));
+    return m_url;
 }
 
 TrashManager::TrashManager(QObject *parent)
@@ -114,6 +148,8 @@ TrashManager::TrashManager(QObject *parent)
     connect(m_trashFileWatcher, &DFileWatcher::fileDeleted, this, &TrashManager::trashFilesChanged);
     connect(m_trashFileWatcher, &DFileWatcher::subfileCreated, this, &TrashManager::trashFilesChanged);
     m_trashFileWatcher->startWatcher();
+
+    updateVolumeTrashWatchers();
 }
 
 const DAbstractFileInfoPointer TrashManager::createFileInfo(const QSharedPointer<DFMCreateFileInfoEvnet> &event) const
@@ -160,12 +196,14 @@ bool TrashManager::writeFilesToClipboard(const QSharedPointer<DFMWriteUrlsToClip
     DUrlList localList;
 
     for(const DUrl &url : event->urlList()) {
-        const QString &path = url.path();
+        QString trash_path;
+        const QString &local_path = DFMStandardPaths::trashUrlPathToLocal(url.path(), &trash_path);
+        const QString &path = local_path.mid(trash_path.size() + 6);
 
-        localList << DUrl::fromLocalFile(DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath) + path);
+        localList << DUrl::fromLocalFile(local_path);
 
         if(path.lastIndexOf('/') > 0) {
-            localList << DUrl::fromLocalFile(DFMStandardPaths::location(DFMStandardPaths::TrashInfosPath) + path);
+            localList << DUrl::fromLocalFile(trash_path + "/info" + path);
         }
     }
 
@@ -197,12 +235,15 @@ bool TrashManager::deleteFiles(const QSharedPointer<DFMDeleteEvent> &event) cons
             return true;
         }
 
-        const QString &path = url.path();
+        QString trash_path;
+        const QString &local_path = DFMStandardPaths::trashUrlPathToLocal(url.path(), &trash_path);
+        // the path relative to the files directory of the trash
+        const QString &path = local_path.mid(trash_path.size() + 6);
 
-        localList << DUrl::fromLocalFile(DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath) + path);
+        localList << DUrl::fromLocalFile(local_path);
 
         if (path.lastIndexOf('/') == 0) {
-            localList << DUrl::fromLocalFile(DFMStandardPaths::location(DFMStandardPaths::TrashInfosPath) + path + ".trashinfo");
+            localList << DUrl::fromLocalFile(trash_path + "/info" + path + ".trashinfo");
         }
     }
 
@@ -213,33 +254,35 @@ bool TrashManager::deleteFiles(const QSharedPointer<DFMDeleteEvent> &event) cons
 
 const DDirIteratorPointer TrashManager::createDirIterator(const QSharedPointer<DFMCreateDiriterator> &event) const
 {
+    if (event->url() == DUrl::fromTrashFile("/")) {
+        // may be called in the thread of a job
+        QMetaObject::invokeMethod(const_cast<TrashManager*>(this), "updateVolumeTrashWatchers");
+    }
+
     return DDirIteratorPointer(new TrashDirIterator(event->url(), event->nameFilters(), event->filters(), event->flags()));
 }
 
 namespace TrashManagerPrivate {
 DUrl localToTrash(const DUrl &url)
 {
-    const QString &localPath = url.toLocalFile();
-    const QString &trashPath = DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath);
+    const QString &path = DFMStandardPaths::localToTrashUrlPath(url.toLocalFile());
 
-    if (!localPath.startsWith(trashPath))
+    if (path.isEmpty())
         return DUrl();
 
-    DUrl u = DUrl::fromTrashFile(localPath.mid(trashPath.length()));
-
-    if (u.path().isEmpty())
-        u.setPath("/");
-
-    return u;
+    return DUrl::fromTrashFile(path);
 }
 QString trashToLocal(const DUrl &url)
 {
-    return DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath) + url.path();
+    return DFMStandardPaths::trashUrlPathToLocal(url.path());
 }
 }
 
 DAbstractFileWatcher *TrashManager::createFileWatcher(const QSharedPointer<DFMCreateFileWatcherEvent> &event) const
 {
+    if (event->url() == DUrl::fromTrashFile("/"))
+        QMetaObject::invokeMethod(const_cast<TrashManager*>(this), "updateVolumeTrashWatchers");
+
     return new DFileProxyWatcher(event->url(),
                                  new DFileWatcher(TrashManagerPrivate::trashToLocal(event->url())),
                                  TrashManagerPrivate::localToTrash);
@@ -247,8 +290,7 @@ DAbstractFileWatcher *TrashManager::createFileWatcher(const QSharedPointer<DFMCr
 
 bool TrashManager::restoreTrashFile(const DUrlList &list, DUrlList *restoreOriginUrls)
 {
-    bool ok = true;
-
+    QList<QExplicitlySharedDataPointer<TrashFileInfo>> infoList;
     DUrlList restoreFailedList;
     DUrlList restoreFileOriginUrlList;
 
@@ -269,17 +311,25 @@ bool TrashManager::restoreTrashFile(const DUrlList &list, DUrlList *restoreOrigi
         //###(zccrs): 必须通过 DAbstractFileInfoPointer 使用
         //            因为对象会被缓存，所以有可能在其它线程中被使用
         //            如果直接定义一个TrashFileInfo对象，就可能存在对象被重复释放
-        QExplicitlySharedDataPointer<TrashFileInfo> info(new TrashFileInfo(url));
+        infoList << QExplicitlySharedDataPointer<TrashFileInfo>(new TrashFileInfo(url));
+    }
+
+    QList<const TrashFileInfo*> restoreList;
 
-        bool ret = info->restore();
+    for (const QExplicitlySharedDataPointer<TrashFileInfo> &info : infoList)
+        restoreList << info.constData();
 
-        if (!ret && info->exists()) {
+    // all the files are restored in one job
+    DUrlList failedList;
+    bool ok = TrashFileInfo::restore(restoreList, &failedList);
+    const QSet<DUrl> &failedUrls = failedList.toSet();
+
+    for (const QExplicitlySharedDataPointer<TrashFileInfo> &info : infoList) {
+        if (failedUrls.contains(info->fileUrl()) && info->exists()) {
             restoreFailedList << info->fileUrl();
         } else {
             restoreFileOriginUrlList << info->originUrl();
         }
-
-        ok = ok && ret;
     }
 
     if (!ok && restoreFailedList.count() > 0){
@@ -295,15 +345,18 @@ bool TrashManager::restoreTrashFile(const DUrlList &list, DUrlList *restoreOrigi
 void TrashManager::cleanTrash(const QObject *sender) const
 {
     DUrlList list;
-    const DUrl &file_url = DUrl::fromLocalFile(DFMStandardPaths::location(DFMStandardPaths::TrashInfosPath));
-    const DUrl &info_url = DUrl::fromLocalFile(DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath));
 
-    if (QFile::exists(file_url.toLocalFile())) {
-        list << file_url;
-    }
+    for (const QString &trash_path : DFMStandardPaths::trashPaths()) {
+        const DUrl &file_url = DUrl::fromLocalFile(trash_path + "/info");
+        const DUrl &info_url = DUrl::fromLocalFile(trash_path + "/files");
+
+        if (QFile::exists(file_url.toLocalFile())) {
+            list << file_url;
+        }
 
-    if (QFile::exists(info_url.toLocalFile())) {
-        list << info_url;
+        if (QFile::exists(info_url.toLocalFile())) {
+            list << info_url;
+        }
     }
 
     fileService->deleteFiles(sender, list, false, false, true);
@@ -311,24 +364,60 @@ void TrashManager::cleanTrash(const QObject *sender) const
 
 bool TrashManager::isEmpty()
 {
-    QDir dir(DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath));
-
-    if (!dir.exists())
-        return true;
-
-    dir.setFilter(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
-
-    QDirIterator iterator(dir);
-
-    return !iterator.hasNext();
+    return DTrashCatalog::instance()->isEmpty();
 }
 
 void TrashManager::trashFilesChanged(const DUrl& url)
 {
     Q_UNUSED(url);
-    if(m_isTrashEmpty == isEmpty())
+
+    DTrashCatalog::instance()->invalidate();
+
+    const bool empty = isEmpty();
+
+    if(m_isTrashEmpty == empty)
         return;
 
-    m_isTrashEmpty = isEmpty();
+    m_isTrashEmpty = empty;
     emit fileSignalManager->trashStateChanged();
 }
+
+void TrashManager::updateVolumeTrashWatchers()
+{
+    const QString &home_trash = DFMStandardPaths::location(DFMStandardPaths::TrashPath);
+    QStringList trash_paths = DFMStandardPaths::trashPaths();
+
+    trash_paths.removeOne(home_trash);
+
+    // the volume was unmounted
+    for (const QString &path : m_volumeTrashWatchers.keys()) {
+        if (!trash_paths.contains(path))
+            m_volumeTrashWatchers.take(path)->deleteLater();
+    }
+
+    for (const QString &path : trash_paths) {
+        if (m_volumeTrashWatchers.contains(path))
+            continue;
+
+        DFileWatcher *watcher = new DFileWatcher(path + "/files", this);
+
+        // the files of a volume trash are shown in the root of trash:///
+        connect(watcher, &DFileWatcher::subfileCreated, this, [this] (const DUrl &url) {
+            trashFilesChanged(url);
+            DAbstractFileWatcher::ghostSignal(DUrl::fromTrashFile("/"), &DAbstractFileWatcher::subfileCreated,
+                                              TrashManagerPrivate::localToTrash(url));
+        });
+        connect(watcher, &DFileWatcher::fileDeleted, this, [this] (const DUrl &url) {
+            trashFilesChanged(url);
+            DAbstractFileWatcher::ghostSignal(DUrl::fromTrashFile("/"), &DAbstractFileWatcher::fileDeleted,
+                                              TrashManagerPrivate::localToTrash(url));
+        });
+        connect(watcher, &DFileWatcher::fileMoved, this, [] (const DUrl &from, const DUrl &to) {
+            DAbstractFileWatcher::ghostSignal(DUrl::fromTrashFile("/"), &DAbstractFileWatcher::fileMoved,
+                                              TrashManagerPrivate::localToTrash(from), TrashManagerPrivate::localToTrash(to));
+        });
+
+        watcher->startWatcher();
+        m_volumeTrashWatchers[path] = watcher;
+    }
+}
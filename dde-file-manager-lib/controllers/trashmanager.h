@@ -31,6 +31,7 @@
 #include <QFileInfoList>
 #include <QFile>
 #include <QFileInfo>
+#include <QMap>
 
 class DAbstractFileInfo;
 class FileMonitor;
@@ -61,9 +62,13 @@ public:
     static bool isEmpty();
 public slots:
     void trashFilesChanged(const DUrl &url);
+private slots:
+    void updateVolumeTrashWatchers();
 private:
     bool m_isTrashEmpty;
     DFileWatcher* m_trashFileWatcher;
+    // trash path of the volume -> watcher of its files directory
+    QMap<QString, DFileWatcher*> m_volumeTrashWatchers;
 };
 
 #endif // TRASHMANAGER_H
@@ -227,6 +227,8 @@ HEADERS += \
     controllers/tagmanagerdaemoncontroller.h \
     controllers/interface/tagmanagerdaemon_interface.h \
     interfaces/dfmsettings.h \
+    interfaces/dfmtextlayoutcache.h \
+    interfaces/dfmimagedecoder.h \
     interfaces/dfmsidebar.h \
     interfaces/dfmsidebaritem.h \
     views/dfmsidebaritemseparator.h \
@@ -397,6 +399,8 @@ SOURCES += \
     controllers/tagmanagerdaemoncontroller.cpp \
     controllers/interface/tagmanagerdaemon_interface.cpp \
     interfaces/dfmsettings.cpp \
+    interfaces/dfmtextlayoutcache.cpp \
+    interfaces/dfmimagedecoder.cpp \
     interfaces/dfmsidebar.cpp \
     interfaces/dfmsidebaritem.cpp \
     views/dfmsidebaritemseparator.cpp \
@@ -285,9 +285,10 @@ void OpenWithDialog::initData()
 
     const QString &default_app = mimeAppsManager->getDefaultAppByMimeType(m_mimeType);
     const QStringList &recommendApps = mimeAppsManager->getRecommendedAppsByQio(m_mimeType);
+    const QMap<QString, DesktopFile> &desktopObjs = mimeAppsManager->getDesktopObjsSnapshot();
 
     for (int i = 0; i < recommendApps.count(); ++i) {
-        const DesktopFile &desktop_info = mimeAppsManager->DesktopObjs.value(recommendApps.at(i));
+        const DesktopFile &desktop_info = desktopObjs.value(recommendApps.at(i));
 
         OpenWithDialogListItem *item = createItem(QIcon::fromTheme(desktop_info.getIcon()), desktop_info.getLocalName(), recommendApps.at(i));
         m_recommandLayout->addWidget(item);
@@ -298,16 +299,16 @@ void OpenWithDialog::initData()
 
     QList<DesktopFile> other_app_list;
 
-    foreach (const QString& f, mimeAppsManager->DesktopObjs.keys()) {
+    foreach (const QString& f, desktopObjs.keys()) {
         //filter recommend apps , no show apps and no mime support apps
-        const DesktopFile& app = mimeAppsManager->DesktopObjs.value(f);
+        const DesktopFile& app = desktopObjs.value(f);
         if(recommendApps.contains(f))
             continue;
 
-        if(mimeAppsManager->DesktopObjs.value(f).getNoShow())
+        if(desktopObjs.value(f).getNoShow())
             continue;
 
-        if(mimeAppsManager->DesktopObjs.value(f).getMimeType().isEmpty())
+        if(desktopObjs.value(f).getMimeType().isEmpty())
             continue;
 
         bool isSameDesktop = false;
@@ -327,7 +328,7 @@ void OpenWithDialog::initData()
         if (isSameDesktop)
             continue;
 
-        other_app_list << mimeAppsManager->DesktopObjs.value(f);
+        other_app_list << desktopObjs.value(f);
         QString iconName = other_app_list.last().getIcon();
         OpenWithDialogListItem *item = createItem(QIcon::fromTheme(iconName), other_app_list.last().getLocalName(), f);
         m_otherLayout->addWidget(item);
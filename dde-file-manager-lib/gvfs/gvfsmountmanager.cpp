@@ -40,6 +40,7 @@
 #include "networkmanager.h"
 #include "dfmapplication.h"
 #include "dabstractfilewatcher.h"
+#include "dmounttablecache.h"
 
 #include <QThread>
 #include <QApplication>
@@ -485,6 +486,7 @@ void GvfsMountManager::monitor_mount_removed_root(GVolumeMonitor *volume_monitor
 void GvfsMountManager::monitor_mount_added(GVolumeMonitor *volume_monitor, GMount *mount)
 {
     Q_UNUSED(volume_monitor)
+    DMountTableCache::instance()->invalidate();
     qCDebug(mountManager()) << "==============================monitor_mount_added==============================";
     QMount qMount = gMountToqMount(mount);
 
@@ -527,6 +529,7 @@ void GvfsMountManager::monitor_mount_added(GVolumeMonitor *volume_monitor, GMoun
 void GvfsMountManager::monitor_mount_removed(GVolumeMonitor *volume_monitor, GMount *mount)
 {
     Q_UNUSED(volume_monitor)
+    DMountTableCache::instance()->invalidate();
     qCDebug(mountManager()) << "==============================monitor_mount_removed==============================" ;
     QMount qMount = gMountToqMount(mount);
 
@@ -977,95 +980,31 @@ void GvfsMountManager::getMounts(GList *mounts)
 
 void GvfsMountManager::listMountsBylsblk()
 {
-    PartMan::Partition p;
-    QString output;
-    QString err;
-    bool status = PartMan::SpawnCmd("lsblk", {"-O", "-J", "-l"},
-                  output, err);
-    if(status){
-        QJsonParseError error;
-        QJsonDocument doc=QJsonDocument::fromJson(output.toLocal8Bit(),&error);
-        if (error.error == QJsonParseError::NoError){
-            QJsonObject devObj = doc.object();
-            foreach (QString key, devObj.keys()) {
-                if (key == "blockdevices"){
-                    QJsonArray objArray = devObj.value(key).toArray();
-                    for(int i=0; i< objArray.count(); i++){
-
-
-                        QJsonObject obj = objArray.at(i).toObject();
-
-                        if (obj.contains("mountpoint")){
-                            QString mountPoint = obj.value("mountpoint").toString();
-                            if (mountPoint.isEmpty() || mountPoint=="/"){
-                                continue;
-                            }else{
-                                p.setMountPoint(obj.value("mountpoint").toString());
-                            }
-                        }
-
-                        if (obj.contains("name")){
-                            p.setName(obj.value("name").toString());
-                        }
-                        if (obj.contains("fstype")){
-                            p.setFs(obj.value("fstype").toString());
-                        }
-                        if (obj.contains("label")){
-                            p.setLabel(obj.value("label").toString());
-                        }
-                        if (obj.contains("uuid")){
-                            p.setUuid(obj.value("uuid").toString());
-                        }
-                        if(obj.contains("rm")){
-                            QString data = obj.value("rm").toString();
-                            if(data == "1")
-                                p.setIsRemovable(true);
-                            else
-                                p.setIsRemovable(false);
-                        }
-
-                        p.setPath(QString("/dev/%1").arg(p.name()));
-
-                        if (!p.fs().isEmpty()){
-                            PartMan::ReadUsageManager readUsageManager;
-                            qlonglong freespace = 0;
-                            qlonglong total = 0;
-                            bool ret = readUsageManager.readUsage(p.path(), p.fs(), freespace, total);
-                            if (ret){
-                                p.setFreespace(freespace);
-                                p.setTotal(total);
-                            }
-                        }
-
-
-                        QDiskInfo diskInfo;
-
-                        diskInfo.setName(p.name());
-                        diskInfo.setUnix_device(p.path());
-                        diskInfo.setUuid(p.uuid());
-                        diskInfo.setId(p.path());
-                        diskInfo.setFree(p.freespace());
-                        diskInfo.setTotal(p.total());
-                        diskInfo.setIs_removable(p.getIsRemovable());
-                        diskInfo.setMounted_root_uri(QString("file://%1").arg(p.mountPoint()));
-                        diskInfo.setCan_unmount(true);
-                        diskInfo.setCan_mount(false);
-                        diskInfo.setCan_eject(false);
-                        if (diskInfo.is_removable()){
-                            diskInfo.setType("removable");
-                        }else{
-                            diskInfo.setType("native");
-                        }
-                        Lsblk_Keys.append(p.path());
-                        DiskInfos.insert(diskInfo.id(), diskInfo);
-                    }
-                }
-            }
+    for (const PartMan::Partition &p : PartMan::Partition::getPartitions()) {
+        if (p.mountPoint().isEmpty() || p.mountPoint() == "/") {
+            continue;
+        }
+
+        QDiskInfo diskInfo;
+
+        diskInfo.setName(p.name());
+        diskInfo.setUnix_device(p.path());
+        diskInfo.setUuid(p.uuid());
+        diskInfo.setId(p.path());
+        diskInfo.setFree(p.freespace());
+        diskInfo.setTotal(p.total());
+        diskInfo.setIs_removable(p.getIsRemovable());
+        diskInfo.setMounted_root_uri(QString("file://%1").arg(p.mountPoint()));
+        diskInfo.setCan_unmount(true);
+        diskInfo.setCan_mount(false);
+        diskInfo.setCan_eject(false);
+        if (diskInfo.is_removable()){
+            diskInfo.setType("removable");
         }else{
-            qCDebug(mountManager()) << error.errorString();
+            diskInfo.setType("native");
         }
-    }else{
-        qCDebug(mountManager()) << status << output << err;
+        Lsblk_Keys.append(p.path());
+        DiskInfos.insert(diskInfo.id(), diskInfo);
     }
 }
 
@@ -1364,6 +1364,24 @@ bool DAbstractFileInfo::isActive() const
     return d->active;
 }
 
+void DAbstractFileInfo::setViewItem(bool viewItem)
+{
+    Q_D(DAbstractFileInfo);
+
+    if (d->proxy) {
+        d->proxy->setViewItem(viewItem);
+    }
+
+    d->viewItem = viewItem;
+}
+
+bool DAbstractFileInfo::isViewItem() const
+{
+    CALL_PROXY(isViewItem());
+
+    return d->viewItem;
+}
+
 void DAbstractFileInfo::refresh()
 {
     CALL_PROXY(refresh());
@@ -290,6 +290,9 @@ public:
     virtual void makeToInactive();
     virtual void makeToActive();
     bool isActive() const;
+    /// The item of a view model. Until it becomes active, the properties that read the file may be guessed
+    void setViewItem(bool viewItem);
+    bool isViewItem() const;
     virtual void refresh();
 
     virtual DUrl goToUrlWhenDeleted() const;
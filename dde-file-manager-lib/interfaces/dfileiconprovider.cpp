@@ -28,6 +28,8 @@
 
 #include <QLibrary>
 #include <QDebug>
+#include <QHash>
+#include <QMutex>
 
 DFM_BEGIN_NAMESPACE
 
@@ -39,6 +41,24 @@ public:
     void init();
     QIcon getFilesystemIcon(const QFileInfo &info) const;
     QIcon fromTheme(QString iconName) const;
+
+    // same as fromTheme, but the icons are shared by all the files of the same type,
+    // so the pixmaps of every size and scale are only rendered once per theme
+    QIcon cachedThemeIcon(const QString &iconName) const;
+    // getFilesystemIcon of a regular file only depends on its mime type
+    QIcon cachedFilesystemIcon(const DFileInfo &info) const;
+    // drops the icons of the old theme, called with the mutex locked
+    void checkThemeChanged() const;
+
+    mutable QMutex mutex;
+    mutable QString themeName;
+    // the null icons are cached too
+    mutable QHash<QString, QIcon> themeIcons;
+    mutable QHash<QString, QIcon> mimeTypeIcons;
+
+    mutable QAtomicInt themeLookups;
+    mutable QAtomicInt gioLookups;
+    mutable QAtomicInt cacheHits;
 };
 
 DFileIconProviderPrivate::DFileIconProviderPrivate()
@@ -111,6 +131,79 @@ QIcon DFileIconProviderPrivate::fromTheme(QString iconName) const
     return icon;
 }
 
+void DFileIconProviderPrivate::checkThemeChanged() const
+{
+    const QString &theme_name = QIcon::themeName();
+
+    if (Q_LIKELY(theme_name == themeName))
+        return;
+
+    themeName = theme_name;
+    themeIcons.clear();
+    mimeTypeIcons.clear();
+}
+
+QIcon DFileIconProviderPrivate::cachedThemeIcon(const QString &iconName) const
+{
+    {
+        QMutexLocker locker(&mutex);
+
+        checkThemeChanged();
+
+        auto it = themeIcons.constFind(iconName);
+
+        if (it != themeIcons.constEnd()) {
+            cacheHits.ref();
+
+            return it.value();
+        }
+    }
+
+    themeLookups.ref();
+
+    const QIcon &icon = fromTheme(iconName);
+    QMutexLocker locker(&mutex);
+
+    themeIcons.insert(iconName, icon);
+
+    return icon;
+}
+
+QIcon DFileIconProviderPrivate::cachedFilesystemIcon(const DFileInfo &info) const
+{
+    // the icon of a directory may be customized
+    if (info.isDir()) {
+        gioLookups.ref();
+
+        return getFilesystemIcon(info.toQFileInfo());
+    }
+
+    const QString &mime_type = info.mimeTypeName();
+
+    {
+        QMutexLocker locker(&mutex);
+
+        checkThemeChanged();
+
+        auto it = mimeTypeIcons.constFind(mime_type);
+
+        if (it != mimeTypeIcons.constEnd()) {
+            cacheHits.ref();
+
+            return it.value();
+        }
+    }
+
+    gioLookups.ref();
+
+    const QIcon &icon = getFilesystemIcon(info.toQFileInfo());
+    QMutexLocker locker(&mutex);
+
+    mimeTypeIcons.insert(mime_type, icon);
+
+    return icon;
+}
+
 Q_GLOBAL_STATIC(DFileIconProvider, globalFIP)
 
 DFileIconProvider::DFileIconProvider()
@@ -150,20 +243,20 @@ QIcon DFileIconProvider::icon(const DFileInfo &info, const QIcon &feedback) cons
 {
     Q_D(const DFileIconProvider);
 
-    QIcon icon = d->fromTheme(info.iconName());
+    QIcon icon = d->cachedThemeIcon(info.iconName());
 
     if (Q_LIKELY(!icon.isNull()))
         return icon;
 
-    icon = this->icon(info.toQFileInfo());
+    icon = d->cachedFilesystemIcon(info);
 
     if (Q_LIKELY(!icon.isNull()))
         return icon;
 
-    icon = d->fromTheme(info.genericIconName());
+    icon = d->cachedThemeIcon(info.genericIconName());
 
     if (icon.isNull())
-        icon = d->fromTheme("unknown");
+        icon = d->cachedThemeIcon("unknown");
 
     if (icon.isNull())
         return feedback;
@@ -171,4 +264,11 @@ QIcon DFileIconProvider::icon(const DFileInfo &info, const QIcon &feedback) cons
     return icon;
 }
 
+DFileIconProvider::Statistics DFileIconProvider::statistics() const
+{
+    Q_D(const DFileIconProvider);
+
+    return Statistics{d->themeLookups.load(), d->gioLookups.load(), d->cacheHits.load()};
+}
+
 DFM_END_NAMESPACE
@@ -46,6 +46,15 @@ public:
     QIcon icon(const QFileInfo &info, const QIcon &feedback) const;
     QIcon icon(const DFileInfo &info, const QIcon &feedback = QIcon()) const;
 
+    // the lookups done by icon(const DFileInfo&) since the program started
+    struct Statistics {
+        int themeLookups;
+        int gioLookups;
+        int cacheHits;
+    };
+
+    Statistics statistics() const;
+
 private:
     QScopedPointer<DFileIconProviderPrivate> d_ptr;
 
@@ -664,7 +664,19 @@ QMimeType DFileInfo::mimeType(QMimeDatabase::MatchMode mode) const
     Q_D(const DFileInfo);
 
     if (!d->mimeType.isValid() || d->mimeTypeMode != mode) {
-        d->mimeType = mimeType(absoluteFilePath(), mode);
+        // do not read the view items that were not visible yet, e.g. when sorting
+        // by type, their content is sniffed in makeToActive if the name is ambiguous.
+        // the other users of the file info always get the type of the content
+        if (mode == QMimeDatabase::MatchDefault && isViewItem() && !isActive()) {
+            bool exact = true;
+
+            d->mimeType = DMimeDatabase().mimeTypeForFileByName(d->fileInfo, &exact);
+            d->mimeTypeByName = !exact;
+        } else {
+            d->mimeType = mimeType(absoluteFilePath(), mode);
+            d->mimeTypeByName = false;
+        }
+
         d->mimeTypeMode = mode;
     }
 
@@ -729,6 +741,15 @@ void DFileInfo::makeToActive()
 
     d->fileInfo.refresh();
     DAbstractFileInfo::makeToActive();
+
+    if (d->mimeTypeByName) {
+        d->mimeTypeByName = false;
+        d->mimeType = QMimeType();
+
+        // the icon of the guessed type
+        if (d->iconFromTheme)
+            d->icon = QIcon();
+    }
 }
 
 void DFileInfo::makeToInactive()
@@ -216,6 +216,10 @@ bool DFileService::fmEvent(const QSharedPointer<DFMEvent> &event, QVariant *resu
 
         break;
     }
+    case DFMEvent::BatchRenameFiles:
+        // only used to undo a batch rename of local files, the watchers update the views
+        result = FileBatchProcess::renameFilesInOrder(event.staticCast<DFMBatchRenameEvent>()->renameList());
+        break;
     case DFMEvent::DeleteFiles: {
         result = CALL_CONTROLLER(deleteFiles);
 
@@ -869,11 +873,23 @@ void DFileService::laterRequestSelectFiles(const DFMUrlListBaseEvent &event) con
     }, event, manager)
 }
 
+// the files whose new name is in use were not renamed
+static void showSkippedRenames(const QMap<DUrl, DUrl> &skipped)
+{
+    if (skipped.isEmpty())
+        return;
+
+    DThreadUtil::runInMainThread(dialogManager, &DialogManager::showRenameNameSameErrorDialog, skipped.first().fileName(), DFMEvent());
+}
+
 ///###: replace
 bool DFileService::multiFilesReplaceName(const QList<DUrl> &urls, const QPair<QString, QString> &pair)const
 {
     auto alteredAndUnAlteredUrls = FileBatchProcess::instance()->replaceText(urls, pair);
-    AppController::multiSelectionFilesCache.first = FileBatchProcess::batchProcessFile(alteredAndUnAlteredUrls).values();
+    QMap<DUrl, DUrl> skipped;
+    AppController::multiSelectionFilesCache.first = FileBatchProcess::batchProcessFile(alteredAndUnAlteredUrls, &skipped).values();
+
+    showSkippedRenames(skipped);
 
     return DFileService::checkMultiSelectionFilesCache();
 }
@@ -883,7 +899,10 @@ bool DFileService::multiFilesReplaceName(const QList<DUrl> &urls, const QPair<QS
 bool DFileService::multiFilesAddStrToName(const QList<DUrl> &urls, const QPair<QString, DFileService::AddTextFlags> &pair)const
 {
     auto alteredAndUnAlteredUrls = FileBatchProcess::instance()->addText(urls, pair);
-    AppController::multiSelectionFilesCache.first = FileBatchProcess::batchProcessFile(alteredAndUnAlteredUrls).values();
+    QMap<DUrl, DUrl> skipped;
+    AppController::multiSelectionFilesCache.first = FileBatchProcess::batchProcessFile(alteredAndUnAlteredUrls, &skipped).values();
+
+    showSkippedRenames(skipped);
 
     return DFileService::checkMultiSelectionFilesCache();
 }
@@ -892,7 +911,10 @@ bool DFileService::multiFilesAddStrToName(const QList<DUrl> &urls, const QPair<Q
 bool DFileService::multiFilesCustomName(const QList<DUrl> &urls, const QPair<QString, QString> &pair)const
 {
     auto alteredAndUnAlteredUrls = FileBatchProcess::instance()->customText(urls, pair);
-    AppController::multiSelectionFilesCache.first = FileBatchProcess::batchProcessFile(alteredAndUnAlteredUrls).values();
+    QMap<DUrl, DUrl> skipped;
+    AppController::multiSelectionFilesCache.first = FileBatchProcess::batchProcessFile(alteredAndUnAlteredUrls, &skipped).values();
+
+    showSkippedRenames(skipped);
 
     return DFileService::checkMultiSelectionFilesCache();
 }
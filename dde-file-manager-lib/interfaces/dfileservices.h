@@ -32,6 +32,7 @@
 #include <QObject>
 #include <QString>
 #include <QMultiHash>
+#include <QMap>
 #include <QPair>
 #include <QDir>
 #include <QDebug>
@@ -164,6 +165,8 @@ signals:
     void fileDeleted(const DUrl &fileUrl) const;
     void fileMovedToTrash(const DUrl &from, const DUrl &to) const;
     void fileRenamed(const DUrl &from, const DUrl &to) const;
+    // the local files renamed in one batch, instead of fileRenamed for each of them
+    void filesRenamed(const QMap<DUrl, DUrl> &renamed) const;
 
 private slots:
     void laterRequestSelectFiles(const DFMUrlListBaseEvent &event) const;
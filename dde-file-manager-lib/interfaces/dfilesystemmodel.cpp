@@ -1654,6 +1654,7 @@ const FileSystemNodePointer DFileSystemModel::createNode(FileSystemNode *parent,
     FileSystemNodePointer node(new FileSystemNode(parent, info));
 
     node->fileInfo->setColumnCompact(d->columnCompact);
+    node->fileInfo->setViewItem(true);
 //        d->urlToNode[info->fileUrl()] = node;
 
     return node;
@@ -24,11 +24,17 @@
 #include "dfmcrumbbar.h"
 
 #include "controllers/jobcontroller.h"
+#include "controllers/searchhistroymanager.h"
+#include "ddirectorynamecache.h"
+#include "singleton.h"
 
 #include "dfileservices.h"
 #include "dfileinfo.h"
 
 #include <QPointer>
+#include <QSet>
+
+#include <algorithm>
 
 DFM_BEGIN_NAMESPACE
 
@@ -89,7 +95,13 @@ class DFMCrumbInterfacePrivate {
 public:
     DFMCrumbInterfacePrivate(DFMCrumbInterface *qq);
 
+    void emitLocalCompletion(const QString &dirPath, QStringList names);
+
     QPointer<JobController> folderCompleterJobPointer;
+    QMetaObject::Connection localCompletionConnection;
+    QMetaObject::Connection localPartialCompletionConnection;
+    // the names sent before all names of the directory were read
+    QSet<QString> localCompletionSent;
     DFMCrumbBar* crumbBar = nullptr;
 
     DFMCrumbInterface *q_ptr;
@@ -103,6 +115,29 @@ DFMCrumbInterfacePrivate::DFMCrumbInterfacePrivate(DFMCrumbInterface *qq)
 
 }
 
+void DFMCrumbInterfacePrivate::emitLocalCompletion(const QString &dirPath, QStringList names)
+{
+    Q_Q(DFMCrumbInterface);
+
+    if (!localCompletionSent.isEmpty()) {
+        names.erase(std::remove_if(names.begin(), names.end(), [this] (const QString &name) {
+            return localCompletionSent.contains(name);
+        }), names.end());
+    }
+
+    // the frequently and recently visited directories first
+    const QHash<QString, qreal> &scores = Singleton<SearchHistroyManager>::instance()->childrenFrecency(dirPath);
+
+    if (!scores.isEmpty()) {
+        std::stable_sort(names.begin(), names.end(), [&scores] (const QString &a, const QString &b) {
+            return scores.value(a) > scores.value(b);
+        });
+    }
+
+    emit q->completionFound(names);
+    emit q->completionListTransmissionCompleted();
+}
+
 
 /*!
  * \class DFMCrumbInterface
@@ -253,6 +288,46 @@ void DFMCrumbInterface::requestCompletionList(const DUrl &url)
         d->folderCompleterJobPointer->stopAndDeleteLater();
     }
 
+    disconnect(d->localCompletionConnection);
+    disconnect(d->localPartialCompletionConnection);
+    d->localCompletionSent.clear();
+
+    // the names of the local directories are read without any file info and cached
+    if (url.isLocalFile()) {
+        const QString &dir_path = url.toLocalFile();
+        DDirectoryNameCache *cache = DDirectoryNameCache::instance();
+        QStringList names;
+
+        if (cache->cachedNames(dir_path, &names)) {
+            d->emitLocalCompletion(dir_path, names);
+
+            return;
+        }
+
+        d->localCompletionConnection = connect(cache, &DDirectoryNameCache::namesReady, this, [d, dir_path] (const QString &path, const QStringList &names) {
+            if (path != dir_path)
+                return;
+
+            disconnect(d->localCompletionConnection);
+            disconnect(d->localPartialCompletionConnection);
+            d->emitLocalCompletion(path, names);
+        });
+        // a huge directory, show the names read so far and append the others later
+        d->localPartialCompletionConnection = connect(cache, &DDirectoryNameCache::namesFound, this, [d, dir_path] (const QString &path, const QStringList &names) {
+            if (path != dir_path)
+                return;
+
+            d->emitLocalCompletion(path, names);
+
+            for (const QString &name : names)
+                d->localCompletionSent << name;
+        });
+
+        cache->requestNames(dir_path);
+
+        return;
+    }
+
     d->folderCompleterJobPointer = DFileService::instance()->getChildrenJob(this, url, QStringList(), QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::NoIteratorFlags, true);
     if (!d->folderCompleterJobPointer) {
         return;
@@ -287,6 +362,9 @@ void DFMCrumbInterface::cancelCompletionListTransmission()
     if (d->folderCompleterJobPointer && d->folderCompleterJobPointer) {
         d->folderCompleterJobPointer->stopAndDeleteLater();
     }
+
+    disconnect(d->localCompletionConnection);
+    disconnect(d->localPartialCompletionConnection);
 }
 
 /*!
@@ -100,6 +100,8 @@ static QString fmeventType2String(DFMEvent::Type type)
         return QStringLiteral(QT_STRINGIFY(CleanSaveOperator));
     case DFMEvent::GetTagsThroughFiles:
         return QStringLiteral(QT_STRINGIFY(GetTagsThroughFiles));
+    case DFMEvent::BatchRenameFiles:
+        return QStringLiteral(QT_STRINGIFY(BatchRenameFiles));
     default:
         return QStringLiteral("Custom: %1").arg(type);
     }
@@ -233,6 +235,8 @@ const QSharedPointer<DFMEvent> DFMEvent::fromJson(DFMEvent::Type type, const QJs
         return DFMWriteUrlsToClipboardEvent::fromJson(json);
     case RenameFile:
         return DFMRenameEvent::fromJson(json);
+    case BatchRenameFiles:
+        return DFMBatchRenameEvent::fromJson(json);
     case DeleteFiles:
         return DFMDeleteEvent::fromJson(json);
     case MoveToTrash:
@@ -452,6 +456,35 @@ QSharedPointer<DFMRenameEvent> DFMRenameEvent::fromJson(const QJsonObject &json)
     return dMakeEventPointer<DFMRenameEvent>(Q_NULLPTR, DUrl::fromUserInput(json["from"].toString()), DUrl::fromUserInput(json["to"].toString()));
 }
 
+DFMBatchRenameEvent::DFMBatchRenameEvent(const QObject *sender, const QList<QPair<DUrl, DUrl>> &list)
+    : DFMEvent(BatchRenameFiles, sender)
+{
+    setData(list);
+}
+
+DUrlList DFMBatchRenameEvent::handleUrlList() const
+{
+    DUrlList list;
+
+    for (const QPair<DUrl, DUrl> &rename : renameList())
+        list << rename.first << rename.second;
+
+    return list;
+}
+
+QSharedPointer<DFMBatchRenameEvent> DFMBatchRenameEvent::fromJson(const QJsonObject &json)
+{
+    QList<QPair<DUrl, DUrl>> list;
+
+    for (const QJsonValue &value : json["renameList"].toArray()) {
+        const QJsonArray &rename = value.toArray();
+
+        list << qMakePair(DUrl::fromUserInput(rename.at(0).toString()), DUrl::fromUserInput(rename.at(1).toString()));
+    }
+
+    return dMakeEventPointer<DFMBatchRenameEvent>(Q_NULLPTR, list);
+}
+
 DFMDeleteEvent::DFMDeleteEvent(const QObject *sender, const DUrlList &list, bool silent, bool force)
     : DFMUrlListBaseEvent(DeleteFiles, sender, list)
 {
@@ -96,6 +96,9 @@ public:
         ChangeTagColor,
         GetTagsThroughFiles,
 
+        // undo of a batch rename
+        BatchRenameFiles,
+
         // user custom
         CustomBase = 1000                            // first user event id
     };
@@ -373,6 +376,22 @@ public:
     static QSharedPointer<DFMRenameEvent> fromJson(const QJsonObject &json);
 };
 
+// renames the files one after another in the order of the list, stops at the first failure
+class DFMBatchRenameEvent : public DFMEvent
+{
+public:
+    explicit DFMBatchRenameEvent(const QObject *sender, const QList<QPair<DUrl, DUrl>> &list);
+
+    inline QList<QPair<DUrl, DUrl>> renameList() const
+    {
+        return qvariant_cast<QList<QPair<DUrl, DUrl>>>(m_data);
+    }
+
+    DUrlList handleUrlList() const Q_DECL_OVERRIDE;
+
+    static QSharedPointer<DFMBatchRenameEvent> fromJson(const QJsonObject &json);
+};
+
 class DFMDeleteEvent : public DFMUrlListBaseEvent
 {
 public:
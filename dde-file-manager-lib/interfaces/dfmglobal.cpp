@@ -357,7 +357,7 @@ void DFMGlobal::initTagManagerConnect()
     connect(TagManager::instance(), &TagManager::filesWereTagged, [] (const QMap<QString, QList<QString>>& files_were_tagged) {
         for (auto i = files_were_tagged.constBegin(); i != files_were_tagged.constEnd(); ++i) {
             // is trash files
-            if (i.key().startsWith(DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath)))
+            if (!DFMStandardPaths::localToTrashUrlPath(i.key()).isEmpty())
                 return;
 
             DUrl url = DUrl::fromLocalFile(i.key());
@@ -597,67 +597,7 @@ void DFMGlobal::elideText(QTextLayout *layout, const QSizeF &size, QTextOption::
 
         if (painter) {
             if (drawBackground) {
-                const QMarginsF margins(backgroundRadius, 0, backgroundRadius, 0);
-                QRectF backBounding = rect;
-                QPainterPath path;
-
-                if (lastLineRect.isValid()) {
-                    if (qAbs(rect.width() - lastLineRect.width()) < backgroundRadius * 2) {
-                        backBounding.setWidth(lastLineRect.width());
-                        backBounding.moveCenter(rect.center());
-                        path.moveTo(lastLineRect.x() - backgroundRadius, lastLineRect.bottom() - backgroundRadius);
-                        path.lineTo(lastLineRect.x(), lastLineRect.bottom() - 1);
-                        path.lineTo(lastLineRect.right(), lastLineRect.bottom() - 1);
-                        path.lineTo(lastLineRect.right() + backgroundRadius, lastLineRect.bottom() - backgroundRadius);
-                        path.lineTo(lastLineRect.right() + backgroundRadius, backBounding.bottom() - backgroundRadius);
-                        path.arcTo(backBounding.right() - backgroundRadius, backBounding.bottom() - backgroundRadius * 2, backgroundRadius * 2, backgroundRadius * 2, 0, -90);
-                        path.lineTo(backBounding.x(), backBounding.bottom());
-                        path.arcTo(backBounding.x() - backgroundRadius, backBounding.bottom() - backgroundRadius * 2, backgroundRadius * 2, backgroundRadius * 2, 270, -90);
-                        lastLineRect = backBounding;
-                    } else if (lastLineRect.width() > rect.width()) {
-                        backBounding += margins;
-                        path.moveTo(backBounding.x() - backgroundRadius, backBounding.y() - 1);
-                        path.arcTo(backBounding.x() - backgroundRadius * 2, backBounding.y() - 1, backgroundRadius * 2, backgroundRadius * 2 + 1, 90, -90);
-                        path.lineTo(backBounding.x(), backBounding.bottom() - backgroundRadius);
-                        path.arcTo(backBounding.x(), backBounding.bottom() - backgroundRadius * 2, backgroundRadius * 2, backgroundRadius * 2, 180, 90);
-                        path.lineTo(backBounding.right() - backgroundRadius, backBounding.bottom());
-                        path.arcTo(backBounding.right() - backgroundRadius * 2, backBounding.bottom() - backgroundRadius * 2, backgroundRadius * 2, backgroundRadius * 2, 270, 90);
-                        path.lineTo(backBounding.right(), backBounding.top() + backgroundRadius);
-                        path.arcTo(backBounding.right(), backBounding.top() - 1, backgroundRadius * 2, backgroundRadius * 2 + 1, 180, -90);
-                        path.closeSubpath();
-                        lastLineRect = rect;
-                    } else {
-                        backBounding += margins;
-                        path.moveTo(lastLineRect.x() - backgroundRadius * 2, lastLineRect.bottom());
-                        path.arcTo(lastLineRect.x() - backgroundRadius * 3, lastLineRect.bottom() - backgroundRadius * 2, backgroundRadius * 2, backgroundRadius * 2, 270, 90);
-                        path.lineTo(lastLineRect.x(), lastLineRect.bottom() - 1);
-                        path.lineTo(lastLineRect.right(), lastLineRect.bottom() - 1);
-                        path.lineTo(lastLineRect.right() + backgroundRadius, lastLineRect.bottom() - backgroundRadius * 2);
-                        path.arcTo(lastLineRect.right() + backgroundRadius, lastLineRect.bottom() - backgroundRadius * 2, backgroundRadius * 2, backgroundRadius * 2, 180, 90);
-
-//                        path.arcTo(lastLineRect.x() - backgroundReaius, lastLineRect.bottom() - backgroundReaius * 2, backgroundReaius * 2, backgroundReaius * 2, 180, 90);
-//                        path.lineTo(lastLineRect.x() - backgroundReaius * 3, lastLineRect.bottom());
-//                        path.moveTo(lastLineRect.right(), lastLineRect.bottom());
-//                        path.arcTo(lastLineRect.right() - backgroundReaius, lastLineRect.bottom() - backgroundReaius * 2, backgroundReaius * 2, backgroundReaius * 2, 270, 90);
-//                        path.arcTo(lastLineRect.right() + backgroundReaius, lastLineRect.bottom() - backgroundReaius * 2, backgroundReaius * 2, backgroundReaius * 2, 180, 90);
-//                        path.lineTo(lastLineRect.right(), lastLineRect.bottom());
-
-                        path.addRoundedRect(backBounding, backgroundRadius, backgroundRadius);
-                        lastLineRect = rect;
-                    }
-                } else {
-                    lastLineRect = backBounding;
-                    path.addRoundedRect(backBounding + margins, backgroundRadius, backgroundRadius);
-                }
-
-                bool a = painter->testRenderHint(QPainter::Antialiasing);
-                qreal o = painter->opacity();
-
-                painter->setRenderHint(QPainter::Antialiasing, true);
-                painter->setOpacity(1);
-                painter->fillPath(path, background);
-                painter->setRenderHint(QPainter::Antialiasing, a);
-                painter->setOpacity(o);
+                drawTextLineBackground(painter, rect, lastLineRect, backgroundRadius, background);
             }
 
             if (drawShadow) {
@@ -693,6 +633,72 @@ void DFMGlobal::elideText(QTextLayout *layout, const QSizeF &size, QTextOption::
     layout->endLayout();
 }
 
+void DFMGlobal::drawTextLineBackground(QPainter *painter, const QRectF &rect, QRectF &lastLineRect,
+                                       qreal radius, const QBrush &background)
+{
+    const QMarginsF margins(radius, 0, radius, 0);
+    QRectF backBounding = rect;
+    QPainterPath path;
+
+    if (lastLineRect.isValid()) {
+        if (qAbs(rect.width() - lastLineRect.width()) < radius * 2) {
+            backBounding.setWidth(lastLineRect.width());
+            backBounding.moveCenter(rect.center());
+            path.moveTo(lastLineRect.x() - radius, lastLineRect.bottom() - radius);
+            path.lineTo(lastLineRect.x(), lastLineRect.bottom() - 1);
+            path.lineTo(lastLineRect.right(), lastLineRect.bottom() - 1);
+            path.lineTo(lastLineRect.right() + radius, lastLineRect.bottom() - radius);
+            path.lineTo(lastLineRect.right() + radius, backBounding.bottom() - radius);
+            path.arcTo(backBounding.right() - radius, backBounding.bottom() - radius * 2, radius * 2, radius * 2, 0, -90);
+            path.lineTo(backBounding.x(), backBounding.bottom());
+            path.arcTo(backBounding.x() - radius, backBounding.bottom() - radius * 2, radius * 2, radius * 2, 270, -90);
+            lastLineRect = backBounding;
+        } else if (lastLineRect.width() > rect.width()) {
+            backBounding += margins;
+            path.moveTo(backBounding.x() - radius, backBounding.y() - 1);
+            path.arcTo(backBounding.x() - radius * 2, backBounding.y() - 1, radius * 2, radius * 2 + 1, 90, -90);
+            path.lineTo(backBounding.x(), backBounding.bottom() - radius);
+            path.arcTo(backBounding.x(), backBounding.bottom() - radius * 2, radius * 2, radius * 2, 180, 90);
+            path.lineTo(backBounding.right() - radius, backBounding.bottom());
+            path.arcTo(backBounding.right() - radius * 2, backBounding.bottom() - radius * 2, radius * 2, radius * 2, 270, 90);
+            path.lineTo(backBounding.right(), backBounding.top() + radius);
+            path.arcTo(backBounding.right(), backBounding.top() - 1, radius * 2, radius * 2 + 1, 180, -90);
+            path.closeSubpath();
+            lastLineRect = rect;
+        } else {
+            backBounding += margins;
+            path.moveTo(lastLineRect.x() - radius * 2, lastLineRect.bottom());
+            path.arcTo(lastLineRect.x() - radius * 3, lastLineRect.bottom() - radius * 2, radius * 2, radius * 2, 270, 90);
+            path.lineTo(lastLineRect.x(), lastLineRect.bottom() - 1);
+            path.lineTo(lastLineRect.right(), lastLineRect.bottom() - 1);
+            path.lineTo(lastLineRect.right() + radius, lastLineRect.bottom() - radius * 2);
+            path.arcTo(lastLineRect.right() + radius, lastLineRect.bottom() - radius * 2, radius * 2, radius * 2, 180, 90);
+
+//                        path.arcTo(lastLineRect.x() - backgroundReaius, lastLineRect.bottom() - backgroundReaius * 2, backgroundReaius * 2, backgroundReaius * 2, 180, 90);
+//                        path.lineTo(lastLineRect.x() - backgroundReaius * 3, lastLineRect.bottom());
+//                        path.moveTo(lastLineRect.right(), lastLineRect.bottom());
+//                        path.arcTo(lastLineRect.right() - backgroundReaius, lastLineRect.bottom() - backgroundReaius * 2, backgroundReaius * 2, backgroundReaius * 2, 270, 90);
+//                        path.arcTo(lastLineRect.right() + backgroundReaius, lastLineRect.bottom() - backgroundReaius * 2, backgroundReaius * 2, backgroundReaius * 2, 180, 90);
+//                        path.lineTo(lastLineRect.right(), lastLineRect.bottom());
+
+            path.addRoundedRect(backBounding, radius, radius);
+            lastLineRect = rect;
+        }
+    } else {
+        lastLineRect = backBounding;
+        path.addRoundedRect(backBounding + margins, radius, radius);
+    }
+
+    bool a = painter->testRenderHint(QPainter::Antialiasing);
+    qreal o = painter->opacity();
+
+    painter->setRenderHint(QPainter::Antialiasing, true);
+    painter->setOpacity(1);
+    painter->fillPath(path, background);
+    painter->setRenderHint(QPainter::Antialiasing, a);
+    painter->setOpacity(o);
+}
+
 QString DFMGlobal::elideText(const QString &text, const QSizeF &size,
                              QTextOption::WrapMode wordWrap, const QFont &font,
                              Qt::TextElideMode mode, qreal lineHeight, qreal flags)
@@ -325,6 +325,10 @@ public:
                           const QBrush &background = QBrush(Qt::NoBrush),
                           qreal backgroundReaius = 4,
                           QList<QRectF> *boundingRegion = 0);
+    // paint the rounded background of one text line, |lastLineRect| is the
+    // rect of the previous line and will be updated for the next line
+    static void drawTextLineBackground(QPainter *painter, const QRectF &rect, QRectF &lastLineRect,
+                                       qreal radius, const QBrush &background);
 
     static QString toPinyin(const QString &text);
     static bool startWithHanzi(const QString &text);
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "dfmimagedecoder.h"
+
+#include <QImageReader>
+#include <QtConcurrent>
+#include <QDebug>
+
+#include <functional>
+
+DFM_BEGIN_NAMESPACE
+
+QImage DFMImageDecoder::read(const QString &fileName, const QSize &size, Qt::AspectRatioMode mode,
+                             const QByteArray &format, QSize *sourceSize)
+{
+    QImageReader reader(fileName, format);
+    const QSize &source_size = reader.size();
+
+    if (sourceSize)
+        *sourceSize = source_size;
+
+    if (source_size.isValid() && !size.isEmpty()) {
+        const QSize &target_size = source_size.scaled(size, mode);
+
+        // never scale up, the caller does it if needed
+        if (target_size.width() < source_size.width() && target_size.height() < source_size.height())
+            reader.setScaledSize(target_size);
+    }
+
+    QImage image;
+
+    if (!reader.read(&image))
+        qWarning() << "Failed to read the image:" << fileName << reader.errorString();
+
+    return image;
+}
+
+QList<QImage> DFMImageDecoder::read(const QStringList &fileNames, const QSize &size, Qt::AspectRatioMode mode)
+{
+    std::function<QImage(const QString &)> decode = [size, mode] (const QString &fileName) {
+        return read(fileName, size, mode);
+    };
+
+    return QtConcurrent::blockingMapped<QList<QImage>>(fileNames, decode);
+}
+
+DFM_END_NAMESPACE
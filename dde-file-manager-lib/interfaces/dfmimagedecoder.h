@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DFMIMAGEDECODER_H
+#define DFMIMAGEDECODER_H
+
+#include "dfmglobal.h"
+
+#include <QImage>
+
+DFM_BEGIN_NAMESPACE
+
+class DFMImageDecoder
+{
+public:
+    // decode the image no larger than needed to cover size by the aspect ratio mode;
+    // the reader scales while decoding (e.g. the DCT scaling of jpeg), so the full
+    // resolution image is never in memory. It is safe to call in any thread.
+    static QImage read(const QString &fileName, const QSize &size,
+                       Qt::AspectRatioMode mode = Qt::KeepAspectRatio,
+                       const QByteArray &format = QByteArray(), QSize *sourceSize = nullptr);
+
+    // decode the images in parallel, the result is in the order of fileNames
+    static QList<QImage> read(const QStringList &fileNames, const QSize &size,
+                              Qt::AspectRatioMode mode = Qt::KeepAspectRatio);
+};
+
+DFM_END_NAMESPACE
+
+#endif // DFMIMAGEDECODER_H
@@ -28,13 +28,111 @@
 #include <QStandardPaths>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QJsonArray>
 #include <QDebug>
 #include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
 #include <QDir>
 #include <QTimer>
+#include <QMutex>
+
+#include <algorithm>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/file.h>
+#include <unistd.h>
 
 DFM_BEGIN_NAMESPACE
 
+// the journal is merged into the setting file once it is larger than the
+// setting file itself, but not before it has reached this size
+static const qint64 MIN_JOURNAL_SIZE_TO_COMPACT = 64 * 1024;
+
+// every process appends to the journal and merges it into the setting file
+// while holding this lock, so no line is lost by a concurrent compaction.
+// closing the returned descriptor releases the lock
+static int lockJournalFile(const QString &fileName)
+{
+    const int fd = ::open(QFile::encodeName(fileName).constData(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+
+    if (fd < 0) {
+        qWarning() << "Failed to open" << fileName << strerror(errno);
+
+        return -1;
+    }
+
+    while (::flock(fd, LOCK_EX) != 0) {
+        if (errno != EINTR) {
+            qWarning() << "Failed to lock" << fileName << strerror(errno);
+            ::close(fd);
+
+            return -1;
+        }
+    }
+
+    return fd;
+}
+
+// the access order of the keys of the bounded groups. value() is const and may
+// be called from other threads, so the stamps are guarded by their own lock
+class KeyAccessStamps
+{
+public:
+    void touch(const QString &group, const QString &key)
+    {
+        QMutexLocker locker(&mutex);
+
+        stamps[group][key] = ++counter;
+    }
+
+    void remove(const QString &group, const QString &key)
+    {
+        QMutexLocker locker(&mutex);
+
+        auto it = stamps.find(group);
+
+        if (it != stamps.end()) {
+            it.value().remove(key);
+        }
+    }
+
+    void removeGroup(const QString &group)
+    {
+        QMutexLocker locker(&mutex);
+
+        stamps.remove(group);
+    }
+
+    void clear()
+    {
+        QMutexLocker locker(&mutex);
+
+        stamps.clear();
+    }
+
+    QHash<QString, quint64> group(const QString &group) const
+    {
+        QMutexLocker locker(&mutex);
+
+        return stamps.value(group);
+    }
+
+    QHash<QString, QHash<QString, quint64>> groups() const
+    {
+        QMutexLocker locker(&mutex);
+
+        return stamps;
+    }
+
+private:
+    mutable QMutex mutex;
+    QHash<QString, QHash<QString, quint64>> stamps;
+    quint64 counter = 0;
+};
+
 class DFMSettingsPrivate
 {
 public:
@@ -48,10 +146,25 @@ public:
 
     QString fallbackFile;
     QString settingFile;
+    // changes are appended to this file on sync, one json object per line
+    QString journalFile;
 #ifndef DFM_NO_FILE_WATCHER
     DFileWatcher *settingFileWatcher = nullptr;
+    DFileWatcher *journalFileWatcher = nullptr;
 #endif
 
+    // the changes not yet written to the journal file
+    QByteArray journalBuffer;
+    // bytes of the journal file already applied to writableData
+    qint64 journalSize = 0;
+    // the setting file as written by the last compaction
+    qint64 settingFileSize = 0;
+    QDateTime settingFileTime;
+
+    // groups with a "maxCount" in their metadata only keep the most recently used keys
+    QHash<QString, int> groupMaxCount;
+    mutable KeyAccessStamps keyAccessStamps;
+
     DFMSettings *q_ptr;
 
     struct Data {
@@ -93,6 +206,23 @@ public:
     void fromJson(const QByteArray &json, Data *data);
     QByteArray toJson(const Data &data);
 
+    void loadWritableData();
+    void addJournalEntry(const QString &group, const QString &key, const QVariant *value);
+    void applyJournal(const QByteArray &journal, bool notify, qint64 *appliedSize = nullptr);
+    void applyJournalEntry(const QJsonObject &entry, bool notify);
+    bool readJournal(bool notify);
+    bool writeJournal();
+    bool compact();
+
+    void touchKey(const QString &group, const QString &key) const
+    {
+        if (groupMaxCount.contains(group)) {
+            keyAccessStamps.touch(group, key);
+        }
+    }
+
+    void evictKeys(const QString &group);
+
     void makeSettingFileToDirty(bool dirty)
     {
         if (settingFileIsDirty == dirty) {
@@ -211,20 +341,329 @@ QByteArray DFMSettingsPrivate::toJson(const Data &data)
         root_object.insert(begin.key(), QJsonValue(QJsonObject::fromVariantHash(begin.value())));
     }
 
+    // save the access order of the bounded groups, from the oldest to the newest
+    QJsonObject recent_object;
+
+    const auto &stamps = keyAccessStamps.groups();
+
+    for (auto begin = stamps.constBegin(); begin != stamps.constEnd(); ++begin) {
+        QList<QPair<quint64, QString>> keys;
+
+        for (auto i = begin.value().constBegin(); i != begin.value().constEnd(); ++i) {
+            keys << qMakePair(i.value(), i.key());
+        }
+
+        std::sort(keys.begin(), keys.end());
+
+        QJsonArray array;
+
+        for (const auto &key : keys) {
+            array.append(key.second);
+        }
+
+        recent_object.insert(begin.key(), array);
+    }
+
+    if (!recent_object.isEmpty()) {
+        root_object.insert("__recent__", recent_object);
+    }
+
     return QJsonDocument(root_object).toJson();
 }
 
+void DFMSettingsPrivate::loadWritableData()
+{
+    writableData.privateValues.clear();
+    writableData.values.clear();
+    keyAccessStamps.clear();
+    journalSize = 0;
+
+    fromJsonFile(settingFile, &writableData);
+
+    const QFileInfo info(settingFile);
+
+    settingFileSize = info.size();
+    settingFileTime = info.lastModified();
+
+    const QVariantHash &recent = writableData.privateValues.value("__recent__");
+
+    for (auto begin = recent.constBegin(); begin != recent.constEnd(); ++begin) {
+        const QVariantHash &values = writableData.values.value(begin.key());
+
+        for (const QString &key : begin.value().toStringList()) {
+            if (values.contains(key)) {
+                touchKey(begin.key(), key);
+            }
+        }
+    }
+
+    // the journal is newer than the setting file
+    readJournal(false);
+}
+
+// a value of nullptr means remove the key, an empty key means remove the group
+// and an empty group means remove all
+void DFMSettingsPrivate::addJournalEntry(const QString &group, const QString &key, const QVariant *value)
+{
+    QJsonObject entry;
+
+    if (!group.isEmpty()) {
+        entry.insert("g", group);
+
+        if (!key.isEmpty()) {
+            entry.insert("k", key);
+
+            if (value) {
+                entry.insert("v", QJsonValue::fromVariant(*value));
+            }
+        }
+    }
+
+    journalBuffer.append(QJsonDocument(entry).toJson(QJsonDocument::Compact));
+    journalBuffer.append('\n');
+    makeSettingFileToDirty(true);
+}
+
+void DFMSettingsPrivate::applyJournal(const QByteArray &journal, bool notify, qint64 *appliedSize)
+{
+    int begin = 0;
+
+    forever {
+        int end = journal.indexOf('\n', begin);
+
+        // the last line may still be written
+        if (end < 0) {
+            break;
+        }
+
+        const QJsonDocument &doc = QJsonDocument::fromJson(journal.mid(begin, end - begin));
+
+        if (doc.isObject()) {
+            applyJournalEntry(doc.object(), notify);
+        }
+
+        begin = end + 1;
+    }
+
+    if (appliedSize) {
+        *appliedSize = begin;
+    }
+}
+
+void DFMSettingsPrivate::applyJournalEntry(const QJsonObject &entry, bool notify)
+{
+    const QString &group = entry.value("g").toString();
+    const QString &key = entry.value("k").toString();
+    QList<QPair<QString, QString>> keys;
+
+    if (notify) {
+        if (!key.isEmpty()) {
+            keys << qMakePair(group, key);
+        } else {
+            for (auto begin = writableData.values.constBegin(); begin != writableData.values.constEnd(); ++begin) {
+                if (!group.isEmpty() && begin.key() != group) {
+                    continue;
+                }
+
+                for (auto i = begin.value().constBegin(); i != begin.value().constEnd(); ++i) {
+                    keys << qMakePair(begin.key(), i.key());
+                }
+            }
+        }
+    }
+
+    QVariantList old_values;
+
+    for (const auto &k : keys) {
+        old_values << q_ptr->value(k.first, k.second);
+    }
+
+    if (group.isEmpty()) {
+        writableData.values.clear();
+        keyAccessStamps.clear();
+    } else if (key.isEmpty()) {
+        writableData.values.remove(group);
+        keyAccessStamps.removeGroup(group);
+    } else if (entry.contains("v")) {
+        writableData.setValue(group, key, entry.value("v").toVariant());
+        touchKey(group, key);
+    } else if (writableData.values.contains(group)) {
+        writableData.values[group].remove(key);
+        keyAccessStamps.remove(group, key);
+    }
+
+    for (int i = 0; i < keys.count(); ++i) {
+        const QVariant &new_value = q_ptr->value(keys.at(i).first, keys.at(i).second);
+
+        if (new_value != old_values.at(i)) {
+            Q_EMIT q_ptr->valueEdited(keys.at(i).first, keys.at(i).second, new_value);
+            Q_EMIT q_ptr->valueChanged(keys.at(i).first, keys.at(i).second, new_value);
+        }
+    }
+}
+
+// apply the lines appended since the last read, return false if the journal was truncated
+bool DFMSettingsPrivate::readJournal(bool notify)
+{
+    QFile file(journalFile);
+
+    if (!file.open(QFile::ReadOnly)) {
+        return journalSize == 0;
+    }
+
+    if (file.size() < journalSize) {
+        return false;
+    }
+
+    if (file.size() == journalSize) {
+        return true;
+    }
+
+    if (!file.seek(journalSize)) {
+        return false;
+    }
+
+    qint64 applied_size = 0;
+
+    applyJournal(file.readAll(), notify, &applied_size);
+    journalSize += applied_size;
+
+    return true;
+}
+
+bool DFMSettingsPrivate::writeJournal()
+{
+    const int fd = lockJournalFile(journalFile);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    // pick up the changes of other processes, the journal is only ever appended to
+    if (QFileInfo(journalFile).size() != journalSize) {
+        _q_onFileChanged(DUrl::fromLocalFile(journalFile));
+    }
+
+    QFile file;
+    bool ok = ::lseek(fd, 0, SEEK_END) >= 0
+              && file.open(fd, QFile::WriteOnly | QFile::Append, QFile::DontCloseHandle)
+              && file.write(journalBuffer) == journalBuffer.size();
+
+    if (!ok) {
+        qWarning() << file.errorString();
+    }
+
+    file.close();
+
+    if (ok) {
+        journalSize = QFileInfo(journalFile).size();
+        journalBuffer.clear();
+    }
+
+    ::close(fd);
+
+    return ok;
+}
+
+bool DFMSettingsPrivate::compact()
+{
+    const int fd = lockJournalFile(journalFile);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    // the lines appended by other processes since the last read belong into the new setting file
+    if (QFileInfo(journalFile).size() != journalSize) {
+        _q_onFileChanged(DUrl::fromLocalFile(journalFile));
+    }
+
+    const QByteArray &json = toJson(writableData);
+
+    QFile file(settingFile);
+    bool ok = file.open(QFile::WriteOnly) && file.write(json) == json.size();
+
+    file.close();
+
+    if (ok) {
+        const QFileInfo info(settingFile);
+
+        settingFileSize = info.size();
+        settingFileTime = info.lastModified();
+
+        // replaying the journal over the new setting file gives the same result,
+        // so a failure here does not lose any value
+        ok = ::ftruncate(fd, 0) == 0;
+
+        if (ok) {
+            journalSize = 0;
+        }
+    }
+
+    ::close(fd);
+
+    return ok;
+}
+
+void DFMSettingsPrivate::evictKeys(const QString &group)
+{
+    const int max_count = groupMaxCount.value(group);
+    const QVariantHash &values = writableData.values.value(group);
+
+    // evict in batches, not every new key needs to sort the group
+    if (max_count <= 0 || values.count() <= max_count + max_count / 8) {
+        return;
+    }
+
+    const QHash<QString, quint64> &stamps = keyAccessStamps.group(group);
+    QVector<QPair<quint64, QString>> keys;
+
+    keys.reserve(values.count());
+
+    for (auto begin = values.constBegin(); begin != values.constEnd(); ++begin) {
+        keys << qMakePair(stamps.value(begin.key()), begin.key());
+    }
+
+    const int evict_count = keys.count() - max_count;
+
+    std::nth_element(keys.begin(), keys.begin() + evict_count, keys.end());
+
+    for (int i = 0; i < evict_count; ++i) {
+        writableData.values[group].remove(keys.at(i).second);
+        keyAccessStamps.remove(group, keys.at(i).second);
+        addJournalEntry(group, keys.at(i).second, nullptr);
+    }
+}
+
 void DFMSettingsPrivate::_q_onFileChanged(const DUrl &url)
 {
-    if (url.toLocalFile() != settingFile) {
+    const QString &file_path = url.toLocalFile();
+
+    if (file_path == journalFile) {
+        // only the appended lines need to be applied, unless the journal was
+        // merged into the setting file by another process
+        if (readJournal(true)) {
+            // the changes not yet written win over the others
+            applyJournal(journalBuffer, false);
+
+            return;
+        }
+    } else if (file_path == settingFile) {
+        const QFileInfo info(settingFile);
+
+        // written by ourselves
+        if (info.size() == settingFileSize && info.lastModified() == settingFileTime) {
+            return;
+        }
+    } else {
         return;
     }
 
     const auto old_values = writableData.values;
 
-    writableData.values.clear();
-    fromJsonFile(settingFile, &writableData);
-    makeSettingFileToDirty(false);
+    loadWritableData();
+    applyJournal(journalBuffer, false);
+    makeSettingFileToDirty(!journalBuffer.isEmpty());
 
     for (auto begin = writableData.values.constBegin(); begin != writableData.values.constEnd(); ++begin) {
         for (auto i = begin.value().constBegin(); i != begin.value().constEnd(); ++i) {
@@ -277,10 +716,22 @@ DFMSettings::DFMSettings(const QString &defaultFile, const QString &fallbackFile
 {
     d_ptr->fallbackFile = fallbackFile;
     d_ptr->settingFile = settingFile;
+    d_ptr->journalFile = settingFile + ".journal";
 
     d_ptr->fromJsonFile(defaultFile, &d_ptr->defaultData);
     d_ptr->fromJsonFile(fallbackFile, &d_ptr->fallbackData);
-    d_ptr->fromJsonFile(settingFile, &d_ptr->writableData);
+
+    const QVariantHash &metadata = d_ptr->defaultData.privateValues.value("__metadata__");
+
+    for (auto begin = metadata.constBegin(); begin != metadata.constEnd(); ++begin) {
+        int max_count = begin.value().toMap().value("maxCount").toInt();
+
+        if (max_count > 0) {
+            d_ptr->groupMaxCount[begin.key()] = max_count;
+        }
+    }
+
+    d_ptr->loadWritableData();
 }
 
 static QString getConfigFilePath(QStandardPaths::StandardLocation type, const QString &fileName, bool writable)
@@ -469,6 +920,8 @@ QVariant DFMSettings::value(const QString &group, const QString &key, const QVar
     QVariant value = d->writableData.values.value(group).value(key, QVariant::Invalid);
 
     if (value.isValid()) {
+        d->touchKey(group, key);
+
         return value;
     }
 
@@ -531,7 +984,9 @@ bool DFMSettings::setValueNoNotify(const QString &group, const QString &key, con
     }
 
     d->writableData.setValue(group, key, value);
-    d->makeSettingFileToDirty(true);
+    d->touchKey(group, key);
+    d->addJournalEntry(group, key, &value);
+    d->evictKeys(group);
 
     return changed;
 }
@@ -553,7 +1008,8 @@ void DFMSettings::removeGroup(const QString &group)
 
     const QVariantHash &group_values = d->writableData.values.take(group);
 
-    d->makeSettingFileToDirty(true);
+    d->keyAccessStamps.removeGroup(group);
+    d->addJournalEntry(group, QString(), nullptr);
 
     for (auto begin = group_values.constBegin(); begin != group_values.constEnd(); ++begin) {
         const QVariant &new_value = value(group, begin.key());
@@ -587,7 +1043,9 @@ void DFMSettings::remove(const QString &group, const QString &key)
     }
 
     const QVariant &old_value = d->writableData.values[group].take(key);
-    d->makeSettingFileToDirty(true);
+
+    d->keyAccessStamps.remove(group, key);
+    d->addJournalEntry(group, key, nullptr);
 
     const QVariant &new_value = value(group, key);
 
@@ -616,7 +1074,8 @@ void DFMSettings::clear()
     const QHash<QString, QVariantHash> old_values = d->writableData.values;
 
     d->writableData.values.clear();
-    d->makeSettingFileToDirty(true);
+    d->keyAccessStamps.clear();
+    d->addJournalEntry(QString(), QString(), nullptr);
 
     for (auto begin = old_values.constBegin(); begin != old_values.constEnd(); ++begin) {
         const QVariantHash &values = begin.value();
@@ -645,9 +1104,8 @@ void DFMSettings::reload()
     d->fallbackData.values.clear();
     d->fromJsonFile(d->fallbackFile, &d_ptr->fallbackData);
 
-    d->writableData.privateValues.clear();
-    d->writableData.values.clear();
-    d->fromJsonFile(d->settingFile, &d_ptr->writableData);
+    d->loadWritableData();
+    d->applyJournal(d->journalBuffer, false);
 }
 
 bool DFMSettings::sync()
@@ -658,16 +1116,15 @@ bool DFMSettings::sync()
         return true;
     }
 
-    const QByteArray &json = d->toJson(d->writableData);
+    QDir().mkpath(QFileInfo(d->settingFile).absolutePath());
 
-    QFile file(d->settingFile);
+    // only write the changes, the whole file is rewritten once the journal became large
+    bool ok = d->journalBuffer.isEmpty() || d->writeJournal();
 
-    if (!file.open(QFile::WriteOnly)) {
-        return false;
+    if (ok && d->journalSize > qMax(MIN_JOURNAL_SIZE_TO_COMPACT, d->settingFileSize)) {
+        ok = d->compact();
     }
 
-    bool ok = file.write(json) == json.size();
-
     if (ok) {
         d->makeSettingFileToDirty(false);
     }
@@ -760,11 +1217,29 @@ void DFMSettings::setWatchChanges(bool watchChanges)
         connect(d->settingFileWatcher, &DFileWatcher::fileModified, this, &DFMSettings::onFileChanged);
 
         d->settingFileWatcher->startWatcher();
+
+        if (!QFile::exists(d->journalFile)) {
+            QFile file(d->journalFile);
+
+            file.open(QFile::WriteOnly);
+        }
+
+        d->journalFileWatcher = new DFileWatcher(d->journalFile, this);
+        d->journalFileWatcher->moveToThread(thread());
+
+        connect(d->journalFileWatcher, &DFileWatcher::fileModified, this, &DFMSettings::onFileChanged);
+
+        d->journalFileWatcher->startWatcher();
     } else {
         if (d->settingFileWatcher) {
             d->settingFileWatcher->deleteLater();
             d->settingFileWatcher = nullptr;
         }
+
+        if (d->journalFileWatcher) {
+            d->journalFileWatcher->deleteLater();
+            d->journalFileWatcher = nullptr;
+        }
     }
 }
 #endif
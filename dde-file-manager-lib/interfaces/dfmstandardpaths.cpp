@@ -24,11 +24,21 @@
 
 #include "dfmstandardpaths.h"
 #include "durl.h"
+#include "dmounttablecache.h"
 
 #include <QDir>
 #include <QCoreApplication>
 #include <QStandardPaths>
 #include <QMap>
+#include <QFile>
+#include <QFileInfo>
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+DFM_USE_NAMESPACE
+
+static const QString VOLUME_TRASH_PREFIX = QStringLiteral(".dfm-volume-trash-");
 
 QString DFMStandardPaths::location(DFMStandardPaths::StandardLocation type)
 {
@@ -188,6 +198,178 @@ DUrl DFMStandardPaths::toStandardUrl(const QString &localPath)
     return DUrl();
 }
 
+// the file systems of fuse (gvfs, avfs...) manage their trash by themselves
+static bool canHaveVolumeTrash(const DMountTableCache::MountEntry &mount)
+{
+    return !mount.readOnly && !mount.fileSystemType.startsWith("fuse.");
+}
+
+// $topdir/.Trash/$uid is only used if $topdir/.Trash is a sticky directory
+static QString adminTrashPath(const QString &topDir)
+{
+    const QString &path = topDir + "/.Trash";
+    struct stat st;
+
+    if (::lstat(QFile::encodeName(path).constData(), &st) != 0
+            || !S_ISDIR(st.st_mode) || !(st.st_mode & S_ISVTX)) {
+        return QString();
+    }
+
+    return path + "/" + QString::number(::getuid());
+}
+
+static bool checkTrashDir(const QString &path, bool create)
+{
+    const QByteArray &local_path = QFile::encodeName(path);
+    struct stat st;
+
+    if (::lstat(local_path.constData(), &st) != 0) {
+        if (!create || ::mkdir(local_path.constData(), 0700) != 0)
+            return false;
+    } else if (!S_ISDIR(st.st_mode) || st.st_uid != ::getuid()) {
+        // must not be a symbolic link and must be owned by the user
+        return false;
+    }
+
+    if (create) {
+        ::mkdir((local_path + "/files").constData(), 0700);
+        ::mkdir((local_path + "/info").constData(), 0700);
+
+        return QFileInfo(path + "/info").isDir() && QFileInfo(path + "/files").isDir();
+    }
+
+    return QFileInfo(path + "/files").isDir();
+}
+
+QString DFMStandardPaths::trashPathForFile(const QString &filePath, bool create)
+{
+    const QString &home_trash = location(TrashPath);
+    DMountTableCache::MountEntry file_mount;
+    DMountTableCache::MountEntry home_mount;
+
+    if (!DMountTableCache::instance()->findMount(filePath, &file_mount)
+            || !DMountTableCache::instance()->findMount(location(HomePath), &home_mount)
+            || file_mount.dev == home_mount.dev || !canHaveVolumeTrash(file_mount)) {
+        return home_trash;
+    }
+
+    const QString &top_dir = file_mount.rootPath == "/" ? QString() : file_mount.rootPath;
+    const QString &admin_trash = adminTrashPath(top_dir);
+
+    if (!admin_trash.isEmpty() && checkTrashDir(admin_trash, create))
+        return admin_trash;
+
+    const QString &user_trash = top_dir + "/.Trash-" + QString::number(::getuid());
+
+    if (checkTrashDir(user_trash, create))
+        return user_trash;
+
+    return home_trash;
+}
+
+QStringList DFMStandardPaths::trashPaths()
+{
+    QStringList list {location(TrashPath)};
+
+    for (const DMountTableCache::MountEntry &mount : DMountTableCache::instance()->mounts()) {
+        if (!canHaveVolumeTrash(mount))
+            continue;
+
+        const QString &top_dir = mount.rootPath == "/" ? QString() : mount.rootPath;
+        const QStringList candidates {adminTrashPath(top_dir), top_dir + "/.Trash-" + QString::number(::getuid())};
+
+        for (const QString &path : candidates) {
+            if (!path.isEmpty() && !list.contains(path) && checkTrashDir(path, false))
+                list << path;
+        }
+    }
+
+    return list;
+}
+
+QString DFMStandardPaths::trashTopDir(const QString &trashPath)
+{
+    if (trashPath == location(TrashPath))
+        return QString();
+
+    QString top_dir = QFileInfo(trashPath).absolutePath();
+
+    // $topdir/.Trash/$uid
+    if (top_dir.endsWith("/.Trash"))
+        top_dir.chop(7);
+
+    return top_dir.isEmpty() ? QStringLiteral("/") : top_dir;
+}
+
+QString DFMStandardPaths::trashUrlPathToLocal(const QString &urlPath, QString *trashPath)
+{
+    if (urlPath.startsWith("/" + VOLUME_TRASH_PREFIX)) {
+        int name_end = urlPath.indexOf('/', 1);
+
+        if (name_end < 0)
+            name_end = urlPath.size();
+
+        const int separator = urlPath.indexOf(':', 1);
+
+        if (separator > 0 && separator < name_end) {
+            const int hex_begin = 1 + VOLUME_TRASH_PREFIX.size();
+            const QString &trash_path = QFile::decodeName(QByteArray::fromHex(urlPath.mid(hex_begin, separator - hex_begin).toLatin1()));
+
+            if (trashPath)
+                *trashPath = trash_path;
+
+            return trash_path + "/files/" + urlPath.mid(separator + 1);
+        }
+    }
+
+    if (trashPath)
+        *trashPath = location(TrashPath);
+
+    return location(TrashFilesPath) + urlPath;
+}
+
+QString DFMStandardPaths::localToTrashUrlPath(const QString &localPath, QString *trashPath)
+{
+    const QString &home_files = location(TrashFilesPath);
+
+    if (localPath == home_files || localPath.startsWith(home_files + "/")) {
+        if (trashPath)
+            *trashPath = location(TrashPath);
+
+        const QString &path = localPath.mid(home_files.size());
+
+        return path.isEmpty() ? QStringLiteral("/") : path;
+    }
+
+    const QString &uid = QString::number(::getuid());
+    const QStringList markers {"/.Trash-" + uid + "/files", "/.Trash/" + uid + "/files"};
+
+    for (const QString &marker : markers) {
+        const int index = localPath.indexOf(marker);
+
+        if (index < 0)
+            continue;
+
+        const int files_end = index + marker.size();
+
+        if (files_end < localPath.size() && localPath.at(files_end) != '/')
+            continue;
+
+        // strip "/files"
+        const QString &trash_path = localPath.left(files_end - 6);
+
+        if (trashPath)
+            *trashPath = trash_path;
+
+        if (files_end + 1 >= localPath.size())
+            return QStringLiteral("/");
+
+        return "/" + VOLUME_TRASH_PREFIX + QFile::encodeName(trash_path).toHex() + ":" + localPath.mid(files_end + 1);
+    }
+
+    return QString();
+}
+
 #ifdef QMAKE_TARGET
 QString DFMStandardPaths::getConfigPath()
 {
@@ -26,6 +26,7 @@
 #define DFMSTANDARDPATHS_H
 
 #include <QString>
+#include <QStringList>
 #include <QStandardPaths>
 
 class DUrl;
@@ -66,6 +67,21 @@ public:
     static QString fromStandardUrl(const DUrl &standardUrl);
     static DUrl toStandardUrl(const QString &localPath);
 
+    // the trash directory (contains files/ and info/) for a file: the home trash
+    // for the volume of the home directory, $topdir/.Trash/$uid or $topdir/.Trash-$uid
+    // for other volumes, so that trashing a file is a rename. Falls back to the
+    // home trash when the volume has no usable trash directory.
+    static QString trashPathForFile(const QString &filePath, bool create = false);
+    // the home trash and the existing trash directories of the mounted volumes
+    static QStringList trashPaths();
+    // the directory the relative paths of the .trashinfo files are based on,
+    // empty for the home trash
+    static QString trashTopDir(const QString &trashPath);
+    // convert between the path of a trash url and the local file, the top level
+    // files of a volume trash are named "<prefix><hex of the trash path>:<name>"
+    static QString trashUrlPathToLocal(const QString &urlPath, QString *trashPath = nullptr);
+    static QString localToTrashUrlPath(const QString &localPath, QString *trashPath = nullptr);
+
 #ifdef QMAKE_TARGET
     static QString getConfigPath();
 #endif
@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "dfmtextlayoutcache.h"
+
+#include <QCache>
+#include <QPainter>
+#include <QStaticText>
+#include <QTextLayout>
+
+DFM_BEGIN_NAMESPACE
+
+namespace TextLayoutCache {
+struct Key
+{
+    QString text;
+    QFont font;
+    QSizeF size;
+    qreal lineHeight;
+    int wordWrap;
+    int elideMode;
+    int flags;
+
+    bool operator==(const Key &other) const
+    {
+        return text == other.text && font == other.font && size == other.size
+               && qFuzzyCompare(lineHeight, other.lineHeight) && wordWrap == other.wordWrap
+               && elideMode == other.elideMode && flags == other.flags;
+    }
+};
+
+inline uint qHash(const Key &key, uint seed = 0)
+{
+    return ::qHash(key.text, seed) ^ ::qHash(key.font, seed)
+           ^ ::qHash(qRound(key.size.width()) ^ (qRound(key.size.height()) << 16), seed)
+           ^ ::qHash((key.wordWrap << 8) | (key.elideMode << 4) | key.flags, seed);
+}
+
+struct Entry
+{
+    QStringList lines;
+    // relative to the top left of the bounding rect
+    QList<QRectF> boundingRegion;
+    // created on first paint, not needed for geometry queries
+    QVector<QStaticText> staticTexts;
+};
+}
+
+using namespace TextLayoutCache;
+
+// 8MB by default
+static const int DEFAULT_MAX_COST = 8 * 1024 * 1024;
+
+class DFMTextLayoutCachePrivate
+{
+public:
+    Entry *entry(const QString &text, const QFont &font, const QSizeF &size, qreal lineHeight,
+                 QTextOption::WrapMode wordWrap, Qt::TextElideMode mode, int flags);
+
+    QCache<Key, Entry> cache{DEFAULT_MAX_COST};
+};
+
+Entry *DFMTextLayoutCachePrivate::entry(const QString &text, const QFont &font, const QSizeF &size, qreal lineHeight,
+                                        QTextOption::WrapMode wordWrap, Qt::TextElideMode mode, int flags)
+{
+    const Key key{text, font, size, lineHeight, wordWrap, mode, flags};
+
+    if (Entry *e = cache.object(key))
+        return e;
+
+    Entry *e = new Entry();
+    QTextLayout layout(text, font);
+
+    DFMGlobal::elideText(&layout, size, wordWrap, mode, lineHeight, flags, &e->lines,
+                         nullptr, QPointF(0, 0), QColor(), QPointF(0, 1), QBrush(Qt::NoBrush),
+                         0, &e->boundingRegion);
+
+    // the QStaticText keeps the glyph indexes and positions of every char
+    int cost = sizeof(Entry) + text.size() * int(sizeof(QChar));
+
+    for (const QString &line : e->lines)
+        cost += line.size() * 32;
+
+    // the object was deleted if the cost is larger than the max cost
+    if (!cache.insert(key, e, cost))
+        return nullptr;
+
+    return e;
+}
+
+Q_GLOBAL_STATIC(DFMTextLayoutCache, tlcGlobal)
+
+DFMTextLayoutCache::DFMTextLayoutCache()
+    : d_ptr(new DFMTextLayoutCachePrivate())
+{
+
+}
+
+DFMTextLayoutCache::~DFMTextLayoutCache()
+{
+
+}
+
+DFMTextLayoutCache *DFMTextLayoutCache::instance()
+{
+    return tlcGlobal;
+}
+
+QList<QRectF> DFMTextLayoutCache::drawText(QPainter *painter, const QString &text, const QFont &font,
+                                           const QRectF &boundingRect, qreal lineHeight,
+                                           QTextOption::WrapMode wordWrap, Qt::TextElideMode mode, int flags,
+                                           qreal radius, const QBrush &background,
+                                           const QColor &shadowColor, const QPointF &shadowOffset)
+{
+    Q_D(DFMTextLayoutCache);
+
+    Entry *e = d->entry(text, font, boundingRect.size(), lineHeight, wordWrap, mode, flags);
+    QList<QRectF> boundingRegion;
+
+    if (!e) {
+        QTextLayout layout(text, font);
+
+        DFMGlobal::elideText(&layout, boundingRect.size(), wordWrap, mode, lineHeight, flags, nullptr,
+                             painter, boundingRect.topLeft(), shadowColor, shadowOffset,
+                             background, radius, &boundingRegion);
+
+        return boundingRegion;
+    }
+
+    if (e->staticTexts.isEmpty()) {
+        e->staticTexts.reserve(e->lines.size());
+
+        for (const QString &line : e->lines) {
+            QStaticText static_text(line);
+
+            static_text.setTextFormat(Qt::PlainText);
+            static_text.prepare(QTransform(), font);
+            e->staticTexts << static_text;
+        }
+    }
+
+    const bool draw_background = background.style() != Qt::NoBrush;
+    const bool draw_shadow = shadowColor.isValid();
+    QRectF last_line_rect;
+
+    for (int i = 0; i < e->boundingRegion.size(); ++i) {
+        const QRectF &rect = e->boundingRegion.at(i).translated(boundingRect.topLeft());
+
+        if (draw_background)
+            DFMGlobal::drawTextLineBackground(painter, rect, last_line_rect, radius, background);
+
+        if (draw_shadow) {
+            const QPen pen = painter->pen();
+
+            painter->setPen(shadowColor);
+            painter->drawStaticText(rect.topLeft() + shadowOffset, e->staticTexts.at(i));
+            painter->setPen(pen);
+        }
+
+        painter->drawStaticText(rect.topLeft(), e->staticTexts.at(i));
+        boundingRegion << rect;
+    }
+
+    return boundingRegion;
+}
+
+QList<QRectF> DFMTextLayoutCache::textBoundingRegion(const QString &text, const QFont &font,
+                                                     const QRectF &boundingRect, qreal lineHeight,
+                                                     QTextOption::WrapMode wordWrap, Qt::TextElideMode mode, int flags)
+{
+    Q_D(DFMTextLayoutCache);
+
+    QList<QRectF> boundingRegion;
+
+    if (Entry *e = d->entry(text, font, boundingRect.size(), lineHeight, wordWrap, mode, flags)) {
+        for (const QRectF &rect : e->boundingRegion)
+            boundingRegion << rect.translated(boundingRect.topLeft());
+    } else {
+        QTextLayout layout(text, font);
+
+        DFMGlobal::elideText(&layout, boundingRect.size(), wordWrap, mode, lineHeight, flags, nullptr,
+                             nullptr, boundingRect.topLeft(), QColor(), QPointF(0, 1),
+                             QBrush(Qt::NoBrush), 0, &boundingRegion);
+    }
+
+    return boundingRegion;
+}
+
+QString DFMTextLayoutCache::elideText(const QString &text, const QSizeF &size, QTextOption::WrapMode wordWrap,
+                                      const QFont &font, Qt::TextElideMode mode, qreal lineHeight, int flags)
+{
+    Q_D(DFMTextLayoutCache);
+
+    if (Entry *e = d->entry(text, font, size, lineHeight, wordWrap, mode, flags))
+        return e->lines.join('\n');
+
+    return DFMGlobal::elideText(text, size, wordWrap, font, mode, lineHeight, flags);
+}
+
+int DFMTextLayoutCache::maxCost() const
+{
+    Q_D(const DFMTextLayoutCache);
+
+    return d->cache.maxCost();
+}
+
+void DFMTextLayoutCache::setMaxCost(int maxCost)
+{
+    Q_D(DFMTextLayoutCache);
+
+    d->cache.setMaxCost(maxCost);
+}
+
+void DFMTextLayoutCache::clear()
+{
+    Q_D(DFMTextLayoutCache);
+
+    d->cache.clear();
+}
+
+DFM_END_NAMESPACE
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DFMTEXTLAYOUTCACHE_H
+#define DFMTEXTLAYOUTCACHE_H
+
+#include "dfmglobal.h"
+
+#include <QScopedPointer>
+
+DFM_BEGIN_NAMESPACE
+
+class DFMTextLayoutCachePrivate;
+class DFMTextLayoutCache
+{
+    Q_DECLARE_PRIVATE(DFMTextLayoutCache)
+
+public:
+    DFMTextLayoutCache();
+    ~DFMTextLayoutCache();
+
+    // shared by all item delegates, only use it in the gui thread
+    static DFMTextLayoutCache *instance();
+
+    // same as DFMGlobal::elideText(QTextLayout*...) with a painter, but the
+    // shaped lines are cached by (text, font, size, modes) and painted as QStaticText
+    QList<QRectF> drawText(QPainter *painter, const QString &text, const QFont &font,
+                           const QRectF &boundingRect, qreal lineHeight,
+                           QTextOption::WrapMode wordWrap, Qt::TextElideMode mode, int flags,
+                           qreal radius, const QBrush &background,
+                           const QColor &shadowColor = QColor(), const QPointF &shadowOffset = QPointF(0, 1));
+
+    // the geometry of the lines that drawText would paint
+    QList<QRectF> textBoundingRegion(const QString &text, const QFont &font,
+                                     const QRectF &boundingRect, qreal lineHeight,
+                                     QTextOption::WrapMode wordWrap, Qt::TextElideMode mode, int flags);
+
+    // cached version of DFMGlobal::elideText(const QString &...)
+    QString elideText(const QString &text, const QSizeF &size, QTextOption::WrapMode wordWrap,
+                      const QFont &font, Qt::TextElideMode mode, qreal lineHeight, int flags = 0);
+
+    // memory budget in bytes
+    int maxCost() const;
+    void setMaxCost(int maxCost);
+
+    void clear();
+
+private:
+    QScopedPointer<DFMTextLayoutCachePrivate> d_ptr;
+
+    Q_DISABLE_COPY(DFMTextLayoutCache)
+};
+
+DFM_END_NAMESPACE
+
+#endif // DFMTEXTLAYOUTCACHE_H
@@ -31,6 +31,7 @@
 #include "dfilesystemmodel.h"
 #include "tag/tagmanager.h"
 #include "app/define.h"
+#include "dfmtextlayoutcache.h"
 
 #include <QLabel>
 #include <QPainter>
@@ -436,9 +437,6 @@ public:
 
     QPointer<ExpandedItem> expandedItem;
 
-//    mutable QHash<QString, QString> elideMap;
-//    mutable QHash<QString, QString> wordWrapMap;
-//    mutable QHash<QString, int> textHeightMap;
     mutable QModelIndex expandedIndex;
     mutable QModelIndex lastAndExpandedInde;
 
@@ -1146,9 +1144,8 @@ void DIconItemDelegate::updateItemSizeHint()
 {
     Q_D(DIconItemDelegate);
 
-//    d->elideMap.clear();
-//    d->wordWrapMap.clear();
-//    d->textHeightMap.clear();
+    // the font or the line height may be changed
+    DFMTextLayoutCache::instance()->clear();
     d->textLineHeight = parent()->parent()->fontMetrics().height();
 
     int width = parent()->parent()->iconSize().width() + 30;
@@ -1212,6 +1209,14 @@ void DIconItemDelegate::initTextLayout(const QModelIndex &index, QTextLayout *la
     }
 }
 
+bool DIconItemDelegate::canCacheTextLayout(const QModelIndex &index) const
+{
+    const QVariantHash &ep = index.data(DFileSystemModel::ExtensionPropertys).toHash();
+
+    // the tag colors are inserted into the text document by initTextLayout
+    return qvariant_cast<QList<QColor>>(ep.value("colored")).isEmpty();
+}
+
 bool DIconItemDelegate::eventFilter(QObject *object, QEvent *event)
 {
     if (event->type() == QEvent::KeyPress) {
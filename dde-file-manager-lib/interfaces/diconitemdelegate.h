@@ -83,6 +83,7 @@ public slots:
 
 protected:
     void initTextLayout(const QModelIndex &index, QTextLayout *layout) const override;
+    bool canCacheTextLayout(const QModelIndex &index) const override;
 
     bool eventFilter(QObject *object, QEvent *event) Q_DECL_OVERRIDE;
 
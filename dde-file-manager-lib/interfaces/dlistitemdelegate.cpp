@@ -14,6 +14,7 @@
 #include "private/dstyleditemdelegate_p.h"
 #include "views/themeconfig.h"
 #include "dfmapplication.h"
+#include "dfmtextlayoutcache.h"
 
 #include <QLabel>
 #include <QPainter>
@@ -183,7 +184,7 @@ void DListItemDelegate::paint(QPainter *painter,
         const QVariant &data = index.data(role);
         painter->setPen(opt.palette.color(drawBackground ? QPalette::BrightText : QPalette::Text));
         if (data.canConvert<QString>()) {
-            const QString &file_name = DFMGlobal::elideText(index.data(role).toString().remove('\n'),
+            const QString &file_name = DFMTextLayoutCache::instance()->elideText(index.data(role).toString().remove('\n'),
                                        rect.size(), QTextOption::WrapAtWordBoundaryOrAnywhere,
                                        opt.font, Qt::ElideRight,
                                        d->textLineHeight);
@@ -227,7 +228,7 @@ void DListItemDelegate::paint(QPainter *painter,
         const QVariant &data = index.data(role);
 
         if (data.canConvert<QString>()) {
-            const QString &text = DFMGlobal::elideText(index.data(role).toString(), rect.size(),
+            const QString &text = DFMTextLayoutCache::instance()->elideText(index.data(role).toString(), rect.size(),
                                   QTextOption::NoWrap, opt.font,
                                   Qt::ElideRight, d->textLineHeight);
 
@@ -273,14 +274,14 @@ void DListItemDelegate::drawNotStringData(const QStyleOptionViewItem &opt, int l
     if (data.canConvert<QPair<QString, QString>>()) {
         QPair<QString, QString> name_path = qvariant_cast<QPair<QString, QString>>(data);
 
-        const QString &file_name = DFMGlobal::elideText(name_path.first.remove('\n'),
+        const QString &file_name = DFMTextLayoutCache::instance()->elideText(name_path.first.remove('\n'),
                                    QSize(rect.width(), rect.height() / 2), QTextOption::NoWrap,
                                    opt.font, Qt::ElideRight,
                                    lineHeight);
         painter->setPen(sortRoleIndexByColumnChildren == 0 ? active_color : normal_color);
         painter->drawText(rect.adjusted(0, 0, 0, -rect.height() / 2), Qt::AlignBottom, file_name);
 
-        const QString &file_path = DFMGlobal::elideText(name_path.second.remove('\n'),
+        const QString &file_path = DFMTextLayoutCache::instance()->elideText(name_path.second.remove('\n'),
                                    QSize(rect.width(), rect.height() / 2), QTextOption::NoWrap,
                                    opt.font, Qt::ElideRight,
                                    lineHeight);
@@ -292,7 +293,7 @@ void DListItemDelegate::drawNotStringData(const QStyleOptionViewItem &opt, int l
 
         const QPair<QString, QPair<QString, QString>> &dst = qvariant_cast<QPair<QString, QPair<QString, QString>>>(data);
 
-        const QString &date = DFMGlobal::elideText(dst.first, QSize(rect.width(), rect.height() / 2),
+        const QString &date = DFMTextLayoutCache::instance()->elideText(dst.first, QSize(rect.width(), rect.height() / 2),
                               QTextOption::NoWrap, opt.font,
                               Qt::ElideRight, lineHeight);
 
@@ -301,14 +302,14 @@ void DListItemDelegate::drawNotStringData(const QStyleOptionViewItem &opt, int l
 
         new_rect = QRect(rect.left(), rect.top(), new_rect.width(), rect.height());
 
-        const QString &size = DFMGlobal::elideText(dst.second.first, QSize(new_rect.width() / 2, new_rect.height() / 2),
+        const QString &size = DFMTextLayoutCache::instance()->elideText(dst.second.first, QSize(new_rect.width() / 2, new_rect.height() / 2),
                               QTextOption::NoWrap, opt.font,
                               Qt::ElideRight, lineHeight);
 
         painter->setPen(sortRoleIndexByColumnChildren == 1 ? active_color : normal_color);
         painter->drawText(new_rect.adjusted(0, new_rect.height() / 2, 0, 0), Qt::AlignTop | Qt::AlignLeft, size);
 
-        const QString &type = DFMGlobal::elideText(dst.second.second, QSize(new_rect.width() / 2, new_rect.height() / 2),
+        const QString &type = DFMTextLayoutCache::instance()->elideText(dst.second.second, QSize(new_rect.width() / 2, new_rect.height() / 2),
                               QTextOption::NoWrap, opt.font,
                               Qt::ElideLeft, lineHeight);
         painter->setPen(sortRoleIndexByColumnChildren == 2 ? active_color : normal_color);
@@ -519,6 +520,8 @@ void DListItemDelegate::updateItemSizeHint()
 {
     Q_D(DListItemDelegate);
 
+    DFMTextLayoutCache::instance()->clear();
+
     d->textLineHeight = parent()->parent()->fontMetrics().height();
     d->itemSizeHint = QSize(-1, qMax(int(parent()->parent()->iconSize().height() * 1.1), d->textLineHeight));
 }
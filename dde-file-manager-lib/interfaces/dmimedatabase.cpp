@@ -26,23 +26,82 @@
 #include "shutil/fileutils.h"
 
 #include <QFileInfo>
+#include <QCache>
+#include <QMutex>
+
+#include <sys/stat.h>
 
 DFM_BEGIN_NAMESPACE
 
-DMimeDatabase::DMimeDatabase()
+namespace MimeTypeCache {
+struct Key
 {
+    dev_t dev;
+    ino_t ino;
+    qint64 mtime;
+    qint64 size;
+    int mode;
 
+    bool operator==(const Key &other) const
+    {
+        return dev == other.dev && ino == other.ino && mtime == other.mtime
+               && size == other.size && mode == other.mode;
+    }
+};
+
+inline uint qHash(const Key &key, uint seed = 0)
+{
+    return ::qHash(quint64(key.ino), seed) ^ ::qHash(quint64(key.dev), seed)
+           ^ ::qHash(key.mtime ^ (key.size << 16) ^ key.mode, seed);
 }
 
-QMimeType DMimeDatabase::mimeTypeForFile(const QString &fileName, QMimeDatabase::MatchMode mode) const
+struct Cache
 {
-    QFileInfo fileInfo(fileName);
+    QMutex mutex;
+    // the names of the types, about 100 bytes for each file
+    QCache<Key, QString> types{100000};
+};
+}
 
-    // Ignore the mode argument if file is retome file
-    if (!fileInfo.isDir() && FileUtils::isGvfsMountFile(fileInfo.absoluteFilePath()))
-        return QMimeDatabase::mimeTypeForFile(fileName, QMimeDatabase::MatchExtension);
+using namespace MimeTypeCache;
+
+Q_GLOBAL_STATIC(Cache, mtcGlobal)
+
+// only the regular files are cached, the others never need to be read
+static bool cacheKey(const QFileInfo &fileInfo, QMimeDatabase::MatchMode mode, Key *key)
+{
+    struct stat st;
+
+    if (::stat(QFile::encodeName(fileInfo.absoluteFilePath()).constData(), &st) != 0 || !S_ISREG(st.st_mode))
+        return false;
+
+    key->dev = st.st_dev;
+    key->ino = st.st_ino;
+    key->mtime = qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    key->size = st.st_size;
+    key->mode = mode;
 
-    return QMimeDatabase::mimeTypeForFile(fileName, mode);
+    return true;
+}
+
+static QString cachedTypeName(const Key &key)
+{
+    QMutexLocker locker(&mtcGlobal->mutex);
+
+    if (const QString *name = mtcGlobal->types.object(key))
+        return *name;
+
+    return QString();
+}
+
+DMimeDatabase::DMimeDatabase()
+{
+
+}
+
+QMimeType DMimeDatabase::mimeTypeForFile(const QString &fileName, QMimeDatabase::MatchMode mode) const
+{
+    return mimeTypeForFile(QFileInfo(fileName), mode);
 }
 
 QMimeType DMimeDatabase::mimeTypeForFile(const QFileInfo &fileInfo, QMimeDatabase::MatchMode mode) const
@@ -51,7 +110,34 @@ QMimeType DMimeDatabase::mimeTypeForFile(const QFileInfo &fileInfo, QMimeDatabas
     if (!fileInfo.isDir() && FileUtils::isGvfsMountFile(fileInfo.absoluteFilePath()))
         return QMimeDatabase::mimeTypeForFile(fileInfo, QMimeDatabase::MatchExtension);
 
-    return QMimeDatabase::mimeTypeForFile(fileInfo, mode);
+    Key key;
+
+    if (mode == MatchExtension || !cacheKey(fileInfo, mode, &key))
+        return QMimeDatabase::mimeTypeForFile(fileInfo, mode);
+
+    const QString &name = cachedTypeName(key);
+
+    if (!name.isEmpty())
+        return mimeTypeForName(name);
+
+    QMimeType type;
+
+    if (mode == MatchDefault) {
+        // same as Qt, the name is enough if it matches only one type
+        const QList<QMimeType> &types = mimeTypesForFileName(fileInfo.fileName());
+
+        if (types.count() == 1)
+            type = types.first();
+    }
+
+    if (!type.isValid())
+        type = QMimeDatabase::mimeTypeForFile(fileInfo, mode);
+
+    QMutexLocker locker(&mtcGlobal->mutex);
+
+    mtcGlobal->types.insert(key, new QString(type.name()));
+
+    return type;
 }
 
 QMimeType DMimeDatabase::mimeTypeForUrl(const QUrl &url) const
@@ -62,4 +148,34 @@ QMimeType DMimeDatabase::mimeTypeForUrl(const QUrl &url) const
     return QMimeDatabase::mimeTypeForUrl(url);
 }
 
+QMimeType DMimeDatabase::mimeTypeForFileByName(const QFileInfo &fileInfo, bool *exact) const
+{
+    if (exact)
+        *exact = true;
+
+    if (fileInfo.isDir() || FileUtils::isGvfsMountFile(fileInfo.absoluteFilePath()))
+        return mimeTypeForFile(fileInfo);
+
+    Key key;
+
+    // the special files are detected by stat
+    if (!cacheKey(fileInfo, MatchDefault, &key))
+        return QMimeDatabase::mimeTypeForFile(fileInfo);
+
+    const QString &name = cachedTypeName(key);
+
+    if (!name.isEmpty())
+        return mimeTypeForName(name);
+
+    const QList<QMimeType> &types = mimeTypesForFileName(fileInfo.fileName());
+
+    if (types.count() == 1)
+        return types.first();
+
+    if (exact)
+        *exact = false;
+
+    return QMimeDatabase::mimeTypeForFile(fileInfo, MatchExtension);
+}
+
 DFM_END_NAMESPACE
@@ -38,9 +38,15 @@ class DMimeDatabase : public QMimeDatabase
 public:
     DMimeDatabase();
 
+    // the results of the regular files are cached by (device, inode, mtime, size) in
+    // the process, the file is only read if its name matches none or several types
     QMimeType mimeTypeForFile(const QString &fileName, MatchMode mode = MatchDefault) const;
     QMimeType mimeTypeForFile(const QFileInfo &fileInfo, MatchMode mode = MatchDefault) const;
     QMimeType mimeTypeForUrl(const QUrl &url) const;
+
+    // never reads the file, the type comes from the cache or from the file name.
+    // exact is false if the content has to be sniffed to know the type
+    QMimeType mimeTypeForFileByName(const QFileInfo &fileInfo, bool *exact = nullptr) const;
 };
 
 DFM_END_NAMESPACE
@@ -10,6 +10,7 @@
 #include "dstyleditemdelegate.h"
 #include "dfileviewhelper.h"
 #include "private/dstyleditemdelegate_p.h"
+#include "dfmtextlayoutcache.h"
 
 #include <QDebug>
 #include <QAbstractItemView>
@@ -17,6 +18,8 @@
 #include <QGuiApplication>
 #include <QThreadStorage>
 
+DFM_USE_NAMESPACE
+
 DStyledItemDelegate::DStyledItemDelegate(DFileViewHelper *parent)
     : DStyledItemDelegate(*new DStyledItemDelegatePrivate(this), parent)
 {
@@ -171,6 +174,16 @@ QList<QRectF> DStyledItemDelegate::drawText(const QModelIndex &index, QPainter *
                                             qreal radius, const QBrush &background, QTextOption::WrapMode wordWrap,
                                             Qt::TextElideMode mode, int flags, const QColor &shadowColor) const
 {
+    if (canCacheTextLayout(index)) {
+        DFMTextLayoutCache *cache = DFMTextLayoutCache::instance();
+
+        if (!painter)
+            return cache->textBoundingRegion(text, QFont(), boundingRect, d_func()->textLineHeight, wordWrap, mode, flags);
+
+        return cache->drawText(painter, text, painter->font(), boundingRect, d_func()->textLineHeight,
+                               wordWrap, mode, flags, radius, background, shadowColor);
+    }
+
     QTextLayout layout;
 
     layout.setText(text);
@@ -194,6 +207,13 @@ void DStyledItemDelegate::initTextLayout(const QModelIndex &index, QTextLayout *
     Q_UNUSED(layout)
 }
 
+bool DStyledItemDelegate::canCacheTextLayout(const QModelIndex &index) const
+{
+    Q_UNUSED(index)
+
+    return true;
+}
+
 void DStyledItemDelegate::initStyleOption(QStyleOptionViewItem *option, const QModelIndex &index) const
 {
     QStyledItemDelegate::initStyleOption(option, index);
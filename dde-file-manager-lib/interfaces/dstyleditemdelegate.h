@@ -71,6 +71,9 @@ protected:
     DStyledItemDelegate(DStyledItemDelegatePrivate &dd, DFileViewHelper *parent);
 
     virtual void initTextLayout(const QModelIndex &index, QTextLayout *layout) const;
+    // the string version of drawText shares the shaped lines through DFMTextLayoutCache,
+    // must return false for the index if initTextLayout changes its layout
+    virtual bool canCacheTextLayout(const QModelIndex &index) const;
     void initStyleOption(QStyleOptionViewItem *option, const QModelIndex &index) const Q_DECL_OVERRIDE;
     QList<QRectF> getCornerGeometryList(const QRectF &baseRect, const QSizeF &cornerSize) const;
 
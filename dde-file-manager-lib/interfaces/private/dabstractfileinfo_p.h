@@ -34,6 +34,7 @@ public:
 
     mutable QString pinyinName;
     bool active = false;
+    bool viewItem = false;
 
     DAbstractFileInfoPointer proxy;
     static DMimeDatabase mimeDatabase;
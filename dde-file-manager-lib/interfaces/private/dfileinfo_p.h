@@ -29,6 +29,8 @@ public:
     QFileInfo fileInfo;
     mutable QMimeType mimeType;
     mutable QMimeDatabase::MatchMode mimeTypeMode;
+    // the type was detected by the file name only, sniffed when the file becomes visible
+    mutable bool mimeTypeByName = false;
     mutable QIcon icon;
     mutable bool iconFromTheme = false;
     mutable QPointer<QTimer> getIconTimer;
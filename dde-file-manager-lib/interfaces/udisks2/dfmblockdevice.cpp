@@ -40,6 +40,8 @@ void DFMBlockDevice::onInterfacesAdded(const QDBusObjectPath &object_path, const
     if (path != d->dbus->path())
         return;
 
+    UDisks2::addCachedInterfaces(path, interfaces_and_properties);
+
     if (interfaces_and_properties.contains(QStringLiteral(UDISKS2_SERVICE ".Filesystem"))) {
         Q_EMIT hasFileSystemChanged(true);
     }
@@ -62,6 +64,8 @@ void DFMBlockDevice::onInterfacesRemoved(const QDBusObjectPath &object_path, con
     if (path != d->dbus->path())
         return;
 
+    UDisks2::removeCachedInterfaces(path, interfaces);
+
     for (const QString &i : interfaces) {
         if (i == QStringLiteral(UDISKS2_SERVICE ".Filesystem")) {
             Q_EMIT hasFileSystemChanged(false);
@@ -75,6 +79,10 @@ void DFMBlockDevice::onInterfacesRemoved(const QDBusObjectPath &object_path, con
 
 void DFMBlockDevice::onPropertiesChanged(const QString &interface, const QVariantMap &changed_properties)
 {
+    Q_D(DFMBlockDevice);
+
+    UDisks2::updateCachedProperties(d->dbus->path(), interface, changed_properties);
+
     if (interface.endsWith(".PartitionTable")) {
         auto begin = changed_properties.begin();
 
@@ -148,14 +156,14 @@ QList<QPair<QString, QVariantMap> > DFMBlockDevice::configuration() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->configuration();
+    return UDisks2::cachedProperty<QList<QPair<QString, QVariantMap>>>(d->dbus, QStringLiteral("Configuration"));
 }
 
 QString DFMBlockDevice::cryptoBackingDevice() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->cryptoBackingDevice().path();
+    return UDisks2::cachedProperty<QDBusObjectPath>(d->dbus, QStringLiteral("CryptoBackingDevice")).path();
 }
 
 /*!
@@ -167,14 +175,14 @@ QByteArray DFMBlockDevice::device() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->device();
+    return UDisks2::cachedProperty<QByteArray>(d->dbus, QStringLiteral("Device"));
 }
 
 qulonglong DFMBlockDevice::deviceNumber() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->deviceNumber();
+    return UDisks2::cachedProperty<qulonglong>(d->dbus, QStringLiteral("DeviceNumber"));
 }
 
 /*!
@@ -186,77 +194,77 @@ QString DFMBlockDevice::drive() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->drive().path();
+    return UDisks2::cachedProperty<QDBusObjectPath>(d->dbus, QStringLiteral("Drive")).path();
 }
 
 bool DFMBlockDevice::hintAuto() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->hintAuto();
+    return UDisks2::cachedProperty<bool>(d->dbus, QStringLiteral("HintAuto"));
 }
 
 QString DFMBlockDevice::hintIconName() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->hintIconName();
+    return UDisks2::cachedProperty<QString>(d->dbus, QStringLiteral("HintIconName"));
 }
 
 bool DFMBlockDevice::hintIgnore() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->hintIgnore();
+    return UDisks2::cachedProperty<bool>(d->dbus, QStringLiteral("HintIgnore"));
 }
 
 QString DFMBlockDevice::hintName() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->hintName();
+    return UDisks2::cachedProperty<QString>(d->dbus, QStringLiteral("HintName"));
 }
 
 bool DFMBlockDevice::hintPartitionable() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->hintPartitionable();
+    return UDisks2::cachedProperty<bool>(d->dbus, QStringLiteral("HintPartitionable"));
 }
 
 QString DFMBlockDevice::hintSymbolicIconName() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->hintSymbolicIconName();
+    return UDisks2::cachedProperty<QString>(d->dbus, QStringLiteral("HintSymbolicIconName"));
 }
 
 bool DFMBlockDevice::hintSystem() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->hintSystem();
+    return UDisks2::cachedProperty<bool>(d->dbus, QStringLiteral("HintSystem"));
 }
 
 QString DFMBlockDevice::id() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->id();
+    return UDisks2::cachedProperty<QString>(d->dbus, QStringLiteral("Id"));
 }
 
 QString DFMBlockDevice::idLabel() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->idLabel();
+    return UDisks2::cachedProperty<QString>(d->dbus, QStringLiteral("IdLabel"));
 }
 
 QString DFMBlockDevice::idType() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->idType();
+    return UDisks2::cachedProperty<QString>(d->dbus, QStringLiteral("IdType"));
 }
 
 DFMBlockDevice::FSType DFMBlockDevice::fsType() const
@@ -285,70 +293,70 @@ QString DFMBlockDevice::idUUID() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->idUUID();
+    return UDisks2::cachedProperty<QString>(d->dbus, QStringLiteral("IdUUID"));
 }
 
 QString DFMBlockDevice::idUsage() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->idUsage();
+    return UDisks2::cachedProperty<QString>(d->dbus, QStringLiteral("IdUsage"));
 }
 
 QString DFMBlockDevice::idVersion() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->idVersion();
+    return UDisks2::cachedProperty<QString>(d->dbus, QStringLiteral("IdVersion"));
 }
 
 QString DFMBlockDevice::mDRaid() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->mDRaid().path();
+    return UDisks2::cachedProperty<QDBusObjectPath>(d->dbus, QStringLiteral("MDRaid")).path();
 }
 
 QString DFMBlockDevice::mDRaidMember() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->mDRaidMember().path();
+    return UDisks2::cachedProperty<QDBusObjectPath>(d->dbus, QStringLiteral("MDRaidMember")).path();
 }
 
 QByteArray DFMBlockDevice::preferredDevice() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->preferredDevice();
+    return UDisks2::cachedProperty<QByteArray>(d->dbus, QStringLiteral("PreferredDevice"));
 }
 
 bool DFMBlockDevice::readOnly() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->readOnly();
+    return UDisks2::cachedProperty<bool>(d->dbus, QStringLiteral("ReadOnly"));
 }
 
 qulonglong DFMBlockDevice::size() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->size();
+    return UDisks2::cachedProperty<qulonglong>(d->dbus, QStringLiteral("Size"));
 }
 
 QByteArrayList DFMBlockDevice::symlinks() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->symlinks();
+    return UDisks2::cachedProperty<QByteArrayList>(d->dbus, QStringLiteral("Symlinks"));
 }
 
 QStringList DFMBlockDevice::userspaceMountOptions() const
 {
     Q_D(const DFMBlockDevice);
 
-    return d->dbus->userspaceMountOptions();
+    return UDisks2::cachedProperty<QStringList>(d->dbus, QStringLiteral("UserspaceMountOptions"));
 }
 
 bool DFMBlockDevice::hasFileSystem() const
@@ -401,10 +409,9 @@ QByteArrayList DFMBlockDevice::mountPoints() const
 
     Q_D(const DFMBlockDevice);
 
-    QDBusInterface ud2(UDISKS2_SERVICE, d->dbus->path(), "org.freedesktop.DBus.Properties", QDBusConnection::systemBus());
-    QDBusReply<QVariant> reply = ud2.call("Get", UDISKS2_SERVICE ".Filesystem", "MountPoints");
+    const QVariant &value = UDisks2::cachedProperty(d->dbus->path(), UDISKS2_SERVICE ".Filesystem", QStringLiteral("MountPoints"));
 
-    return qdbus_cast<QByteArrayList>(reply.value());
+    return qdbus_cast<QByteArrayList>(value);
 }
 
 DFMBlockDevice::PTType DFMBlockDevice::ptType() const
@@ -415,10 +422,7 @@ DFMBlockDevice::PTType DFMBlockDevice::ptType() const
         return InvalidPT;
     }
 
-    QDBusInterface ud2(UDISKS2_SERVICE, d->dbus->path(), "org.freedesktop.DBus.Properties", QDBusConnection::systemBus());
-    QDBusReply<QVariant> reply = ud2.call("Get", UDISKS2_SERVICE ".PartitionTable", "Type");
-
-    const QString &type = reply.value().toString();
+    const QString &type = UDisks2::cachedProperty(d->dbus->path(), UDISKS2_SERVICE ".PartitionTable", QStringLiteral("Type")).toString();
 
     if (type.isEmpty()) {
         return InvalidPT;
@@ -443,10 +447,9 @@ QList<QPair<QString, QVariantMap> > DFMBlockDevice::childConfiguration() const
         return QList<QPair<QString, QVariantMap>>();
     }
 
-    QDBusInterface ud2(UDISKS2_SERVICE, d->dbus->path(), "org.freedesktop.DBus.Properties", QDBusConnection::systemBus());
-    QDBusReply<QVariant> reply = ud2.call("Get", UDISKS2_SERVICE ".Encrypted", "ChildConfiguration");
+    const QVariant &value = UDisks2::cachedProperty(d->dbus->path(), UDISKS2_SERVICE ".Encrypted", QStringLiteral("ChildConfiguration"));
 
-    return qdbus_cast<QList<QPair<QString, QVariantMap>>>(reply.value());
+    return qdbus_cast<QList<QPair<QString, QVariantMap>>>(value);
 }
 
 void DFMBlockDevice::setWatchChanges(bool watchChanges)
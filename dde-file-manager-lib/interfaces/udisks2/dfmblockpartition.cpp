@@ -42,63 +42,63 @@ qulonglong DFMBlockPartition::flags() const
 {
     Q_D(const DFMBlockPartition);
 
-    return d->dbus->flags();
+    return UDisks2::cachedProperty<qulonglong>(d->dbus, QStringLiteral("Flags"));
 }
 
 bool DFMBlockPartition::isContained() const
 {
     Q_D(const DFMBlockPartition);
 
-    return d->dbus->isContained();
+    return UDisks2::cachedProperty<bool>(d->dbus, QStringLiteral("IsContained"));
 }
 
 bool DFMBlockPartition::isContainer() const
 {
     Q_D(const DFMBlockPartition);
 
-    return d->dbus->isContainer();
+    return UDisks2::cachedProperty<bool>(d->dbus, QStringLiteral("IsContainer"));
 }
 
 QString DFMBlockPartition::name() const
 {
     Q_D(const DFMBlockPartition);
 
-    return d->dbus->name();
+    return UDisks2::cachedProperty<QString>(d->dbus, QStringLiteral("Name"));
 }
 
 uint DFMBlockPartition::number() const
 {
     Q_D(const DFMBlockPartition);
 
-    return d->dbus->number();
+    return UDisks2::cachedProperty<uint>(d->dbus, QStringLiteral("Number"));
 }
 
 qulonglong DFMBlockPartition::offset() const
 {
     Q_D(const DFMBlockPartition);
 
-    return d->dbus->offset();
+    return UDisks2::cachedProperty<qulonglong>(d->dbus, QStringLiteral("Offset"));
 }
 
 qulonglong DFMBlockPartition::size() const
 {
     Q_D(const DFMBlockPartition);
 
-    return d->dbus->size();
+    return UDisks2::cachedProperty<qulonglong>(d->dbus, QStringLiteral("Size"));
 }
 
 QString DFMBlockPartition::table() const
 {
     Q_D(const DFMBlockPartition);
 
-    return d->dbus->table().path();
+    return UDisks2::cachedProperty<QDBusObjectPath>(d->dbus, QStringLiteral("Table")).path();
 }
 
 QString DFMBlockPartition::type() const
 {
     Q_D(const DFMBlockPartition);
 
-    return d->dbus->type();
+    return UDisks2::cachedProperty<QString>(d->dbus, QStringLiteral("Type"));
 }
 
 DFMBlockPartition::Type DFMBlockPartition::eType() const
@@ -122,7 +122,7 @@ QString DFMBlockPartition::UUID() const
 {
     Q_D(const DFMBlockPartition);
 
-    return d->dbus->uUID();
+    return UDisks2::cachedProperty<QString>(d->dbus, QStringLiteral("UUID"));
 }
 
 DFMBlockPartition::GUIDType DFMBlockPartition::guidType() const
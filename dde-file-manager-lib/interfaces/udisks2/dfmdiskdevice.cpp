@@ -50,147 +50,147 @@ QString DFMDiskDevice::path() const
 
 bool DFMDiskDevice::canPowerOff() const
 {
-    return d_ptr->dbus->canPowerOff();
+    return UDisks2::cachedProperty<bool>(d_ptr->dbus, QStringLiteral("CanPowerOff"));
 }
 
 QVariantMap DFMDiskDevice::configuration() const
 {
-    return d_ptr->dbus->configuration();
+    return UDisks2::cachedProperty<QVariantMap>(d_ptr->dbus, QStringLiteral("Configuration"));
 }
 
 QString DFMDiskDevice::connectionBus() const
 {
-    return d_ptr->dbus->connectionBus();
+    return UDisks2::cachedProperty<QString>(d_ptr->dbus, QStringLiteral("ConnectionBus"));
 }
 
 bool DFMDiskDevice::ejectable() const
 {
-    return d_ptr->dbus->ejectable();
+    return UDisks2::cachedProperty<bool>(d_ptr->dbus, QStringLiteral("Ejectable"));
 }
 
 QString DFMDiskDevice::id() const
 {
-    return d_ptr->dbus->id();
+    return UDisks2::cachedProperty<QString>(d_ptr->dbus, QStringLiteral("Id"));
 }
 
 QString DFMDiskDevice::media() const
 {
-    return d_ptr->dbus->media();
+    return UDisks2::cachedProperty<QString>(d_ptr->dbus, QStringLiteral("Media"));
 }
 
 bool DFMDiskDevice::mediaAvailable() const
 {
-    return d_ptr->dbus->mediaAvailable();
+    return UDisks2::cachedProperty<bool>(d_ptr->dbus, QStringLiteral("MediaAvailable"));
 }
 
 bool DFMDiskDevice::mediaChangeDetected() const
 {
-    return d_ptr->dbus->mediaChangeDetected();
+    return UDisks2::cachedProperty<bool>(d_ptr->dbus, QStringLiteral("MediaChangeDetected"));
 }
 
 QStringList DFMDiskDevice::mediaCompatibility() const
 {
-    return d_ptr->dbus->mediaCompatibility();
+    return UDisks2::cachedProperty<QStringList>(d_ptr->dbus, QStringLiteral("MediaCompatibility"));
 }
 
 bool DFMDiskDevice::mediaRemovable() const
 {
-    return d_ptr->dbus->mediaRemovable();
+    return UDisks2::cachedProperty<bool>(d_ptr->dbus, QStringLiteral("MediaRemovable"));
 }
 
 QString DFMDiskDevice::model() const
 {
-    return d_ptr->dbus->model();
+    return UDisks2::cachedProperty<QString>(d_ptr->dbus, QStringLiteral("Model"));
 }
 
 bool DFMDiskDevice::optical() const
 {
-    return d_ptr->dbus->optical();
+    return UDisks2::cachedProperty<bool>(d_ptr->dbus, QStringLiteral("Optical"));
 }
 
 bool DFMDiskDevice::opticalBlank() const
 {
-    return d_ptr->dbus->opticalBlank();
+    return UDisks2::cachedProperty<bool>(d_ptr->dbus, QStringLiteral("OpticalBlank"));
 }
 
 uint DFMDiskDevice::opticalNumAudioTracks() const
 {
-    return d_ptr->dbus->opticalNumAudioTracks();
+    return UDisks2::cachedProperty<uint>(d_ptr->dbus, QStringLiteral("OpticalNumAudioTracks"));
 }
 
 uint DFMDiskDevice::opticalNumDataTracks() const
 {
-    return d_ptr->dbus->opticalNumDataTracks();
+    return UDisks2::cachedProperty<uint>(d_ptr->dbus, QStringLiteral("OpticalNumDataTracks"));
 }
 
 uint DFMDiskDevice::opticalNumSessions() const
 {
-    return d_ptr->dbus->opticalNumSessions();
+    return UDisks2::cachedProperty<uint>(d_ptr->dbus, QStringLiteral("OpticalNumSessions"));
 }
 
 uint DFMDiskDevice::opticalNumTracks() const
 {
-    return d_ptr->dbus->opticalNumTracks();
+    return UDisks2::cachedProperty<uint>(d_ptr->dbus, QStringLiteral("OpticalNumTracks"));
 }
 
 bool DFMDiskDevice::removable() const
 {
-    return d_ptr->dbus->removable();
+    return UDisks2::cachedProperty<bool>(d_ptr->dbus, QStringLiteral("Removable"));
 }
 
 QString DFMDiskDevice::revision() const
 {
-    return d_ptr->dbus->revision();
+    return UDisks2::cachedProperty<QString>(d_ptr->dbus, QStringLiteral("Revision"));
 }
 
 int DFMDiskDevice::rotationRate() const
 {
-    return d_ptr->dbus->rotationRate();
+    return UDisks2::cachedProperty<int>(d_ptr->dbus, QStringLiteral("RotationRate"));
 }
 
 QString DFMDiskDevice::seat() const
 {
-    return d_ptr->dbus->seat();
+    return UDisks2::cachedProperty<QString>(d_ptr->dbus, QStringLiteral("Seat"));
 }
 
 QString DFMDiskDevice::serial() const
 {
-    return d_ptr->dbus->serial();
+    return UDisks2::cachedProperty<QString>(d_ptr->dbus, QStringLiteral("Serial"));
 }
 
 QString DFMDiskDevice::siblingId() const
 {
-    return d_ptr->dbus->siblingId();
+    return UDisks2::cachedProperty<QString>(d_ptr->dbus, QStringLiteral("SiblingId"));
 }
 
 qulonglong DFMDiskDevice::size() const
 {
-    return d_ptr->dbus->size();
+    return UDisks2::cachedProperty<qulonglong>(d_ptr->dbus, QStringLiteral("Size"));
 }
 
 QString DFMDiskDevice::sortKey() const
 {
-    return d_ptr->dbus->sortKey();
+    return UDisks2::cachedProperty<QString>(d_ptr->dbus, QStringLiteral("SortKey"));
 }
 
 qulonglong DFMDiskDevice::timeDetected() const
 {
-    return d_ptr->dbus->timeDetected();
+    return UDisks2::cachedProperty<qulonglong>(d_ptr->dbus, QStringLiteral("TimeDetected"));
 }
 
 qulonglong DFMDiskDevice::timeMediaDetected() const
 {
-    return d_ptr->dbus->timeMediaDetected();
+    return UDisks2::cachedProperty<qulonglong>(d_ptr->dbus, QStringLiteral("TimeMediaDetected"));
 }
 
 QString DFMDiskDevice::vendor() const
 {
-    return d_ptr->dbus->vendor();
+    return UDisks2::cachedProperty<QString>(d_ptr->dbus, QStringLiteral("Vendor"));
 }
 
 QString DFMDiskDevice::WWN() const
 {
-    return d_ptr->dbus->wWN();
+    return UDisks2::cachedProperty<QString>(d_ptr->dbus, QStringLiteral("WWN"));
 }
 
 void DFMDiskDevice::eject(const QVariantMap &options)
@@ -56,27 +56,14 @@ void DFMDiskManagerPrivate::updateBlockDeviceMountPointsMap()
 {
     blockDeviceMountPointsMap.clear();
 
-    auto om = UDisks2::objectManager();
-    const QMap<QDBusObjectPath, QMap<QString, QVariantMap>> &objects = om->GetManagedObjects().value();
-    auto begin = objects.constBegin();
-
-    while (begin != objects.constEnd()) {
-        const QString path = begin.key().path();
-        const QMap<QString, QVariantMap> object = begin.value();
-
-        ++begin;
-
-        if (!path.startsWith(QStringLiteral("/org/freedesktop/UDisks2/block_devices/"))) {
+    for (const QString &path : UDisks2::cachedObjectPaths(QStringLiteral("/org/freedesktop/UDisks2/block_devices"))) {
+        if (!UDisks2::interfaceIsExistes(path, UDISKS2_SERVICE ".Filesystem")) {
             continue;
         }
 
-        const QVariantMap &filesystem = object.value(QStringLiteral(UDISKS2_SERVICE ".Filesystem"));
-
-        if (filesystem.isEmpty()) {
-            continue;
-        }
+        const QVariant &mount_points = UDisks2::cachedProperty(path, UDISKS2_SERVICE ".Filesystem", QStringLiteral("MountPoints"));
 
-        blockDeviceMountPointsMap[path] = qdbus_cast<QByteArrayList>(filesystem.value("MountPoints"));
+        blockDeviceMountPointsMap[path] = qdbus_cast<QByteArrayList>(mount_points);
     }
 }
 
@@ -84,6 +71,9 @@ void DFMDiskManager::onInterfacesAdded(const QDBusObjectPath &object_path, const
 {
     const QString &path = object_path.path();
     const QString &path_drive = QStringLiteral("/org/freedesktop/UDisks2/drives/");
+
+    UDisks2::addCachedInterfaces(path, interfaces_and_properties);
+
     const QString &path_device = QStringLiteral("/org/freedesktop/UDisks2/block_devices/");
 
     if (path.startsWith(path_drive)) {
@@ -109,6 +99,8 @@ void DFMDiskManager::onInterfacesRemoved(const QDBusObjectPath &object_path, con
 {
     const QString &path = object_path.path();
 
+    UDisks2::removeCachedInterfaces(path, interfaces);
+
     for (const QString &i : interfaces) {
         if (i == QStringLiteral(UDISKS2_SERVICE ".Drive")) {
             Q_EMIT diskDeviceRemoved(path);
@@ -128,6 +120,8 @@ void DFMDiskManager::onPropertiesChanged(const QString &interface, const QVarian
 {
     Q_D(DFMDiskManager);
 
+    UDisks2::updateCachedProperties(message.path(), interface, changed_properties);
+
     if (interface != UDISKS2_SERVICE ".Filesystem") {
         return;
     }
@@ -174,37 +168,26 @@ DFMDiskManager::~DFMDiskManager()
 
 }
 
-static QStringList getDBusNodeNameList(const QString &service, const QString &path, const QDBusConnection &connection)
+QStringList DFMDiskManager::blockDevices() const
 {
-    QDBusInterface ud2(service, path, "org.freedesktop.DBus.Introspectable", connection);
-    QDBusReply<QString> reply = ud2.call("Introspect");
-    QXmlStreamReader xml_parser(reply.value());
-    QStringList nodeList;
-
-    while (!xml_parser.atEnd()) {
-        xml_parser.readNext();
-
-        if (xml_parser.tokenType() == QXmlStreamReader::StartElement
-                && xml_parser.name().toString() == "node") {
-            const QString &name = xml_parser.attributes().value("name").toString();
-
-            if (!name.isEmpty()) {
-                nodeList << path + "/" + name;
-            }
-        }
-    }
-
-    return nodeList;
+    return UDisks2::cachedObjectPaths(QStringLiteral("/org/freedesktop/UDisks2/block_devices"));
 }
 
-QStringList DFMDiskManager::blockDevices() const
+QStringList DFMDiskManager::diskDevices() const
 {
-    return getDBusNodeNameList(UDISKS2_SERVICE, "/org/freedesktop/UDisks2/block_devices", QDBusConnection::systemBus());
+    return UDisks2::cachedObjectPaths(QStringLiteral("/org/freedesktop/UDisks2/drives"));
 }
 
-QStringList DFMDiskManager::diskDevices() const
+/*!
+ * \brief The number of synchronous calls made to udisksd by DFMBlockDevice,
+ * DFMBlockPartition, DFMDiskDevice and DFMDiskManager.
+ *
+ * Their properties are served from a local mirror, compare the value before
+ * and after a refresh to get how many bus round-trips the refresh costs.
+ */
+quint64 DFMDiskManager::busCallCount()
 {
-    return getDBusNodeNameList(UDISKS2_SERVICE, "/org/freedesktop/UDisks2/drives", QDBusConnection::systemBus());
+    return UDisks2::busCallCount();
 }
 
 bool DFMDiskManager::watchChanges() const
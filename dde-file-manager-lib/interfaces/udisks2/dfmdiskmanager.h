@@ -57,6 +57,7 @@ public:
     static DFMDiskDevice *createDiskDevice(const QString &path, QObject *parent = nullptr);
 
     static QDBusError lastError();
+    static quint64 busCallCount();
 
 public Q_SLOTS:
     void setWatchChanges(bool watchChanges);
@@ -25,16 +25,218 @@
 #include <QDBusArgument>
 #include <QDBusInterface>
 #include <QDBusConnection>
+#include <QDBusMessage>
 #include <QDBusReply>
 #include <QXmlStreamReader>
+#include <QCoreApplication>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QDebug>
+
+#include <functional>
 
 DFM_BEGIN_NAMESPACE
 
 namespace UDisks2 {
 Q_GLOBAL_STATIC_WITH_ARGS(OrgFreedesktopDBusObjectManagerInterface, omGlobal, (UDISKS2_SERVICE, "/org/freedesktop/UDisks2", QDBusConnection::systemBus()))
 
+class PropertyCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    PropertyCache();
+
+    void ensureLoaded();
+
+    void addInterfaces(const QString &path, const QMap<QString, QVariantMap> &interfacesAndProperties);
+    void removeInterfaces(const QString &path, const QStringList &interfaces);
+    void updateProperties(const QString &path, const QString &interface,
+                          const QVariantMap &changedProperties, const QStringList &invalidatedProperties);
+    // the changes received before the objects are loaded are applied after them,
+    // otherwise they are lost or overwritten by the older objects
+    void applyChange(const std::function<void()> &change);
+
+    QReadWriteLock lock;
+    // object path -> interface -> property -> value
+    QHash<QString, QMap<QString, QVariantMap>> objects;
+    QAtomicInteger<quint64> busCalls;
+
+private Q_SLOTS:
+    void onInterfacesAdded(const QDBusObjectPath &object_path, const QMap<QString, QVariantMap> &interfaces_and_properties);
+    void onInterfacesRemoved(const QDBusObjectPath &object_path, const QStringList &interfaces);
+    void onPropertiesChanged(const QString &interface, const QVariantMap &changed_properties,
+                             const QStringList &invalidated_properties, const QDBusMessage &message);
+
+private:
+    QMutex loadMutex;
+    QAtomicInt loaded;
+    QMutex pendingMutex;
+    QList<std::function<void()>> pendingChanges;
+};
+
+Q_GLOBAL_STATIC(PropertyCache, pcGlobal)
+
+PropertyCache::PropertyCache()
+{
+    // the signals must be received even if the first user is a short lived thread
+    if (QCoreApplication::instance())
+        moveToThread(QCoreApplication::instance()->thread());
+}
+
+void PropertyCache::ensureLoaded()
+{
+    if (loaded.loadAcquire())
+        return;
+
+    QMutexLocker locker(&loadMutex);
+
+    if (loaded.load())
+        return;
+
+    OrgFreedesktopDBusObjectManagerInterface *object_manager = objectManager();
+
+    // connect before fetching the objects, otherwise a change between them is lost
+    connect(object_manager, &OrgFreedesktopDBusObjectManagerInterface::InterfacesAdded,
+            this, &PropertyCache::onInterfacesAdded);
+    connect(object_manager, &OrgFreedesktopDBusObjectManagerInterface::InterfacesRemoved,
+            this, &PropertyCache::onInterfacesRemoved);
+    QDBusConnection::systemBus().connect(UDISKS2_SERVICE, QString(), "org.freedesktop.DBus.Properties", "PropertiesChanged",
+                                         this, SLOT(onPropertiesChanged(const QString &, const QVariantMap &, const QStringList &, const QDBusMessage &)));
+
+    busCalls.fetchAndAddRelaxed(1);
+
+    QDBusPendingReply<QMap<QDBusObjectPath, QMap<QString, QVariantMap>>> reply = object_manager->GetManagedObjects();
+
+    reply.waitForFinished();
+
+    if (reply.isError()) {
+        // every property will be read from the bus
+        qWarning() << "Failed to get the udisks2 objects:" << reply.error().message();
+    } else {
+        const QMap<QDBusObjectPath, QMap<QString, QVariantMap>> &managed_objects = reply.value();
+        QWriteLocker write_locker(&lock);
+
+        for (auto begin = managed_objects.constBegin(); begin != managed_objects.constEnd(); ++begin) {
+            objects[begin.key().path()] = begin.value();
+        }
+    }
+
+    QMutexLocker pending_locker(&pendingMutex);
+
+    for (const std::function<void()> &change : pendingChanges) {
+        change();
+    }
+
+    pendingChanges.clear();
+    loaded.storeRelease(1);
+}
+
+void PropertyCache::applyChange(const std::function<void()> &change)
+{
+    QMutexLocker locker(&pendingMutex);
+
+    if (!loaded.loadAcquire()) {
+        pendingChanges << change;
+
+        return;
+    }
+
+    locker.unlock();
+    change();
+}
+
+void PropertyCache::addInterfaces(const QString &path, const QMap<QString, QVariantMap> &interfacesAndProperties)
+{
+    QWriteLocker locker(&lock);
+    QMap<QString, QVariantMap> &object = objects[path];
+
+    for (auto begin = interfacesAndProperties.constBegin(); begin != interfacesAndProperties.constEnd(); ++begin) {
+        object[begin.key()] = begin.value();
+    }
+}
+
+void PropertyCache::removeInterfaces(const QString &path, const QStringList &interfaces)
+{
+    QWriteLocker locker(&lock);
+    auto object = objects.find(path);
+
+    if (object == objects.end())
+        return;
+
+    for (const QString &i : interfaces) {
+        object->remove(i);
+    }
+
+    if (object->isEmpty())
+        objects.erase(object);
+}
+
+void PropertyCache::updateProperties(const QString &path, const QString &interface,
+                                     const QVariantMap &changedProperties, const QStringList &invalidatedProperties)
+{
+    QWriteLocker locker(&lock);
+    auto object = objects.find(path);
+
+    // not a managed object, or it was removed already
+    if (object == objects.end())
+        return;
+
+    QVariantMap &properties = (*object)[interface];
+
+    for (auto begin = changedProperties.constBegin(); begin != changedProperties.constEnd(); ++begin) {
+        properties[begin.key()] = begin.value();
+    }
+
+    for (const QString &name : invalidatedProperties) {
+        properties.remove(name);
+    }
+}
+
+void PropertyCache::onInterfacesAdded(const QDBusObjectPath &object_path, const QMap<QString, QVariantMap> &interfaces_and_properties)
+{
+    const QString &path = object_path.path();
+
+    applyChange([this, path, interfaces_and_properties] {
+        addInterfaces(path, interfaces_and_properties);
+    });
+}
+
+void PropertyCache::onInterfacesRemoved(const QDBusObjectPath &object_path, const QStringList &interfaces)
+{
+    const QString &path = object_path.path();
+
+    applyChange([this, path, interfaces] {
+        removeInterfaces(path, interfaces);
+    });
+}
+
+void PropertyCache::onPropertiesChanged(const QString &interface, const QVariantMap &changed_properties,
+                                        const QStringList &invalidated_properties, const QDBusMessage &message)
+{
+    const QString &path = message.path();
+
+    applyChange([this, path, interface, changed_properties, invalidated_properties] {
+        updateProperties(path, interface, changed_properties, invalidated_properties);
+    });
+}
+
 bool interfaceIsExistes(const QString &path, const QString &interface)
 {
+    PropertyCache *cache = pcGlobal;
+
+    cache->ensureLoaded();
+
+    {
+        QReadLocker locker(&cache->lock);
+        auto object = cache->objects.constFind(path);
+
+        if (object != cache->objects.constEnd())
+            return object->contains(interface);
+    }
+
+    cache->busCalls.fetchAndAddRelaxed(1);
+
     QDBusInterface ud2(UDISKS2_SERVICE, path, "org.freedesktop.DBus.Introspectable", QDBusConnection::systemBus());
     QDBusReply<QString> reply = ud2.call("Introspect");
     QXmlStreamReader xml_parser(reply.value());
@@ -69,6 +271,92 @@ OrgFreedesktopDBusObjectManagerInterface *objectManager()
 
     return omGlobal;
 }
+
+QVariant cachedProperty(const QString &path, const QString &interface, const QString &name)
+{
+    PropertyCache *cache = pcGlobal;
+
+    cache->ensureLoaded();
+
+    {
+        QReadLocker locker(&cache->lock);
+        auto object = cache->objects.constFind(path);
+
+        if (object != cache->objects.constEnd()) {
+            auto properties = object->constFind(interface);
+
+            // the object does not implement the interface
+            if (properties == object->constEnd())
+                return QVariant();
+
+            auto value = properties->constFind(name);
+
+            if (value != properties->constEnd())
+                return value.value();
+        }
+    }
+
+    cache->busCalls.fetchAndAddRelaxed(1);
+
+    QDBusMessage message = QDBusMessage::createMethodCall(UDISKS2_SERVICE, path, "org.freedesktop.DBus.Properties", "Get");
+
+    message << interface << name;
+
+    QDBusReply<QVariant> reply = QDBusConnection::systemBus().call(message);
+
+    if (!reply.isValid())
+        return QVariant();
+
+    // keep it until the next PropertiesChanged, only for the objects the mirror follows
+    cache->updateProperties(path, interface, QVariantMap {{name, reply.value()}}, QStringList());
+
+    return reply.value();
+}
+
+QStringList cachedObjectPaths(const QString &parentPath)
+{
+    PropertyCache *cache = pcGlobal;
+
+    cache->ensureLoaded();
+
+    const QString &prefix = parentPath.endsWith('/') ? parentPath : parentPath + '/';
+    QStringList paths;
+    QReadLocker locker(&cache->lock);
+
+    for (auto begin = cache->objects.constBegin(); begin != cache->objects.constEnd(); ++begin) {
+        if (begin.key().startsWith(prefix))
+            paths << begin.key();
+    }
+
+    paths.sort();
+
+    return paths;
+}
+
+void updateCachedProperties(const QString &path, const QString &interface,
+                            const QVariantMap &changedProperties, const QStringList &invalidatedProperties)
+{
+    PropertyCache *cache = pcGlobal;
+
+    cache->applyChange([cache, path, interface, changedProperties, invalidatedProperties] {
+        cache->updateProperties(path, interface, changedProperties, invalidatedProperties);
+    });
+}
+
+void addCachedInterfaces(const QString &path, const QMap<QString, QVariantMap> &interfacesAndProperties)
+{
+    pcGlobal->addInterfaces(path, interfacesAndProperties);
+}
+
+void removeCachedInterfaces(const QString &path, const QStringList &interfaces)
+{
+    pcGlobal->removeInterfaces(path, interfaces);
+}
+
+quint64 busCallCount()
+{
+    return pcGlobal->busCalls.load();
+}
 }
 
 DFM_END_NAMESPACE
@@ -132,3 +420,5 @@ const QDBusArgument &operator>>(const QDBusArgument &argument, dde_file_manager:
 
     return argument;
 }
+
+#include "udisks2_dbus_common.moc"
@@ -23,14 +23,12 @@
 
 #include <dfmglobal.h>
 
+#include <QDBusAbstractInterface>
+#include <QDBusArgument>
 #include <QDBusObjectPath>
 #include <QString>
 #include <QVariantMap>
 
-QT_BEGIN_NAMESPACE
-class QDBusArgument;
-QT_END_NAMESPACE
-
 class OrgFreedesktopDBusObjectManagerInterface;
 
 #define UDISKS2_SERVICE "org.freedesktop.UDisks2"
@@ -68,6 +66,33 @@ struct ActiveDeviceInfo
 
 bool interfaceIsExistes(const QString &path, const QString &interface);
 OrgFreedesktopDBusObjectManagerInterface *objectManager();
+
+// A process wide mirror of the interfaces and properties of all udisks2 objects.
+// It is filled by one GetManagedObjects() call and then follows InterfacesAdded,
+// InterfacesRemoved and PropertiesChanged, so reading a property from it costs
+// no bus round-trip. interfaceIsExistes() is answered from the mirror as well.
+// A property that is not in the mirror (invalidated, or the object is unknown)
+// is read from the bus.
+QVariant cachedProperty(const QString &path, const QString &interface, const QString &name);
+QStringList cachedObjectPaths(const QString &parentPath);
+
+// let the receivers of the udisks2 signals update the mirror before they read it,
+// the order in which the slots of one D-Bus signal are invoked is undefined
+void updateCachedProperties(const QString &path, const QString &interface,
+                            const QVariantMap &changedProperties, const QStringList &invalidatedProperties = QStringList());
+void addCachedInterfaces(const QString &path, const QMap<QString, QVariantMap> &interfacesAndProperties);
+void removeCachedInterfaces(const QString &path, const QStringList &interfaces);
+
+// the number of synchronous calls made to udisksd, compare it before and after
+// a refresh of the UI to get the cost of the refresh
+quint64 busCallCount();
+
+template<typename T>
+inline T cachedProperty(const QDBusAbstractInterface *dbus, const QString &name)
+{
+    // the values of GetManagedObjects() are QDBusArgument for the container types
+    return qdbus_cast<T>(cachedProperty(dbus->path(), dbus->interface(), name));
+}
 }
 DFM_END_NAMESPACE
 
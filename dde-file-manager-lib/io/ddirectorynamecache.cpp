@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ddirectorynamecache.h"
+#include "dfilewatcher.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <QCoreApplication>
+#include <QTimer>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+DFM_BEGIN_NAMESPACE
+
+// the directories of the last completions
+#define MAX_CACHED_DIRECTORIES 32
+// the names read so far are shown after it, so a huge directory does not hold up the first completion
+#define KEYSTROKE_BUDGET 100
+// the names are handed over to the gui thread after every so many entries
+#define PARTIAL_NAMES_BATCH 256
+
+Q_GLOBAL_STATIC(DDirectoryNameCache, dncGlobal)
+
+DDirectoryNameCache::DDirectoryNameCache(QObject *parent)
+    : QObject(parent)
+{
+    // the file watchers must not outlive the application
+    if (qApp)
+        connect(qApp, &QCoreApplication::aboutToQuit, this, &DDirectoryNameCache::clear);
+}
+
+DDirectoryNameCache::~DDirectoryNameCache()
+{
+
+}
+
+DDirectoryNameCache *DDirectoryNameCache::instance()
+{
+    return dncGlobal;
+}
+
+bool DDirectoryNameCache::cachedNames(const QString &dirPath, QStringList *names)
+{
+    auto it = m_entries.constFind(dirPath);
+
+    if (it == m_entries.constEnd())
+        return false;
+
+    m_lru.removeOne(dirPath);
+    m_lru << dirPath;
+
+    if (names)
+        *names = it.value().names;
+
+    return true;
+}
+
+void DDirectoryNameCache::requestNames(const QString &dirPath)
+{
+    if (m_pending.contains(dirPath))
+        return;
+
+    // watch before reading, so the changes during the read are not lost.
+    // A directory can not be cached if its changes are unknown, it is read anyway
+    DAbstractFileWatcher *watcher = createWatcher(dirPath);
+    QFutureWatcher<QStringList> *future = new QFutureWatcher<QStringList>(this);
+    QSharedPointer<PartialNames> partial(new PartialNames);
+
+    m_pending[dirPath] = Pending{future, watcher, {}, partial};
+
+    QTimer::singleShot(KEYSTROKE_BUDGET, future, [this, future, dirPath, partial] {
+        if (future->isFinished())
+            return;
+
+        QMutexLocker locker(&partial->mutex);
+        const QStringList names = partial->names;
+
+        locker.unlock();
+
+        if (!names.isEmpty())
+            Q_EMIT namesFound(dirPath, names);
+    });
+
+    connect(future, &QFutureWatcher<QStringList>::finished, this, [this, future, dirPath] {
+        future->deleteLater();
+
+        auto it = m_pending.find(dirPath);
+
+        // the directory was removed while reading
+        if (it == m_pending.end() || it.value().future != future)
+            return;
+
+        const Pending pending = it.value();
+        QStringList names = future->result();
+
+        m_pending.erase(it);
+
+        // a change may or may not be in the names that were read, both give the same result
+        for (const QPair<QString, bool> &change : pending.changes) {
+            names.removeAll(change.first);
+
+            if (change.second)
+                names << change.first;
+        }
+
+        if (pending.watcher)
+            insert(dirPath, names, pending.watcher);
+
+        Q_EMIT namesReady(dirPath, names);
+    });
+
+    future->setFuture(QtConcurrent::run([dirPath, partial] {
+        return readNames(dirPath, partial.data());
+    }));
+}
+
+QStringList DDirectoryNameCache::readNames(const QString &dirPath)
+{
+    return readNames(dirPath, nullptr);
+}
+
+QStringList DDirectoryNameCache::readNames(const QString &dirPath, PartialNames *partial)
+{
+    QStringList names;
+    DIR *dir = ::opendir(QFile::encodeName(dirPath).constData());
+
+    if (!dir)
+        return names;
+
+    const int dir_fd = ::dirfd(dir);
+    int scanned = 0;
+    int published = 0;
+
+    while (struct dirent *entry = ::readdir(dir)) {
+        if (entry->d_name[0] == '.' && (entry->d_name[1] == 0 || (entry->d_name[1] == '.' && entry->d_name[2] == 0)))
+            continue;
+
+        bool is_dir = entry->d_type == DT_DIR;
+
+        // follow the symlinks like QDir::Dirs, and some file systems do not fill d_type
+        if (entry->d_type == DT_LNK || entry->d_type == DT_UNKNOWN) {
+            struct stat st;
+
+            is_dir = ::fstatat(dir_fd, entry->d_name, &st, 0) == 0 && S_ISDIR(st.st_mode);
+        }
+
+        if (is_dir)
+            names << QFile::decodeName(entry->d_name);
+
+        if (partial && ++scanned % PARTIAL_NAMES_BATCH == 0 && names.count() > published) {
+            QMutexLocker locker(&partial->mutex);
+
+            partial->names << names.mid(published);
+            published = names.count();
+        }
+    }
+
+    ::closedir(dir);
+
+    return names;
+}
+
+DAbstractFileWatcher *DDirectoryNameCache::createWatcher(const QString &dirPath)
+{
+    DAbstractFileWatcher *watcher = new DFileWatcher(dirPath, this);
+
+    if (!watcher->startWatcher()) {
+        delete watcher;
+
+        return nullptr;
+    }
+
+    const QString &dir_path = QDir::cleanPath(dirPath);
+
+    auto in_directory = [dir_path] (const DUrl &url) {
+        return QFileInfo(url.toLocalFile()).absolutePath() == dir_path;
+    };
+
+    connect(watcher, &DAbstractFileWatcher::subfileCreated, this, [this, dirPath, in_directory] (const DUrl &url) {
+        if (in_directory(url))
+            onSubfileChanged(dirPath, url.fileName(), true);
+    });
+    connect(watcher, &DAbstractFileWatcher::fileDeleted, this, [this, dirPath, dir_path, in_directory] (const DUrl &url) {
+        if (QDir::cleanPath(url.toLocalFile()) == dir_path)
+            invalidate(dirPath);
+        else if (in_directory(url))
+            onSubfileChanged(dirPath, url.fileName(), false);
+    });
+    connect(watcher, &DAbstractFileWatcher::fileMoved, this, [this, dirPath, dir_path, in_directory] (const DUrl &from, const DUrl &to) {
+        if (QDir::cleanPath(from.toLocalFile()) == dir_path) {
+            invalidate(dirPath);
+
+            return;
+        }
+
+        if (in_directory(from))
+            onSubfileChanged(dirPath, from.fileName(), false);
+
+        if (in_directory(to))
+            onSubfileChanged(dirPath, to.fileName(), true);
+    });
+
+    return watcher;
+}
+
+void DDirectoryNameCache::onSubfileChanged(const QString &dirPath, const QString &name, bool added)
+{
+    // only the directories are cached
+    if (added && !QFileInfo(dirPath + "/" + name).isDir())
+        return;
+
+    auto pending = m_pending.find(dirPath);
+
+    if (pending != m_pending.end()) {
+        pending.value().changes << qMakePair(name, added);
+
+        return;
+    }
+
+    auto it = m_entries.find(dirPath);
+
+    if (it == m_entries.end())
+        return;
+
+    it.value().names.removeAll(name);
+
+    if (added)
+        it.value().names << name;
+}
+
+void DDirectoryNameCache::insert(const QString &dirPath, const QStringList &names, DAbstractFileWatcher *watcher)
+{
+    invalidate(dirPath);
+
+    m_entries[dirPath] = Entry{names, watcher};
+    m_lru << dirPath;
+
+    while (m_lru.count() > MAX_CACHED_DIRECTORIES)
+        invalidate(m_lru.first());
+}
+
+void DDirectoryNameCache::invalidate(const QString &dirPath)
+{
+    auto pending = m_pending.find(dirPath);
+
+    // the result of the read is dropped
+    if (pending != m_pending.end()) {
+        if (pending.value().watcher)
+            pending.value().watcher->deleteLater();
+
+        m_pending.erase(pending);
+    }
+
+    auto it = m_entries.find(dirPath);
+
+    if (it == m_entries.end())
+        return;
+
+    // called from a signal of the watcher
+    it.value().watcher->deleteLater();
+    m_entries.erase(it);
+    m_lru.removeOne(dirPath);
+}
+
+void DDirectoryNameCache::clear()
+{
+    for (const Entry &entry : m_entries)
+        delete entry.watcher;
+
+    for (const Pending &pending : m_pending)
+        delete pending.watcher;
+
+    m_entries.clear();
+    m_pending.clear();
+    m_lru.clear();
+}
+
+DFM_END_NAMESPACE
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DDIRECTORYNAMECACHE_H
+#define DDIRECTORYNAMECACHE_H
+
+#include "dfmglobal.h"
+
+#include <QObject>
+#include <QHash>
+#include <QStringList>
+#include <QMutex>
+#include <QSharedPointer>
+
+class DAbstractFileWatcher;
+
+QT_BEGIN_NAMESPACE
+template <typename T> class QFutureWatcher;
+QT_END_NAMESPACE
+
+DFM_BEGIN_NAMESPACE
+
+class DDirectoryNameCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DDirectoryNameCache(QObject *parent = nullptr);
+    ~DDirectoryNameCache();
+
+    // only use it in the gui thread
+    static DDirectoryNameCache *instance();
+
+    // the names of the sub directories, returns false if they are not cached
+    bool cachedNames(const QString &dirPath, QStringList *names);
+    // read the names in a thread, they are cached until the directory changes.
+    // A directory which can not be watched is read but not cached
+    void requestNames(const QString &dirPath);
+
+    // the names of the sub directories (and the symlinks to directories) by the
+    // d_type of the entries, no file info is created. It is thread safe.
+    static QStringList readNames(const QString &dirPath);
+
+Q_SIGNALS:
+    // the names read so far, if the read takes longer than a keystroke
+    void namesFound(const QString &dirPath, const QStringList &names);
+    // all names, including the ones of namesFound
+    void namesReady(const QString &dirPath, const QStringList &names);
+
+private:
+    // the names are appended while the directory is read
+    struct PartialNames {
+        QMutex mutex;
+        QStringList names;
+    };
+
+    static QStringList readNames(const QString &dirPath, PartialNames *partial);
+
+    DAbstractFileWatcher *createWatcher(const QString &dirPath);
+    void onSubfileChanged(const QString &dirPath, const QString &name, bool added);
+    void insert(const QString &dirPath, const QStringList &names, DAbstractFileWatcher *watcher);
+    void invalidate(const QString &dirPath);
+    void clear();
+
+    struct Entry {
+        QStringList names;
+        DAbstractFileWatcher *watcher;
+    };
+
+    // the changes while the names are read, merged into the names when the read is done
+    struct Pending {
+        QFutureWatcher<QStringList> *future;
+        // null if the directory can not be watched
+        DAbstractFileWatcher *watcher;
+        QList<QPair<QString, bool>> changes;
+        QSharedPointer<PartialNames> partial;
+    };
+
+    QHash<QString, Entry> m_entries;
+    // least recently used first
+    QStringList m_lru;
+    QHash<QString, Pending> m_pending;
+};
+
+DFM_END_NAMESPACE
+
+#endif // DDIRECTORYNAMECACHE_H
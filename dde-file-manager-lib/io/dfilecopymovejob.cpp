@@ -27,6 +27,9 @@
 #include "dfilehandler.h"
 #include "ddiriterator.h"
 #include "dfilestatisticsjob.h"
+#include "dlocalfileremover.h"
+#include "dfilejobscheduler.h"
+#include "dfilejobtracer.h"
 
 #include <QMutex>
 #include <QTimer>
@@ -90,6 +93,19 @@ private:
     QElapsedTimer timer;
 };
 
+// run the system call as a span of the phase if the job is traced
+template<typename Fun>
+static inline auto traced(quint64 job, DFileJobTracer::Phase phase, Fun fun) -> decltype(fun())
+{
+    DFileJobTraceSpan span(job, phase);
+
+    if (job) {
+        DFileJobTracer::instance()->addCounter(job, DFileJobTracer::Syscalls);
+    }
+
+    return fun();
+}
+
 DFileCopyMoveJobPrivate::DFileCopyMoveJobPrivate(DFileCopyMoveJob *qq)
     : q_ptr(qq)
     , updateSpeedElapsedTimer(new ElapsedTimer())
@@ -204,6 +220,8 @@ void DFileCopyMoveJobPrivate::unsetError()
 DFileCopyMoveJob::Action DFileCopyMoveJobPrivate::handleError(const DAbstractFileInfo *sourceInfo,
         const DAbstractFileInfo *targetInfo)
 {
+    DFileJobTracer::instance()->addCounter(traceJob, DFileJobTracer::Errors);
+
     if (actionOfError[error] != DFileCopyMoveJob::NoAction) {
         lastErrorHandleAction = actionOfError[error];
         unsetError();
@@ -240,6 +258,10 @@ DFileCopyMoveJob::Action DFileCopyMoveJobPrivate::handleError(const DAbstractFil
         return lastErrorHandleAction;
     }
 
+    const bool is_conflict = error == DFileCopyMoveJob::FileExistsError || error == DFileCopyMoveJob::DirectoryExistsError;
+    DFileJobTraceSpan span(traceJob, is_conflict ? DFileJobTracer::Conflict : DFileJobTracer::HandleError,
+                           sourceInfo ? sourceInfo->fileUrl().toString() : QString());
+
     setState(DFileCopyMoveJob::SleepState);
 
     do {
@@ -268,6 +290,8 @@ DFileCopyMoveJob::Action DFileCopyMoveJobPrivate::handleError(const DAbstractFil
 
     if (lastErrorHandleAction == DFileCopyMoveJob::CancelAction) {
         setError(DFileCopyMoveJob::CancelError);
+    } else if (lastErrorHandleAction == DFileCopyMoveJob::RetryAction) {
+        DFileJobTracer::instance()->addCounter(traceJob, DFileJobTracer::Retries);
     }
 
     qCDebug(fileJob()) << "from user," << "action:" << lastErrorHandleAction
@@ -304,12 +328,19 @@ bool DFileCopyMoveJobPrivate::stateCheck()
     if (state == DFileCopyMoveJob::PausedState) {
         qCDebug(fileJob()) << "Will be suspended";
 
+        // the queued jobs can use the disks while this one is paused
+        DFileJobScheduler::instance()->release(q_ptr);
+
         if (!jobWait()) {
             setError(DFileCopyMoveJob::CancelError);
             qCDebug(fileJob()) << "Will be abort";
 
             return false;
         }
+
+        if (!waitForDevices()) {
+            return false;
+        }
     } else if (state == DFileCopyMoveJob::StoppedState) {
         setError(DFileCopyMoveJob::CancelError);
         qCDebug(fileJob()) << "Will be abort";
@@ -320,6 +351,51 @@ bool DFileCopyMoveJobPrivate::stateCheck()
     return true;
 }
 
+bool DFileCopyMoveJobPrivate::waitForDevices()
+{
+    if (!scheduled) {
+        return true;
+    }
+
+    DFileJobTraceSpan span(traceJob, DFileJobTracer::Wait);
+
+    setState(DFileCopyMoveJob::SleepState);
+
+    if (!DFileJobScheduler::instance()->acquire(q_ptr, sourceUrlList, targetUrl)) {
+        setError(DFileCopyMoveJob::CancelError);
+        qCDebug(fileJob()) << "Will be abort, while waiting for the devices";
+
+        return false;
+    }
+
+    if (state == DFileCopyMoveJob::SleepState) {
+        setState(DFileCopyMoveJob::RunningState);
+    }
+
+    return true;
+}
+
+// removing and moving in one file system only change the directories, they
+// do not make the disk seek like reading and writing the file data does
+bool DFileCopyMoveJobPrivate::movesData() const
+{
+    if (!targetUrl.isValid()) {
+        return false;
+    }
+
+    if (mode == DFileCopyMoveJob::CopyMode) {
+        return true;
+    }
+
+    for (const DUrl &source : sourceUrlList) {
+        if (!DStorageInfo::inSameDevice(source, targetUrl)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 bool DFileCopyMoveJobPrivate::checkFileSize(qint64 size) const
 {
     const DStorageInfo &targetStorageInfo = directoryStack.top().targetStorageInfo;
@@ -463,7 +539,11 @@ bool DFileCopyMoveJobPrivate::doProcess(const DUrl &from, DAbstractFileInfoPoint
                 handler->setPermissions(source_info->fileUrl(), QFileDevice::ReadUser | QFileDevice::WriteUser | QFileDevice::ExeUser);
             }
 
-            ok = mergeDirectory(handler, source_info.constData(), nullptr);
+            if (from.isLocalFile()) {
+                ok = removeLocalDirectory(handler, source_info.constData());
+            } else {
+                ok = mergeDirectory(handler, source_info.constData(), nullptr);
+            }
 
             if (ok) {
                 joinToCompletedDirectoryList(from, DUrl(), size);
@@ -674,7 +754,7 @@ bool DFileCopyMoveJobPrivate::mergeDirectory(DFileHandler *handler, const DAbstr
         DFileCopyMoveJob::Action action = DFileCopyMoveJob::NoAction;
 
         do {
-            if (!handler->mkdir(toInfo->fileUrl())) {
+            if (!traced(traceJob, DFileJobTracer::Mkdir, [&] { return handler->mkdir(toInfo->fileUrl()); })) {
                 const DAbstractFileInfoPointer &parent_info = DFileService::instance()->createFileInfo(nullptr, toInfo->parentUrl());
 
                 if (!parent_info->exists() || parent_info->isWritable()) {
@@ -765,11 +845,15 @@ bool DFileCopyMoveJobPrivate::doCopyFile(const DAbstractFileInfo *fromInfo, cons
 
         return false;
     }
+
+    DFileJobTracer *tracer = traceJob ? DFileJobTracer::instance() : nullptr;
+    DFileJobTraceSpan file_span(traceJob, DFileJobTracer::File, fromInfo->fileUrl().toString());
+
 open_file: {
         DFileCopyMoveJob::Action action = DFileCopyMoveJob::NoAction;
 
         do {
-            if (fromDevice->open(QIODevice::ReadOnly)) {
+            if (traced(traceJob, DFileJobTracer::Open, [&] { return fromDevice->open(QIODevice::ReadOnly); })) {
                 action = DFileCopyMoveJob::NoAction;
             } else {
                 qCDebug(fileJob()) << "open error:" << fromInfo->fileUrl();
@@ -791,7 +875,7 @@ open_file: {
         }
 
         do {
-            if (toDevice->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            if (traced(traceJob, DFileJobTracer::Open, [&] { return toDevice->open(QIODevice::WriteOnly | QIODevice::Truncate); })) {
                 action = DFileCopyMoveJob::NoAction;
             } else {
                 qCDebug(fileJob()) << "open error:" << toInfo->fileUrl();
@@ -844,8 +928,16 @@ open_file: {
         }
 
         char data[blockSize + 1];
+        qint64 trace_begin = tracer ? tracer->now() : 0;
         qint64 size_read = fromDevice->read(data, blockSize);
 
+        // too many blocks to write a span for each one
+        if (tracer) {
+            tracer->addTime(traceJob, DFileJobTracer::Read, tracer->now() - trace_begin);
+            tracer->addCounter(traceJob, DFileJobTracer::Syscalls);
+            tracer->addCounter(traceJob, DFileJobTracer::BytesRead, qMax(size_read, qint64(0)));
+        }
+
         if (Q_UNLIKELY(size_read <= 0)) {
             if (fromDevice->atEnd()) {
                 break;
@@ -882,8 +974,14 @@ open_file: {
             return false;
         }
 
+        trace_begin = tracer ? tracer->now() : 0;
         qint64 size_write = toDevice->write(data, size_read);
 
+        if (tracer) {
+            tracer->addTime(traceJob, DFileJobTracer::Write, tracer->now() - trace_begin);
+            tracer->addCounter(traceJob, DFileJobTracer::Syscalls);
+        }
+
         if (Q_UNLIKELY(size_write != size_read)) {
             do {
                 // 在某些情况下（往sftp挂载目录写入），可能一次未能写入那么多数据
@@ -895,6 +993,7 @@ open_file: {
                     do {
                         currentJobDataSizeInfo.second += size_write;
                         completedDataSize += size_write;
+                        DFileJobTracer::instance()->addCounter(traceJob, DFileJobTracer::BytesWritten, size_write);
                         //        writtenDataSize += size_write;
 
                         surplus_data += size_write;
@@ -937,6 +1036,10 @@ open_file: {
         completedDataSize += size_write;
 //        writtenDataSize += size_write;
 
+        if (tracer) {
+            tracer->addCounter(traceJob, DFileJobTracer::BytesWritten, size_write);
+        }
+
         if (Q_LIKELY(!fileHints.testFlag(DFileCopyMoveJob::DontIntegrityChecking))) {
             source_checksum = adler32(source_checksum, reinterpret_cast<Bytef *>(data), size_read);
         }
@@ -947,13 +1050,19 @@ open_file: {
 //        }
     }
 
-    fromDevice->close();
-    toDevice->close();
+    {
+        DFileJobTraceSpan span(traceJob, DFileJobTracer::Sync);
+
+        fromDevice->close();
+        toDevice->close();
+    }
 
     if (fileHints.testFlag(DFileCopyMoveJob::DontIntegrityChecking)) {
         return true;
     }
 
+    DFileJobTraceSpan verify_span(traceJob, DFileJobTracer::Verify);
+
     DFileCopyMoveJob::Action action = DFileCopyMoveJob::NoAction;
 
     do {
@@ -1036,7 +1145,9 @@ bool DFileCopyMoveJobPrivate::doRemoveFile(DFileHandler *handler, const DAbstrac
     bool is_file = fileInfo->isFile() || fileInfo->isSymLink();
 
     do {
-        if (is_file ? handler->remove(fileInfo->fileUrl()) : handler->rmdir(fileInfo->fileUrl())) {
+        if (traced(traceJob, DFileJobTracer::Remove, [&] {
+                return is_file ? handler->remove(fileInfo->fileUrl()) : handler->rmdir(fileInfo->fileUrl());
+            })) {
             return true;
         }
 
@@ -1052,6 +1163,67 @@ bool DFileCopyMoveJobPrivate::doRemoveFile(DFileHandler *handler, const DAbstrac
     return action == DFileCopyMoveJob::SkipAction;
 }
 
+bool DFileCopyMoveJobPrivate::removeLocalDirectory(DFileHandler *handler, const DAbstractFileInfo *fileInfo)
+{
+    DLocalFileRemover remover;
+    qint64 removed_count = 0;
+    qint64 removed_data_size = 0;
+
+    auto update_completed = [&] {
+        const qint64 count = remover.removedCount();
+
+        completedDataSize += remover.removedDataSize() - removed_data_size;
+        removed_data_size = remover.removedDataSize();
+
+        if (count != removed_count) {
+            completedFilesCount += count - removed_count;
+            removed_count = count;
+
+            Q_EMIT q_ptr->completedFilesCountChanged(completedFilesCount);
+        }
+    };
+
+    remover.setCountDataSize(true);
+    remover.start(fileInfo->toLocalFile());
+
+    beginJob(JobInfo::Remove, fileInfo->fileUrl(), DUrl());
+
+    while (!remover.waitForFinished(100)) {
+        update_completed();
+
+        const bool paused = state == DFileCopyMoveJob::PausedState;
+
+        if (paused) {
+            remover.pause();
+        }
+
+        if (!stateCheck()) {
+            remover.stop();
+            remover.waitForFinished();
+            update_completed();
+            endJob();
+
+            return false;
+        }
+
+        if (paused) {
+            remover.resume();
+        }
+    }
+
+    update_completed();
+    endJob();
+
+    if (remover.isRemoved()) {
+        return true;
+    }
+
+    qCDebug(fileJob()) << "Failed on remove the directory in parallel:" << remover.errors().count() << "errors";
+
+    // ask the user about the files left, one by one
+    return mergeDirectory(handler, fileInfo, nullptr);
+}
+
 bool DFileCopyMoveJobPrivate::doRenameFile(DFileHandler *handler, const DAbstractFileInfo *oldInfo, const DAbstractFileInfo *newInfo)
 {
     const DStorageInfo &storage_source = directoryStack.top().sourceStorageInfo;
@@ -1059,7 +1231,7 @@ bool DFileCopyMoveJobPrivate::doRenameFile(DFileHandler *handler, const DAbstrac
 
     if (storage_target.device() != "gvfsd-fuse" || storage_source == storage_target) {
         // 先尝试直接rename
-        if (handler->rename(oldInfo->fileUrl(), newInfo->fileUrl())) {
+        if (traced(traceJob, DFileJobTracer::Rename, [&] { return handler->rename(oldInfo->fileUrl(), newInfo->fileUrl()); })) {
             return true;
         }
     }
@@ -1097,7 +1269,7 @@ bool DFileCopyMoveJobPrivate::doLinkFile(DFileHandler *handler, const DAbstractF
     DFileCopyMoveJob::Action action = DFileCopyMoveJob::NoAction;
 
     do {
-        if (handler->link(linkPath, fileInfo->fileUrl())) {
+        if (traced(traceJob, DFileJobTracer::Link, [&] { return handler->link(linkPath, fileInfo->fileUrl()); })) {
             return true;
         }
 
@@ -1229,6 +1401,7 @@ void DFileCopyMoveJobPrivate::joinToCompletedFileList(const DUrl &from, const DU
     }
 
     ++completedFilesCount;
+    DFileJobTracer::instance()->addCounter(traceJob, DFileJobTracer::Files);
 
     Q_EMIT q_ptr->completedFilesCountChanged(completedFilesCount);
 
@@ -1276,6 +1449,8 @@ void DFileCopyMoveJobPrivate::updateSpeed()
 
     qint64 speed = total_size / time * 1000;
 
+    DFileJobScheduler::instance()->setJobSpeed(q_ptr, speed);
+
     Q_EMIT q_ptr->speedUpdated(speed);
 }
 
@@ -1555,6 +1730,8 @@ void DFileCopyMoveJob::run()
     d->targetUrlList.clear();
     d->completedDataSize = 0;
     d->completedFilesCount = 0;
+    d->traceJob = DFileJobTracer::instance()->beginJob(d->mode == CopyMode ? "copy" : (d->targetUrl.isValid() ? "move" : "remove"),
+                                                       d->sourceUrlList, d->targetUrl);
 
     DAbstractFileInfoPointer target_info;
 
@@ -1583,6 +1760,13 @@ void DFileCopyMoveJob::run()
         qCDebug(fileJob(), "remove mode");
     }
 
+    // wait for the other jobs on the same disks
+    d->scheduled = d->movesData();
+
+    if (!d->waitForDevices()) {
+        goto end;
+    }
+
     for (DUrl &source : d->sourceUrlList) {
         if (!d->stateCheck()) {
             goto end;
@@ -1626,6 +1810,7 @@ void DFileCopyMoveJob::run()
     d->setError(NoError);
 
 end:
+    DFileJobScheduler::instance()->release(this);
     d->fileStatistics->stop();
     d->setState(StoppedState);
 
@@ -1633,6 +1818,9 @@ end:
         Q_EMIT progressChanged(1, d->completedDataSize);
     }
 
+    DFileJobTracer::instance()->endJob(d->traceJob, d->error);
+    d->traceJob = 0;
+
     qCDebug(fileJob()) << "job finished, error:" << error() << ", message:" << errorString();
 }
 
@@ -0,0 +1,364 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "dfilejobscheduler.h"
+#include "dfilecopymovejob.h"
+#include "dmounttablecache.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+DFM_BEGIN_NAMESPACE
+
+Q_GLOBAL_STATIC(DFileJobScheduler, fjsGlobal)
+
+// the sysfs directory of the disk which the block device belongs to
+static QString sysfsDiskPath(dev_t rdev)
+{
+    QString path = QFileInfo(QStringLiteral("/sys/dev/block/%1:%2").arg(major(rdev)).arg(minor(rdev))).canonicalFilePath();
+
+    // dm-crypt on lvm on md etc.
+    for (int level = 0; level < 8 && !path.isEmpty(); ++level) {
+        // /sys/devices/.../block/sda/sda1 -> /sys/devices/.../block/sda
+        if (QFile::exists(path + QStringLiteral("/partition"))) {
+            path = QFileInfo(path).absolutePath();
+            continue;
+        }
+
+        // device mapper and md, use the first device under them
+        const QStringList &slaves = QDir(path + QStringLiteral("/slaves")).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+
+        if (slaves.isEmpty())
+            break;
+
+        path = QFileInfo(QStringLiteral("/sys/class/block/") + slaves.first()).canonicalFilePath();
+    }
+
+    return path;
+}
+
+static bool readSysfsFlag(const QString &path)
+{
+    QFile file(path);
+
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    return file.readAll().trimmed() == "1";
+}
+
+DFileJobScheduler::DFileJobScheduler()
+{
+
+}
+
+DFileJobScheduler::~DFileJobScheduler()
+{
+
+}
+
+DFileJobScheduler *DFileJobScheduler::instance()
+{
+    return fjsGlobal;
+}
+
+bool DFileJobScheduler::acquire(DFileCopyMoveJob *job, const DUrlList &sourceUrls, const DUrl &targetUrl)
+{
+    DUrlList urls = sourceUrls;
+
+    if (targetUrl.isValid())
+        urls << targetUrl;
+
+    Ticket ticket;
+
+    ticket.job = job;
+    ticket.devices = devicesOfUrls(urls);
+
+    bool exclusive = false;
+
+    for (const Device &device : ticket.devices) {
+        exclusive = exclusive || device.exclusive;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    if (!exclusive) {
+        m_running << ticket;
+
+        return true;
+    }
+
+    m_queue << ticket;
+
+    locker.unlock();
+    Q_EMIT queueChanged();
+    locker.relock();
+
+    forever {
+        int index = -1;
+
+        for (int i = 0; i < m_queue.count(); ++i) {
+            if (m_queue.at(i).job == job) {
+                index = i;
+                break;
+            }
+        }
+
+        if (index < 0 || job->state() == DFileCopyMoveJob::StoppedState) {
+            if (index >= 0)
+                m_queue.removeAt(index);
+
+            locker.unlock();
+            Q_EMIT queueChanged();
+
+            return false;
+        }
+
+        if (canStart(index)) {
+            m_running << m_queue.takeAt(index);
+
+            locker.unlock();
+            Q_EMIT queueChanged();
+
+            return true;
+        }
+
+        // also wake up now and then to notice that the job was stopped
+        m_condition.wait(&m_mutex, 100);
+    }
+}
+
+void DFileJobScheduler::release(DFileCopyMoveJob *job)
+{
+    QMutexLocker locker(&m_mutex);
+    bool changed = false;
+
+    for (int i = m_running.count() - 1; i >= 0; --i) {
+        if (m_running.at(i).job == job) {
+            m_running.removeAt(i);
+            changed = true;
+        }
+    }
+
+    if (!changed)
+        return;
+
+    m_condition.wakeAll();
+    locker.unlock();
+
+    Q_EMIT queueChanged();
+}
+
+bool DFileJobScheduler::isQueued(const DFileCopyMoveJob *job) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (const Ticket &ticket : m_queue) {
+        if (ticket.job == job)
+            return true;
+    }
+
+    return false;
+}
+
+QList<DFileCopyMoveJob *> DFileJobScheduler::queuedJobs() const
+{
+    QMutexLocker locker(&m_mutex);
+    QList<DFileCopyMoveJob *> jobs;
+
+    for (const Ticket &ticket : m_queue) {
+        jobs << ticket.job;
+    }
+
+    return jobs;
+}
+
+void DFileJobScheduler::moveToFront(DFileCopyMoveJob *job)
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (int i = 0; i < m_queue.count(); ++i) {
+        if (m_queue.at(i).job == job) {
+            m_queue.move(i, 0);
+            m_condition.wakeAll();
+            locker.unlock();
+
+            Q_EMIT queueChanged();
+
+            return;
+        }
+    }
+}
+
+void DFileJobScheduler::setJobSpeed(const DFileCopyMoveJob *job, qint64 speed)
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (Ticket &ticket : m_running) {
+        if (ticket.job == job)
+            ticket.speed = speed;
+    }
+}
+
+QMap<QString, qint64> DFileJobScheduler::deviceThroughput() const
+{
+    QMutexLocker locker(&m_mutex);
+    QMap<QString, qint64> throughput;
+
+    for (const Ticket &ticket : m_running) {
+        for (const Device &device : ticket.devices) {
+            throughput[device.name] += ticket.speed;
+        }
+    }
+
+    return throughput;
+}
+
+QList<DFileJobScheduler::Device> DFileJobScheduler::devicesOfUrls(const DUrlList &urls)
+{
+    QList<Device> devices;
+    QList<dev_t> known_devs;
+
+    for (const DUrl &url : urls) {
+        if (!url.isLocalFile())
+            continue;
+
+        struct stat st;
+
+        if (::stat(QFile::encodeName(url.toLocalFile()).constData(), &st) != 0)
+            continue;
+
+        if (known_devs.contains(st.st_dev))
+            continue;
+
+        known_devs << st.st_dev;
+
+        const Device &device = deviceOf(st.st_dev);
+
+        if (device.name.isEmpty())
+            continue;
+
+        bool contains = false;
+
+        for (const Device &d : devices) {
+            contains = contains || d.name == device.name;
+        }
+
+        if (!contains)
+            devices << device;
+    }
+
+    return devices;
+}
+
+DFileJobScheduler::Device DFileJobScheduler::deviceOf(dev_t dev)
+{
+    const quint64 generation = DMountTableCache::instance()->generation();
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        // the device numbers may be reused after the mount table changed
+        if (generation != m_mountTableGeneration) {
+            m_deviceCache.clear();
+            m_mountTableGeneration = generation;
+        }
+
+        auto cached = m_deviceCache.constFind(dev);
+
+        if (cached != m_deviceCache.constEnd())
+            return cached.value();
+    }
+
+    Device device;
+    dev_t rdev = 0;
+    DMountTableCache::MountEntry entry;
+
+    // btrfs and others use an anonymous st_dev, get the block device from the mount table
+    if (DMountTableCache::instance()->findMount(dev, &entry) && entry.device.startsWith("/dev/")) {
+        struct stat st;
+
+        if (::stat(entry.device.constData(), &st) == 0 && S_ISBLK(st.st_mode))
+            rdev = st.st_rdev;
+    }
+
+    if (rdev == 0 && major(dev) != 0)
+        rdev = dev;
+
+    // tmpfs, fuse, network file systems...
+    if (rdev != 0) {
+        const QString &disk_path = sysfsDiskPath(rdev);
+
+        if (!disk_path.isEmpty()) {
+            device.name = QFileInfo(disk_path).fileName();
+            device.exclusive = readSysfsFlag(disk_path + QStringLiteral("/queue/rotational"))
+                               || readSysfsFlag(disk_path + QStringLiteral("/removable"));
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    m_deviceCache[dev] = device;
+
+    return device;
+}
+
+bool DFileJobScheduler::canStart(int queueIndex) const
+{
+    QList<QString> busy_devices;
+
+    for (const Ticket &ticket : m_running) {
+        for (const Device &device : ticket.devices) {
+            if (device.exclusive)
+                busy_devices << device.name;
+        }
+    }
+
+    // the disks are reserved for the earlier jobs, unless they are paused
+    for (int i = 0; i < queueIndex; ++i) {
+        const Ticket &ticket = m_queue.at(i);
+
+        if (ticket.job->state() == DFileCopyMoveJob::PausedState)
+            continue;
+
+        for (const Device &device : ticket.devices) {
+            if (device.exclusive)
+                busy_devices << device.name;
+        }
+    }
+
+    const Ticket &ticket = m_queue.at(queueIndex);
+
+    if (ticket.job->state() == DFileCopyMoveJob::PausedState)
+        return false;
+
+    for (const Device &device : ticket.devices) {
+        if (device.exclusive && busy_devices.contains(device.name))
+            return false;
+    }
+
+    return true;
+}
+
+DFM_END_NAMESPACE
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DFILEJOBSCHEDULER_H
+#define DFILEJOBSCHEDULER_H
+
+#include <dfmglobal.h>
+#include <durl.h>
+
+#include <QObject>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <sys/types.h>
+
+DFM_BEGIN_NAMESPACE
+
+class DFileCopyMoveJob;
+// Runs the copy/move jobs that read or write the same rotational or removable
+// disk one after another. Several jobs on one such disk make it seek between
+// the files all the time. That is much slower than running them in sequence.
+// Only the jobs copying file data come here. These are the copies and the
+// moves to another file system. Removing and renaming do not wait.
+// Jobs on different disks, on SSDs or on non-local files run concurrently.
+// Queued jobs are started in FIFO order. A paused job does not hold its place.
+// A job gets all of its disks at once, so two jobs never wait for each other.
+// All functions are thread safe.
+class DFileJobScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DFileJobScheduler *instance();
+
+    // blocks until no earlier job uses the disks of sourceUrls and targetUrl,
+    // returns false if the job was stopped while it was waiting
+    bool acquire(DFileCopyMoveJob *job, const DUrlList &sourceUrls, const DUrl &targetUrl);
+    void release(DFileCopyMoveJob *job);
+
+    bool isQueued(const DFileCopyMoveJob *job) const;
+    QList<DFileCopyMoveJob *> queuedJobs() const;
+    // start the job as soon as its disks are free, before the other queued jobs
+    void moveToFront(DFileCopyMoveJob *job);
+
+    void setJobSpeed(const DFileCopyMoveJob *job, qint64 speed);
+    // the sum of the speed (bytes per second) of the running jobs on each disk,
+    // the key is the kernel name of the disk (like sda)
+    QMap<QString, qint64> deviceThroughput() const;
+
+    DFileJobScheduler();
+    ~DFileJobScheduler();
+
+Q_SIGNALS:
+    void queueChanged();
+
+private:
+    struct Device {
+        QString name;
+        // rotational or removable disks, only one job is running on them
+        bool exclusive = false;
+    };
+
+    struct Ticket {
+        DFileCopyMoveJob *job = nullptr;
+        QList<Device> devices;
+        qint64 speed = 0;
+    };
+
+    QList<Device> devicesOfUrls(const DUrlList &urls);
+    Device deviceOf(dev_t dev);
+    bool canStart(int queueIndex) const;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_condition;
+    QList<Ticket> m_queue;
+    QList<Ticket> m_running;
+    QHash<dev_t, Device> m_deviceCache;
+    quint64 m_mountTableGeneration = 0;
+};
+
+DFM_END_NAMESPACE
+
+#endif // DFILEJOBSCHEDULER_H
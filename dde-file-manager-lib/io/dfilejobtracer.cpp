@@ -0,0 +1,382 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "dfilejobtracer.h"
+
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+DFM_BEGIN_NAMESPACE
+
+Q_GLOBAL_STATIC(DFileJobTracer, fjtGlobal)
+
+// write the events to the file after the buffer is full or a job finished
+static const int EVENT_BUFFER_SIZE = 64 * 1024;
+// microseconds between two snapshots of the running jobs sent to the daemon
+static const qint64 RUNNING_REPORT_INTERVAL = 1000 * 1000;
+
+DFileJobTracer *DFileJobTracer::instance()
+{
+    return fjtGlobal;
+}
+
+bool DFileJobTracer::isEnabled()
+{
+    static const bool enabled = !qgetenv("DFM_FILE_JOB_TRACE").isEmpty();
+
+    return enabled;
+}
+
+DFileJobTracer::DFileJobTracer()
+{
+    m_timer.start();
+
+    if (isEnabled()) {
+        m_file.setFileName(QFile::decodeName(qgetenv("DFM_FILE_JOB_TRACE")));
+    }
+}
+
+DFileJobTracer::~DFileJobTracer()
+{
+    QMutexLocker locker(&m_mutex);
+
+    flush();
+}
+
+quint64 DFileJobTracer::beginJob(const QString &name, const DUrlList &sourceUrls, const DUrl &targetUrl)
+{
+    if (!isEnabled())
+        return 0;
+
+    QMutexLocker locker(&m_mutex);
+
+    const quint64 job = ++m_lastJobId;
+    JobTrace &trace = m_jobs[job];
+
+    trace.id = job;
+    trace.name = QStringLiteral("%1 #%2").arg(name).arg(job);
+    trace.begin = now();
+
+    // the job is shown as a thread in the trace viewer
+    QJsonObject event {
+        {"name", "thread_name"},
+        {"ph", "M"},
+        {"pid", QCoreApplication::applicationPid()},
+        {"tid", static_cast<qint64>(job)},
+        {"args", QJsonObject {{"name", trace.name}}}
+    };
+
+    appendEvent(QJsonDocument(event).toJson(QJsonDocument::Compact));
+
+    QStringList sources;
+
+    for (const DUrl &url : sourceUrls) {
+        sources << url.toString();
+    }
+
+    // the urls are shown with the first span of the job
+    QJsonObject urls_event {
+        {"name", "urls"},
+        {"cat", "file.job"},
+        {"ph", "i"},
+        {"s", "t"},
+        {"pid", QCoreApplication::applicationPid()},
+        {"tid", static_cast<qint64>(job)},
+        {"ts", trace.begin},
+        {"args", QJsonObject {{"sources", QJsonArray::fromStringList(sources)}, {"target", targetUrl.toString()}}}
+    };
+
+    appendEvent(QJsonDocument(urls_event).toJson(QJsonDocument::Compact));
+
+    return job;
+}
+
+void DFileJobTracer::endJob(quint64 job, int error)
+{
+    if (!job)
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_jobs.find(job);
+
+    if (it == m_jobs.end())
+        return;
+
+    const JobTrace trace = it.value();
+
+    m_jobs.erase(it);
+
+    QVariantMap job_summary = toVariantMap(trace);
+
+    job_summary["error"] = error;
+    job_summary["duration"] = now() - trace.begin;
+
+    QJsonObject event {
+        {"name", trace.name},
+        {"cat", "file.job"},
+        {"ph", "X"},
+        {"pid", QCoreApplication::applicationPid()},
+        {"tid", static_cast<qint64>(job)},
+        {"ts", trace.begin},
+        {"dur", job_summary.value("duration").toLongLong()},
+        {"args", QJsonObject::fromVariantMap(job_summary)}
+    };
+
+    appendEvent(QJsonDocument(event).toJson(QJsonDocument::Compact));
+    flush();
+
+    locker.unlock();
+
+    job_summary["running"] = false;
+    report(job_summary);
+}
+
+qint64 DFileJobTracer::now() const
+{
+    return m_timer.nsecsElapsed() / 1000;
+}
+
+void DFileJobTracer::addSpan(quint64 job, DFileJobTracer::Phase phase, qint64 begin, qint64 duration, const QString &file)
+{
+    if (!job)
+        return;
+
+    QJsonObject event {
+        {"name", phaseName(phase)},
+        {"cat", "file.job"},
+        {"ph", "X"},
+        {"pid", QCoreApplication::applicationPid()},
+        {"tid", static_cast<qint64>(job)},
+        {"ts", begin},
+        {"dur", duration}
+    };
+
+    if (!file.isEmpty()) {
+        event["args"] = QJsonObject {{"file", file}};
+    }
+
+    const QByteArray &data = QJsonDocument(event).toJson(QJsonDocument::Compact);
+    QMutexLocker locker(&m_mutex);
+    auto it = m_jobs.find(job);
+
+    if (it == m_jobs.end())
+        return;
+
+    it->phaseTime[phase] += duration;
+    ++it->phaseCount[phase];
+
+    appendEvent(data);
+
+    const QList<QVariantMap> &snapshots = takeRunningSnapshots();
+
+    locker.unlock();
+
+    for (const QVariantMap &snapshot : snapshots) {
+        report(snapshot);
+    }
+}
+
+void DFileJobTracer::addTime(quint64 job, DFileJobTracer::Phase phase, qint64 duration, int count)
+{
+    if (!job)
+        return;
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_jobs.find(job);
+
+    if (it == m_jobs.end())
+        return;
+
+    it->phaseTime[phase] += duration;
+    it->phaseCount[phase] += count;
+
+    const QList<QVariantMap> &snapshots = takeRunningSnapshots();
+
+    locker.unlock();
+
+    for (const QVariantMap &snapshot : snapshots) {
+        report(snapshot);
+    }
+}
+
+void DFileJobTracer::addCounter(quint64 job, DFileJobTracer::Counter counter, qint64 value)
+{
+    if (!job)
+        return;
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_jobs.find(job);
+
+    if (it == m_jobs.end())
+        return;
+
+    it->counters[counter] += value;
+}
+
+QString DFileJobTracer::phaseName(DFileJobTracer::Phase phase)
+{
+    switch (phase) {
+    case Wait: return QStringLiteral("wait");
+    case File: return QStringLiteral("file");
+    case Open: return QStringLiteral("open");
+    case Read: return QStringLiteral("read");
+    case Write: return QStringLiteral("write");
+    case Sync: return QStringLiteral("sync");
+    case Verify: return QStringLiteral("verify");
+    case Mkdir: return QStringLiteral("mkdir");
+    case Remove: return QStringLiteral("remove");
+    case Rename: return QStringLiteral("rename");
+    case Link: return QStringLiteral("link");
+    case Conflict: return QStringLiteral("conflict");
+    case HandleError: return QStringLiteral("handleError");
+    default: break;
+    }
+
+    return QString();
+}
+
+QString DFileJobTracer::counterName(DFileJobTracer::Counter counter)
+{
+    switch (counter) {
+    case Files: return QStringLiteral("files");
+    case BytesRead: return QStringLiteral("bytesRead");
+    case BytesWritten: return QStringLiteral("bytesWritten");
+    case Syscalls: return QStringLiteral("syscalls");
+    case Errors: return QStringLiteral("errors");
+    case Retries: return QStringLiteral("retries");
+    default: break;
+    }
+
+    return QString();
+}
+
+QVariantMap DFileJobTracer::toVariantMap(const DFileJobTracer::JobTrace &trace)
+{
+    QVariantMap phases;
+    QVariantMap counters;
+
+    // the time is in microseconds
+    for (int i = 0; i < PhaseCount; ++i) {
+        if (trace.phaseCount[i] > 0) {
+            phases[phaseName(static_cast<Phase>(i))] = QVariantMap {
+                {"count", trace.phaseCount[i]},
+                {"time", trace.phaseTime[i]}
+            };
+        }
+    }
+
+    for (int i = 0; i < CounterCount; ++i) {
+        counters[counterName(static_cast<Counter>(i))] = trace.counters[i];
+    }
+
+    QVariantMap map {
+        {"phases", phases},
+        {"counters", counters}
+    };
+
+    if (!trace.name.isEmpty()) {
+        map["name"] = trace.name;
+    }
+
+    if (trace.id > 0) {
+        map["job"] = trace.id;
+    }
+
+    return map;
+}
+
+QList<QVariantMap> DFileJobTracer::takeRunningSnapshots()
+{
+    QList<QVariantMap> snapshots;
+    const qint64 current = now();
+
+    if (current - m_lastRunningReport < RUNNING_REPORT_INTERVAL) {
+        return snapshots;
+    }
+
+    m_lastRunningReport = current;
+
+    for (const JobTrace &trace : m_jobs) {
+        QVariantMap snapshot = toVariantMap(trace);
+
+        snapshot["running"] = true;
+        snapshot["duration"] = current - trace.begin;
+        snapshots << snapshot;
+    }
+
+    return snapshots;
+}
+
+void DFileJobTracer::report(const QVariantMap &summary)
+{
+    // the daemon keeps the summaries of the latest jobs of all processes, do not start it only for that
+    QDBusMessage message = QDBusMessage::createMethodCall("com.deepin.filemanager.daemon",
+                                                          "/com/deepin/filemanager/daemon/Operations",
+                                                          "com.deepin.filemanager.daemon.Operations",
+                                                          "ReportJobTrace");
+    QVariantMap map = summary;
+
+    map["pid"] = QCoreApplication::applicationPid();
+    message << QString::fromUtf8(QJsonDocument(QJsonObject::fromVariantMap(map)).toJson(QJsonDocument::Compact));
+    message.setAutoStartService(false);
+    QDBusConnection::systemBus().send(message);
+}
+
+void DFileJobTracer::appendEvent(const QByteArray &event)
+{
+    // the trace viewer accepts an array without the closing bracket
+    m_buffer.append(event).append(",\n");
+
+    if (m_buffer.size() >= EVENT_BUFFER_SIZE)
+        flush();
+}
+
+void DFileJobTracer::flush()
+{
+    if (m_buffer.isEmpty() || m_file.fileName().isEmpty())
+        return;
+
+    if (!m_file.isOpen()) {
+        if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            qWarning() << "Failed to open the trace file:" << m_file.fileName() << m_file.errorString();
+            // do not try again
+            m_file.setFileName(QString());
+            m_buffer.clear();
+
+            return;
+        }
+
+        if (m_file.size() == 0) {
+            m_file.write("[\n");
+        }
+    }
+
+    m_file.write(m_buffer);
+    m_file.flush();
+    m_buffer.clear();
+}
+
+DFM_END_NAMESPACE
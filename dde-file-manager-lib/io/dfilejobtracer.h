@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DFILEJOBTRACER_H
+#define DFILEJOBTRACER_H
+
+#include <dfmglobal.h>
+#include <durl.h>
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QVariantMap>
+
+DFM_BEGIN_NAMESPACE
+
+// Opt-in tracing of the file operation jobs, enabled by setting the
+// DFM_FILE_JOB_TRACE environment variable to the path of a trace file.
+// The spans of every phase are written to that file in the JSON array format
+// of the Chrome trace viewer (chrome://tracing, Perfetto), one row per job.
+// A snapshot of the running jobs is sent to the file manager daemon at most
+// every second while they make progress, and the summary of each job when it
+// finished, see com.deepin.filemanager.daemon.Operations.GetJobTraceSummary.
+// A job id of 0 means the tracing is disabled, all functions do nothing then.
+// All functions are thread safe.
+class DFileJobTracer
+{
+public:
+    enum Phase {
+        Wait,           // waiting for the other jobs on the same disks
+        File,           // the whole copy of a file, includes the phases below
+        Open,
+        Read,
+        Write,
+        Sync,           // close and flush the target file
+        Verify,         // integrity checking
+        Mkdir,
+        Remove,
+        Rename,
+        Link,
+        Conflict,       // asking what to do with an existing file
+        HandleError,    // asking what to do with the other errors
+        PhaseCount
+    };
+
+    enum Counter {
+        Files,
+        BytesRead,
+        BytesWritten,
+        Syscalls,
+        Errors,
+        Retries,
+        CounterCount
+    };
+
+    static DFileJobTracer *instance();
+    static bool isEnabled();
+
+    DFileJobTracer();
+    ~DFileJobTracer();
+
+    // returns 0 if the tracing is disabled
+    quint64 beginJob(const QString &name, const DUrlList &sourceUrls, const DUrl &targetUrl);
+    void endJob(quint64 job, int error);
+
+    // microseconds since the tracer was created, the time base of the spans
+    qint64 now() const;
+    // add the time to the summary and write a span to the trace file
+    void addSpan(quint64 job, Phase phase, qint64 begin, qint64 duration, const QString &file = QString());
+    // add the time to the summary only, for the phases that are too frequent
+    // to be written one by one (the reads and writes of every block)
+    void addTime(quint64 job, Phase phase, qint64 duration, int count = 1);
+    void addCounter(quint64 job, Counter counter, qint64 value = 1);
+
+    static QString phaseName(Phase phase);
+    static QString counterName(Counter counter);
+
+private:
+    struct JobTrace {
+        quint64 id = 0;
+        QString name;
+        qint64 begin = 0;
+        qint64 phaseTime[PhaseCount] = {0};
+        qint64 phaseCount[PhaseCount] = {0};
+        qint64 counters[CounterCount] = {0};
+    };
+
+    static QVariantMap toVariantMap(const JobTrace &trace);
+    void appendEvent(const QByteArray &event);
+    void flush();
+    // the snapshots of the running jobs if the last ones are old enough, with m_mutex locked
+    QList<QVariantMap> takeRunningSnapshots();
+    static void report(const QVariantMap &summary);
+
+    mutable QMutex m_mutex;
+    QElapsedTimer m_timer;
+    QFile m_file;
+    QByteArray m_buffer;
+    quint64 m_lastJobId = 0;
+    QHash<quint64, JobTrace> m_jobs;
+    qint64 m_lastRunningReport = 0;
+};
+
+// Adds a span of the phase from the construction to the destruction
+class DFileJobTraceSpan
+{
+public:
+    inline DFileJobTraceSpan(quint64 job, DFileJobTracer::Phase phase, const QString &file = QString())
+        : m_job(job)
+        , m_phase(phase)
+    {
+        if (m_job) {
+            m_file = file;
+            m_begin = DFileJobTracer::instance()->now();
+        }
+    }
+
+    inline ~DFileJobTraceSpan()
+    {
+        if (m_job) {
+            DFileJobTracer *tracer = DFileJobTracer::instance();
+
+            tracer->addSpan(m_job, m_phase, m_begin, tracer->now() - m_begin, m_file);
+        }
+    }
+
+private:
+    quint64 m_job;
+    DFileJobTracer::Phase m_phase;
+    QString m_file;
+    qint64 m_begin = 0;
+
+    Q_DISABLE_COPY(DFileJobTraceSpan)
+};
+
+DFM_END_NAMESPACE
+
+#endif // DFILEJOBTRACER_H
@@ -0,0 +1,467 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "dlocalfileremover.h"
+
+#include <QDir>
+#include <QFile>
+#include <QMutex>
+#include <QQueue>
+#include <QStack>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QDebug>
+
+#include <errno.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+DFM_BEGIN_NAMESPACE
+
+static const int MAX_ERROR_COUNT = 100;
+static const int MAX_DEFAULT_THREAD_COUNT = 4;
+
+namespace LocalFileRemover {
+struct linux_dirent64 {
+    quint64 d_ino;
+    qint64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+struct Node {
+    Node *parent = nullptr;
+    // the full path for the root node
+    QByteArray name;
+    // opened by the thread reading the directory, closed when all children are done
+    int fd = -1;
+    // the reading of the directory itself and each of its sub directories
+    QAtomicInt pending = 1;
+    QAtomicInt failed = 0;
+};
+}
+
+using namespace LocalFileRemover;
+
+class DLocalFileRemoverPrivate
+{
+public:
+    explicit DLocalFileRemoverPrivate(int maxThreadCount);
+
+    void run();
+    void walk(Node *node, QStack<Node*> &localNodes);
+    void dispatch(Node *node, QStack<Node*> &localNodes);
+    void done(Node *node);
+    void waitIfPaused();
+    void addError(const Node *parent, const QByteArray &name, int errorNumber);
+
+    int threadCount;
+    bool countDataSize = false;
+    bool started = false;
+
+    mutable QMutex mutex;
+    QWaitCondition queueCondition;
+    QWaitCondition finishedCondition;
+    QWaitCondition pauseCondition;
+    QQueue<Node*> queue;
+    QAtomicInt queueSize = 0;
+    bool finished = false;
+    bool removed = false;
+
+    QAtomicInt stopped = 0;
+    QAtomicInt paused = 0;
+    QAtomicInteger<qint64> removedCount = 0;
+    QAtomicInteger<qint64> removedDataSize = 0;
+    QList<DLocalFileRemover::Error> errors;
+
+    QThreadPool threadPool;
+};
+
+class LocalFileRemoverWorker : public QRunnable
+{
+public:
+    explicit LocalFileRemoverWorker(DLocalFileRemoverPrivate *d)
+        : d(d) {}
+
+    void run() override
+    {
+        d->run();
+    }
+
+private:
+    DLocalFileRemoverPrivate *d;
+};
+
+DLocalFileRemoverPrivate::DLocalFileRemoverPrivate(int maxThreadCount)
+    : threadCount(maxThreadCount > 0 ? maxThreadCount : qBound(1, QThread::idealThreadCount(), MAX_DEFAULT_THREAD_COUNT))
+{
+    threadPool.setMaxThreadCount(threadCount);
+}
+
+void DLocalFileRemoverPrivate::run()
+{
+    // the sub directories not handed out to other threads, walked depth first
+    // so that only the descriptors of one branch are open
+    QStack<Node*> local_nodes;
+
+    forever {
+        Node *node = nullptr;
+
+        if (!local_nodes.isEmpty()) {
+            node = local_nodes.pop();
+        } else {
+            QMutexLocker locker(&mutex);
+
+            while (queue.isEmpty() && !finished) {
+                queueCondition.wait(&mutex);
+            }
+
+            if (queue.isEmpty()) {
+                return;
+            }
+
+            node = queue.dequeue();
+            queueSize.deref();
+        }
+
+        walk(node, local_nodes);
+    }
+}
+
+void DLocalFileRemoverPrivate::walk(Node *node, QStack<Node*> &localNodes)
+{
+    waitIfPaused();
+
+    if (stopped.load()) {
+        node->failed.store(1);
+        done(node);
+
+        return;
+    }
+
+    const int parent_fd = node->parent ? node->parent->fd : AT_FDCWD;
+
+    node->fd = ::openat(parent_fd, node->name.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+
+    if (node->fd < 0) {
+        addError(node->parent, node->name, errno);
+        node->failed.store(1);
+        done(node);
+
+        return;
+    }
+
+    char buffer[32 * 1024];
+
+    while (!stopped.load()) {
+        const long size = ::syscall(SYS_getdents64, node->fd, buffer, sizeof(buffer));
+
+        if (size < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            addError(node->parent, node->name, errno);
+            node->failed.store(1);
+            break;
+        }
+
+        if (size == 0) {
+            break;
+        }
+
+        for (long offset = 0; offset < size;) {
+            const linux_dirent64 *entry = reinterpret_cast<const linux_dirent64*>(buffer + offset);
+            const char *name = entry->d_name;
+
+            offset += entry->d_reclen;
+
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                continue;
+            }
+
+            unsigned char type = entry->d_type;
+            struct stat st;
+            bool has_stat = false;
+
+            // some file systems do not fill in the type
+            if (type == DT_UNKNOWN || (countDataSize && type != DT_DIR)) {
+                if (::fstatat(node->fd, name, &st, AT_SYMLINK_NOFOLLOW) == 0) {
+                    has_stat = true;
+                    type = S_ISDIR(st.st_mode) ? DT_DIR : DT_REG;
+                }
+            }
+
+            if (type == DT_DIR) {
+                Node *child = new Node();
+
+                child->parent = node;
+                child->name = name;
+                node->pending.ref();
+                dispatch(child, localNodes);
+
+                continue;
+            }
+
+            if (::unlinkat(node->fd, name, 0) == 0) {
+                removedCount.fetchAndAddRelaxed(1);
+
+                if (has_stat && !S_ISLNK(st.st_mode)) {
+                    removedDataSize.fetchAndAddRelaxed(st.st_size);
+                }
+            } else {
+                addError(node, name, errno);
+                node->failed.store(1);
+            }
+        }
+
+        waitIfPaused();
+    }
+
+    if (stopped.load()) {
+        node->failed.store(1);
+    }
+
+    done(node);
+}
+
+void DLocalFileRemoverPrivate::dispatch(Node *node, QStack<Node*> &localNodes)
+{
+    // only hand out work while there are threads likely to be idle
+    if (queueSize.load() < threadCount) {
+        QMutexLocker locker(&mutex);
+
+        queue.enqueue(node);
+        queueSize.ref();
+        queueCondition.wakeOne();
+
+        return;
+    }
+
+    localNodes.push(node);
+}
+
+void DLocalFileRemoverPrivate::done(Node *node)
+{
+    if (node->pending.deref()) {
+        return;
+    }
+
+    // remove the directories whose children are all done, up to the root
+    while (node) {
+        Node *parent = node->parent;
+        bool ok = !node->failed.load() && !stopped.load();
+
+        if (node->fd >= 0) {
+            ::close(node->fd);
+        }
+
+        if (ok) {
+            if (::unlinkat(parent ? parent->fd : AT_FDCWD, node->name.constData(), AT_REMOVEDIR) == 0) {
+                if (parent) {
+                    removedCount.fetchAndAddRelaxed(1);
+                }
+            } else {
+                addError(parent, node->name, errno);
+                ok = false;
+            }
+        }
+
+        delete node;
+
+        if (!parent) {
+            QMutexLocker locker(&mutex);
+
+            removed = ok;
+            finished = true;
+            queueCondition.wakeAll();
+            finishedCondition.wakeAll();
+
+            return;
+        }
+
+        if (!ok) {
+            parent->failed.store(1);
+        }
+
+        node = parent->pending.deref() ? nullptr : parent;
+    }
+}
+
+void DLocalFileRemoverPrivate::waitIfPaused()
+{
+    if (!paused.load()) {
+        return;
+    }
+
+    QMutexLocker locker(&mutex);
+
+    while (paused.load() && !stopped.load()) {
+        pauseCondition.wait(&mutex);
+    }
+}
+
+void DLocalFileRemoverPrivate::addError(const Node *parent, const QByteArray &name, int errorNumber)
+{
+    QByteArray path = name;
+
+    for (const Node *node = parent; node; node = node->parent) {
+        path.prepend('/').prepend(node->name);
+    }
+
+    qWarning() << "Failed to remove" << path << ::strerror(errorNumber);
+
+    QMutexLocker locker(&mutex);
+
+    if (errors.count() < MAX_ERROR_COUNT) {
+        errors << DLocalFileRemover::Error {QFile::decodeName(path), errorNumber};
+    }
+}
+
+DLocalFileRemover::DLocalFileRemover(int maxThreadCount)
+    : d_ptr(new DLocalFileRemoverPrivate(maxThreadCount))
+{
+
+}
+
+DLocalFileRemover::~DLocalFileRemover()
+{
+    Q_D(DLocalFileRemover);
+
+    stop();
+    d->threadPool.waitForDone();
+}
+
+void DLocalFileRemover::setCountDataSize(bool countDataSize)
+{
+    Q_D(DLocalFileRemover);
+
+    d->countDataSize = countDataSize;
+}
+
+bool DLocalFileRemover::start(const QString &directoryPath)
+{
+    Q_D(DLocalFileRemover);
+
+    if (d->started) {
+        return false;
+    }
+
+    d->started = true;
+
+    Node *root = new Node();
+
+    root->name = QFile::encodeName(QDir::cleanPath(QDir::current().absoluteFilePath(directoryPath)));
+
+    d->queue.enqueue(root);
+    d->queueSize.ref();
+
+    for (int i = 0; i < d->threadCount; ++i) {
+        d->threadPool.start(new LocalFileRemoverWorker(d));
+    }
+
+    return true;
+}
+
+bool DLocalFileRemover::waitForFinished(int msecs)
+{
+    Q_D(DLocalFileRemover);
+
+    if (!d->started) {
+        return true;
+    }
+
+    QMutexLocker locker(&d->mutex);
+
+    while (!d->finished) {
+        if (!d->finishedCondition.wait(&d->mutex, msecs < 0 ? ULONG_MAX : static_cast<unsigned long>(msecs))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void DLocalFileRemover::stop()
+{
+    Q_D(DLocalFileRemover);
+
+    QMutexLocker locker(&d->mutex);
+
+    d->stopped.store(1);
+    d->pauseCondition.wakeAll();
+}
+
+void DLocalFileRemover::pause()
+{
+    Q_D(DLocalFileRemover);
+
+    d->paused.store(1);
+}
+
+void DLocalFileRemover::resume()
+{
+    Q_D(DLocalFileRemover);
+
+    QMutexLocker locker(&d->mutex);
+
+    d->paused.store(0);
+    d->pauseCondition.wakeAll();
+}
+
+bool DLocalFileRemover::isRemoved() const
+{
+    Q_D(const DLocalFileRemover);
+
+    QMutexLocker locker(&d->mutex);
+
+    return d->removed;
+}
+
+qint64 DLocalFileRemover::removedCount() const
+{
+    Q_D(const DLocalFileRemover);
+
+    return d->removedCount.load();
+}
+
+qint64 DLocalFileRemover::removedDataSize() const
+{
+    Q_D(const DLocalFileRemover);
+
+    return d->removedDataSize.load();
+}
+
+QList<DLocalFileRemover::Error> DLocalFileRemover::errors() const
+{
+    Q_D(const DLocalFileRemover);
+
+    QMutexLocker locker(&d->mutex);
+
+    return d->errors;
+}
+
+DFM_END_NAMESPACE
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DLOCALFILEREMOVER_H
+#define DLOCALFILEREMOVER_H
+
+#include <dfmglobal.h>
+
+#include <QScopedPointer>
+
+DFM_BEGIN_NAMESPACE
+
+// Removes a local directory tree. The tree is read with getdents64 on
+// directory descriptors and every entry is removed with unlinkat relative
+// to its parent, so no path is resolved twice. Independent sub directories
+// are handed out to a small pool of threads.
+// The remover does not ask anything on errors, it removes what it can and
+// records the failures; the caller decides how to handle what is left.
+class DLocalFileRemoverPrivate;
+class DLocalFileRemover
+{
+    Q_DECLARE_PRIVATE(DLocalFileRemover)
+
+public:
+    struct Error {
+        QString filePath;
+        int errorNumber;
+    };
+
+    // maxThreadCount <= 0 means decided by the number of cpu cores
+    explicit DLocalFileRemover(int maxThreadCount = 0);
+    ~DLocalFileRemover();
+
+    // stat every file for removedDataSize(), costs a syscall per file
+    void setCountDataSize(bool countDataSize);
+
+    bool start(const QString &directoryPath);
+    // return false if the timeout was reached
+    bool waitForFinished(int msecs = -1);
+
+    void stop();
+    void pause();
+    void resume();
+
+    // whether the directory itself was removed
+    bool isRemoved() const;
+    // entries removed below the directory
+    qint64 removedCount() const;
+    qint64 removedDataSize() const;
+    // only the first errors are kept
+    QList<Error> errors() const;
+
+private:
+    QScopedPointer<DLocalFileRemoverPrivate> d_ptr;
+
+    Q_DISABLE_COPY(DLocalFileRemover)
+};
+
+DFM_END_NAMESPACE
+
+#endif // DLOCALFILEREMOVER_H
@@ -0,0 +1,318 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "dmounttablecache.h"
+
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QDebug>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+DFM_BEGIN_NAMESPACE
+
+Q_GLOBAL_STATIC(DMountTableCache, mtcGlobal)
+
+// mountinfo escapes space, tab, newline and backslash as \ooo
+static QByteArray unescapeMountField(const QByteArray &field)
+{
+    if (!field.contains('\\'))
+        return field;
+
+    QByteArray result;
+    result.reserve(field.size());
+
+    for (int i = 0; i < field.size(); ++i) {
+        if (field.at(i) == '\\' && i + 3 < field.size()) {
+            bool ok = false;
+            const char c = static_cast<char>(field.mid(i + 1, 3).toInt(&ok, 8));
+
+            if (ok) {
+                result.append(c);
+                i += 3;
+                continue;
+            }
+        }
+
+        result.append(field.at(i));
+    }
+
+    return result;
+}
+
+// udev escapes unsafe characters of the label as \xHH
+static QString decodeLabel(const QString &name)
+{
+    if (!name.contains(QLatin1String("\\x")))
+        return name;
+
+    QByteArray result;
+    const QByteArray &data = QFile::encodeName(name);
+
+    for (int i = 0; i < data.size(); ++i) {
+        if (data.at(i) == '\\' && i + 3 < data.size() && data.at(i + 1) == 'x') {
+            bool ok = false;
+            const char c = static_cast<char>(data.mid(i + 2, 2).toInt(&ok, 16));
+
+            if (ok) {
+                result.append(c);
+                i += 3;
+                continue;
+            }
+        }
+
+        result.append(data.at(i));
+    }
+
+    return QString::fromUtf8(result);
+}
+
+// canonical device path -> label
+static QHash<QString, QString> deviceLabels()
+{
+    QHash<QString, QString> labels;
+    QDirIterator it(QStringLiteral("/dev/disk/by-label"), QDir::NoDotAndDotDot);
+
+    while (it.hasNext()) {
+        it.next();
+        labels.insert(it.fileInfo().canonicalFilePath(), decodeLabel(it.fileName()));
+    }
+
+    return labels;
+}
+
+DMountTableCache::DMountTableCache()
+{
+    m_mountInfoFd = ::open("/proc/self/mountinfo", O_RDONLY | O_CLOEXEC);
+
+    if (m_mountInfoFd < 0) {
+        qWarning() << "Failed to open /proc/self/mountinfo";
+    }
+}
+
+DMountTableCache::~DMountTableCache()
+{
+    if (m_mountInfoFd >= 0) {
+        ::close(m_mountInfoFd);
+    }
+}
+
+DMountTableCache *DMountTableCache::instance()
+{
+    return mtcGlobal;
+}
+
+bool DMountTableCache::findMount(const QString &path, MountEntry *entry)
+{
+    QString file_path = QFileInfo(path).absoluteFilePath();
+    struct stat st;
+
+    // use the nearest existing parent for a path that does not exist yet
+    while (::stat(QFile::encodeName(file_path).constData(), &st) != 0) {
+        if (file_path == QStringLiteral("/") || file_path.isEmpty())
+            return false;
+
+        file_path = QFileInfo(file_path).absolutePath();
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    checkForChanges();
+
+    const QVector<MountEntry> &entries = m_entries.value(st.st_dev);
+
+    if (entries.isEmpty())
+        return false;
+
+    // a device may be mounted more than once (bind mounts), prefer the
+    // deepest mount point containing the path
+    const MountEntry *best = &entries.first();
+    int best_length = -1;
+
+    for (const MountEntry &e : entries) {
+        if (e.rootPath.length() <= best_length)
+            continue;
+
+        if (file_path == e.rootPath || e.rootPath == QStringLiteral("/")
+                || file_path.startsWith(e.rootPath + QLatin1Char('/'))) {
+            best = &e;
+            best_length = e.rootPath.length();
+        }
+    }
+
+    if (entry)
+        *entry = *best;
+
+    return true;
+}
+
+bool DMountTableCache::findMount(dev_t dev, MountEntry *entry)
+{
+    QMutexLocker locker(&m_mutex);
+
+    checkForChanges();
+
+    const QVector<MountEntry> &entries = m_entries.value(dev);
+
+    if (entries.isEmpty())
+        return false;
+
+    if (entry)
+        *entry = entries.first();
+
+    return true;
+}
+
+QVector<DMountTableCache::MountEntry> DMountTableCache::mounts()
+{
+    QMutexLocker locker(&m_mutex);
+
+    checkForChanges();
+
+    QVector<MountEntry> list;
+
+    for (const QVector<MountEntry> &entries : m_entries)
+        list << entries;
+
+    return list;
+}
+
+quint64 DMountTableCache::generation()
+{
+    QMutexLocker locker(&m_mutex);
+
+    checkForChanges();
+
+    return m_generation;
+}
+
+void DMountTableCache::invalidate()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_dirty = true;
+}
+
+void DMountTableCache::checkForChanges()
+{
+    if (m_mountInfoFd >= 0 && !m_dirty) {
+        struct pollfd fds;
+
+        fds.fd = m_mountInfoFd;
+        fds.events = POLLPRI;
+        fds.revents = 0;
+
+        // the kernel raises POLLERR | POLLPRI once after each mount table change
+        if (::poll(&fds, 1, 0) > 0 && (fds.revents & (POLLERR | POLLPRI)))
+            m_dirty = true;
+    }
+
+    if (m_dirty)
+        reload();
+}
+
+void DMountTableCache::reload()
+{
+    m_dirty = false;
+    ++m_generation;
+    m_entries.clear();
+
+    if (m_mountInfoFd < 0)
+        return;
+
+    QByteArray data;
+    char buffer[4096];
+
+    ::lseek(m_mountInfoFd, 0, SEEK_SET);
+
+    forever {
+        ssize_t size = ::read(m_mountInfoFd, buffer, sizeof(buffer));
+
+        if (size < 0 && errno == EINTR)
+            continue;
+
+        if (size <= 0)
+            break;
+
+        data.append(buffer, static_cast<int>(size));
+    }
+
+    QHash<QString, dev_t> mount_points;
+    const QHash<QString, QString> &labels = deviceLabels();
+
+    // 36 35 98:0 /mnt1 /mnt/parent rw,noatime master:1 - ext3 /dev/root rw,errors=continue
+    for (const QByteArray &line : data.split('\n')) {
+        const QList<QByteArray> fields = line.split(' ');
+        const int separator = fields.indexOf("-", 6);
+
+        if (fields.size() < 10 || separator < 0 || separator + 3 > fields.size())
+            continue;
+
+        const QList<QByteArray> numbers = fields.at(2).split(':');
+
+        if (numbers.size() != 2)
+            continue;
+
+        MountEntry entry;
+
+        entry.dev = makedev(numbers.first().toUInt(), numbers.last().toUInt());
+        entry.rootPath = QFile::decodeName(unescapeMountField(fields.at(4)));
+        entry.readOnly = fields.at(5).split(',').contains("ro");
+        entry.fileSystemType = fields.at(separator + 1);
+        entry.device = unescapeMountField(fields.at(separator + 2));
+
+        if (!labels.isEmpty() && entry.device.startsWith("/dev/"))
+            entry.label = labels.value(QFileInfo(QFile::decodeName(entry.device)).canonicalFilePath());
+
+        // same rule as QStorageInfo: btrfs subvolumes are given by subvol=,
+        // everything else by the root of the mount within the filesystem
+        if (entry.fileSystemType == "btrfs" && separator + 3 < fields.size()) {
+            for (const QByteArray &option : fields.at(separator + 3).split(',')) {
+                if (option.startsWith("subvol="))
+                    entry.subvolume = option.mid(7);
+            }
+        } else if (fields.at(3) != "/") {
+            entry.subvolume = unescapeMountField(fields.at(3));
+        }
+
+        // a later mount on the same mount point hides the former one
+        auto hidden = mount_points.constFind(entry.rootPath);
+
+        if (hidden != mount_points.constEnd()) {
+            QVector<MountEntry> &list = m_entries[hidden.value()];
+
+            for (int i = list.count() - 1; i >= 0; --i) {
+                if (list.at(i).rootPath == entry.rootPath)
+                    list.remove(i);
+            }
+        }
+
+        mount_points[entry.rootPath] = entry.dev;
+        m_entries[entry.dev].append(entry);
+    }
+}
+
+DFM_END_NAMESPACE
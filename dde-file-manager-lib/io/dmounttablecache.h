@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DMOUNTTABLECACHE_H
+#define DMOUNTTABLECACHE_H
+
+#include <dfmglobal.h>
+
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+
+#include <sys/types.h>
+
+DFM_BEGIN_NAMESPACE
+
+// Process wide copy of /proc/self/mountinfo indexed by st_dev.
+// The table is only parsed again after the kernel reported a change of the
+// mount table (POLLPRI on the mountinfo file) or after invalidate() was called,
+// so looking up the mount of a path costs one stat() and a hash lookup.
+// All functions are thread safe.
+class DMountTableCache
+{
+public:
+    struct MountEntry {
+        dev_t dev = 0;
+        QString rootPath;
+        QByteArray device;
+        QByteArray fileSystemType;
+        QByteArray subvolume;
+        // from /dev/disk/by-label, empty if the device has no label
+        QString label;
+        bool readOnly = false;
+    };
+
+    static DMountTableCache *instance();
+
+    bool findMount(const QString &path, MountEntry *entry);
+    bool findMount(dev_t dev, MountEntry *entry);
+    // the visible mounts, in no particular order
+    QVector<MountEntry> mounts();
+
+    // increased every time the table is reloaded
+    quint64 generation();
+
+    // for udisks/gvfs mount signals, forces a reload on next lookup
+    void invalidate();
+
+    DMountTableCache();
+    ~DMountTableCache();
+
+private:
+    void checkForChanges();
+    void reload();
+
+    QMutex m_mutex;
+    int m_mountInfoFd = -1;
+    bool m_dirty = true;
+    quint64 m_generation = 0;
+    QHash<dev_t, QVector<MountEntry>> m_entries;
+};
+
+DFM_END_NAMESPACE
+
+#endif // DMOUNTTABLECACHE_H
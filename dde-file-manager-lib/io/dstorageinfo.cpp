@@ -21,6 +21,11 @@
 #include <gio/gio.h>
 
 #include "dstorageinfo.h"
+#include "dmounttablecache.h"
+
+#include <QMutex>
+
+#include <sys/statvfs.h>
 
 DFM_BEGIN_NAMESPACE
 
@@ -36,18 +41,172 @@ static QString preprocessPath(const QString &path, DStorageInfo::PathHints hints
     return path;
 }
 
+// Result of the GIO queries for mounts whose size can not be got by statvfs
+// (gvfs, mtp ...), shared by all paths of the same mount until the mount table
+// is changed.
+struct GioStorageInfo
+{
+    GFileInfo *gioInfo = nullptr;
+    QString rootPath;
+    QByteArray device;
+};
+
+class GioStorageInfoCache
+{
+public:
+    ~GioStorageInfoCache() {
+        for (const GioStorageInfo &info : infos) {
+            if (info.gioInfo)
+                g_object_unref(info.gioInfo);
+        }
+    }
+
+    bool find(const QString &key, quint64 generation, GioStorageInfo *info) {
+        QMutexLocker locker(&mutex);
+
+        if (generation != this->generation) {
+            clear();
+            this->generation = generation;
+
+            return false;
+        }
+
+        if (!infos.contains(key))
+            return false;
+
+        *info = infos.value(key);
+
+        if (info->gioInfo)
+            g_object_ref(info->gioInfo);
+
+        return true;
+    }
+
+    void insert(const QString &key, const GioStorageInfo &info) {
+        QMutexLocker locker(&mutex);
+
+        remove(key);
+
+        if (info.gioInfo)
+            g_object_ref(info.gioInfo);
+
+        infos.insert(key, info);
+    }
+
+    void remove(const QString &key) {
+        const GioStorageInfo &info = infos.take(key);
+
+        if (info.gioInfo)
+            g_object_unref(info.gioInfo);
+    }
+
+    void invalidate(const QString &key) {
+        QMutexLocker locker(&mutex);
+
+        remove(key);
+    }
+
+private:
+    void clear() {
+        for (const GioStorageInfo &info : infos) {
+            if (info.gioInfo)
+                g_object_unref(info.gioInfo);
+        }
+
+        infos.clear();
+    }
+
+    QMutex mutex;
+    quint64 generation = 0;
+    QHash<QString, GioStorageInfo> infos;
+};
+
+Q_GLOBAL_STATIC(GioStorageInfoCache, gioCache)
+
 class DStorageInfoPrivate : public QSharedData
 {
 public:
+    DStorageInfoPrivate() {}
+    DStorageInfoPrivate(const DStorageInfoPrivate &other)
+        : QSharedData(other)
+        , gioInfo(other.gioInfo)
+        , rootPath(other.rootPath)
+        , device(other.device)
+        , cached(other.cached)
+        , mount(other.mount)
+        , path(other.path)
+        , usageLoaded(other.usageLoaded)
+        , bytesTotal(other.bytesTotal)
+        , bytesFree(other.bytesFree)
+        , bytesAvailable(other.bytesAvailable)
+    {
+        if (gioInfo)
+            g_object_ref(gioInfo);
+    }
+
     ~DStorageInfoPrivate() {
         if (gioInfo) {
             g_object_unref(gioInfo);
         }
     }
 
+    void reset() {
+        if (gioInfo) {
+            g_object_unref(gioInfo);
+            gioInfo = nullptr;
+        }
+
+        rootPath.clear();
+        device.clear();
+        cached = false;
+        mount = DMountTableCache::MountEntry();
+        path.clear();
+        usageLoaded = false;
+        bytesTotal = bytesFree = bytesAvailable = -1;
+    }
+
+    // the sizes of cached mounts, statvfs is called once per setPath
+    void loadUsage() const {
+        QMutexLocker locker(&usageMutex);
+
+        if (usageLoaded)
+            return;
+
+        usageLoaded = true;
+
+        struct statvfs info;
+
+        if (statvfs(QFile::encodeName(path).constData(), &info) == 0) {
+            bytesTotal = static_cast<qint64>(info.f_blocks) * info.f_frsize;
+            bytesFree = static_cast<qint64>(info.f_bfree) * info.f_frsize;
+            bytesAvailable = static_cast<qint64>(info.f_bavail) * info.f_frsize;
+        }
+    }
+
+    // mounts served by gvfsd-fuse are one directory each below the fuse mount point
+    QString gioCacheKey(const QString &path) const {
+        if (mount.device == QByteArrayLiteral("gvfsd-fuse") && path.startsWith(mount.rootPath + QLatin1Char('/'))) {
+            const QString &sub_path = path.mid(mount.rootPath.length() + 1);
+
+            return mount.rootPath + QLatin1Char('/') + sub_path.section(QLatin1Char('/'), 0, 0);
+        }
+
+        return mount.rootPath;
+    }
+
     GFileInfo *gioInfo = nullptr;
     QString rootPath;
     QByteArray device;
+
+    // true if the mount information is from DMountTableCache
+    bool cached = false;
+    DMountTableCache::MountEntry mount;
+    QString path;
+    mutable bool usageLoaded = false;
+    mutable QMutex usageMutex;
+    mutable qint64 bytesTotal = -1;
+    mutable qint64 bytesFree = -1;
+    mutable qint64 bytesAvailable = -1;
 };
 
 DStorageInfo::DStorageInfo()
@@ -83,6 +242,7 @@ DStorageInfo::~DStorageInfo()
 
 DStorageInfo &DStorageInfo::operator=(const DStorageInfo &other)
 {
+    QStorageInfo::operator=(other);
     d_ptr = other.d_ptr;
 
     return *this;
@@ -90,13 +250,38 @@ DStorageInfo &DStorageInfo::operator=(const DStorageInfo &other)
 
 void DStorageInfo::setPath(const QString &path, PathHints hints)
 {
-    QStorageInfo::setPath(preprocessPath(path, hints));
+    const QString &real_path = preprocessPath(path, hints);
+
+    d_ptr.detach();
 
     Q_D(DStorageInfo);
 
-    d_ptr.detach();
+    d->reset();
+
+    // Look up the mount in the process wide mount table, this avoids parsing
+    // /proc/self/mountinfo in QStorageInfo::setPath for every call.
+    if (DMountTableCache::instance()->findMount(real_path, &d->mount)) {
+        d->cached = true;
+        d->path = real_path;
+        // the GIO fallback below also replaces the root path and device, so
+        // the size is needed now, one statvfs instead of parsing the mount table
+        d->loadUsage();
+    } else {
+        QStorageInfo::setPath(real_path);
+    }
+
+    if (bytesTotal() <= 0) {
+        const QString &cache_key = d->cached ? d->gioCacheKey(QFileInfo(real_path).absoluteFilePath()) : QString();
+        GioStorageInfo gio_info;
+
+        if (!cache_key.isEmpty() && gioCache->find(cache_key, DMountTableCache::instance()->generation(), &gio_info)) {
+            d->gioInfo = gio_info.gioInfo;
+            d->rootPath = gio_info.rootPath;
+            d->device = gio_info.device;
+
+            return;
+        }
 
-    if (QStorageInfo::bytesTotal() <= 0) {
         GFile *file = g_file_new_for_path(QFile::encodeName(path).constData());
         GError *error = nullptr;
         d->gioInfo = g_file_query_filesystem_info(file, "filesystem::*", nullptr, &error);
@@ -119,7 +304,7 @@ void DStorageInfo::setPath(const QString &path, PathHints hints)
             char *root_path = g_file_get_path(root_file);
 
             d->rootPath = QFile::decodeName(root_path);
-            d->device = QStorageInfo::device();
+            d->device = d->cached ? d->mount.device : QStorageInfo::device();
 
             if (d->device == QByteArrayLiteral("gvfsd-fuse")) {
                 char *uri = g_file_get_uri(root_file);
@@ -134,6 +319,14 @@ void DStorageInfo::setPath(const QString &path, PathHints hints)
         }
 
         g_object_unref(file);
+
+        if (!cache_key.isEmpty()) {
+            gio_info.gioInfo = d->gioInfo;
+            gio_info.rootPath = d->rootPath;
+            gio_info.device = d->device;
+
+            gioCache->insert(cache_key, gio_info);
+        }
     }
 }
 
@@ -145,6 +338,9 @@ QString DStorageInfo::rootPath() const
         return d->rootPath;
     }
 
+    if (d->cached)
+        return d->mount.rootPath;
+
     return QStorageInfo::rootPath();
 }
 
@@ -153,7 +349,7 @@ QByteArray DStorageInfo::device() const
     Q_D(const DStorageInfo);
 
     if (d->device.isEmpty())
-        return QStorageInfo::device();
+        return d->cached ? d->mount.device : QStorageInfo::device();
 
     return d->device;
 }
@@ -166,9 +362,26 @@ QByteArray DStorageInfo::fileSystemType() const
         return g_file_info_get_attribute_string(d->gioInfo, G_FILE_ATTRIBUTE_FILESYSTEM_TYPE);
     }
 
+    if (d->cached)
+        return d->mount.fileSystemType;
+
     return QStorageInfo::fileSystemType();
 }
 
+QByteArray DStorageInfo::subvolume() const
+{
+    Q_D(const DStorageInfo);
+
+    if (d->cached)
+        return d->mount.subvolume;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+    return QStorageInfo::subvolume();
+#else
+    return QByteArray();
+#endif
+}
+
 qint64 DStorageInfo::bytesTotal() const
 {
     Q_D(const DStorageInfo);
@@ -176,6 +389,12 @@ qint64 DStorageInfo::bytesTotal() const
     if (d->gioInfo)
         return g_file_info_get_attribute_uint64(d->gioInfo, G_FILE_ATTRIBUTE_FILESYSTEM_SIZE);
 
+    if (d->cached) {
+        d->loadUsage();
+
+        return d->bytesTotal;
+    }
+
     return QStorageInfo::bytesTotal();
 }
 
@@ -189,6 +408,12 @@ qint64 DStorageInfo::bytesFree() const
         return bytesTotal() - used;
     }
 
+    if (d->cached) {
+        d->loadUsage();
+
+        return d->bytesFree;
+    }
+
     return QStorageInfo::bytesFree();
 }
 
@@ -200,9 +425,35 @@ qint64 DStorageInfo::bytesAvailable() const
         return g_file_info_get_attribute_uint64(d->gioInfo, G_FILE_ATTRIBUTE_FILESYSTEM_FREE);
     }
 
+    if (d->cached) {
+        d->loadUsage();
+
+        return d->bytesAvailable;
+    }
+
     return QStorageInfo::bytesAvailable();
 }
 
+QString DStorageInfo::name() const
+{
+    Q_D(const DStorageInfo);
+
+    if (d->cached)
+        return d->mount.label;
+
+    return QStorageInfo::name();
+}
+
+QString DStorageInfo::displayName() const
+{
+    const QString &label = name();
+
+    if (!label.isEmpty())
+        return label;
+
+    return rootPath();
+}
+
 bool DStorageInfo::isReadOnly() const
 {
     Q_D(const DStorageInfo);
@@ -211,13 +462,45 @@ bool DStorageInfo::isReadOnly() const
         return g_file_info_get_attribute_boolean(d->gioInfo, G_FILE_ATTRIBUTE_FILESYSTEM_READONLY);
     }
 
+    if (d->cached)
+        return d->mount.readOnly;
+
     return QStorageInfo::isReadOnly();
 }
 
+bool DStorageInfo::isReady() const
+{
+    Q_D(const DStorageInfo);
+
+    if (d->cached) {
+        if (d->gioInfo)
+            return true;
+
+        d->loadUsage();
+
+        return d->bytesTotal >= 0;
+    }
+
+    return QStorageInfo::isReady();
+}
+
+bool DStorageInfo::isRoot() const
+{
+    Q_D(const DStorageInfo);
+
+    if (d->cached)
+        return rootPath() == QStringLiteral("/");
+
+    return QStorageInfo::isRoot();
+}
+
 bool DStorageInfo::isValid() const
 {
     Q_D(const DStorageInfo);
 
+    if (d->cached)
+        return true;
+
     return QStorageInfo::isValid();
 }
 
@@ -225,8 +508,16 @@ void DStorageInfo::refresh()
 {
     Q_D(DStorageInfo);
 
-    QStorageInfo::refresh();
-    setPath(rootPath());
+    const QString root_path = rootPath();
+
+    // the free space of gio mounts is cached, query it again
+    if (d->gioInfo && d->cached)
+        gioCache->invalidate(d->gioCacheKey(root_path));
+
+    if (!d->cached)
+        QStorageInfo::refresh();
+
+    setPath(root_path);
 }
 
 bool DStorageInfo::inSameDevice(QString path1, QString path2, PathHints hints)
@@ -301,10 +592,8 @@ QDebug operator<<(QDebug debug, const DFM_NAMESPACE::DStorageInfo &info)
             debug << ", name=\"" << info.name() << '"';
         if (!info.device().isEmpty())
             debug << ", device=\"" << info.device() << '"';
-#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
         if (!info.subvolume().isEmpty())
             debug << ", subvolume=\"" << info.subvolume() << '"';
-#endif
         if (info.isReadOnly())
             debug << " [read only]";
         debug << (info.isReady() ? " [ready]" : " [not ready]");
@@ -58,12 +58,18 @@ public:
     QString rootPath() const;
     QByteArray device() const;
     QByteArray fileSystemType() const;
+    QByteArray subvolume() const;
 
     qint64 bytesTotal() const;
     qint64 bytesFree() const;
     qint64 bytesAvailable() const;
 
+    QString name() const;
+    QString displayName() const;
+
     bool isReadOnly() const;
+    bool isReady() const;
+    bool isRoot() const;
 
     bool isValid() const;
     void refresh();
@@ -0,0 +1,356 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "dtrashcatalog.h"
+#include "interfaces/dfmstandardpaths.h"
+#include "shutil/fileutils.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QSaveFile>
+#include <QSet>
+
+#include <sys/stat.h>
+
+DFM_BEGIN_NAMESPACE
+
+Q_GLOBAL_STATIC(DTrashCatalog, tcGlobal)
+
+static qint64 modifiedTime(const QString &path, bool nanoseconds)
+{
+    struct stat st;
+
+    if (::stat(QFile::encodeName(path).constData(), &st) != 0)
+        return -1;
+
+    if (!nanoseconds)
+        return st.st_mtim.tv_sec;
+
+    return qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+}
+
+static DTrashCatalog::Record parseTrashInfo(const QString &fileName, const QString &trashPath)
+{
+    DTrashCatalog::Record record;
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly))
+        return record;
+
+    bool in_group = false;
+
+    for (const QByteArray &data : file.readAll().split('\n')) {
+        const QByteArray &line = data.trimmed();
+
+        if (line.startsWith('[')) {
+            in_group = line == "[Trash Info]";
+            continue;
+        }
+
+        const int index = line.indexOf('=');
+
+        if (!in_group || index <= 0)
+            continue;
+
+        const QByteArray &key = line.left(index).trimmed();
+        const QByteArray &value = line.mid(index + 1).trimmed();
+
+        if (key == "Path") {
+            record.originalPath = QString::fromUtf8(QByteArray::fromPercentEncoding(value));
+
+            // the paths in a volume trash may be relative to the top directory of the volume
+            if (!record.originalPath.startsWith('/'))
+                record.originalPath = QDir(DFMStandardPaths::trashTopDir(trashPath)).absoluteFilePath(record.originalPath);
+        } else if (key == "DeletionDate") {
+            record.deletionDateString = QString::fromUtf8(value);
+            record.deletionDate = QDateTime::fromString(record.deletionDateString, Qt::ISODate);
+        } else if (key == "TagNameList" && !value.isEmpty()) {
+            record.tagNameList = QString::fromUtf8(value).split(',');
+        }
+    }
+
+    return record;
+}
+
+DTrashCatalog::DTrashCatalog()
+{
+
+}
+
+DTrashCatalog::~DTrashCatalog()
+{
+    sync();
+}
+
+DTrashCatalog *DTrashCatalog::instance()
+{
+    return tcGlobal;
+}
+
+bool DTrashCatalog::record(const QString &trashPath, const QString &name, Record *record)
+{
+    QMutexLocker locker(&m_mutex);
+
+    Trash &t = trash(trashPath);
+
+    refresh(trashPath, t);
+
+    auto it = t.records.constFind(name);
+
+    if (it == t.records.constEnd())
+        return false;
+
+    if (record)
+        *record = it.value();
+
+    return true;
+}
+
+int DTrashCatalog::count()
+{
+    const QStringList &trash_paths = DFMStandardPaths::trashPaths();
+    QMutexLocker locker(&m_mutex);
+    int count = 0;
+
+    for (const QString &path : trash_paths) {
+        count += filesCount(path, trash(path));
+    }
+
+    return count;
+}
+
+bool DTrashCatalog::isEmpty()
+{
+    const QStringList &trash_paths = DFMStandardPaths::trashPaths();
+    QMutexLocker locker(&m_mutex);
+
+    for (const QString &path : trash_paths) {
+        if (hasFiles(path, trash(path)))
+            return false;
+    }
+
+    return true;
+}
+
+qint64 DTrashCatalog::size(const QString &trashPath, const QString &name)
+{
+    const QString &file_path = trashPath + "/files/" + name;
+    struct stat st;
+
+    if (::lstat(QFile::encodeName(file_path).constData(), &st) != 0)
+        return -1;
+
+    if (!S_ISDIR(st.st_mode))
+        return st.st_size;
+
+    // same as the directorysizes of the specification, the entry is valid
+    // while the mtime of the .trashinfo file is not changed
+    const qint64 info_mtime = modifiedTime(trashPath + "/info/" + name + ".trashinfo", false);
+
+    {
+        QMutexLocker locker(&m_mutex);
+        Trash &t = trash(trashPath);
+
+        loadDirectorySizes(trashPath, t);
+
+        auto it = t.directorySizes.constFind(name);
+
+        if (it != t.directorySizes.constEnd() && it->infoMTime == info_mtime)
+            return it->size;
+    }
+
+    const qint64 size = FileUtils::totalSize(file_path);
+
+    QMutexLocker locker(&m_mutex);
+    Trash &t = trash(trashPath);
+
+    t.directorySizes[name] = DirectorySize{size, info_mtime};
+    t.directorySizesChanged = true;
+
+    return size;
+}
+
+qint64 DTrashCatalog::totalSize()
+{
+    QList<QPair<QString, QString>> items;
+
+    {
+        const QStringList &trash_paths = DFMStandardPaths::trashPaths();
+        QMutexLocker locker(&m_mutex);
+
+        for (const QString &path : trash_paths) {
+            Trash &t = trash(path);
+
+            refresh(path, t);
+
+            for (auto it = t.records.constBegin(); it != t.records.constEnd(); ++it)
+                items << qMakePair(path, it.key());
+        }
+    }
+
+    qint64 total = 0;
+
+    for (const QPair<QString, QString> &item : items)
+        total += qMax(size(item.first, item.second), qint64(0));
+
+    sync();
+
+    return total;
+}
+
+void DTrashCatalog::sync()
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (auto it = m_trashes.begin(); it != m_trashes.end(); ++it) {
+        if (!it->directorySizesChanged)
+            continue;
+
+        it->directorySizesChanged = false;
+        saveDirectorySizes(it.key(), it.value());
+    }
+}
+
+void DTrashCatalog::invalidate()
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (Trash &t : m_trashes) {
+        t.dirty = true;
+    }
+}
+
+DTrashCatalog::Trash &DTrashCatalog::trash(const QString &trashPath)
+{
+    return m_trashes[trashPath];
+}
+
+void DTrashCatalog::refresh(const QString &trashPath, Trash &trash)
+{
+    const QString &info_path = trashPath + "/info";
+    const qint64 info_mtime = modifiedTime(info_path, true);
+
+    if (!trash.dirty && info_mtime == trash.infoMTime)
+        return;
+
+    trash.dirty = false;
+    trash.infoMTime = info_mtime;
+
+    const QStringList &entries = QDir(info_path).entryList({"*.trashinfo"}, QDir::Files | QDir::Hidden | QDir::System);
+    QSet<QString> names;
+
+    for (const QString &entry : entries) {
+        const QString &name = entry.left(entry.size() - 10);
+
+        names << name;
+
+        // the .trashinfo files are never changed after they were written
+        if (!trash.records.contains(name))
+            trash.records[name] = parseTrashInfo(info_path + "/" + entry, trashPath);
+    }
+
+    for (auto it = trash.records.begin(); it != trash.records.end();) {
+        if (names.contains(it.key()))
+            ++it;
+        else
+            it = trash.records.erase(it);
+    }
+}
+
+int DTrashCatalog::filesCount(const QString &trashPath, Trash &trash)
+{
+    const QString &files_path = trashPath + "/files";
+    const qint64 files_mtime = modifiedTime(files_path, true);
+
+    if (files_mtime >= 0 && files_mtime == trash.filesMTime)
+        return trash.filesCount;
+
+    QDirIterator iterator(files_path, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+    int count = 0;
+
+    while (iterator.hasNext()) {
+        iterator.next();
+        ++count;
+    }
+
+    trash.filesMTime = files_mtime;
+    trash.filesCount = count;
+
+    return count;
+}
+
+bool DTrashCatalog::hasFiles(const QString &trashPath, Trash &trash)
+{
+    const QString &files_path = trashPath + "/files";
+    const qint64 files_mtime = modifiedTime(files_path, true);
+
+    if (files_mtime >= 0 && files_mtime == trash.filesMTime)
+        return trash.filesCount > 0;
+
+    // stop at the first entry, the count is left to count()
+    return QDirIterator(files_path, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot).hasNext();
+}
+
+void DTrashCatalog::loadDirectorySizes(const QString &trashPath, Trash &trash)
+{
+    if (trash.directorySizesLoaded)
+        return;
+
+    trash.directorySizesLoaded = true;
+
+    QFile file(trashPath + "/directorysizes");
+
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    // [size] [mtime] [percent-encoded-directory-name]
+    for (const QByteArray &line : file.readAll().split('\n')) {
+        const QList<QByteArray> &fields = line.split(' ');
+
+        if (fields.size() != 3)
+            continue;
+
+        const QString &name = QString::fromUtf8(QByteArray::fromPercentEncoding(fields.at(2)));
+
+        trash.directorySizes[name] = DirectorySize{fields.at(0).toLongLong(), fields.at(1).toLongLong()};
+    }
+}
+
+void DTrashCatalog::saveDirectorySizes(const QString &trashPath, const Trash &trash)
+{
+    QSaveFile file(trashPath + "/directorysizes");
+
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    for (auto it = trash.directorySizes.constBegin(); it != trash.directorySizes.constEnd(); ++it) {
+        // drop the directories that are not in the trash any longer
+        if (!trash.dirty && !trash.records.contains(it.key()))
+            continue;
+
+        file.write(QByteArray::number(it->size) + ' ' + QByteArray::number(it->infoMTime) + ' '
+                   + it.key().toUtf8().toPercentEncoding() + '\n');
+    }
+
+    file.commit();
+}
+
+DFM_END_NAMESPACE
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DTRASHCATALOG_H
+#define DTRASHCATALOG_H
+
+#include <dfmglobal.h>
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+
+DFM_BEGIN_NAMESPACE
+
+// Process wide index of the .trashinfo files of the home trash and the volume
+// trashes. The info directory of a trash is only read again after its mtime
+// changed or after invalidate() was called, and then only the new .trashinfo
+// files are parsed, so counting the trash items and looking up the original
+// path of an item do not touch the disk for every item.
+// The items are the entries of the files directories, so the files without a
+// .trashinfo file are counted too.
+// The sizes of the trashed directories are cached in the "directorysizes" file
+// of the trash as described by the freedesktop trash specification. The file
+// is written once by totalSize() or sync(), not for every computed size.
+// All functions are thread safe.
+class DTrashCatalog
+{
+public:
+    struct Record {
+        // absolute, the relative paths of a volume trash are resolved
+        QString originalPath;
+        QDateTime deletionDate;
+        // as written in the .trashinfo file, if it isn't a valid ISO date
+        QString deletionDateString;
+        QStringList tagNameList;
+    };
+
+    static DTrashCatalog *instance();
+
+    // the record of files/<name> in the trash directory
+    bool record(const QString &trashPath, const QString &name, Record *record);
+    // the number of items in all the trash directories
+    int count();
+    bool isEmpty();
+
+    qint64 size(const QString &trashPath, const QString &name);
+    qint64 totalSize();
+    // writes the changed directorysizes files
+    void sync();
+
+    // for the trash watchers, forces to read the info directories on next lookup
+    void invalidate();
+
+    DTrashCatalog();
+    ~DTrashCatalog();
+
+private:
+    struct DirectorySize {
+        qint64 size;
+        qint64 infoMTime;
+    };
+
+    struct Trash {
+        bool dirty = true;
+        qint64 infoMTime = -1;
+        QHash<QString, Record> records;
+        qint64 filesMTime = -1;
+        int filesCount = 0;
+        bool directorySizesLoaded = false;
+        bool directorySizesChanged = false;
+        QHash<QString, DirectorySize> directorySizes;
+    };
+
+    Trash &trash(const QString &trashPath);
+    void refresh(const QString &trashPath, Trash &trash);
+    int filesCount(const QString &trashPath, Trash &trash);
+    bool hasFiles(const QString &trashPath, Trash &trash);
+    void loadDirectorySizes(const QString &trashPath, Trash &trash);
+    void saveDirectorySizes(const QString &trashPath, const Trash &trash);
+
+    QMutex m_mutex;
+    QHash<QString, Trash> m_trashes;
+};
+
+DFM_END_NAMESPACE
+
+#endif // DTRASHCATALOG_H
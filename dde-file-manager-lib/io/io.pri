@@ -9,6 +9,12 @@ HEADERS += \
     $$PWD/dlocalfilehandler.h \
     $$PWD/dfilestatisticsjob.h \
     $$PWD/dstorageinfo.h \
+    $$PWD/dmounttablecache.h \
+    $$PWD/dlocalfileremover.h \
+    $$PWD/dfilejobscheduler.h \
+    $$PWD/dfilejobtracer.h \
+    $$PWD/dtrashcatalog.h \
+    $$PWD/ddirectorynamecache.h \
     $$PWD/dgiofiledevice.h
 
 SOURCES += \
@@ -20,6 +26,12 @@ SOURCES += \
     $$PWD/dlocalfilehandler.cpp \
     $$PWD/dfilestatisticsjob.cpp \
     $$PWD/dstorageinfo.cpp \
+    $$PWD/dmounttablecache.cpp \
+    $$PWD/dlocalfileremover.cpp \
+    $$PWD/dfilejobscheduler.cpp \
+    $$PWD/dfilejobtracer.cpp \
+    $$PWD/dtrashcatalog.cpp \
+    $$PWD/ddirectorynamecache.cpp \
     $$PWD/dgiofiledevice.cpp
 
 include(private/private.pri)
@@ -69,6 +69,8 @@ public:
     DFileCopyMoveJob::Action handleError(const DAbstractFileInfo *sourceInfo, const DAbstractFileInfo *targetInfo);
     bool jobWait();
     bool stateCheck();
+    bool waitForDevices();
+    bool movesData() const;
     bool checkFileSize(qint64 size) const;
     bool checkFreeSpace(qint64 needSize);
     QString formatFileName(const QString &name) const;
@@ -79,6 +81,7 @@ public:
     bool mergeDirectory(DFileHandler *handler, const DAbstractFileInfo *fromInfo, const DAbstractFileInfo *toInfo);
     bool doCopyFile(const DAbstractFileInfo *fromInfo, const DAbstractFileInfo *toInfo, int blockSize = 1048576);
     bool doRemoveFile(DFileHandler *handler, const DAbstractFileInfo *fileInfo);
+    bool removeLocalDirectory(DFileHandler *handler, const DAbstractFileInfo *fileInfo);
     bool doRenameFile(DFileHandler *handler, const DAbstractFileInfo *oldInfo, const DAbstractFileInfo *newInfo);
     bool doLinkFile(DFileHandler *handler, const DAbstractFileInfo *fileInfo, const QString &linkPath);
 
@@ -130,6 +133,10 @@ public:
     QTimer *updateSpeedTimer = nullptr;
     int timeOutCount = 0;
     bool needUpdateProgress = false;
+    // the id of the job in DFileJobTracer, 0 if the tracing is disabled
+    quint64 traceJob = 0;
+    // only the jobs which copy the file data wait for their disks in DFileJobScheduler
+    bool scheduled = false;
 
     Q_DECLARE_PUBLIC(DFileCopyMoveJob)
 };
@@ -270,7 +270,7 @@ QSet<MenuAction> DesktopFileInfo::disableMenuActionList() const
     Q_D(const DesktopFileInfo);
     if(d->deepinID == "dde-trash"){
         QSet<MenuAction> actions;
-        if(FileUtils::filesCount(DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath)) <= 0)
+        if(TrashManager::isEmpty())
             actions << MenuAction::ClearTrash;
         return actions;
     }
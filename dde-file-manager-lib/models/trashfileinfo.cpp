@@ -35,11 +35,13 @@
 #include "singleton.h"
 #include "fileoperations/filejob.h"
 #include "dialogs/dialogmanager.h"
+#include "dtrashcatalog.h"
 
 #include <QMimeType>
-#include <QSettings>
 #include <QIcon>
 
+DFM_USE_NAMESPACE
+
 namespace FileSortFunction
 {
 COMPARE_FUN_DEFINE(deletionDate, DeletionDate, TrashFileInfo)
@@ -61,6 +63,8 @@ public:
     QString displayDeletionDate;
     QDateTime deletionDate;
     QStringList tagNameList;
+    // the trash directory containing the file, contains files/ and info/
+    QString trashPath;
 
     void updateInfo();
     void inheritParentTrashInfo();
@@ -69,31 +73,23 @@ public:
 void TrashFileInfoPrivate::updateInfo()
 {
     const QString &filePath = proxy->absoluteFilePath();
-    const QString &basePath = DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath);
+    const QString &basePath = trashPath + "/files";
     const QString &fileBaseName = QDir::separator() + proxy->fileName();
+    DTrashCatalog::Record record;
 
-    if (QFile::exists(DFMStandardPaths::location(DFMStandardPaths::TrashInfosPath) + fileBaseName + ".trashinfo")) {
-        QSettings setting(DFMStandardPaths::location(DFMStandardPaths::TrashInfosPath) + fileBaseName + ".trashinfo", QSettings::NativeFormat);
-
-        setting.beginGroup("Trash Info");
-        setting.setIniCodec("utf-8");
-
-        originalFilePath = QByteArray::fromPercentEncoding(setting.value("Path").toByteArray()) + filePath.mid(basePath.size() + fileBaseName.size());
+    if (DTrashCatalog::instance()->record(trashPath, proxy->fileName(), &record)) {
+        originalFilePath = record.originalPath + filePath.mid(basePath.size() + fileBaseName.size());
 
         displayName = originalFilePath.mid(originalFilePath.lastIndexOf('/') + 1);
 
-        deletionDate = QDateTime::fromString(setting.value("DeletionDate").toString(), Qt::ISODate);
+        deletionDate = record.deletionDate;
         displayDeletionDate = deletionDate.toString(DAbstractFileInfo::dateTimeFormat());
 
         if (displayDeletionDate.isEmpty()) {
-            displayDeletionDate = setting.value("DeletionDate").toString();
+            displayDeletionDate = record.deletionDateString;
         }
 
-        const QString &tag_name_list = setting.value("TagNameList").toString();
-
-        if (!tag_name_list.isEmpty()) {
-            tagNameList = tag_name_list.split(",");
-        }
+        tagNameList = record.tagNameList;
     } else {
         //inherits from parent trash info
         inheritParentTrashInfo();
@@ -116,7 +112,7 @@ void TrashFileInfoPrivate::updateInfo()
 void TrashFileInfoPrivate::inheritParentTrashInfo()
 {
     const QString &filePath = proxy->absoluteFilePath();
-    QString nameLayer = filePath.right(filePath.length() - DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath).length() - 1);
+    QString nameLayer = filePath.right(filePath.length() - (trashPath + "/files").length() - 1);
     QStringList names = nameLayer.split("/");
 
     QString name = names.takeFirst();
@@ -125,19 +121,16 @@ void TrashFileInfoPrivate::inheritParentTrashInfo()
         restPath += "/" + str;
     }
 
-    if (QFile::exists(DFMStandardPaths::location(DFMStandardPaths::TrashInfosPath) + QDir::separator() + name + ".trashinfo")) {
-        QSettings setting(DFMStandardPaths::location(DFMStandardPaths::TrashInfosPath) + QDir::separator() + name + ".trashinfo", QSettings::NativeFormat);
+    DTrashCatalog::Record record;
 
-        setting.beginGroup("Trash Info");
-        setting.setIniCodec("utf-8");
+    if (DTrashCatalog::instance()->record(trashPath, name, &record)) {
+        originalFilePath = record.originalPath + restPath;
 
-        originalFilePath = QByteArray::fromPercentEncoding(setting.value("Path").toByteArray()) + restPath;
-
-        deletionDate = QDateTime::fromString(setting.value("DeletionDate").toString(), Qt::ISODate);
+        deletionDate = record.deletionDate;
         displayDeletionDate = deletionDate.toString(DAbstractFileInfo::dateTimeFormat());
 
         if (displayDeletionDate.isEmpty()) {
-            displayDeletionDate = setting.value("DeletionDate").toString();
+            displayDeletionDate = record.deletionDateString;
         }
     }
 }
@@ -153,7 +146,7 @@ TrashFileInfo::TrashFileInfo(const DUrl &url)
         qWarning() << "mkpath trash files path failed, path =" << trashFilesPath;
     }
 
-    setProxy(DAbstractFileInfoPointer(new DFileInfo(trashFilesPath + url.path())));
+    setProxy(DAbstractFileInfoPointer(new DFileInfo(DFMStandardPaths::trashUrlPathToLocal(url.path(), &d->trashPath))));
     d->updateInfo();
 }
 
@@ -191,6 +184,24 @@ bool TrashFileInfo::isDir() const
     return DAbstractFileInfo::isDir();
 }
 
+qint64 TrashFileInfo::size() const
+{
+    if (fileUrl() == DUrl::fromTrashFile("/")) {
+        return DTrashCatalog::instance()->totalSize();
+    }
+
+    return DAbstractFileInfo::size();
+}
+
+int TrashFileInfo::filesCount() const
+{
+    if (fileUrl() == DUrl::fromTrashFile("/")) {
+        return DTrashCatalog::instance()->count();
+    }
+
+    return DAbstractFileInfo::filesCount();
+}
+
 QString TrashFileInfo::fileDisplayName() const
 {
     Q_D(const TrashFileInfo);
@@ -482,32 +493,75 @@ DAbstractFileInfo::CompareFunction TrashFileInfo::compareFunByColumn(int columnR
 
 bool TrashFileInfo::restore() const
 {
-    Q_D(const TrashFileInfo);
+    return restore(QList<const TrashFileInfo*>() << this);
+}
 
-    if (d->originalFilePath.isEmpty()) {
-        qDebug() << "OriginalFile path ie empty.";
+bool TrashFileInfo::restore(const QList<const TrashFileInfo *> &list, DUrlList *failedUrls)
+{
+    bool ok = true;
+    QStringList src_list;
+    QStringList tar_list;
+    QList<const TrashFileInfo*> job_list;
 
-        return false;
-    }
+    for (const TrashFileInfo *info : list) {
+        const TrashFileInfoPrivate *d = info->d_func();
+
+        if (d->originalFilePath.isEmpty()) {
+            qDebug() << "OriginalFile path ie empty.";
+
+            ok = false;
+
+            if (failedUrls)
+                failedUrls->append(info->fileUrl());
+
+            continue;
+        }
+
+        QDir dir(d->originalFilePath.left(d->originalFilePath.lastIndexOf('/')));
+
+        if (dir.isAbsolute() && !dir.mkpath(dir.absolutePath())) {
+            qDebug() << "mk" << dir.absolutePath() << "failed!";
 
-    QDir dir(d->originalFilePath.left(d->originalFilePath.lastIndexOf('/')));
+            ok = false;
 
-    if (dir.isAbsolute() && !dir.mkpath(dir.absolutePath())) {
-        qDebug() << "mk" << dir.absolutePath() << "failed!";
+            if (failedUrls)
+                failedUrls->append(info->fileUrl());
 
-        return false;
+            continue;
+        }
+
+        src_list << info->absoluteFilePath();
+        tar_list << d->originalFilePath;
+        job_list << info;
     }
 
+    if (job_list.isEmpty())
+        return ok;
+
     FileJob job(FileJob::Restore);
+    QStringList restored_list;
 
     dialogManager->addJob(&job);
 
-    bool ok = job.doTrashRestore(absoluteFilePath(), d->originalFilePath);
+    ok = job.doTrashRestore(src_list, tar_list, &restored_list) && ok;
     dialogManager->removeJob(job.getJobId());
 
-    // restore the file tag infos
-    if (ok && !d->tagNameList.isEmpty()) {
-        DFileService::instance()->setFileTags(nullptr, DUrl::fromLocalFile(d->originalFilePath), d->tagNameList);
+    const QSet<QString> &restored_files = restored_list.toSet();
+
+    for (const TrashFileInfo *info : job_list) {
+        const TrashFileInfoPrivate *d = info->d_func();
+
+        if (!restored_files.contains(info->absoluteFilePath())) {
+            if (failedUrls)
+                failedUrls->append(info->fileUrl());
+
+            continue;
+        }
+
+        // restore the file tag infos
+        if (!d->tagNameList.isEmpty()) {
+            DFileService::instance()->setFileTags(nullptr, DUrl::fromLocalFile(d->originalFilePath), d->tagNameList);
+        }
     }
 
     return ok;
@@ -40,6 +40,8 @@ public:
     bool isWritable() const Q_DECL_OVERRIDE;
     bool canShare() const Q_DECL_OVERRIDE;
     bool isDir() const Q_DECL_OVERRIDE;
+    qint64 size() const Q_DECL_OVERRIDE;
+    int filesCount() const Q_DECL_OVERRIDE;
 
     QString fileDisplayName() const Q_DECL_OVERRIDE;
     QFile::Permissions permissions() const Q_DECL_OVERRIDE;
@@ -78,6 +80,8 @@ public:
     DUrl goToUrlWhenDeleted() const Q_DECL_OVERRIDE;
 
     bool restore() const;
+    // restore the files in one job, the urls failed to restore are appended to failedUrls
+    static bool restore(const QList<const TrashFileInfo*> &list, DUrlList *failedUrls = nullptr);
     QDateTime deletionDate() const;
     QString sourceFilePath() const;
 
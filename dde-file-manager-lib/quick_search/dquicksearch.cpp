@@ -21,6 +21,7 @@
 
 #include <regex>
 #include <thread>
+#include <vector>
 #include <string>
 #include <fstream>
 #include <iomanip>
@@ -44,11 +45,16 @@ extern "C"
 #include "shutil/dquicksearchfilter.h"
 #include "dstorageinfo.h"
 
+#include <QDir>
+#include <QFile>
+#include <QThread>
 #include <QDebug>
 
 DFM_USE_NAMESPACE
 
 #define MAX_RESULTS 100
+///###: the bytes of names scanned by one call of search_files, so a search can be stopped between the calls.
+#define SEARCH_SLICE (1 << 20)
 
 #define ACT_NEW_FILE    0
 #define ACT_NEW_LINK    1
@@ -217,6 +223,41 @@ static std::shared_ptr<std::pair<std::queue<partition>, std::queue<partition>>>
 }
 
 
+///###: the key of the disk which the block device major:minor belongs to.
+///###: partitions of one disk share the key, so they can be scanned one after another
+///###: instead of making the disk head jump between them.
+static QString disk_of_partition(unsigned int major_number, unsigned int minor_number)
+{
+    const QString sys_path{ QStringLiteral("/sys/dev/block/%1:%2").arg(major_number).arg(minor_number) };
+    QString device_path{ QFileInfo{ sys_path }.canonicalFilePath() };
+
+    ///###: at most 8 levels: dm-crypt on lvm on md etc.
+    for (int level = 0; level < 8 && !device_path.isEmpty(); ++level) {
+
+        ///###: etc: /sys/devices/.../block/sda/sda1 -> /sys/devices/.../block/sda
+        if (QFileInfo::exists(device_path + QStringLiteral("/partition"))) {
+            device_path = QFileInfo{ device_path }.absolutePath();
+            continue;
+        }
+
+        ///###: device mapper and md devices, follow the first device under them.
+        const QStringList slaves{ QDir{ device_path + QStringLiteral("/slaves") }.entryList(QDir::Dirs | QDir::NoDotAndDotDot) };
+
+        if (slaves.isEmpty()) {
+            break;
+        }
+
+        device_path = QFileInfo{ QStringLiteral("/sys/class/block/") + slaves.first() }.canonicalFilePath();
+    }
+
+    if (device_path.isEmpty()) {
+        return sys_path;
+    }
+
+    return device_path;
+}
+
+
 ///###: this function do not check whether posix_reg_str is empty or not.
 static QByteArray grep_regx_to_posix(const QByteArray &posix_reg_str)
 {
@@ -313,108 +354,113 @@ QList<QString> DQuickSearch::search(const QString &local_path, const QString &ke
 {
     QList<QString> searched_list{};
 
-    if (!m_readyFlag.load(std::memory_order_consume)) {
-        return searched_list;
-    }
+    search(local_path, key_words, [&searched_list](const QList<QString> &chunk)->bool {
+        searched_list.append(chunk);
+        return true;
+    });
+
+#ifdef QT_DEBUG
+    qDebug() << searched_list;
+#endif //QT_DEBUG
+
+    return searched_list;
+}
 
+bool DQuickSearch::search(const QString &local_path, const QString &key_words,
+                          const std::function<bool(const QList<QString> &)> &on_chunk)
+{
 #ifdef QT_DEBUG
     qDebug() << local_path << key_words;
 #endif //QT_DEBUG
 
+    ///###: do not wait for the other partitions, search as soon as the partition of local_path was indexed.
     if (QFileInfo::exists(local_path) && !key_words.isEmpty()) {
         QPair<QString, QString> device_and_mount_point{ detail::get_mount_point_of_file(local_path) };
-        std::map<QString, QString>::const_iterator pos{ m_mount_point_and_lft_buf.find(device_and_mount_point.second) };
+        fs_buf *buf{ nullptr };
 
-        ///###: adler32 check.
-        std::size_t adler32_value_backup{ DQuickSearch::read_adler32_value(pos->first) };
-        std::size_t adler32_value_now{ DQuickSearch::count_adler32(pos->first) };
+        {
+            std::lock_guard<std::mutex> raii_lock{ m_mutex };
+            std::map<QString, QString>::const_iterator pos{ m_mount_point_and_lft_buf.find(device_and_mount_point.second) };
 
-        if (adler32_value_backup != adler32_value_now) {
-            return searched_list;
-        }
+            if (pos == m_mount_point_and_lft_buf.cend()) {
+                return true;
+            }
 
+            ///###: adler32 check.
+            std::size_t adler32_value_backup{ DQuickSearch::read_adler32_value(pos->first) };
+            std::size_t adler32_value_now{ DQuickSearch::count_adler32(pos->first) };
 
-        if (pos != m_mount_point_and_lft_buf.cend()) {
-            std::lock_guard<std::mutex> raii_lock{ m_mutex };
-            fs_buf *buf{ nullptr };
-            load_fs_buf(&buf, pos->second.toLocal8Bit().constData());
-            QScopedPointer<fs_buf, ScopedPointerFsbufDeleter> sp(buf);
-            Q_UNUSED(sp); Q_UNUSED(raii_lock);
+            if (adler32_value_backup != adler32_value_now) {
+                return true;
+            }
 
-            if (buf) {
-                QByteArray query_str{ key_words.toLocal8Bit() };
-                QByteArray local_path_8bit{ local_path.toLocal8Bit() };
-                std::uint32_t path_off{ 0 };
-                std::uint32_t end_off{ 0 };
-                std::uint32_t start_off{ 0 };
-                query_str = detail::grep_regx_to_posix(query_str);
-                regex_t compiled;
-                QScopedPointer<regex_t, ScopedPointerRegextDeleter> sp_compiled(&compiled);
-                Q_UNUSED(sp_compiled);
-
-                int err{ regcomp(&compiled, query_str.constData(), REG_ICASE | REG_EXTENDED) };
+            load_fs_buf(&buf, pos->second.toLocal8Bit().constData());
+            Q_UNUSED(raii_lock);
+        }
 
-#ifdef QT_DEBUG
-                qDebug() << local_path_8bit;
-                qDebug() << err;
-#endif //QT_DEBUG
+        ///###: buf is private to this call, so it is searched without m_mutex (see m_mutex).
+        QScopedPointer<fs_buf, ScopedPointerFsbufDeleter> sp(buf);
+        Q_UNUSED(sp);
 
-                get_path_range(buf, local_path_8bit.data(), &path_off,  &start_off, &end_off);
+        if (buf) {
+            QByteArray query_str{ key_words.toLocal8Bit() };
+            QByteArray local_path_8bit{ local_path.toLocal8Bit() };
+            std::uint32_t path_off{ 0 };
+            std::uint32_t end_off{ 0 };
+            std::uint32_t start_off{ 0 };
+            query_str = detail::grep_regx_to_posix(query_str);
+            regex_t compiled;
+            QScopedPointer<regex_t, ScopedPointerRegextDeleter> sp_compiled(&compiled);
+            Q_UNUSED(sp_compiled);
 
-                end_off = end_off == 0 ? get_tail(buf) : end_off;
-                start_off = start_off == 0 ? first_name(buf) : start_off;
-                std::uint32_t name_offs[MAX_RESULTS] {};
-                std::uint32_t count{ MAX_RESULTS };
+            int err{ regcomp(&compiled, query_str.constData(), REG_ICASE | REG_EXTENDED) };
 
 #ifdef QT_DEBUG
-                qDebug() << start_off << end_off << path_off;
+            qDebug() << local_path_8bit;
+            qDebug() << err;
 #endif //QT_DEBUG
 
-                if (!err) {
+            get_path_range(buf, local_path_8bit.data(), &path_off,  &start_off, &end_off);
 
-                    search_files(buf, &start_off, end_off, &compiled, match_regex, name_offs, &count);
+            end_off = end_off == 0 ? get_tail(buf) : end_off;
+            start_off = start_off == 0 ? first_name(buf) : start_off;
+            std::uint32_t name_offs[MAX_RESULTS] {};
 
-                    char path[PATH_MAX];
-                    for (std::uint32_t i = 0; i < count; i++) {
-                        char *file_or_dir_name{ get_path_by_name_off(buf, name_offs[i], path, sizeof(path)) };
+#ifdef QT_DEBUG
+            qDebug() << start_off << end_off << path_off;
+#endif //QT_DEBUG
 
-                        if (file_or_dir_name && !DQuickSearchFilter::instance()->whetherFilterCurrentFile(QByteArray{ file_or_dir_name })) {
-                            searched_list.push_back(QString{ file_or_dir_name });
-                        }
-                    }
+            if (!err) {
+                char path[PATH_MAX];
 
-                    std::vector<std::uint32_t> vec_names_off{};
+                ///###: hand over every batch of search_files as soon as it was found,
+                ///###: so the caller can show the first results or stop the search early.
+                while (start_off < end_off) {
+                    std::uint32_t slice_end{ end_off - start_off > SEARCH_SLICE ? start_off + SEARCH_SLICE : end_off };
+                    std::uint32_t count{ MAX_RESULTS };
 
-                    while (count == MAX_RESULTS) {
-                        search_files(buf, &start_off, end_off, &compiled, match_regex, name_offs, &count);
+                    search_files(buf, &start_off, slice_end, &compiled, match_regex, name_offs, &count);
 
-                        for (std::size_t index = 0; index < count; ++index) {
-                            vec_names_off.push_back(name_offs[index]);
-                        }
-                    }
+                    QList<QString> chunk{};
 
-                    for (std::uint32_t off_beg : vec_names_off) {
-                        char *file_or_dir_name{ get_path_by_name_off(buf, off_beg, path, sizeof(path)) };
+                    for (std::uint32_t i = 0; i < count; ++i) {
+                        char *file_or_dir_name{ get_path_by_name_off(buf, name_offs[i], path, sizeof(path)) };
 
                         if (file_or_dir_name && !DQuickSearchFilter::instance()->whetherFilterCurrentFile(QByteArray{ file_or_dir_name })) {
-                            searched_list.push_back(QString{ file_or_dir_name });
+                            chunk.push_back(QString{ file_or_dir_name });
                         }
-#ifdef QT_DEBUG
-                        qDebug() << file_or_dir_name;
-#endif //QT_DEBUG
                     }
 
-#ifdef QT_DEBUG
-                    qDebug() << searched_list;
-#endif //QT_DEBUG
-
-                    return searched_list;
+                    ///###: also called with an empty chunk, so a search without matches can be stopped too.
+                    if (!on_chunk(chunk)) {
+                        return false;
+                    }
                 }
             }
         }
     }
 
-    return searched_list;
+    return true;
 }
 
 void DQuickSearch::filesWereCreated(const QList<QByteArray> &files_path)
@@ -632,6 +678,22 @@ bool DQuickSearch::createCache()
     return true;
 }
 
+bool DQuickSearch::whetherPathCached(const QString &local_path)
+{
+    if (m_readyFlag.load(std::memory_order_consume)) {
+        return true;
+    }
+
+    if (local_path.isEmpty()) {
+        return false;
+    }
+
+    QPair<QString, QString> device_and_mount_point{ detail::get_mount_point_of_file(local_path) };
+    std::lock_guard<std::mutex> raii_lock{ m_mutex };
+
+    return m_mount_point_and_lft_buf.find(device_and_mount_point.second) != m_mount_point_and_lft_buf.cend();
+}
+
 QPair<QString, QString> DQuickSearch::getDevAndMountPoint(const QString &local_path)
 {
     return detail::get_mount_point_of_file(local_path);
@@ -898,9 +960,12 @@ void DQuickSearch::cache_every_partion()
     };
 
     if (partion_count > 0) {
-        std::lock_guard<std::mutex> raii_lock{ m_mutex }; //###: locked!
 
         if (is_auto_indexes_inner() && is_auto_indexes_removable()) {
+            ///###: scanning is bound by the disk, so every disk is scanned by its own thread and
+            ///###: the partitions of one disk are scanned one after another. each partition is
+            ///###: published as soon as it is ready.
+            std::map<QString, std::vector<QString>> mount_points_of_disk{};
 
             for (int index = 0; index < partion_count; ++index) {
                 QString mount_point{ detail::restore_escaped_char(partitions[index].mount_point) };
@@ -908,12 +973,27 @@ void DQuickSearch::cache_every_partion()
                 if (QFileInfo::exists(mount_point)) {
 
                     if (!isFiltered(DUrl::fromLocalFile(mount_point))) {
+                        QString disk{ detail::disk_of_partition(partitions[index].major, partitions[index].minor) };
+                        mount_points_of_disk[disk].push_back(mount_point);
+                    }
+                }
+            }
+
+            std::vector<std::thread> threads_of_disk{};
+
+            for (const std::pair<const QString, std::vector<QString>> &disk_and_mount_points : mount_points_of_disk) {
+                threads_of_disk.emplace_back([this, disk_and_mount_points] {
+                    for (const QString &mount_point : disk_and_mount_points.second) {
 
-                        if (!create_lft(mount_point)) {
+                        if (!cachePartition(mount_point)) {
                             qWarning() << "A error occured, when creating lft in: " << mount_point;
                         }
                     }
-                }
+                });
+            }
+
+            for (std::thread &thread_of_disk : threads_of_disk) {
+                thread_of_disk.join();
             }
 
             change_status_flag();
@@ -921,6 +1001,8 @@ void DQuickSearch::cache_every_partion()
             return;
         }
 
+        std::lock_guard<std::mutex> raii_lock{ m_mutex }; //###: locked!
+
         std::shared_ptr<std::pair<std::queue<partition>, std::queue<partition>>> usb_and_inner_partion{
             detail::removable_inner_partion(partitions)
         };
@@ -1022,7 +1104,27 @@ bool DQuickSearch::isFiltered(const DUrl &path)
     return result;
 }
 
+bool DQuickSearch::cachePartition(const QString &mount_point)
+{
+    QString built_file{};
+
+    ///###: only publishing is locked, searching in the ready partitions is not blocked by scanning.
+    if (!DQuickSearch::build_lft(mount_point, &built_file)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> raii_lock{ m_mutex };
+    return publish_lft(mount_point, built_file);
+}
+
 bool DQuickSearch::create_lft(const QString &mount_point)
+{
+    QString built_file{};
+
+    return DQuickSearch::build_lft(mount_point, &built_file) && publish_lft(mount_point, built_file);
+}
+
+bool DQuickSearch::build_lft(const QString &mount_point, QString *built_file)
 {
     if (!mount_point.isEmpty()) {
         QByteArray file_located{ mount_point.toLocal8Bit() };
@@ -1035,6 +1137,9 @@ bool DQuickSearch::create_lft(const QString &mount_point)
             file_located = QByteArray { "/.__deepin.lft" };
         }
 
+        ///###: the published lft may be loaded meanwhile, and the same partition may be indexed by two threads.
+        file_located += QByteArray { "." } + QByteArray::number(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+
         fs_buf *buffer = new_fs_buf(buffer_size, full_path.constData());
         QScopedPointer<fs_buf, ScopedPointerFsbufDeleter> sp(buffer);
         Q_UNUSED(sp);
@@ -1043,22 +1148,38 @@ bool DQuickSearch::create_lft(const QString &mount_point)
             build_fstree(buffer, 0, NULL, NULL);
 
             if (save_fs_buf(buffer, file_located.constData()) == 0) {
-
-                ///###: adler32 check.
-                std::size_t adler32_value{ DQuickSearch::count_adler32(mount_point) };
-
-                if (adler32_value) {
-                    DQuickSearch::store_adler32_value(mount_point, adler32_value);
-                    m_mount_point_and_lft_buf[mount_point] = QString::fromLocal8Bit(file_located);
-                    return true;
-                }
+                *built_file = QString::fromLocal8Bit(file_located);
+                return true;
             }
+
+            QFile::remove(QString::fromLocal8Bit(file_located));
         }
     }
 
     return false;
 }
 
+bool DQuickSearch::publish_lft(const QString &mount_point, const QString &built_file)
+{
+    QString lft_file{ mount_point == QStringLiteral("/") ? QStringLiteral("/.__deepin.lft") : mount_point + QStringLiteral("/.__deepin.lft") };
+
+    if (::rename(built_file.toLocal8Bit().constData(), lft_file.toLocal8Bit().constData()) != 0) {
+        QFile::remove(built_file);
+        return false;
+    }
+
+    ///###: adler32 check.
+    std::size_t adler32_value{ DQuickSearch::count_adler32(mount_point) };
+
+    if (adler32_value) {
+        DQuickSearch::store_adler32_value(mount_point, adler32_value);
+        m_mount_point_and_lft_buf[mount_point] = lft_file;
+        return true;
+    }
+
+    return false;
+}
+
 QList<QString> DQuickSearch::filter_result(const QList<QString> &searched_result, const QByteArray &regex)
 {
     QList<QString> result{};
@@ -26,6 +26,7 @@
 #include <queue>
 #include <memory>
 #include <atomic>
+#include <functional>
 
 
 #ifdef __cplusplus
@@ -73,6 +74,11 @@ public:
     DQuickSearch &operator=(const DQuickSearch &) = delete;
 
     QList<QString> search(const QString &local_path, const QString &key_words);
+    ///###: on_chunk gets the results in bounded chunks as soon as they are found, and an empty chunk
+    ///###: after every slice of the index without matches. the search stops if it returns false.
+    ///###: Returns false if the search was stopped. on_chunk is called without m_mutex.
+    bool search(const QString &local_path, const QString &key_words,
+                const std::function<bool(const QList<QString> &)> &on_chunk);
 
     void filesWereCreated(const QList<QByteArray> &files_path);
     void filesWereDeleted(const QList<QByteArray> &files_path);
@@ -84,6 +90,12 @@ public:
         return m_readyFlag.load(std::memory_order_consume);
     }
 
+    ///###: the partition of local_path has been indexed, even if others are still being indexed.
+    bool whetherPathCached(const QString &local_path);
+
+    ///###: index mount_point and publish its lft, it can be called for several partitions at once.
+    bool cachePartition(const QString &mount_point);
+
     static DQuickSearch *instance()noexcept
     {
         static DQuickSearch *quick_search{ new DQuickSearch };
@@ -130,12 +142,23 @@ private:
     void initialize_connection()noexcept;
     bool create_lft(const QString &mount_point);
 
+    ///###: scan mount_point into a private fs_buf and save it beside the lft, m_mutex is not needed.
+    static bool build_lft(const QString &mount_point, QString *built_file);
+    ///###: replace the lft of mount_point by built_file and make it searchable, m_mutex must be held.
+    bool publish_lft(const QString &mount_point, const QString &built_file);
+
     ///###: it is standby.
     static QList<QString> filter_result(const QList<QString> &searched_result, const QByteArray &regex);
 
 
 
     std::atomic<bool> m_readyFlag{ false };
+
+    ///###: the anything library keeps all of its state in the fs_buf handed to every call, so a fs_buf
+    ///###: private to one thread is built, loaded and searched without a lock, and the partitions are
+    ///###: indexed in parallel. (the quicksearchindex benchmark checks that the lft files built in parallel
+    ///###: are the same as the ones built one by one.) m_mutex guards the members and the published lft
+    ///###: files of the mount points: publishing, loading and updating them.
     std::mutex m_mutex{};
     std::atomic<bool> m_flag{ false };
     std::deque<QString> m_backup{};
@@ -26,6 +26,7 @@
 #include "properties.h"
 #include <QFile>
 #include <QSettings>
+#include <QDataStream>
 #include <QDebug>
 
 /**
@@ -135,3 +136,21 @@ QStringList DesktopFile::getMimeType() const {
     return m_mimeType;
 }
 //---------------------------------------------------------------------------
+
+QDataStream &operator<<(QDataStream &out, const DesktopFile &file)
+{
+    out << file.m_fileName << file.m_name << file.m_localName << file.m_exec
+        << file.m_icon << file.m_type << file.m_categories << file.m_mimeType
+        << file.m_deepinId << file.m_noDisplay << file.m_hidden;
+
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, DesktopFile &file)
+{
+    in >> file.m_fileName >> file.m_name >> file.m_localName >> file.m_exec
+       >> file.m_icon >> file.m_type >> file.m_categories >> file.m_mimeType
+       >> file.m_deepinId >> file.m_noDisplay >> file.m_hidden;
+
+    return in;
+}
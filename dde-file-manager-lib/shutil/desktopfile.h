@@ -27,6 +27,10 @@
 
 #include <QStringList>
 
+QT_BEGIN_NAMESPACE
+class QDataStream;
+QT_END_NAMESPACE
+
 /**
  * @class DesktopFile
  * @brief Represents a linux desktop file
@@ -47,6 +51,9 @@ public:
   bool getNoShow() const;
   QStringList getCategories() const;
   QStringList getMimeType() const;
+
+  friend QDataStream &operator<<(QDataStream &out, const DesktopFile &file);
+  friend QDataStream &operator>>(QDataStream &in, DesktopFile &file);
 private:
   QString m_fileName;
   QString m_name;
@@ -28,9 +28,181 @@
 
 #include <QDebug>
 #include <QByteArray>
+#include <QFileInfo>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#ifndef RENAME_NOREPLACE
+#define RENAME_NOREPLACE (1 << 0)
+#endif
 
 std::once_flag FileBatchProcess::flag;
 
+namespace BatchRename {
+struct Entry
+{
+    DUrl fromUrl;
+    DUrl toUrl;
+    QByteArray from;
+    QByteArray to;
+};
+
+struct Step
+{
+    int dirFd;
+    QByteArray from;
+    QByteArray to;
+    // the index of the entry, -1 for moving a file of a cycle to the temporary name
+    int entry;
+};
+}
+
+using namespace BatchRename;
+
+// renameat2 is in glibc since 2.28 only
+static int renameNoReplace(int dirFd, const QByteArray &from, const QByteArray &to)
+{
+#ifdef SYS_renameat2
+    int ret = ::syscall(SYS_renameat2, dirFd, from.constData(), dirFd, to.constData(), RENAME_NOREPLACE);
+
+    // EINVAL if the file system does not support the flag
+    if (ret == 0 || (errno != ENOSYS && errno != EINVAL))
+        return ret;
+#endif
+
+    struct stat st;
+
+    if (::fstatat(dirFd, to.constData(), &st, AT_SYMLINK_NOFOLLOW) == 0) {
+        errno = EEXIST;
+
+        return -1;
+    }
+
+    return ::renameat(dirFd, from.constData(), dirFd, to.constData());
+}
+
+static bool nameExists(int dirFd, const QByteArray &name)
+{
+    struct stat st;
+
+    return ::fstatat(dirFd, name.constData(), &st, AT_SYMLINK_NOFOLLOW) == 0;
+}
+
+// the names only differ in case and find the same file, e.g. IMG.JPG and img.jpg on vfat
+static bool isCaseOnlyRename(int dirFd, const QByteArray &from, const QByteArray &to)
+{
+    struct stat from_st;
+    struct stat to_st;
+
+    if (QString::compare(QFile::decodeName(from), QFile::decodeName(to), Qt::CaseInsensitive) != 0)
+        return false;
+
+    return ::fstatat(dirFd, from.constData(), &from_st, AT_SYMLINK_NOFOLLOW) == 0
+           && ::fstatat(dirFd, to.constData(), &to_st, AT_SYMLINK_NOFOLLOW) == 0
+           && from_st.st_dev == to_st.st_dev && from_st.st_ino == to_st.st_ino;
+}
+
+// the steps to rename the entries of one directory. A chain (a->b, b->c) is
+// renamed from its end, a cycle (a->b, b->a) and a rename that only changes the
+// case on a case insensitive file system through a temporary name. The entries
+// whose target is taken by another entry or by a file that is not renamed are
+// dropped before anything is touched.
+static QVector<Step> planDirectory(int dirFd, const QVector<Entry> &entries, QVector<bool> *dropped)
+{
+    const int count = entries.size();
+    QHash<QByteArray, int> sources;
+    QHash<QByteArray, int> targets;
+    QVector<bool> case_only(count, false);
+    QVector<int> queue;
+
+    dropped->fill(false, count);
+    sources.reserve(count);
+    targets.reserve(count);
+
+    for (int i = 0; i < count; ++i)
+        sources[entries.at(i).from] = i;
+
+    for (int i = 0; i < count; ++i) {
+        const Entry &e = entries.at(i);
+
+        bool in_use = targets.contains(e.to);
+
+        if (!in_use && !sources.contains(e.to) && nameExists(dirFd, e.to)) {
+            case_only[i] = isCaseOnlyRename(dirFd, e.from, e.to);
+            in_use = !case_only.at(i);
+        }
+
+        if (in_use) {
+            (*dropped)[i] = true;
+            queue << i;
+        } else {
+            targets[e.to] = i;
+        }
+    }
+
+    // the file of a dropped entry stays, so the entry renaming to it is dropped too
+    while (!queue.isEmpty()) {
+        const int i = targets.value(entries.at(queue.takeLast()).from, -1);
+
+        if (i >= 0 && !dropped->at(i)) {
+            (*dropped)[i] = true;
+            queue << i;
+        }
+    }
+
+    QVector<Step> steps;
+    // 0: pending, 1: in the current chain, 2: planned
+    QVector<char> state(count, 0);
+    int temp_count = 0;
+
+    steps.reserve(count);
+
+    for (int e = 0; e < count; ++e) {
+        if (dropped->at(e) || state.at(e) != 0)
+            continue;
+
+        QVector<int> chain;
+        int i = e;
+
+        // the entry that must move its file away before entry i
+        while (i >= 0 && state.at(i) == 0) {
+            state[i] = 1;
+            chain << i;
+            i = sources.value(entries.at(i).to, -1);
+        }
+
+        QByteArray temp_name;
+        int cycle_entry = (i >= 0 && state.at(i) == 1) ? i : -1;
+
+        // the end of the chain, its target is the same file
+        if (i < 0 && case_only.at(chain.last()))
+            cycle_entry = chain.last();
+
+        if (cycle_entry >= 0) {
+            do {
+                temp_name = QByteArray(".dfm-rename-") + QByteArray::number(::getpid()) + '-' + QByteArray::number(temp_count++);
+            } while (nameExists(dirFd, temp_name));
+
+            steps << Step{dirFd, entries.at(cycle_entry).from, temp_name, -1};
+        }
+
+        for (int k = chain.size() - 1; k >= 0; --k) {
+            const int index = chain.at(k);
+
+            steps << Step{dirFd, index == cycle_entry ? temp_name : entries.at(index).from, entries.at(index).to, index};
+            state[index] = 2;
+        }
+    }
+
+    return steps;
+}
+
 QSharedMap<DUrl, DUrl> FileBatchProcess::replaceText(const QList<DUrl>& originUrls, const QPair<QString, QString> &pair) const
 {
     if(originUrls.isEmpty() == true) { //###: here, judge whether there are fileUrls in originUrls.
@@ -146,7 +318,7 @@ QSharedMap<DUrl, DUrl> FileBatchProcess::customText(const QList<DUrl> &originUrl
 
 
 ////###: use the value of map to rename the file who name is the key of map.
-QMap<DUrl, DUrl> FileBatchProcess::batchProcessFile(const QSharedMap<DUrl, DUrl> &map)
+QMap<DUrl, DUrl> FileBatchProcess::batchProcessFile(const QSharedMap<DUrl, DUrl> &map, QMap<DUrl, DUrl> *skipped)
 {
     QMap<DUrl, DUrl> cache;
 
@@ -154,12 +326,19 @@ QMap<DUrl, DUrl> FileBatchProcess::batchProcessFile(const QSharedMap<DUrl, DUrl>
         return cache;
     }
 
-    QMap<DUrl, DUrl>::const_iterator beg = map->constBegin();
-    QMap<DUrl, DUrl>::const_iterator end = map->constEnd();
+    QMap<DUrl, DUrl> others = *map;
 
     // 实现批量回退
     DFMEventDispatcher::instance()->processEvent<DFMSaveOperatorEvent>();
 
+    cache = batchRenameLocalFiles(others, skipped);
+
+    if (!cache.isEmpty())
+        emit DFileService::instance()->filesRenamed(cache);
+
+    QMap<DUrl, DUrl>::const_iterator beg = others.constBegin();
+    QMap<DUrl, DUrl>::const_iterator end = others.constEnd();
+
     for (; beg != end; ++beg) {
         DUrl currentName{ beg.key() };
         DUrl hopedName{ beg.value() };
@@ -179,3 +358,155 @@ QMap<DUrl, DUrl> FileBatchProcess::batchProcessFile(const QSharedMap<DUrl, DUrl>
 
     return cache;
 }
+
+bool FileBatchProcess::renameFilesInOrder(const QList<QPair<DUrl, DUrl>> &list)
+{
+    for (const QPair<DUrl, DUrl> &rename : list) {
+        if (!rename.first.isLocalFile() || !rename.second.isLocalFile()) {
+            qWarning() << "Only the local files can be renamed in order:" << rename.first << rename.second;
+
+            return false;
+        }
+    }
+
+    int done = 0;
+
+    for (; done < list.size(); ++done) {
+        const QPair<DUrl, DUrl> &rename = list.at(done);
+
+        // both are absolute paths
+        if (renameNoReplace(AT_FDCWD, QFile::encodeName(rename.first.toLocalFile()), QFile::encodeName(rename.second.toLocalFile())) != 0) {
+            qWarning() << "Failed to rename" << rename.first << "to" << rename.second << strerror(errno) << ", roll back the renaming";
+            break;
+        }
+    }
+
+    if (done == list.size())
+        return true;
+
+    for (int i = done - 1; i >= 0; --i) {
+        const QPair<DUrl, DUrl> &rename = list.at(i);
+
+        if (renameNoReplace(AT_FDCWD, QFile::encodeName(rename.second.toLocalFile()), QFile::encodeName(rename.first.toLocalFile())) != 0) {
+            qWarning() << "Failed to roll back the renaming of" << rename.first << "to" << rename.second << strerror(errno);
+            break;
+        }
+    }
+
+    return false;
+}
+
+QMap<DUrl, DUrl> FileBatchProcess::batchRenameLocalFiles(QMap<DUrl, DUrl> &map, QMap<DUrl, DUrl> *skipped)
+{
+    QMap<DUrl, DUrl> renamed;
+    QMap<QString, QVector<Entry>> directories;
+
+    for (auto it = map.begin(); it != map.end();) {
+        const QFileInfo from_info(it.key().toLocalFile());
+        const QFileInfo to_info(it.value().toLocalFile());
+
+        // the desktop files are renamed by their Name key in FileController
+        if (!it.key().isLocalFile() || !it.value().isLocalFile() || from_info.suffix() == "desktop"
+                || from_info.absolutePath() != to_info.absolutePath()) {
+            ++it;
+            continue;
+        }
+
+        if (it.key() != it.value()) {
+            directories[from_info.absolutePath()] << Entry{it.key(), it.value(),
+                                                           QFile::encodeName(from_info.fileName()),
+                                                           QFile::encodeName(to_info.fileName())};
+        }
+
+        it = map.erase(it);
+    }
+
+    QVector<QVector<Entry>> entries;
+    QVector<Step> steps;
+    QList<int> dir_fds;
+
+    for (auto it = directories.constBegin(); it != directories.constEnd(); ++it) {
+        const int fd = ::open(QFile::encodeName(it.key()).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+        if (fd < 0) {
+            qWarning() << "Failed to open the directory for renaming:" << it.key() << strerror(errno);
+            continue;
+        }
+
+        QVector<bool> dropped;
+        const QVector<Step> &dir_steps = planDirectory(fd, it.value(), &dropped);
+
+        for (int i = 0; i < dropped.size(); ++i) {
+            if (!dropped.at(i))
+                continue;
+
+            qWarning() << "The file name is in use, skip renaming:" << it.value().at(i).fromUrl << it.value().at(i).toUrl;
+
+            if (skipped)
+                skipped->insert(it.value().at(i).fromUrl, it.value().at(i).toUrl);
+        }
+
+        // the entry of a step is the index in its directory, the fd finds the directory
+        dir_fds << fd;
+        entries << it.value();
+        steps << dir_steps;
+    }
+
+    int done = 0;
+
+    for (; done < steps.size(); ++done) {
+        const Step &step = steps.at(done);
+
+        if (renameNoReplace(step.dirFd, step.from, step.to) != 0) {
+            qWarning() << "Failed to rename" << step.from << "to" << step.to << strerror(errno) << ", roll back the batch";
+            break;
+        }
+    }
+
+    // the steps that stay done
+    int applied = done;
+
+    if (done < steps.size()) {
+        applied = 0;
+
+        for (int i = done - 1; i >= 0; --i) {
+            const Step &step = steps.at(i);
+
+            // keep the steps before it, the undo entry restores them
+            if (renameNoReplace(step.dirFd, step.to, step.from) != 0) {
+                qWarning() << "Failed to roll back the renaming of" << step.from << "to" << step.to << strerror(errno);
+                applied = i + 1;
+                break;
+            }
+        }
+    }
+
+    QList<QPair<DUrl, DUrl>> undo_list;
+
+    for (int i = 0; i < applied; ++i) {
+        const Step &step = steps.at(i);
+        const QVector<Entry> &dir_entries = entries.at(dir_fds.indexOf(step.dirFd));
+        const QString &dir_path = QFileInfo(dir_entries.first().fromUrl.toLocalFile()).absolutePath();
+
+        // the undo renames the steps back in reverse order, so a cycle is restored as well
+        undo_list.prepend(qMakePair(DUrl::fromLocalFile(dir_path + "/" + QFile::decodeName(step.to)),
+                                    DUrl::fromLocalFile(dir_path + "/" + QFile::decodeName(step.from))));
+
+        if (step.entry >= 0) {
+            const Entry &e = dir_entries.at(step.entry);
+
+            renamed[e.fromUrl] = e.toUrl;
+        }
+    }
+
+    // one undo entry for the whole batch
+    if (!undo_list.isEmpty()) {
+        DFMEventDispatcher::instance()->processEvent<DFMSaveOperatorEvent>(QSharedPointer<DFMEvent>(),
+                                                                             dMakeEventPointer<DFMBatchRenameEvent>(nullptr, undo_list));
+    }
+
+    for (int fd : dir_fds)
+        ::close(fd);
+
+    return renamed;
+}
@@ -71,7 +71,10 @@ public:
 
 
 
-    static QMap<DUrl, DUrl> batchProcessFile(const QSharedMap<DUrl, DUrl> &map);
+    // the entries whose new name is in use are not renamed, they are put to skipped
+    static QMap<DUrl, DUrl> batchProcessFile(const QSharedMap<DUrl, DUrl> &map, QMap<DUrl, DUrl> *skipped = nullptr);
+    // rename the local files one after another, all or nothing (for the undo of a batch)
+    static bool renameFilesInOrder(const QList<QPair<DUrl, DUrl>> &list);
 
     ////###: this is thread safe.
     inline static QSharedPointer<FileBatchProcess> instance()
@@ -85,6 +88,9 @@ public:
 
 
 private:
+    // rename the local files in one batch, the files of the map which can not be renamed are removed
+    static QMap<DUrl, DUrl> batchRenameLocalFiles(QMap<DUrl, DUrl> &map, QMap<DUrl, DUrl> *skipped);
+
     ////###: there flag is very important.
     static std::once_flag flag;
 };
@@ -728,6 +728,10 @@ QString FileUtils::getInternetShortcutUrl(const QString &path)
 
 QString FileUtils::getFileMimetype(const QString &path)
 {
+    // the shared-mime-info database of GIO and Qt is the same, use the cached result
+    if (QFileInfo::exists(path))
+        return DMimeDatabase().mimeTypeForFile(path).name();
+
     GFile *file;
     GFileInfo *info;
     QString result;
@@ -955,12 +959,15 @@ bool FileUtils::isGvfsMountFile(const QString &filePath)
         }
     }
 
-    QString gvfsDir = QString("%1/gvfs").arg(XDG_RUNTIME_DIR);
-    if (filePath.startsWith(gvfsDir) && DUrl(filePath) != DUrl(gvfsDir)) {
-        return true;
-    }
+    // called for every file when painting the icons, so do not construct urls here
+    const QString &gvfsDir = XDG_RUNTIME_DIR + "/gvfs";
 
-    return false;
+    if (!filePath.startsWith(gvfsDir))
+        return false;
+
+    const QStringRef &rest = filePath.midRef(gvfsDir.size());
+
+    return !rest.isEmpty() && rest != QLatin1String("/");
 }
 
 bool FileUtils::isFileExists(const QString &filePath)
@@ -979,6 +986,11 @@ QString FileUtils::getMimeTypeByGIO(const QString &uri)
     GError* error = NULL;
     GFileInfo* fileInfo = NULL;
     QString mimeType;
+    const QUrl url(uri);
+
+    // the shared-mime-info database of GIO and Qt is the same, use the cached result
+    if (url.isLocalFile() && QFileInfo::exists(url.toLocalFile()))
+        return DMimeDatabase().mimeTypeForFile(url.toLocalFile()).name();
 
     file = g_file_new_for_uri(uri.toLocal8Bit().constData());
     if(!file)
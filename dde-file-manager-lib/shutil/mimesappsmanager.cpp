@@ -39,6 +39,10 @@
 #include <QDirIterator>
 #include <QDateTime>
 #include <QThread>
+#include <QMutex>
+#include <QLocale>
+#include <QDataStream>
+#include <QSaveFile>
 #include <QStandardPaths>
 #include <QDebug>
 
@@ -72,9 +76,173 @@ QMap<QString, DesktopFile> MimesAppsManager::AudioMimeApps = {};
 
 QMap<QString, DesktopFile> MimesAppsManager::DesktopObjs = {};
 
+namespace MimeAppsIndex {
+// "DMAI"
+static const quint32 Magic = 0x444d4149;
+static const quint32 Version = 1;
+
+struct Entry
+{
+    DesktopFile desktopFile;
+    // birth time of the desktop file, used to sort the apps of a mime type
+    qint64 created = 0;
+};
+
+struct Folder
+{
+    // last modified time of the applications folder and of its sub folders,
+    // the folder is scanned again if any of them has changed
+    QMap<QString, qint64> dirTimes;
+    QList<Entry> entries;
+};
+
+QDataStream &operator<<(QDataStream &out, const Entry &entry)
+{
+    return out << entry.desktopFile << entry.created;
+}
+
+QDataStream &operator>>(QDataStream &in, Entry &entry)
+{
+    return in >> entry.desktopFile >> entry.created;
+}
+
+QDataStream &operator<<(QDataStream &out, const Folder &folder)
+{
+    return out << folder.dirTimes << folder.entries;
+}
+
+QDataStream &operator>>(QDataStream &in, Folder &folder)
+{
+    return in >> folder.dirTimes >> folder.entries;
+}
+}
+
+using namespace MimeAppsIndex;
+
+// the parsed desktop files of every applications folder, only used in initMimeTypeApps/updateMimeTypeApps
+static QMutex IndexMutex;
+static QMap<QString, Folder> IndexFolders;
+static bool IndexLoaded = false;
+
+// lookups for getRecommendedApps, reset when the index has been rebuilt,
+// also guards DesktopFiles, DesktopObjs and MimeApps
+static QMutex LookupMutex;
+// incremented when the index has been rebuilt
+static int LookupGeneration = 0;
+static QHash<QString, QString> DesktopIdFiles;
+static QHash<QString, QStringList> RecommendedApps;
+
+static QMap<QString, qint64> folderTimes(const QString &folder)
+{
+    QMap<QString, qint64> times;
+    const QFileInfo info(folder);
+
+    if (!info.isDir())
+        return times;
+
+    times[folder] = info.lastModified().toMSecsSinceEpoch();
+
+    QDirIterator it(folder, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+
+    while (it.hasNext()) {
+        it.next();
+        times[it.filePath()] = it.fileInfo().lastModified().toMSecsSinceEpoch();
+    }
+
+    return times;
+}
+
+static Folder scanFolder(const QString &folder)
+{
+    Folder index;
+
+    // read the times first, a change during the scan is found next time
+    index.dirTimes = folderTimes(folder);
+
+    QDirIterator it(folder, QStringList("*.desktop"),
+                    QDir::Files | QDir::NoDotAndDotDot,
+                    QDirIterator::Subdirectories);
+
+    while (it.hasNext()) {
+        it.next();
+
+        Entry entry;
+
+        entry.desktopFile = DesktopFile(it.filePath());
+        entry.created = it.fileInfo().created().toMSecsSinceEpoch();
+        index.entries << entry;
+    }
+
+    return index;
+}
+
+static bool loadIndex(QMap<QString, Folder> &folders)
+{
+    QFile file(MimesAppsManager::getMimeAppsIndexFile());
+
+    if (!file.open(QIODevice::ReadOnly) || file.size() <= 0)
+        return false;
+
+    uchar *data = file.map(0, file.size());
+
+    if (!data)
+        return false;
+
+    bool ok = false;
+
+    {
+        // read in place from the mapped pages instead of copying the whole file
+        QDataStream stream(QByteArray::fromRawData(reinterpret_cast<const char*>(data), static_cast<int>(file.size())));
+        quint32 magic = 0;
+        quint32 version = 0;
+        QString locale;
+
+        stream.setVersion(QDataStream::Qt_5_0);
+        stream >> magic >> version;
+
+        // the local names of the desktop files depend on the locale
+        if (magic == Magic && version == Version) {
+            stream >> locale;
+
+            if (locale == QLocale::system().name()) {
+                stream >> folders;
+                ok = stream.status() == QDataStream::Ok;
+            }
+        }
+    }
+
+    file.unmap(data);
+
+    if (!ok)
+        folders.clear();
+
+    return ok;
+}
+
+static bool saveIndex(const QMap<QString, Folder> &folders)
+{
+    const QString &path = MimesAppsManager::getMimeAppsIndexFile();
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QSaveFile file(path);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "failed to write mime apps index:" << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << Magic << Version << QLocale::system().name() << folders;
+
+    return file.commit();
+}
+
 MimeAppsWorker::MimeAppsWorker(QObject *parent): QObject(parent)
 {
-    m_fileSystemWatcher = new QFileSystemWatcher;
+    m_fileSystemWatcher = new QFileSystemWatcher(this);
     m_updateCacheTimer = new QTimer(this);
     m_updateCacheTimer->setInterval(2000);
     m_updateCacheTimer->setSingleShot(true);
@@ -102,123 +270,43 @@ void MimeAppsWorker::startWatch()
 
 void MimeAppsWorker::handleDirectoryChanged(const QString &filePath)
 {
-    Q_UNUSED(filePath)
-
-    //for 1.4
-//    if(QFile::exists(filePath)){
-//        m_fileSystemWatcher->addPath(filePath);
-
-//        QMap<QString, QSet<QString>> mimeAppsSet;
-
-//        DesktopFile desktopFile(filePath);
-//        MimesAppsManager::DesktopFiles.append(filePath);
-//        MimesAppsManager::DesktopObjs.insert(filePath, desktopFile);
-//        QStringList mimeTypes = desktopFile.getMimeType();
-//        foreach (QString mimeType, mimeTypes) {
-//            if (!mimeType.isEmpty()){
-//                QSet<QString> apps;
-//                if (mimeAppsSet.contains(mimeType)){
-//                    apps = mimeAppsSet.value(mimeType);
-//                    apps.insert(filePath);
-//                }else{
-//                    apps.insert(filePath);
-//                }
-//                mimeAppsSet.insert(mimeType, apps);
-//            }
-//        }
-
-//        foreach (QString key, mimeAppsSet.keys()) {
-//            QSet<QString> apps = mimeAppsSet.value(key);
-//            QStringList orderApps;
-//            if (apps.count() > 1){
-//                QFileInfoList fileInfos;
-//                foreach (QString app, apps) {
-//                    QFileInfo info(app);
-//                    fileInfos.append(info);
-//                }
-
-//                std::sort(fileInfos.begin(), fileInfos.end(), MimesAppsManager::lessByDateTime);
-
-//                foreach (QFileInfo info, fileInfos) {
-//                    orderApps.append(info.absoluteFilePath());
-//                }
-//            }else{
-//                orderApps.append(apps.toList());
-//            }
-//            MimesAppsManager::MimeApps.insert(key, orderApps);
-//        }
-
-//        foreach (QString desktopFile, MimesAppsManager::DesktopObjs.keys()) {
-//            QString iconName = MimesAppsManager::DesktopObjs.value(desktopFile).getIcon();
-//            fileIconProvider->getDesktopIcon(iconName, 48);
-//        }
-
-//    }else{
-//        m_fileSystemWatcher->removePath(filePath);
-//        MimesAppsManager::DesktopFiles.removeOne(filePath);
-//        MimesAppsManager::DesktopObjs.remove(filePath);
-//    }
-//    updateCache();
+    const QString &folder = MimesAppsManager::getApplicationsFolder(filePath);
+
+    if (!folder.isEmpty() && !m_dirtyFolders.contains(folder))
+        m_dirtyFolders << folder;
+
     m_updateCacheTimer->start();
 }
 
 void MimeAppsWorker::handleFileChanged(const QString &filePath)
 {
-    Q_UNUSED(filePath)
-//    updateCache();
-    m_updateCacheTimer->start();
-    //for 1.4
-//    DesktopFile desktopFile(filePath);
-//    MimesAppsManager::DesktopObjs.remove(filePath);
-//    MimesAppsManager::DesktopObjs.insert(filePath, desktopFile);
-
-//    QMap<QString, QSet<QString>> mimeAppsSet;
-
-//    QStringList mimeTypes = desktopFile.getMimeType();
-//    foreach (QString mimeType, mimeTypes) {
-//        if (!mimeType.isEmpty()){
-//            QSet<QString> apps;
-//            if (mimeAppsSet.contains(mimeType)){
-//                apps = mimeAppsSet.value(mimeType);
-//                apps.insert(filePath);
-//            }else{
-//                apps.insert(filePath);
-//            }
-//            mimeAppsSet.insert(mimeType, apps);
-//        }
-//    }
-
-//    foreach (QString key, mimeAppsSet.keys()) {
-//        QSet<QString> apps = mimeAppsSet.value(key);
-//        QStringList orderApps;
-//        if (apps.count() > 1){
-//            QFileInfoList fileInfos;
-//            foreach (QString app, apps) {
-//                QFileInfo info(app);
-//                fileInfos.append(info);
-//            }
-
-//            std::sort(fileInfos.begin(), fileInfos.end(), MimesAppsManager::lessByDateTime);
-
-//            foreach (QFileInfo info, fileInfos) {
-//                orderApps.append(info.absoluteFilePath());
-//            }
-//        }else{
-//            orderApps.append(apps.toList());
-//        }
-//        MimesAppsManager::MimeApps.insert(key, orderApps);
-//    }
-
-//    foreach (QString desktopFile, MimesAppsManager::DesktopObjs.keys()) {
-//        QString iconName = MimesAppsManager::DesktopObjs.value(desktopFile).getIcon();
-//        fileIconProvider->getDesktopIcon(iconName, 48);
-//    }
-
+    // a desktop file rewritten in place does not change the folder mtime
+    handleDirectoryChanged(filePath);
 }
 
 void MimeAppsWorker::updateCache()
 {
-    MimesAppsManager::initMimeTypeApps();
+    const QStringList folders = m_dirtyFolders;
+
+    m_dirtyFolders.clear();
+    MimesAppsManager::updateMimeTypeApps(folders);
+
+    // also watch the desktop files added since the last update
+    const QSet<QString> &watched = m_fileSystemWatcher->files().toSet();
+    QStringList files;
+
+    QMutexLocker locker(&LookupMutex);
+    const QStringList desktopFiles = MimesAppsManager::DesktopFiles;
+
+    locker.unlock();
+
+    for (const QString &file : desktopFiles) {
+        if (!watched.contains(file))
+            files << file;
+    }
+
+    if (!files.isEmpty())
+        m_fileSystemWatcher->addPaths(files);
 }
 
 void MimeAppsWorker::writeData(const QString &path, const QByteArray &content)
@@ -411,13 +499,27 @@ QStringList MimesAppsManager::getRecommendedApps(const DUrl &url)
         recommendedApps.append(custom_app);
     }
 
-    GDesktopAppInfo *desktopAppInfo = g_desktop_app_info_new(default_app.toLocal8Bit().constData());
+    if (default_app.isEmpty())
+        return recommendedApps;
+
+    QMutexLocker locker(&LookupMutex);
+    QString default_app_file = DesktopIdFiles.value(default_app);
 
-    if (desktopAppInfo) {
-        default_app = QString::fromLocal8Bit(g_desktop_app_info_get_filename(desktopAppInfo));
-        g_object_unref(desktopAppInfo);
-        MimesAppsManager::removeOneDupFromList(recommendedApps, default_app);
-        recommendedApps.prepend(default_app);
+    locker.unlock();
+
+    // the desktop id is not in the index yet
+    if (default_app_file.isEmpty()) {
+        GDesktopAppInfo *desktopAppInfo = g_desktop_app_info_new(default_app.toLocal8Bit().constData());
+
+        if (desktopAppInfo) {
+            default_app_file = QString::fromLocal8Bit(g_desktop_app_info_get_filename(desktopAppInfo));
+            g_object_unref(desktopAppInfo);
+        }
+    }
+
+    if (!default_app_file.isEmpty()) {
+        MimesAppsManager::removeOneDupFromList(recommendedApps, default_app_file);
+        recommendedApps.prepend(default_app_file);
     }
 
     return recommendedApps;
@@ -425,6 +527,19 @@ QStringList MimesAppsManager::getRecommendedApps(const DUrl &url)
 
 QStringList MimesAppsManager::getRecommendedAppsByQio(const QMimeType &mimeType)
 {
+    QMutexLocker locker(&LookupMutex);
+    auto cached = RecommendedApps.constFind(mimeType.name());
+
+    if (cached != RecommendedApps.constEnd())
+        return cached.value();
+
+    // computed on a snapshot, the index can be rebuilt meanwhile
+    const QMap<QString, QStringList> mimeApps = MimeApps;
+    const QMap<QString, DesktopFile> desktopObjs = DesktopObjs;
+    const int generation = LookupGeneration;
+
+    locker.unlock();
+
     QStringList recommendApps;
     QList<QMimeType> mimeTypeList;
     QMimeDatabase mimeDatabase;
@@ -439,12 +554,12 @@ QStringList MimesAppsManager::getRecommendedAppsByQio(const QMimeType &mimeType)
             type_name_list.append(type.aliases());
 
             foreach (const QString &name, type_name_list) {
-                foreach (const QString &app, mimeAppsManager->MimeApps.value(name)) {
+                foreach (const QString &app, mimeApps.value(name)) {
                     bool app_exist = false;
 
                     for (const QString &other : recommendApps) {
-                        const DesktopFile &app_desktop = mimeAppsManager->DesktopObjs.value(app);
-                        const DesktopFile &other_desktop = mimeAppsManager->DesktopObjs.value(other);
+                        const DesktopFile &app_desktop = desktopObjs.value(app);
+                        const DesktopFile &other_desktop = desktopObjs.value(other);
 
                         if (app_desktop.getExec() == other_desktop.getExec() && app_desktop.getLocalName() == other_desktop.getLocalName()) {
                             app_exist = true;
@@ -474,6 +589,11 @@ QStringList MimesAppsManager::getRecommendedAppsByQio(const QMimeType &mimeType)
             break;
     }
 
+    locker.relock();
+
+    if (generation == LookupGeneration)
+        RecommendedApps[mimeType.name()] = recommendApps;
+
     return recommendApps;
 }
 
@@ -503,7 +623,10 @@ QStringList MimesAppsManager::getRecommendedAppsByGio(const QString &mimeType)
 QStringList MimesAppsManager::getrecommendedAppsFromMimeWhiteList(const DUrl &url)
 {
     const DAbstractFileInfoPointer& info = fileService->createFileInfo(Q_NULLPTR, url);
-    QString aliasMimeType = info->mimeTypeName();
+    // the file info may be shared with a view that only guessed the type by the name
+    QString aliasMimeType = info->isViewItem() && !info->isActive() && url.isLocalFile()
+                            ? DMimeDatabase().mimeTypeForFile(url.toLocalFile()).name()
+                            : info->mimeTypeName();
     QStringList recommendedApps;
     QString mimeAssociationsFile = QString("%1/%2/%3").arg(DFMStandardPaths::location(DFMStandardPaths::ApplicationSharePath),
                                                            "mimetypeassociations",
@@ -554,6 +677,25 @@ QString MimesAppsManager::getMimeAppsCacheFile()
     return QString("%1/%2").arg(DFMStandardPaths::location(DFMStandardPaths::CachePath), "MimeApps.json");
 }
 
+QString MimesAppsManager::getMimeAppsIndexFile()
+{
+    return QString("%1/%2").arg(DFMStandardPaths::location(DFMStandardPaths::CachePath), "MimeApps.index");
+}
+
+QString MimesAppsManager::getApplicationsFolder(const QString &filePath)
+{
+    const QString &path = QDir::cleanPath(filePath);
+
+    foreach (const QString &folder, getApplicationsFolders()) {
+        const QString &folderPath = QDir::cleanPath(folder);
+
+        if (path == folderPath || path.startsWith(folderPath + "/"))
+            return folder;
+    }
+
+    return QString();
+}
+
 QString MimesAppsManager::getMimeInfoCacheFilePath()
 {
     return "/usr/share/applications/mimeinfo.cache";
@@ -595,6 +737,13 @@ QString MimesAppsManager::getDDEMimeTypeFile()
     return QString("%1/%2/%3").arg(getMimeInfoCacheFileRootPath(), "deepin", "dde-mimetype.list");
 }
 
+QMap<QString, DesktopFile> MimesAppsManager::getDesktopObjsSnapshot()
+{
+    QMutexLocker locker(&LookupMutex);
+
+    return DesktopObjs;
+}
+
 QMap<QString, DesktopFile> MimesAppsManager::getDesktopObjs()
 {
     QMap<QString, DesktopFile> desktopObjs;
@@ -605,66 +754,117 @@ QMap<QString, DesktopFile> MimesAppsManager::getDesktopObjs()
 }
 
 void MimesAppsManager::initMimeTypeApps()
+{
+    updateMimeTypeApps(QStringList());
+}
+
+void MimesAppsManager::updateMimeTypeApps(const QStringList &changedFolders)
 {
     qDebug() << "getMimeTypeApps in" << QThread::currentThread() << qApp->thread();
-    DesktopFiles.clear();
-    DesktopObjs.clear();
+
+    QMutexLocker locker(&IndexMutex);
+
+    if (!IndexLoaded) {
+        IndexLoaded = true;
+        loadIndex(IndexFolders);
+    }
+
+    const QStringList &folders = getApplicationsFolders();
+    bool indexChanged = false;
+
+    // only parse the desktop files of the folders that have changed
+    foreach (const QString &folder, folders) {
+        auto index = IndexFolders.constFind(folder);
+
+        if (index == IndexFolders.constEnd() || changedFolders.contains(folder)
+                || index.value().dirTimes != folderTimes(folder)) {
+            IndexFolders[folder] = scanFolder(folder);
+            indexChanged = true;
+        }
+    }
+
+    foreach (const QString &folder, IndexFolders.keys()) {
+        if (!folders.contains(folder)) {
+            IndexFolders.remove(folder);
+            indexChanged = true;
+        }
+    }
+
+    if (indexChanged)
+        saveIndex(IndexFolders);
+
+    QStringList desktopFiles;
+    QMap<QString, DesktopFile> desktopObjs;
+    QHash<QString, qint64> createdTimes;
+    QHash<QString, QString> desktopIdFiles;
+
     DDE_MimeTypes.clear();
+    loadDDEMimeTypes();
 
     QMap<QString, QSet<QString>> mimeAppsSet;
-    loadDDEMimeTypes();
-    foreach (QString desktopFolder, getApplicationsFolders()) {
-        QDirIterator it(desktopFolder, QStringList("*.desktop"),
-                        QDir::Files | QDir::NoDotAndDotDot,
-                        QDirIterator::Subdirectories);
-        while (it.hasNext()) {
-          it.next();
-          QString filePath = it.filePath();
-          DesktopFile desktopFile(filePath);
-          DesktopFiles.append(filePath);
-          DesktopObjs.insert(filePath, desktopFile);
-          QStringList mimeTypes = desktopFile.getMimeType();
-          QString fileName = QFileInfo(filePath).fileName();
-          if (DDE_MimeTypes.contains(fileName)){
-              mimeTypes.append(DDE_MimeTypes.value(fileName));
-          }
 
-          foreach (QString mimeType, mimeTypes) {
-              if (!mimeType.isEmpty()){
-                  QSet<QString> apps;
-                  if (mimeAppsSet.contains(mimeType)){
-                      apps = mimeAppsSet.value(mimeType);
-                      apps.insert(filePath);
-                  }else{
-                      apps.insert(filePath);
-                  }
-                  mimeAppsSet.insert(mimeType, apps);
-              }
-          }
+    foreach (const QString &folder, folders) {
+        for (const Entry &entry : IndexFolders.value(folder).entries) {
+            const QString &filePath = entry.desktopFile.getFileName();
+
+            desktopFiles.append(filePath);
+            desktopObjs.insert(filePath, entry.desktopFile);
+            createdTimes.insert(filePath, entry.created);
+
+            QStringList mimeTypes = entry.desktopFile.getMimeType();
+            QString fileName = QFileInfo(filePath).fileName();
+            if (DDE_MimeTypes.contains(fileName)){
+                mimeTypes.append(DDE_MimeTypes.value(fileName));
+            }
+
+            foreach (const QString &mimeType, mimeTypes) {
+                if (!mimeType.isEmpty())
+                    mimeAppsSet[mimeType].insert(filePath);
+            }
         }
     }
 
-    foreach (QString key, mimeAppsSet.keys()) {
-        QSet<QString> apps = mimeAppsSet.value(key);
-        QStringList orderApps;
-        if (apps.count() > 1){
-            QFileInfoList fileInfos;
-            foreach (QString app, apps) {
-                QFileInfo info(app);
-                fileInfos.append(info);
-            }
+    // same order as gio: the folders of the user first
+    for (int i = folders.count() - 1; i >= 0; --i) {
+        const QString &folderPath = QDir::cleanPath(folders.at(i)) + "/";
 
-            std::sort(fileInfos.begin(), fileInfos.end(), MimesAppsManager::lessByDateTime);
+        for (const Entry &entry : IndexFolders.value(folders.at(i)).entries) {
+            const QString &filePath = entry.desktopFile.getFileName();
+            QString desktopId = filePath.mid(folderPath.length());
 
-            foreach (QFileInfo info, fileInfos) {
-                orderApps.append(info.absoluteFilePath());
-            }
-        }else{
-            orderApps.append(apps.toList());
+            desktopId.replace("/", "-");
+
+            if (!desktopIdFiles.contains(desktopId))
+                desktopIdFiles.insert(desktopId, filePath);
         }
-        MimeApps.insert(key, orderApps);
     }
 
+    locker.unlock();
+
+    QMap<QString, QStringList> mimeApps;
+
+    for (auto it = mimeAppsSet.constBegin(); it != mimeAppsSet.constEnd(); ++it) {
+        QStringList orderApps = it.value().toList();
+
+        // sort by the time stored in the index instead of stat every file
+        std::sort(orderApps.begin(), orderApps.end(), [&createdTimes] (const QString &f1, const QString &f2) {
+            return createdTimes.value(f1) < createdTimes.value(f2);
+        });
+
+        mimeApps.insert(it.key(), orderApps);
+    }
+
+    QMutexLocker lookupLocker(&LookupMutex);
+
+    DesktopFiles = desktopFiles;
+    DesktopObjs = desktopObjs;
+    MimeApps = mimeApps;
+    DesktopIdFiles = desktopIdFiles;
+    RecommendedApps.clear();
+    ++LookupGeneration;
+
+    lookupLocker.unlock();
+
     //check mime apps from cache
     QFile f(getMimeInfoCacheFilePath());
     if(!f.open(QIODevice::ReadOnly)){
@@ -705,11 +905,17 @@ void MimesAppsManager::initMimeTypeApps()
     f.close();
 
     const QString mimeInfoCacheRootPath = getMimeInfoCacheFileRootPath();
+    AudioMimeApps.clear();
+    ImageMimeApps.clear();
+    TextMimeApps.clear();
+    VideoMimeApps.clear();
+
     foreach (QString desktop, audioDesktopList) {
         const QString path = QString("%1/%2").arg(mimeInfoCacheRootPath,desktop);
         if(!QFile::exists(path))
             continue;
-        DesktopFile df(path);
+        // already parsed for the index in most cases
+        const DesktopFile df = desktopObjs.contains(path) ? desktopObjs.value(path) : DesktopFile(path);
         AudioMimeApps.insert(path, df);
     }
 
@@ -717,7 +923,7 @@ void MimesAppsManager::initMimeTypeApps()
         const QString path = QString("%1/%2").arg(mimeInfoCacheRootPath,desktop);
         if(!QFile::exists(path))
             continue;
-        DesktopFile df(path);
+        const DesktopFile df = desktopObjs.contains(path) ? desktopObjs.value(path) : DesktopFile(path);
         ImageMimeApps.insert(path, df);
     }
 
@@ -725,7 +931,7 @@ void MimesAppsManager::initMimeTypeApps()
         const QString path = QString("%1/%2").arg(mimeInfoCacheRootPath,desktop);
         if(!QFile::exists(path))
             continue;
-        DesktopFile df(path);
+        const DesktopFile df = desktopObjs.contains(path) ? desktopObjs.value(path) : DesktopFile(path);
         TextMimeApps.insert(path, df);
     }
 
@@ -733,7 +939,7 @@ void MimesAppsManager::initMimeTypeApps()
         const QString path = QString("%1/%2").arg(mimeInfoCacheRootPath,desktop);
         if(!QFile::exists(path))
             continue;
-        DesktopFile df(path);
+        const DesktopFile df = desktopObjs.contains(path) ? desktopObjs.value(path) : DesktopFile(path);
         VideoMimeApps.insert(path, df);
     }
 
@@ -60,6 +60,8 @@ public slots:
 private:
     QFileSystemWatcher* m_fileSystemWatcher = NULL;
     QTimer* m_updateCacheTimer;
+    // applications folders whose desktop files changed since the last update
+    QStringList m_dirtyFolders;
 };
 
 
@@ -101,6 +103,8 @@ public:
 
     static QStringList getApplicationsFolders();
     static QString getMimeAppsCacheFile();
+    static QString getMimeAppsIndexFile();
+    static QString getApplicationsFolder(const QString& filePath);
     static QString getMimeInfoCacheFilePath();
     static QString getMimeInfoCacheFileRootPath();
     static QString getDesktopFilesCacheFile();
@@ -108,7 +112,10 @@ public:
     static QStringList getDesktopFiles();
     static QString getDDEMimeTypeFile();
     static QMap<QString, DesktopFile> getDesktopObjs();
+    // a copy of DesktopObjs, which is replaced when the index has been rebuilt
+    static QMap<QString, DesktopFile> getDesktopObjsSnapshot();
     static void initMimeTypeApps();
+    static void updateMimeTypeApps(const QStringList& changedFolders);
     static void loadDDEMimeTypes();
     static bool lessByDateTime(const QFileInfo& f1,  const QFileInfo& f2);
     static bool removeOneDupFromList(QStringList& list, const QString desktopFilePath);
@@ -65,6 +65,7 @@
 #include "view/viewinterface.h"
 #include "plugins/pluginmanager.h"
 #include "controllers/trashmanager.h"
+#include "controllers/searchhistroymanager.h"
 #include "themeconfig.h"
 
 #include <dplatformwindowhandle.h>
@@ -1004,6 +1005,11 @@ void DFileManagerWindow::initConnect()
         d->tabBar->onCurrentUrlChanged(DFMUrlBaseEvent(this, currentUrl()));
         emit fileSignalManager->currentUrlChanged(DFMUrlBaseEvent(this, currentUrl()));
 
+        // ranks the completions of the address bar
+        if (currentUrl().isLocalFile()) {
+            Singleton<SearchHistroyManager>::instance()->recordVisit(currentUrl().toLocalFile());
+        }
+
         const DAbstractFileInfoPointer &info = DFileService::instance()->createFileInfo(this, currentUrl());
 
         if (info)
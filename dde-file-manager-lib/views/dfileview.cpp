@@ -43,6 +43,7 @@
 #include "interfaces/dfmglobal.h"
 #include "interfaces/diconitemdelegate.h"
 #include "interfaces/dlistitemdelegate.h"
+#include "interfaces/dfileiconprovider.h"
 #include "dfmapplication.h"
 #include "interfaces/dfmcrumbbar.h"
 
@@ -72,9 +73,13 @@
 #include <QHeaderView>
 #include <QMimeData>
 #include <QScrollBar>
+#include <QLoggingCategory>
 
 DWIDGET_USE_NAMESPACE
 
+// the icon lookups of a paint, debug messages are disabled by default
+Q_LOGGING_CATEGORY(viewIcons, "file.view.icons", QtInfoMsg)
+
 #define ICON_VIEW_SPACING 5
 #define LIST_VIEW_SPACING 1
 #define LIST_VIEW_MINIMUM_WIDTH 80
@@ -1322,6 +1327,26 @@ void DFileView::focusInEvent(QFocusEvent *event)
     DFileMenuManager::setActionBlacklist(d->menuBlacklist);
 }
 
+void DFileView::paintEvent(QPaintEvent *event)
+{
+    if (!viewIcons().isDebugEnabled())
+        return DListView::paintEvent(event);
+
+    const DFileIconProvider::Statistics &old = DFileIconProvider::globalProvider()->statistics();
+
+    DListView::paintEvent(event);
+
+    const DFileIconProvider::Statistics &now = DFileIconProvider::globalProvider()->statistics();
+
+    // the icons are cached by type, only the first paint and the paint after
+    // the icon theme changed should look up the icons, keep the format stable
+    if (now.themeLookups != old.themeLookups || now.gioLookups != old.gioLookups) {
+        qCDebug(viewIcons) << "icon lookups of paint, theme:" << now.themeLookups - old.themeLookups
+                           << "gio:" << now.gioLookups - old.gioLookups
+                           << "cache hits:" << now.cacheHits - old.cacheHits;
+    }
+}
+
 void DFileView::resizeEvent(QResizeEvent *event)
 {
     Q_D(DFileView);
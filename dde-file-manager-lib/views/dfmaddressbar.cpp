@@ -337,10 +337,10 @@ void DFMAddressBar::initConnections()
         }
         QString str = text();
         if (!DUrl::fromUserInput(str).isLocalFile()) {
-            if (!historyList.contains(str)) {
-                historyList.append(str);
-                Singleton<SearchHistroyManager>::instance()->writeIntoSearchHistory(str);
-            }
+            // the history is bounded and ranked by the frecency
+            Singleton<SearchHistroyManager>::instance()->writeIntoSearchHistory(str);
+            historyList = Singleton<SearchHistroyManager>::instance()->toStringList();
+            isHistoryInCompleterModel = false;
         }
     });
     connect(this, &DFMAddressBar::textEdited, this, &DFMAddressBar::onTextEdited);
@@ -23,9 +23,9 @@
  */
 
 #include "imageview.h"
+#include "dfmimagedecoder.h"
 
 #include <QUrl>
-#include <QImageReader>
 #include <QApplication>
 #include <QDesktopWidget>
 #include <QtMath>
@@ -37,6 +37,8 @@
 
 #define MIN_SIZE QSize(400, 300)
 
+DFM_USE_NAMESPACE
+
 ImageView::ImageView(const QString &fileName, const QByteArray &format, QWidget *parent)
     : QLabel(parent)
 {
@@ -47,16 +49,14 @@ ImageView::ImageView(const QString &fileName, const QByteArray &format, QWidget
 
 void ImageView::setFile(const QString &fileName, const QByteArray &format)
 {
-    QImageReader reader(fileName, format);
-
-    m_sourceSize = reader.size();
-
     const QSize &dsize = qApp->desktop()->size();
     qreal device_pixel_ratio = this->devicePixelRatioF();
 
-    QPixmap pixmap = QPixmap::fromImageReader(&reader).scaled(QSize(qMin((int)(dsize.width() * 0.7 * device_pixel_ratio), m_sourceSize.width()),
-                                                                    qMin((int)(dsize.height() * 0.8 * device_pixel_ratio), m_sourceSize.height())),
-                                                              Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    // decoded at the display size, a huge image is never loaded in full resolution
+    const QImage &image = DFMImageDecoder::read(fileName, QSize(dsize.width() * 0.7 * device_pixel_ratio,
+                                                                dsize.height() * 0.8 * device_pixel_ratio),
+                                                Qt::KeepAspectRatio, format, &m_sourceSize);
+    QPixmap pixmap = QPixmap::fromImage(image);
 
     pixmap.setDevicePixelRatio(device_pixel_ratio);
 
@@ -44,6 +44,60 @@
 #include <QButtonGroup>
 #include <QPushButton>
 
+// the rendered images shown by the item widgets, least recently used first
+class RenderedImages{
+public:
+    explicit RenderedImages(qint64 maxCost):
+        maxCost(maxCost){}
+
+    bool contains(int index) const
+    {
+        return costs.contains(index);
+    }
+
+    void touch(int index)
+    {
+        if (lru.removeOne(index))
+            lru << index;
+    }
+
+    // returns the indexes whose images should be released to stay in the budget
+    QList<int> insert(int index, qint64 cost, const QList<int> &pinned)
+    {
+        if (costs.contains(index)) {
+            totalCost -= costs.value(index);
+            lru.removeOne(index);
+        }
+
+        costs[index] = cost;
+        totalCost += cost;
+        lru << index;
+
+        QList<int> evicted;
+
+        for (int i = 0; totalCost > maxCost && i < lru.size();) {
+            const int e = lru.at(i);
+
+            if (e == index || pinned.contains(e)) {
+                ++i;
+                continue;
+            }
+
+            lru.removeAt(i);
+            totalCost -= costs.take(e);
+            evicted << e;
+        }
+
+        return evicted;
+    }
+
+private:
+    qint64 maxCost;
+    qint64 totalCost = 0;
+    QList<int> lru;
+    QHash<int, qint64> costs;
+};
+
 class PdfWidgetPrivate{
 public:
     PdfWidgetPrivate(PdfWidget* qq):
@@ -63,7 +117,10 @@ public:
     QSharedPointer<poppler::document> doc;
 
     PdfInitWorker* pdfInitWorker = NULL;
-    QMap<int, QImage> pageMap;
+    RenderedImages pageImages{PAGE_CACHE_COST};
+    RenderedImages thumbImages{THUMB_CACHE_COST};
+    // the width of the page list when the page was rendered
+    QHash<int, int> pageWidths;
 
     PdfWidget* q_ptr = NULL;
     Q_DECLARE_PUBLIC(PdfWidget)
@@ -102,6 +159,8 @@ PdfWidget::~PdfWidget()
     disconnect(d->pdfInitWorker, &PdfInitWorker::thumbAdded, this, &PdfWidget::onThumbAdded);
     disconnect(d->pdfInitWorker, &PdfInitWorker::pageAdded, this, &PdfWidget::onpageAdded);
 
+    // wait for the page in rendering
+    delete d->pdfInitWorker;
 }
 
 void PdfWidget::initDoc(const QString& file)
@@ -169,8 +228,9 @@ void PdfWidget::initUI()
 
     initEmptyPages();
 
-    loadThumbSync(0);
-    loadPageSync(0);
+    // the visible items are known after the widget is laid out
+    d->thumbWorkTimer->start();
+    d->pageWorkTimer->start();
 }
 
 void PdfWidget::initConnections()
@@ -207,12 +267,16 @@ void PdfWidget::onThumbAdded(int index, QImage img)
 {
     Q_D(PdfWidget);
     QListWidgetItem* item = d->thumbListWidget->item(index);
-    QWidget* w = d->thumbListWidget->itemWidget(item);
 
-    if(!w){
-        QPushButton* bnt = new QPushButton(this);
+    if(!item){
+        return;
+    }
+
+    QPushButton* bnt = qobject_cast<QPushButton*>(d->thumbListWidget->itemWidget(item));
+
+    if(!bnt){
+        bnt = new QPushButton(this);
         d->thumbButtonGroup->addButton(bnt);
-        bnt->setIcon(QIcon(QPixmap::fromImage(img)));
         bnt->setFixedSize(img.size());
         bnt->setIconSize(QSize(img.width() - 4, img.height()));
         bnt->setCheckable(true);
@@ -238,6 +302,13 @@ void PdfWidget::onThumbAdded(int index, QImage img)
         item->setSizeHint(img.size());
     }
 
+    bnt->setIcon(QIcon(QPixmap::fromImage(img)));
+
+    for (int i : d->thumbImages.insert(index, img.byteCount(), visibleRows(d->thumbListWidget))) {
+        if (QPushButton *evicted = qobject_cast<QPushButton*>(d->thumbListWidget->itemWidget(d->thumbListWidget->item(i))))
+            evicted->setIcon(QIcon());
+    }
+
     if(d->thumbScrollBar->maximum() == 0){
         d->thumbScrollBar->hide();
     } else {
@@ -249,28 +320,47 @@ void PdfWidget::onpageAdded(int index, QImage img)
 {
     Q_D(PdfWidget);
 
-    d->pageMap.insert(index, img);
-
     QListWidgetItem* item = d->pageListWidget->item(index);
-    QWidget* w = d->pageListWidget->itemWidget(item);
 
-    if(!w){
-        img = img.scaled(d->pageListWidget->width(), img.height(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        QImage page(d->pageListWidget->width(), img.height() + 4, QImage::Format_ARGB32_Premultiplied);
-        page.fill(Qt::white);
-        QPainter p(&page);
-        p.drawImage((page.width() - img.width())/2, 2, img);
-        if(index < (d->doc->pages() - 1)){
-            QPen pen(QColor(0, 0, 0 , 20));
-            p.setPen(pen);
-            p.drawLine(0, page.height() - 1, page.width(), page.height() - 1);
-        }
+    if(!item){
+        return;
+    }
 
-        QLabel* pageLabel = new QLabel(this);
-        pageLabel->setPixmap(QPixmap::fromImage(page));
+    QLabel* pageLabel = qobject_cast<QLabel*>(d->pageListWidget->itemWidget(item));
 
+    if(!pageLabel){
+        pageLabel = new QLabel(this);
         d->pageListWidget->setItemWidget(item, pageLabel);
-        item->setSizeHint(page.size());
+    }
+
+    const int width = d->pageListWidget->width();
+
+    // rendered for the width before a resize, a new one is requested already
+    if(img.width() > width){
+        img = img.scaledToWidth(width, Qt::FastTransformation);
+    }
+
+    QImage page(width, img.height() + 4, QImage::Format_ARGB32_Premultiplied);
+    page.fill(Qt::white);
+    QPainter p(&page);
+    p.drawImage((page.width() - img.width())/2, 2, img);
+    if(index < (d->doc->pages() - 1)){
+        QPen pen(QColor(0, 0, 0 , 20));
+        p.setPen(pen);
+        p.drawLine(0, page.height() - 1, page.width(), page.height() - 1);
+    }
+    p.end();
+
+    pageLabel->setPixmap(QPixmap::fromImage(page));
+    item->setSizeHint(page.size());
+    d->pageWidths[index] = width;
+
+    // keep the size hint of the released pages, the scroll position must not jump
+    for (int i : d->pageImages.insert(index, page.byteCount(), visibleRows(d->pageListWidget))) {
+        if (QLabel *evicted = qobject_cast<QLabel*>(d->pageListWidget->itemWidget(d->pageListWidget->item(i))))
+            evicted->clear();
+
+        d->pageWidths.remove(i);
     }
 
     if(d->pageScrollBar->maximum() == 0){
@@ -298,8 +388,6 @@ void PdfWidget::onPageScrollBarvalueChanged(const int &val)
     d->pageWorkTimer->stop();
     d->pageWorkTimer->start();
 
-    resizeCurrentPage();
-
     QListWidgetItem* item = d->pageListWidget->itemAt(d->pageListWidget->width() /2 , 20);
     if(!item){
         return;
@@ -323,32 +411,38 @@ void PdfWidget::onPageScrollBarvalueChanged(const int &val)
 
 void PdfWidget::startLoadCurrentPages()
 {
-    Q_D(const PdfWidget);
-    QListWidgetItem* item = d->pageListWidget->itemAt(d->pageListWidget->width() / 2, 0);
-    if(!item){
-        item = d->pageListWidget->itemAt(d->pageListWidget->width() / 2, d->pageListWidget->spacing() * 2 + 1);
-    }
-    if(item)
-    {
-        int row = d->pageListWidget->row(item);
-        loadPageSync(row);
+    Q_D(PdfWidget);
+
+    const int width = d->pageListWidget->width();
+    QList<int> rows;
+
+    for (int row : visibleRows(d->pageListWidget)) {
+        if (d->pageImages.contains(row) && d->pageWidths.value(row) == width) {
+            d->pageImages.touch(row);
+        } else {
+            rows << row;
+        }
     }
+
+    // also cancels the requests of the pages scrolled out
+    loadPageSync(rows);
 }
 
 void PdfWidget::startLoadCurrentThumbs()
 {
-    Q_D(const PdfWidget);
-    QListWidgetItem* item = d->thumbListWidget->itemAt(d->thumbListWidget->width() / 2, 0);
-    //To prevent this point is int empty area, we get another point again with next pixcel that lager than it spacing
-    if(!item){
-        item = d->thumbListWidget->itemAt(d->thumbListWidget->width() / 2, d->thumbListWidget->spacing() * 2  + 1);
-    }
+    Q_D(PdfWidget);
 
-    if(item)
-    {
-        int row = d->thumbListWidget->row(item);
-        loadThumbSync(row);
+    QList<int> rows;
+
+    for (int row : visibleRows(d->thumbListWidget)) {
+        if (d->thumbImages.contains(row)) {
+            d->thumbImages.touch(row);
+        } else {
+            rows << row;
+        }
     }
+
+    loadThumbSync(rows);
 }
 
 void PdfWidget::resizeEvent(QResizeEvent *event)
@@ -380,7 +474,8 @@ void PdfWidget::resizeEvent(QResizeEvent *event)
     d->pageScrollBar->move(event->size().width() - d->pageScrollBar->width(), 30);
     d->pageListWidget->setFixedWidth(width() - d->thumbListWidget->width());
 
-    resizeCurrentPage();
+    // render the visible pages again for the new width
+    d->pageWorkTimer->start();
 }
 
 void PdfWidget::renderBorder(QImage &img)
@@ -409,22 +504,54 @@ void PdfWidget::emptyBorder(QImage &img)
     painter.drawRect(0, 0, img.width() - 2, img.height() - 2);
 }
 
-void PdfWidget::loadPageSync(const int &index)
+void PdfWidget::loadPageSync(const QList<int> &indexes)
 {
     Q_D(PdfWidget);
 
-    QtConcurrent::run([=]{
-       d->pdfInitWorker->startGetPageImage(index);
-    });
+    d->pdfInitWorker->startGetPageImage(indexes, d->pageListWidget->width());
 }
 
-void PdfWidget::loadThumbSync(const int &index)
+void PdfWidget::loadThumbSync(const QList<int> &indexes)
 {
     Q_D(PdfWidget);
 
-    QtConcurrent::run([=]{
-        d->pdfInitWorker->startGetPageThumb(index);
-    });
+    d->pdfInitWorker->startGetPageThumb(indexes);
+}
+
+QList<int> PdfWidget::visibleRows(const QListWidget *listWidget) const
+{
+    QList<int> rows;
+    const QRect &rect = listWidget->viewport()->rect();
+    const int x = rect.center().x();
+    QListWidgetItem* first = listWidget->itemAt(x, rect.top());
+    //To prevent this point is int empty area, we get another point again with next pixcel that lager than it spacing
+    if(!first){
+        first = listWidget->itemAt(x, rect.top() + listWidget->spacing() * 2 + 1);
+    }
+
+    if(!first){
+        return rows;
+    }
+
+    QListWidgetItem* last = listWidget->itemAt(x, rect.bottom());
+    if(!last){
+        last = listWidget->itemAt(x, rect.bottom() - listWidget->spacing() * 2 - 1);
+    }
+
+    const int begin = listWidget->row(first);
+    const int end = last ? qMax(begin, listWidget->row(last)) : begin;
+
+    for (int i = begin; i <= end; ++i)
+        rows << i;
+
+    // prefetch the neighbours
+    if (begin > 0)
+        rows << begin - 1;
+
+    if (end + 1 < listWidget->count())
+        rows << end + 1;
+
+    return rows;
 }
 
 void PdfWidget::initEmptyPages()
@@ -443,130 +570,87 @@ void PdfWidget::initEmptyPages()
     }
 }
 
-void PdfWidget::resizeCurrentPage()
+PdfInitWorker::PdfInitWorker(QSharedPointer<poppler::document> doc, QObject *parent):
+    QObject(parent),
+    m_doc(doc)
 {
-    Q_D(PdfWidget);
-
-    QListWidgetItem* currentItem = d->pageListWidget->itemAt(d->pageListWidget->width() / 2, d->pageListWidget->height() / 2);
-
-    if(!currentItem)
-        return;
-
-    int currentRow = d->pageListWidget->row(currentItem);
-    int index = currentRow - DISPLAT_PAGE_NUM/2;
-    if(index < 0){
-        index = 0;
-    }
-    int counter = 0;
-    while(counter < DISPLAT_PAGE_NUM){
-        counter ++;
 
-        if(d->pageMap.contains(index)){
-
-            QListWidgetItem* item = d->pageListWidget->item(index);
-            if(!item){
-                continue;
-            }
-
-            QWidget* w = d->pageListWidget->itemWidget(item);
-            if(!w){
-                continue;
-            }
-
-            QLabel* label = qobject_cast<QLabel*>(w);
+}
 
-            QImage img = d->pageMap.value(index);
-            img = img.scaled(d->pageListWidget->width(), img.height(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
-            QImage page(d->pageListWidget->width(), img.height() + 4, QImage::Format_ARGB32_Premultiplied);
-            page.fill(Qt::white);
+PdfInitWorker::~PdfInitWorker()
+{
+    m_mutex.lock();
+    m_stop = true;
+    m_mutex.unlock();
 
-            QPainter p(&page);
-            p.drawImage((page.width() - img.width()) / 2, 2, img);
+    m_future.waitForFinished();
+}
 
-            if(index < (d->doc->pages() - 1)){
-                QPen pen(QColor(0, 0, 0 , 20));
-                p.setPen(pen);
-                p.drawLine(0, page.height() - 1, page.width(), page.height() - 1);
-            }
+void PdfInitWorker::startGetPageImage(const QList<int> &indexes, int width)
+{
+    QMutexLocker locker(&m_mutex);
 
-            label->setPixmap(QPixmap::fromImage(page));
-            item->setSizeHint(page.size());
+    m_pageRequests = indexes;
+    m_pageWidth = width;
 
-            index ++;
-        } else {
-            index ++;
-            continue;
-        }
+    if (!m_running && !m_pageRequests.isEmpty()) {
+        m_running = true;
+        m_future = QtConcurrent::run(this, &PdfInitWorker::run);
     }
 }
 
-PdfInitWorker::PdfInitWorker(QSharedPointer<poppler::document> doc, QObject *parent):
-    QObject(parent),
-    m_doc(doc)
+void PdfInitWorker::startGetPageThumb(const QList<int> &indexes)
 {
+    QMutexLocker locker(&m_mutex);
+
+    m_thumbRequests = indexes;
 
+    if (!m_running && !m_thumbRequests.isEmpty()) {
+        m_running = true;
+        m_future = QtConcurrent::run(this, &PdfInitWorker::run);
+    }
 }
 
-void PdfInitWorker::startGetPageThumb(int index)
+void PdfInitWorker::run()
 {
-    int counter = 0;
-    while(counter < DISPLAY_THUMB_NUM){
-        counter++;
+    forever {
+        QMutexLocker locker(&m_mutex);
 
-        //Skip for indexed thumb we got
-        if(m_gotThumbIndexes.contains(index)){
-            index ++;
-            continue;
+        if (m_stop || (m_pageRequests.isEmpty() && m_thumbRequests.isEmpty())) {
+            m_running = false;
+            return;
         }
 
-        QImage img = getRenderedPageImage(index);
+        // the pages are more important than the thumbs
+        const bool is_thumb = m_pageRequests.isEmpty();
+        const int index = is_thumb ? m_thumbRequests.takeFirst() : m_pageRequests.takeFirst();
+        const QSize size = is_thumb ? DEFAULT_THUMB_SIZE : QSize(m_pageWidth, 0);
 
-        if(img.isNull()){
-            break;
-        } else{
-            QImage thumb = getPageThumb(img);
-            emit thumbAdded(index, thumb);
-            m_gotThumbIndexes << index;
-            index ++;
-        }
+        locker.unlock();
 
-    }
-}
+        const QImage &img = getRenderedPageImage(index, size);
 
-void PdfInitWorker::startGetPageImage(int index)
-{
-    int counter = 0;
-    while(counter < DISPLAT_PAGE_NUM){
-        counter++;
-
-        //Skip for indexed page we got
-        if(m_gotPageIndexes.contains(index)){
-            index ++;
+        if (img.isNull()) {
             continue;
         }
 
-        QImage img = getRenderedPageImage(index);
-
-        if(img.isNull()){
-            break;
+        if (is_thumb) {
+            emit thumbAdded(index, img);
         } else {
             emit pageAdded(index, img);
-            m_gotPageIndexes << index;
-            index ++;
         }
     }
 }
 
-QImage PdfInitWorker::getPageThumb(const QImage &img) const
-{
-    QImage newImg = img;
-    return newImg.scaled(DEFAULT_THUMB_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-}
-
-QImage PdfInitWorker::getRenderedPageImage(const int &index) const
+QImage PdfInitWorker::getRenderedPageImage(const int &index, const QSize &size) const
 {
     QImage img;
 
+    if (!m_doc || size.width() <= 0) {
+        return img;
+    }
+
+    QMutexLocker locker(&m_docMutex);
     QSharedPointer<poppler::page> page = QSharedPointer<poppler::page>(m_doc->create_page(index));
 
     if (!page) {
@@ -582,12 +666,27 @@ QImage PdfInitWorker::getRenderedPageImage(const int &index) const
         return img;
     }
 
-    if(page->page_rect().width() * page->page_rect().height() > 1920 * 1080 * 3){
+    const poppler::rectf &rect = page->page_rect();
+
+    if(rect.width() <= 0 || rect.height() <= 0){
+        return img;
+    }
+
+    // render at the target size (size.height() is 0 to fit the width only) instead of scaling it later
+    qreal scale = size.width() / rect.width();
+
+    if(size.height() > 0){
+        scale = qMin(scale, size.height() / rect.height());
+    }
+
+    if(rect.width() * scale * rect.height() * scale > 1920 * 1080 * 3){
         qDebug () << "This pdf page is tool large, ignore...";
         return img;
     }
 
-    poppler::image imageData = pr.render_page(page.data());
+    poppler::image imageData = pr.render_page(page.data(), 72.0 * scale, 72.0 * scale);
+
+    locker.unlock();
 
     if (!imageData.is_valid()) {
         qDebug () << "Render error";
@@ -601,10 +700,10 @@ QImage PdfInitWorker::getRenderedPageImage(const int &index) const
         qDebug ()  << "Image format is invalid";
         return img;
     case poppler::image::format_mono:
-        img = QImage((uchar*)imageData.data(), imageData.width(), imageData.height(), QImage::Format_Mono);
+        img = QImage((uchar*)imageData.data(), imageData.width(), imageData.height(), imageData.bytes_per_row(), QImage::Format_Mono).copy();
         break;
     case poppler::image::format_rgb24:
-        img = QImage((uchar*)imageData.data(),imageData.width(),imageData.height(),QImage::Format_ARGB6666_Premultiplied);
+        img = QImage((uchar*)imageData.data(),imageData.width(),imageData.height(),imageData.bytes_per_row(),QImage::Format_ARGB6666_Premultiplied).copy();
         break;
     case poppler::image::format_argb32:
     {
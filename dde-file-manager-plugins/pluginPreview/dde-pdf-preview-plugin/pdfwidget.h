@@ -29,6 +29,8 @@
 #include <QSharedPointer>
 #include <QListWidget>
 #include <QLabel>
+#include <QMutex>
+#include <QFuture>
 
 #include "poppler-document.h"
 #include "poppler-page.h"
@@ -39,6 +41,9 @@
 #define DEFAULT_PAGE_SIZE QSize(800, 1200)
 #define DISPLAY_THUMB_NUM 10
 #define DISPLAT_PAGE_NUM 5
+// memory budget of the rendered images kept by the item widgets
+#define PAGE_CACHE_COST (64 * 1024 * 1024)
+#define THUMB_CACHE_COST (8 * 1024 * 1024)
 
 class PdfWidgetPrivate;
 class PdfInitWorker;
@@ -72,12 +77,11 @@ private:
     void renderBorder(QImage& img);
     void emptyBorder(QImage& img);
 
-    void loadPageSync(const int& index);
-    void loadThumbSync(const int& index);
+    void loadPageSync(const QList<int> &indexes);
+    void loadThumbSync(const QList<int> &indexes);
+    QList<int> visibleRows(const QListWidget *listWidget) const;
     void initEmptyPages();
 
-    void resizeCurrentPage();
-
     QSharedPointer<PdfWidgetPrivate> d_ptr;
     Q_DECLARE_PRIVATE_D(qGetPtrHelper(d_ptr), PdfWidget)
 };
@@ -86,21 +90,30 @@ class PdfInitWorker: public QObject{
     Q_OBJECT
 public:
     explicit PdfInitWorker(QSharedPointer<poppler::document> doc, QObject* parent = 0);
+    ~PdfInitWorker();
 
-    void startGetPageThumb(int index);
-    void startGetPageImage(int index);
+    // replace the pending requests, the pages not in the list are not rendered any more
+    void startGetPageImage(const QList<int> &indexes, int width);
+    void startGetPageThumb(const QList<int> &indexes);
 
 signals:
     void pageAdded(const int& index, const QImage& img);
     void thumbAdded(const int& index, const QImage& img);
 
 private:
-    QImage getPageThumb(const QImage& img) const;
-    QImage getRenderedPageImage(const int& index) const;
-
-    QList<int> m_gotThumbIndexes;
-    QList<int> m_gotPageIndexes;
-
+    void run();
+    QImage getRenderedPageImage(const int& index, const QSize &size) const;
+
+    QMutex m_mutex;
+    QList<int> m_pageRequests;
+    QList<int> m_thumbRequests;
+    int m_pageWidth = 0;
+    bool m_running = false;
+    bool m_stop = false;
+    QFuture<void> m_future;
+
+    // poppler::document is not thread safe
+    mutable QMutex m_docMutex;
     QSharedPointer<poppler::document> m_doc;
 };
 
@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui widgets
+QT       += core gui widgets concurrent
 
 TARGET = dde-text-preview-plugin
 TEMPLATE = lib
@@ -14,10 +14,12 @@ include(../../../common/common.pri)
 
 SOURCES += \
     main.cpp \
-    textpreview.cpp
+    textpreview.cpp \
+    textpreviewdocument.cpp
 
 HEADERS += \
-    textpreview.h
+    textpreview.h \
+    textpreviewdocument.h
 DISTFILES += \
     dde-text-preview-plugin.json
 
@@ -23,6 +23,7 @@
  */
 
 #include "textpreview.h"
+#include "textpreviewdocument.h"
 #include "dabstractfileinfo.h"
 #include "dfileservices.h"
 
@@ -32,10 +33,19 @@
 #include <QUrl>
 #include <QFileInfo>
 #include <QPlainTextEdit>
+#include <QScrollBar>
+#include <QHBoxLayout>
+#include <QWheelEvent>
+#include <QCoreApplication>
 #include <QDebug>
 
 DFM_BEGIN_NAMESPACE
 
+// the smaller files are loaded to the text browser at once
+static const qint64 WINDOWED_PREVIEW_MIN_SIZE = 4 * 1024 * 1024;
+static const int WINDOW_LINES = 1000;
+static const int WINDOW_MARGIN = 300;
+
 TextPreview::TextPreview(QObject *parent):
     DFMFilePreview(parent)
 {
@@ -44,8 +54,8 @@ TextPreview::TextPreview(QObject *parent):
 
 TextPreview::~TextPreview()
 {
-    if (m_textBrowser)
-        m_textBrowser->deleteLater();
+    if (m_widget)
+        m_widget->deleteLater();
 }
 
 bool TextPreview::setFileUrl(const DUrl &url)
@@ -54,48 +64,73 @@ bool TextPreview::setFileUrl(const DUrl &url)
         return true;
 
     m_url = url;
+    m_document.reset();
 
-    QByteArray text;
+    initWidget();
 
-    {
-        const DAbstractFileInfoPointer &info = DFileService::instance()->createFileInfo(this, url);
+    const QString &file_path = url.toLocalFile();
 
-        if (!info)
-            return false;
+    if (url.isLocalFile() && QFileInfo(file_path).size() > WINDOWED_PREVIEW_MIN_SIZE) {
+        QScopedPointer<TextPreviewDocument> document(new TextPreviewDocument());
 
-        QScopedPointer<QIODevice> device(info->createIODevice());
+        if (document->open(file_path)) {
+            m_document.swap(document);
 
-        if (!device) {
-            if (url.isLocalFile()) {
-               device.reset(new QFile(url.toLocalFile()));
-            }
-        }
+            connect(m_document.data(), &TextPreviewDocument::lineCountChanged, this, &TextPreview::updateScrollRange);
 
-        if (!device)
-            return false;
+            m_textBrowser->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+            m_scrollBar->show();
+            m_windowStart = 0;
+            m_windowLines = 0;
+            m_windowAtEnd = false;
 
-        if (!device->open(QIODevice::ReadOnly)) {
-            return false;
-        }
+            updateScrollRange();
+
+            m_updatingWindow = true;
+            m_scrollBar->setValue(0);
+            m_updatingWindow = false;
 
-        text = device->readAll();
+            updateWindow(0);
+        }
     }
 
-    if (!m_textBrowser) {
-        m_textBrowser = new QPlainTextEdit();
+    if (!m_document) {
+        QByteArray text;
 
-        m_textBrowser->setReadOnly(true);
-        m_textBrowser->setTextInteractionFlags(Qt::TextSelectableByMouse | Qt::TextSelectableByKeyboard);
-        m_textBrowser->setWordWrapMode(QTextOption::NoWrap);
-        m_textBrowser->setFixedSize(800, 500);
-        m_textBrowser->setFocusPolicy(Qt::NoFocus);
-    }
+        {
+            const DAbstractFileInfoPointer &info = DFileService::instance()->createFileInfo(this, url);
+
+            if (!info)
+                return false;
+
+            QScopedPointer<QIODevice> device(info->createIODevice());
 
+            if (!device) {
+                if (url.isLocalFile()) {
+                   device.reset(new QFile(file_path));
+                }
+            }
 
-    QString convertedStr{ DFMGlobal::toUnicode(text, url.toLocalFile()) };
+            if (!device)
+                return false;
 
-    m_textBrowser->setPlainText(convertedStr);
-    m_title = QFileInfo(url.toLocalFile()).fileName();
+            if (!device->open(QIODevice::ReadOnly)) {
+                return false;
+            }
+
+            // the file can not be windowed, only show the head of it
+            text = device->read(WINDOWED_PREVIEW_MIN_SIZE);
+        }
+
+        m_scrollBar->hide();
+        m_textBrowser->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+
+        QString convertedStr{ DFMGlobal::toUnicode(text, file_path) };
+
+        m_textBrowser->setPlainText(convertedStr);
+    }
+
+    m_title = QFileInfo(file_path).fileName();
 
     Q_EMIT titleChanged();
 
@@ -104,7 +139,7 @@ bool TextPreview::setFileUrl(const DUrl &url)
 
 QWidget *TextPreview::contentWidget() const
 {
-    return m_textBrowser;
+    return m_widget;
 }
 
 QString TextPreview::title() const
@@ -117,4 +152,98 @@ bool TextPreview::showStatusBarSeparator() const
     return true;
 }
 
+bool TextPreview::eventFilter(QObject *watched, QEvent *event)
+{
+    if (m_document && event->type() == QEvent::Wheel && watched == m_textBrowser->viewport()) {
+        QWheelEvent *e = static_cast<QWheelEvent *>(event);
+
+        // the vertical scrolling is over the whole file, not the loaded window
+        if (qAbs(e->angleDelta().y()) >= qAbs(e->angleDelta().x())) {
+            QCoreApplication::sendEvent(m_scrollBar, event);
+
+            return true;
+        }
+    }
+
+    return DFMFilePreview::eventFilter(watched, event);
+}
+
+void TextPreview::initWidget()
+{
+    if (m_widget)
+        return;
+
+    m_widget = new QWidget();
+    m_textBrowser = new QPlainTextEdit(m_widget);
+    m_scrollBar = new QScrollBar(Qt::Vertical, m_widget);
+
+    m_textBrowser->setReadOnly(true);
+    m_textBrowser->setTextInteractionFlags(Qt::TextSelectableByMouse | Qt::TextSelectableByKeyboard);
+    m_textBrowser->setWordWrapMode(QTextOption::NoWrap);
+    m_textBrowser->setFocusPolicy(Qt::NoFocus);
+    m_textBrowser->viewport()->installEventFilter(this);
+    m_scrollBar->hide();
+
+    QHBoxLayout *layout = new QHBoxLayout(m_widget);
+
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(0);
+    layout->addWidget(m_textBrowser);
+    layout->addWidget(m_scrollBar);
+
+    m_widget->setFixedSize(800, 500);
+
+    connect(m_scrollBar.data(), &QScrollBar::valueChanged, this, [this] (int value) {
+        if (!m_updatingWindow)
+            updateWindow(value);
+    });
+    connect(m_textBrowser->verticalScrollBar(), &QScrollBar::valueChanged, this, &TextPreview::onTextScrolled);
+}
+
+int TextPreview::visibleLineCount() const
+{
+    return qMax(1, m_widget->height() / m_textBrowser->fontMetrics().lineSpacing());
+}
+
+void TextPreview::updateScrollRange()
+{
+    if (!m_document)
+        return;
+
+    const int visible_lines = visibleLineCount();
+
+    m_updatingWindow = true;
+    m_scrollBar->setPageStep(visible_lines);
+    m_scrollBar->setRange(0, qMax(0, m_document->lineCount() - visible_lines));
+    m_updatingWindow = false;
+}
+
+void TextPreview::updateWindow(int line)
+{
+    const int visible_lines = visibleLineCount();
+
+    if (line < m_windowStart || m_windowLines == 0
+            || (line + visible_lines > m_windowStart + m_windowLines && !m_windowAtEnd)) {
+        m_windowStart = qMax(0, line - WINDOW_MARGIN);
+        m_updatingWindow = true;
+        m_textBrowser->setPlainText(m_document->text(m_windowStart, WINDOW_LINES, &m_windowLines, &m_windowAtEnd));
+        m_updatingWindow = false;
+    }
+
+    m_updatingWindow = true;
+    m_textBrowser->verticalScrollBar()->setValue(line - m_windowStart);
+    m_updatingWindow = false;
+}
+
+void TextPreview::onTextScrolled(int value)
+{
+    // e.g. the selection is dragged out of the viewport
+    if (!m_document || m_updatingWindow)
+        return;
+
+    m_updatingWindow = true;
+    m_scrollBar->setValue(m_windowStart + value);
+    m_updatingWindow = false;
+}
+
 DFM_END_NAMESPACE
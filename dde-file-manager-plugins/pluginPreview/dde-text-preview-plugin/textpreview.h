@@ -34,10 +34,12 @@
 
 QT_BEGIN_NAMESPACE
 class QPlainTextEdit;
+class QScrollBar;
 QT_END_NAMESPACE
 
 DFM_BEGIN_NAMESPACE
 
+class TextPreviewDocument;
 class TextPreview : public DFMFilePreview
 {
     Q_OBJECT
@@ -55,11 +57,29 @@ public:
 
     QWidget* previewWidget();
 
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) Q_DECL_OVERRIDE;
+
 private:
+    void initWidget();
+    int visibleLineCount() const;
+    void updateScrollRange();
+    void updateWindow(int line);
+    void onTextScrolled(int value);
+
     DUrl m_url;
     QString m_title;
 
+    QPointer<QWidget> m_widget;
     QPointer<QPlainTextEdit> m_textBrowser;
+    QPointer<QScrollBar> m_scrollBar;
+
+    // only set for the large local files, the text browser shows a window of it
+    QScopedPointer<TextPreviewDocument> m_document;
+    int m_windowStart = 0;
+    int m_windowLines = 0;
+    bool m_windowAtEnd = false;
+    bool m_updatingWindow = false;
 };
 
 DFM_END_NAMESPACE
@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "textpreviewdocument.h"
+
+#include <QTextCodec>
+#include <QElapsedTimer>
+#include <QtConcurrent>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+DFM_BEGIN_NAMESPACE
+
+static const int LINES_PER_CHECKPOINT = 256;
+static const int ENCODING_PREFIX_SIZE = 64 * 1024;
+// bounds the decoded window if the lines are very long
+static const qint64 MAX_WINDOW_BYTES = 2 * 1024 * 1024;
+static const qint64 DEFAULT_LINE_LENGTH = 80;
+static const qint64 READ_BLOCK_SIZE = 64 * 1024;
+static const qint64 INDEX_BLOCK_SIZE = 1024 * 1024;
+
+TextPreviewDocument::TextPreviewDocument(QObject *parent)
+    : QObject(parent)
+{
+
+}
+
+TextPreviewDocument::~TextPreviewDocument()
+{
+    m_stop.store(1);
+    m_indexFuture.waitForFinished();
+}
+
+bool TextPreviewDocument::open(const QString &filePath)
+{
+    m_file.setFileName(filePath);
+
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+
+    m_size = m_file.size();
+
+    if (m_size <= 0)
+        return false;
+
+    const QByteArray &prefix = read(0, qMin<qint64>(m_size, ENCODING_PREFIX_SIZE));
+
+    if (prefix.isEmpty())
+        return false;
+
+    const QByteArray &encoding = DFMGlobal::detectCharset(prefix, filePath);
+
+    m_codec = QTextCodec::codecForName(encoding);
+
+    if (!m_codec)
+        m_codec = QTextCodec::codecForLocale();
+
+    // the lines are split at the '\n' byte
+    if (m_codec->name().startsWith("UTF-16") || m_codec->name().startsWith("UTF-32"))
+        return false;
+
+    m_checkpoints << 0;
+    m_indexFuture = QtConcurrent::run(this, &TextPreviewDocument::buildIndex);
+
+    return true;
+}
+
+qint64 TextPreviewDocument::size() const
+{
+    return m_size;
+}
+
+bool TextPreviewDocument::isIndexed() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_indexed;
+}
+
+int TextPreviewDocument::lineCount() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_indexed)
+        return m_indexedLines;
+
+    const qint64 average = m_indexedLines > 0 ? qMax<qint64>(1, m_indexedBytes / m_indexedLines) : DEFAULT_LINE_LENGTH;
+
+    return static_cast<int>(qMin<qint64>(INT_MAX, m_indexedLines + (m_size - m_indexedBytes) / average + 1));
+}
+
+QString TextPreviewDocument::text(int firstLine, int maxLines, int *lines, bool *atEnd) const
+{
+    const qint64 begin = lineOffset(firstLine);
+    const qint64 limit = qMin(m_size, begin + MAX_WINDOW_BYTES);
+    QByteArray data;
+    // the end of the last complete line
+    int end = 0;
+    int count = 0;
+    bool truncated = false;
+
+    while (count < maxLines && begin + data.size() < limit) {
+        const qint64 length = qMin(READ_BLOCK_SIZE, limit - begin - data.size());
+        const QByteArray &block = read(begin + data.size(), length);
+        int index = data.size();
+
+        data += block;
+        truncated = block.size() < length;
+
+        while (count < maxLines && (index = data.indexOf('\n', index)) >= 0) {
+            end = ++index;
+            ++count;
+        }
+
+        if (truncated)
+            break;
+    }
+
+    // the rest is the start of a line that is cut by the window or the end of the file
+    if (count < maxLines && end < data.size())
+        ++count;
+    else
+        data.truncate(end);
+
+    if (lines)
+        *lines = count;
+
+    if (atEnd)
+        *atEnd = truncated || begin + data.size() >= m_size;
+
+    QString text = m_codec->toUnicode(data);
+
+    // the last line break would add an empty block
+    if (text.endsWith(QLatin1Char('\n')))
+        text.chop(1);
+
+    return text;
+}
+
+void TextPreviewDocument::buildIndex()
+{
+    posix_fadvise(m_file.handle(), 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    QVector<qint64> pending;
+    QElapsedTimer timer;
+    // the offset of the next line and of the next block
+    qint64 start = 0;
+    qint64 offset = 0;
+    int line = 0;
+    bool finished = false;
+
+    timer.start();
+
+    while (!m_stop.load() && !finished) {
+        const qint64 length = qMin(INDEX_BLOCK_SIZE, m_size - offset);
+        const QByteArray &block = read(offset, length);
+
+        // stops at the end of a truncated file too
+        finished = block.size() < length || offset + block.size() >= m_size;
+
+        for (int index = block.indexOf('\n'); index >= 0 && line < INT_MAX; index = block.indexOf('\n', index + 1)) {
+            start = offset + index + 1;
+            ++line;
+
+            if (line % LINES_PER_CHECKPOINT == 0 && start < m_size)
+                pending << start;
+        }
+
+        offset += block.size();
+
+        if (line == INT_MAX) {
+            finished = true;
+        } else if (finished && start < offset) {
+            // the last line has no line break
+            start = offset;
+            ++line;
+        }
+
+        if (finished || timer.elapsed() > 200) {
+            QMutexLocker locker(&m_mutex);
+
+            m_checkpoints << pending;
+            m_indexedBytes = start;
+            m_indexedLines = line;
+            m_indexed = finished;
+            locker.unlock();
+
+            pending.clear();
+            timer.restart();
+
+            Q_EMIT lineCountChanged();
+        }
+    }
+
+    posix_fadvise(m_file.handle(), 0, 0, POSIX_FADV_NORMAL);
+}
+
+qint64 TextPreviewDocument::lineOffset(int line) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    const int checkpoint = line / LINES_PER_CHECKPOINT;
+    qint64 offset = 0;
+    int from = 0;
+
+    if (checkpoint < m_checkpoints.size()) {
+        offset = m_checkpoints.at(checkpoint);
+        from = checkpoint * LINES_PER_CHECKPOINT;
+    } else if (m_indexed || line < m_indexedLines) {
+        offset = m_checkpoints.last();
+        from = (m_checkpoints.size() - 1) * LINES_PER_CHECKPOINT;
+    } else {
+        // not indexed yet, guess by the average line length
+        const qint64 average = m_indexedLines > 0 ? qMax<qint64>(1, m_indexedBytes / m_indexedLines) : DEFAULT_LINE_LENGTH;
+
+        offset = qMin(m_size - 1, m_indexedBytes + (line - m_indexedLines) * average);
+        locker.unlock();
+
+        return lineStart(offset);
+    }
+
+    locker.unlock();
+
+    return skipLines(offset, line - from);
+}
+
+qint64 TextPreviewDocument::lineStart(qint64 offset) const
+{
+    const qint64 limit = qMax<qint64>(0, offset - MAX_WINDOW_BYTES);
+
+    for (qint64 end = offset; end > limit;) {
+        const qint64 begin = qMax(limit, end - READ_BLOCK_SIZE);
+        const QByteArray &block = read(begin, end - begin);
+        const int index = block.lastIndexOf('\n');
+
+        if (index >= 0)
+            return begin + index + 1;
+
+        end = begin;
+    }
+
+    return limit == 0 ? 0 : offset;
+}
+
+// the offset of the line count lines after the line at offset, or of the last line
+qint64 TextPreviewDocument::skipLines(qint64 offset, int count) const
+{
+    qint64 start = offset;
+
+    while (count > 0 && offset < m_size) {
+        const qint64 length = qMin(READ_BLOCK_SIZE, m_size - offset);
+        const QByteArray &block = read(offset, length);
+
+        for (int index = block.indexOf('\n'); index >= 0 && count > 0; index = block.indexOf('\n', index + 1)) {
+            if (offset + index + 1 >= m_size)
+                break;
+
+            start = offset + index + 1;
+            --count;
+        }
+
+        if (block.size() < length)
+            break;
+
+        offset += block.size();
+    }
+
+    return start;
+}
+
+// returns less data if the file was truncated
+QByteArray TextPreviewDocument::read(qint64 offset, qint64 length) const
+{
+    QByteArray data(static_cast<int>(length), Qt::Uninitialized);
+    qint64 done = 0;
+
+    while (done < length) {
+        const ssize_t size = ::pread(m_file.handle(), data.data() + done, static_cast<size_t>(length - done), offset + done);
+
+        if (size < 0 && errno == EINTR)
+            continue;
+
+        if (size <= 0)
+            break;
+
+        done += size;
+    }
+
+    data.resize(static_cast<int>(done));
+
+    return data;
+}
+
+DFM_END_NAMESPACE
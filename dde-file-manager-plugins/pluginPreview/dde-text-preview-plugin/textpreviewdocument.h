@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2017 ~ 2018 Deepin Technology Co., Ltd.
+ *
+ * Author:     zccrs <zccrs@live.com>
+ *
+ * Maintainer: zccrs <zhangjide@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TEXTPREVIEWDOCUMENT_H
+#define TEXTPREVIEWDOCUMENT_H
+
+#include "dfmglobal.h"
+
+#include <QObject>
+#include <QFile>
+#include <QMutex>
+#include <QVector>
+#include <QFuture>
+
+QT_BEGIN_NAMESPACE
+class QTextCodec;
+QT_END_NAMESPACE
+
+DFM_BEGIN_NAMESPACE
+
+// a read only view of a large text file: only the requested lines are read and
+// decoded, the line offsets are indexed in the background. The file is read by
+// pread and not mapped, a mapped file that is truncated meanwhile raises SIGBUS
+class TextPreviewDocument : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TextPreviewDocument(QObject *parent = nullptr);
+    ~TextPreviewDocument();
+
+    // fails for files that can not be read or are not in an ASCII compatible encoding
+    bool open(const QString &filePath);
+
+    qint64 size() const;
+    bool isIndexed() const;
+    // estimated by the average line length until the index is finished
+    int lineCount() const;
+
+    // decode at most maxLines lines starting at firstLine
+    QString text(int firstLine, int maxLines, int *lines = nullptr, bool *atEnd = nullptr) const;
+
+Q_SIGNALS:
+    // emitted from the indexing thread
+    void lineCountChanged();
+
+private:
+    void buildIndex();
+    qint64 lineOffset(int line) const;
+    qint64 lineStart(qint64 offset) const;
+    qint64 skipLines(qint64 offset, int count) const;
+    QByteArray read(qint64 offset, qint64 length) const;
+
+    QFile m_file;
+    // the size when the file was opened, the reads stop early if it was truncated
+    qint64 m_size = 0;
+    QTextCodec *m_codec = nullptr;
+
+    mutable QMutex m_mutex;
+    // offset of the line i * LINES_PER_CHECKPOINT
+    QVector<qint64> m_checkpoints;
+    qint64 m_indexedBytes = 0;
+    int m_indexedLines = 0;
+    bool m_indexed = false;
+
+    QAtomicInt m_stop;
+    QFuture<void> m_indexFuture;
+};
+
+DFM_END_NAMESPACE
+
+#endif // TEXTPREVIEWDOCUMENT_H
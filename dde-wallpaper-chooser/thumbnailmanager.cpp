@@ -24,6 +24,7 @@
 
 #include "thumbnailmanager.h"
 #include "constants.h"
+#include "dfmimagedecoder.h"
 
 #include <QDir>
 #include <QPixmap>
@@ -31,31 +32,44 @@
 #include <QStandardPaths>
 #include <QApplication>
 #include <QUrl>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QImageReader>
 #include <QtConcurrent>
 
-static QPixmap ThumbnailImage(const QString &path)
+DFM_USE_NAMESPACE
+
+static QImage ThumbnailImage(const QString &path, const QString &cacheFile)
 {
     QUrl url = QUrl::fromPercentEncoding(path.toUtf8());
     QString realPath = url.toLocalFile();
 
-    ThumbnailManager * tnm = ThumbnailManager::instance();
-
     const qreal ratio = qApp->devicePixelRatio();
-
-    QPixmap pix = QPixmap::fromImage(QImage(realPath).scaled(QSize(ItemWidth * ratio, ItemHeight * ratio),
-                                                             Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation));
-
     const QRect r(0, 0, ItemWidth * ratio, ItemHeight * ratio);
     const QSize size(ItemWidth * ratio, ItemHeight * ratio);
 
-    if (pix.width() > ItemWidth * ratio || pix.height() > ItemHeight * ratio)
-        pix = pix.copy(QRect(pix.rect().center() - r.center(), size));
+    // QPixmap is not usable out of the gui thread
+    QImage image = DFMImageDecoder::read(realPath, size, Qt::KeepAspectRatioByExpanding);
+
+    if (image.isNull())
+        return image;
+
+    // the reader does not scale up
+    if (image.width() < size.width() || image.height() < size.height())
+        image = image.scaled(size, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
 
-    pix.setDevicePixelRatio(ratio);
+    if (image.width() > size.width() || image.height() > size.height())
+        image = image.copy(QRect(image.rect().center() - r.center(), size));
 
-    tnm->replace(path, pix);
+    const QFileInfo info(realPath);
 
-    return pix;
+    image.setText(QT_STRINGIFY(Thumb::MTime), QString::number(info.lastModified().toMSecsSinceEpoch()));
+    image.setText(QT_STRINGIFY(Thumb::Size), QString::number(info.size()));
+    image.save(cacheFile, "PNG");
+
+    image.setDevicePixelRatio(ratio);
+
+    return image;
 }
 
 ThumbnailManager::ThumbnailManager() :
@@ -64,8 +78,6 @@ ThumbnailManager::ThumbnailManager() :
     const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
     m_cacheDir = cacheDir + QDir::separator() + qApp->applicationVersion() + QDir::separator() + QString::number(qApp->devicePixelRatio());
 
-    connect(&m_futureWatcher, &QFutureWatcher<QPixmap>::finished, this, &ThumbnailManager::onProcessFinished, Qt::QueuedConnection);
-
     QDir::root().mkpath(m_cacheDir);
 }
 
@@ -81,18 +93,19 @@ void ThumbnailManager::clear()
 void ThumbnailManager::find(const QString &key)
 {
     QString file = QDir(m_cacheDir).absoluteFilePath(key);
-    const QPixmap pixmap(file);
-    if (!pixmap.isNull())
-    {
-        emit thumbnailFounded(key, pixmap);
-        return;
+
+    if (isCacheValid(file, key)) {
+        const QPixmap pixmap(file);
+
+        if (!pixmap.isNull()) {
+            emit thumbnailFounded(key, pixmap);
+            return;
+        }
     }
 
     m_queuedRequests << key;
 
-    // first item, start
-    if (m_queuedRequests.size() == 1)
-        processNextReq();
+    processNextReq();
 }
 
 void ThumbnailManager::remove(const QString &key)
@@ -116,8 +129,15 @@ bool ThumbnailManager::replace(const QString &key, const QPixmap &pixmap)
 
 void ThumbnailManager::stop()
 {
-    m_futureWatcher.cancel();
     m_queuedRequests.clear();
+
+    // the running decoding can not be interrupted, drop the results
+    for (QFutureWatcher<QImage> *watcher : m_runningRequests.keys()) {
+        watcher->disconnect(this);
+        watcher->deleteLater();
+    }
+
+    m_runningRequests.clear();
 }
 
 ThumbnailManager *ThumbnailManager::instance()
@@ -127,22 +147,42 @@ ThumbnailManager *ThumbnailManager::instance()
 
 void ThumbnailManager::processNextReq()
 {
-    Q_ASSERT(m_futureWatcher.isFinished());
+    while (!m_queuedRequests.isEmpty() && m_runningRequests.size() < QThread::idealThreadCount()) {
+        const QString &item = m_queuedRequests.dequeue();
+        QFutureWatcher<QImage> *watcher = new QFutureWatcher<QImage>(this);
 
-    const QString &item = m_queuedRequests.front();
+        connect(watcher, &QFutureWatcher<QImage>::finished, this, &ThumbnailManager::onProcessFinished, Qt::QueuedConnection);
 
-    QFuture<QPixmap> future = QtConcurrent::run(ThumbnailImage, item);
-    m_futureWatcher.setFuture(future);
+        m_runningRequests[watcher] = item;
+        watcher->setFuture(QtConcurrent::run(ThumbnailImage, item, QDir(m_cacheDir).absoluteFilePath(item)));
+    }
+}
+
+bool ThumbnailManager::isCacheValid(const QString &file, const QString &key) const
+{
+    QImageReader reader(file);
+
+    if (!reader.canRead())
+        return false;
+
+    // same as the wallpaper when it was cached
+    const QFileInfo info(QUrl(QUrl::fromPercentEncoding(key.toUtf8())).toLocalFile());
+
+    return reader.text(QT_STRINGIFY(Thumb::MTime)) == QString::number(info.lastModified().toMSecsSinceEpoch())
+            && reader.text(QT_STRINGIFY(Thumb::Size)) == QString::number(info.size());
 }
 
 void ThumbnailManager::onProcessFinished()
 {
-    if (m_futureWatcher.isCanceled()) return;
+    QFutureWatcher<QImage> *watcher = static_cast<QFutureWatcher<QImage>*>(sender());
+    const QString &key = m_runningRequests.take(watcher);
+
+    watcher->deleteLater();
 
-    emit thumbnailFounded(m_queuedRequests.front(), m_futureWatcher.result());
+    const QImage &image = watcher->result();
 
-    m_queuedRequests.pop_front();
+    if (!image.isNull())
+        emit thumbnailFounded(key, QPixmap::fromImage(image));
 
-    if (!m_queuedRequests.isEmpty())
-        processNextReq();
+    processNextReq();
 }
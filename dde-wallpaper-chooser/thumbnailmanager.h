@@ -29,6 +29,7 @@
 #include <QQueue>
 #include <QFutureWatcher>
 #include <QPixmap>
+#include <QHash>
 
 class ThumbnailManager : public QObject
 {
@@ -50,6 +51,7 @@ signals:
 
 private:
     void processNextReq();
+    bool isCacheValid(const QString &file, const QString &key) const;
 
 private slots:
     void onProcessFinished();
@@ -57,7 +59,8 @@ private slots:
 private:
     QQueue<QString> m_queuedRequests;
     QString m_cacheDir;
-    QFutureWatcher<QPixmap> m_futureWatcher;
+    // the wallpapers are decoded in parallel, at most idealThreadCount at a time
+    QHash<QFutureWatcher<QImage>*, QString> m_runningRequests;
 };
 
 #endif // THUMBNAILMANAGER_H
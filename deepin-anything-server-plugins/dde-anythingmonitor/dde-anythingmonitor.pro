@@ -39,6 +39,7 @@ PKGCONFIG += deepin-anything-server-lib
 INCLUDEPATH += $$PWD/../../dde-file-manager-lib \
                $$PWD/../../dde-file-manager-lib/interfaces \
                $$PWD/../../dde-file-manager-lib/shutil \
+               $$PWD/../../dde-file-manager-lib/io \
                $$PWD/../../utils
 
 unix{
@@ -68,6 +69,7 @@ SOURCES += \
     $$DDE_FILE_MANAGER_LIB_DIR/controllers/interface/tagmanagerdaemon_interface.cpp \
     $$DDE_FILE_MANAGER_LIB_DIR/interfaces/durl.cpp \
     $$DDE_FILE_MANAGER_LIB_DIR/interfaces/dfmstandardpaths.cpp \
+    $$DDE_FILE_MANAGER_LIB_DIR/io/dmounttablecache.cpp \
     $$DDE_FILE_MANAGER_LIB_DIR/interfaces/dfmapplication.cpp \
     $$DDE_FILE_MANAGER_LIB_DIR/interfaces/dfmsettings.cpp \
     taghandle.cpp \
@@ -82,6 +84,7 @@ HEADERS += \
     $$DDE_FILE_MANAGER_LIB_DIR/controllers/interface/tagmanagerdaemon_interface.h \
     $$DDE_FILE_MANAGER_LIB_DIR/interfaces/durl.h \
     $$DDE_FILE_MANAGER_LIB_DIR/interfaces/dfmstandardpaths.h \
+    $$DDE_FILE_MANAGER_LIB_DIR/io/dmounttablecache.h \
     $$DDE_FILE_MANAGER_LIB_DIR/interfaces/dfmapplication.h \
     $$DDE_FILE_MANAGER_LIB_DIR/interfaces/dfmsettings.h \
     taghandle.h
@@ -42,6 +42,7 @@
 #include "app/define.h"
 #include "shutil/fileutils.h"
 #include "dialogs/dialogmanager.h"
+#include "dfilejobscheduler.h"
 #include "singleton.h"
 
 class ErrorHandle : public DFileCopyMoveJob::Handle
@@ -155,6 +156,10 @@ MoveCopyTaskWidget::MoveCopyTaskWidget(DFileCopyMoveJob *job, QWidget *parent)
         }
     });
     connect(m_animatePad, &CircleProgressAnimatePad::clicked, job, &DFileCopyMoveJob::togglePause);
+    connect(DFileJobScheduler::instance(), &DFileJobScheduler::queueChanged, this, &MoveCopyTaskWidget::updateMessageByJob);
+    connect(m_startFirstButton, &QPushButton::clicked, this, [job] {
+        DFileJobScheduler::instance()->moveToFront(job);
+    });
 
     m_jobInfo->totalDataSize = job->totalDataSize();
 
@@ -200,6 +205,14 @@ void MoveCopyTaskWidget::initUI()
     m_closeButton->hide();
     setMouseTracking(true);
 
+    if (m_fileJob) {
+        // the job is waiting for other jobs on the same disk
+        m_startFirstButton = new QPushButton(tr("Start first"));
+        m_startFirstButton->setObjectName("StartFirstButton");
+        m_startFirstButton->setAttribute(Qt::WA_NoMousePropagation);
+        m_startFirstButton->hide();
+    }
+
     m_speedLabel = new QLabel;
     m_remainLabel = new QLabel;
     m_speedLabel->setFixedHeight(18);
@@ -264,6 +277,11 @@ void MoveCopyTaskWidget::initUI()
     mainLayout->addLayout(rightLayout);
     mainLayout->addSpacing(5);
     mainLayout->setContentsMargins(0, 0, 0, 0);
+
+    if (m_startFirstButton) {
+        mainLayout->addWidget(m_startFirstButton, 0, Qt::AlignCenter);
+    }
+
     mainLayout->addWidget(m_closeButton, 0, Qt::AlignCenter);
     mainLayout->addSpacing(20);
     setLayout(mainLayout);
@@ -447,6 +465,9 @@ void MoveCopyTaskWidget::updateMessage(const QMap<QString, QString> &data)
             } else if (m_jobDetail.value("type") == "trash") {
                 msg1 = tr("Trashing %1").arg(file);
                 msg2 = tr("");
+            } else if (m_jobDetail.value("type") == "undo") {
+                msg1 = tr("Undoing %1").arg(file);
+                msg2 = tr("");
             }
         }
 
@@ -476,12 +497,19 @@ void MoveCopyTaskWidget::updateMessage(const QMap<QString, QString> &data)
                 m_keepBothButton->hide();
                 m_errorLabel->setText(m_fileJob->errorString());
             }
+        } else if (status == "queued") {
+            msg1 = file.isEmpty() ? tr("Waiting") : msg1;
+            msg2 = tr("Waiting for other tasks on the same disk");
         } else if (!status.isEmpty()) {
             m_animatePad->stopAnimation();
         } else if (m_fileJob) {
             m_errorLabel->setText(QString());
         }
 
+        if (m_startFirstButton) {
+            m_startFirstButton->setVisible(status == "queued");
+        }
+
         QFontMetrics fm(m_msg1Label->font());
         msg1 = fm.elidedText(msg1, Qt::ElideMiddle, m_msg1Label->width());
         msg2 = fm.elidedText(msg2, Qt::ElideMiddle, m_msg2Label->width());
@@ -747,6 +775,8 @@ void MoveCopyTaskWidget::updateMessageByJob()
             datas["status"] = "conflict";
         } else if (m_fileJob->error() != DFileCopyMoveJob::NoError) {
             datas["status"] = "error";
+        } else if (DFileJobScheduler::instance()->isQueued(m_fileJob)) {
+            datas["status"] = "queued";
         }
     }
 
@@ -126,6 +126,7 @@ private:
     QLabel *m_errorLabel = nullptr;
 
     QPushButton* m_closeButton;
+    QPushButton* m_startFirstButton = nullptr;
     QPushButton* m_pauseBuuton;
     QPushButton* m_keepBothButton;
     QPushButton* m_skipButton;
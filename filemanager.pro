@@ -7,7 +7,8 @@ SUBDIRS  += \
     dde-file-manager-plugins \
     dde-dock-plugins\
     dde-desktop \
-    dde-file-thumbnail-tool
+    dde-file-thumbnail-tool \
+    dde-file-manager-benchmark
 
 isEqual(BUILD_MINIMUM, YES){
 
@@ -26,4 +27,5 @@ dde-dock-plugins.depends = dde-file-manager-lib
 dde-desktop.depends = dde-file-manager-lib
 dde-file-manager-daemon.depends = dde-file-manager-lib
 deepin-anything-server-plugins.depends = dde-file-manager-lib
+dde-file-manager-benchmark.depends = dde-file-manager-lib
 #dde-sharefiles.depends = dde-file-manager-lib
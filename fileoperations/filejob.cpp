@@ -37,6 +37,7 @@
 #include "dfmevent.h"
 #include "dfmeventdispatcher.h"
 #include "dabstractfilewatcher.h"
+#include "dlocalfileremover.h"
 
 #include "tag/tagmanager.h"
 
@@ -280,9 +281,28 @@ DUrlList FileJob::doMoveCopyJob(const DUrlList &files, const DUrl &destination)
     qDebug() << "Do file operation is started" << m_jobDetail;
     jobPrepared();
 
+    DUrlList list;
+
+    if (!moveCopyFiles(files, destination, true, &list))
+        return list;
+
+    if(m_isJobAdded)
+        jobRemoved();
+    emit finished();
+    qDebug() << "Do file operation is done" << m_jobDetail;
+
+    foreach (DUrl url, list) {
+        CopyingFiles.removeOne(url);
+    }
+
+    return list;
+}
+
+bool FileJob::moveCopyFiles(const DUrlList &files, const DUrl &destination, bool countSize, DUrlList *result)
+{
     m_isGvfsFileOperationUsed = checkUseGvfsFileOperation(files, destination);
 
-    DUrlList list;
+    DUrlList &list = *result;
     QString tarDirPath = destination.toLocalFile();
     QDir tarDir(tarDirPath);
     QStorageInfo tarStorageInfo = getStorageInfo(tarDirPath);
@@ -312,9 +332,9 @@ DUrlList FileJob::doMoveCopyJob(const DUrlList &files, const DUrl &destination)
         if(!diskSpaceAvailable){
             emit requestNoEnoughSpaceDialogShowed();
             emit requestJobRemovedImmediately(m_jobDetail);
-            return DUrlList();
+            return false;
         }
-    } else{
+    } else if (countSize) {
         m_totalSize = FileUtils::totalSize(files);
     }
 
@@ -323,7 +343,7 @@ DUrlList FileJob::doMoveCopyJob(const DUrlList &files, const DUrl &destination)
     if(!tarDir.exists())
     {
         qDebug() << "Destination must be directory";
-        return list;
+        return false;
     }
 
     for(int i = 0; i < files.size(); i++)
@@ -435,16 +455,8 @@ DUrlList FileJob::doMoveCopyJob(const DUrlList &files, const DUrl &destination)
         else
             list << DUrl();
     }
-    if(m_isJobAdded)
-        jobRemoved();
-    emit finished();
-    qDebug() << "Do file operation is done" << m_jobDetail;
-
-    foreach (DUrl url, list) {
-        CopyingFiles.removeOne(url);
-    }
 
-    return list;
+    return true;
 }
 
 void FileJob::doDelete(const DUrlList &files)
@@ -498,36 +510,83 @@ DUrlList FileJob::doMoveToTrash(const DUrlList &files)
         return list;
     }
 
-    if (files.count() > 0){
-        QStorageInfo storageInfo = getStorageInfo(files.at(0).toLocalFile());
-        QStorageInfo trashStorageInfo = getStorageInfo(DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath));
-        if(storageInfo.rootPath() != trashStorageInfo.rootPath()){
-            m_isInSameDisk = false;
-        }
-    }
+    // the files on other volumes go to the trash of the volume, so that
+    // moving them is a rename, see the freedesktop trash specification
+    QMap<QString, DUrlList> trashFiles;
+
+    for (const DUrl &url : files)
+        trashFiles[DFMStandardPaths::trashPathForFile(url.toLocalFile(), true)] << url;
 
     //store url list whom cannot be moved to trash
-    DUrlList canMoveToTrashList;
     DUrlList canNotMoveToTrashList;
 
-    for(int i = 0; i < files.size(); i++)
-    {
-        DUrl url = files.at(i);
-        if (!m_isInSameDisk){
+    for (auto it = trashFiles.constBegin(); it != trashFiles.constEnd(); ++it) {
+        QStorageInfo storageInfo = getStorageInfo(it.value().first().toLocalFile());
+        QStorageInfo trashStorageInfo = getStorageInfo(it.key() + "/files");
+
+        if (storageInfo.rootPath() == trashStorageInfo.rootPath())
+            continue;
+
+        for (const DUrl &url : it.value()) {
             //check if is target file in the / disk
             bool canMoveToTrash = checkTrashFileOutOf1GB(url);
             if(!canMoveToTrash){
                 canNotMoveToTrashList << url;
-                continue;
             }
         }
-        canMoveToTrashList << url;
     }
 
     if(canNotMoveToTrashList.size() > 0){
         emit requestCanNotMoveToTrashDialogShowed(canNotMoveToTrashList);
     }else{
-        list = doMove(files, DUrl::fromLocalFile(DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath)));
+        // one job for all trashes: the progress counts every file and the
+        // no permission dialog shows up once
+        QMap<QString, DUrlList> movableFiles;
+        DUrlList allMovableFiles;
+
+        m_noPermissonUrls.clear();
+
+        for (auto it = trashFiles.constBegin(); it != trashFiles.constEnd(); ++it) {
+            for (const DUrl &url : it.value()) {
+                if (canMove(url.toLocalFile())) {
+                    movableFiles[it.key()] << url;
+                    allMovableFiles << url;
+                } else {
+                    m_noPermissonUrls << url;
+                }
+            }
+        }
+
+        qDebug() << "Do file operation is started" << m_jobDetail;
+        m_totalSize = FileUtils::totalSize(allMovableFiles);
+        jobPrepared();
+
+        for (auto it = movableFiles.constBegin(); it != movableFiles.constEnd(); ++it) {
+            if (m_isAborted)
+                break;
+
+            DUrlList movedFiles;
+
+            m_trashLoc = it.key();
+            m_isInSameDisk = true;
+
+            if (!moveCopyFiles(it.value(), DUrl::fromLocalFile(m_trashLoc + "/files"), false, &movedFiles))
+                break;
+
+            list << movedFiles;
+        }
+
+        foreach (DUrl url, list) {
+            CopyingFiles.removeOne(url);
+        }
+
+        if (!m_noPermissonUrls.isEmpty()) {
+            DFMUrlListBaseEvent noPermissionEvent(nullptr, m_noPermissonUrls);
+            noPermissionEvent.setWindowId(getWindowId());
+            emit fileSignalManager->requestShowNoPermissionDialog(noPermissionEvent);
+        }
+
+        m_noPermissonUrls.clear();
     }
 
     if(m_isJobAdded)
@@ -542,13 +601,49 @@ DUrlList FileJob::doMoveToTrash(const DUrlList &files)
 
 bool FileJob::doTrashRestore(const QString &srcFilePath, const QString &tarFilePath)
 {
-//    qDebug() << srcFile << tarFile;
-    qDebug() << "Do restore trash file is started";
+    return doTrashRestore(QStringList() << srcFilePath, QStringList() << tarFilePath);
+}
+
+bool FileJob::doTrashRestore(const QStringList &srcFilePaths, const QStringList &tarFilePaths, QStringList *restoredFiles)
+{
+    qDebug() << "Do restore trash file is started" << srcFilePaths.count();
     DUrlList files;
-    files << QUrl::fromLocalFile(srcFilePath);
+
+    for (const QString &path : srcFilePaths)
+        files << DUrl::fromLocalFile(path);
+
     m_totalSize = FileUtils::totalSize(files);
     jobPrepared();
 
+    bool ok = true;
+
+    for (int i = 0; i < srcFilePaths.count() && i < tarFilePaths.count(); ++i) {
+        if (m_status == FileJob::Cancelled) {
+            ok = false;
+            break;
+        }
+
+        if (restoreTrashItem(srcFilePaths.at(i), tarFilePaths.at(i))) {
+            if (restoredFiles)
+                restoredFiles->append(srcFilePaths.at(i));
+        } else {
+            ok = false;
+        }
+    }
+
+    if(m_isJobAdded)
+        jobRemoved();
+    emit finished();
+    qDebug() << "Do restore trash file is done!";
+
+    return ok;
+}
+
+bool FileJob::restoreTrashItem(const QString &srcFilePath, const QString &tarFilePath)
+{
+//    qDebug() << srcFile << tarFile;
+    m_isInSameDisk = true;
+
     QStorageInfo srcStorageInfo = getStorageInfo(srcFilePath);
     QString tarDir = DUrl::fromLocalFile(tarFilePath).parentUrl().toLocalFile();
     QStorageInfo tarStorageInfo = getStorageInfo(tarDir);
@@ -587,13 +682,16 @@ bool FileJob::doTrashRestore(const QString &srcFilePath, const QString &tarFileP
     }
 
     if (ok) {
-        QFile::remove(DFMStandardPaths::location(DFMStandardPaths::TrashInfosPath) + QDir::separator() + QFileInfo(srcFilePath).fileName() + ".trashinfo");
-    }
+        QString trash_path;
 
-    if(m_isJobAdded)
-        jobRemoved();
-    emit finished();
-    qDebug() << "Do restore trash file is done!";
+        // the file may be in the trash of its volume
+        DFMStandardPaths::localToTrashUrlPath(srcFilePath, &trash_path);
+
+        if (trash_path.isEmpty())
+            trash_path = DFMStandardPaths::location(DFMStandardPaths::TrashPath);
+
+        QFile::remove(trash_path + "/info" + QDir::separator() + QFileInfo(srcFilePath).fileName() + ".trashinfo");
+    }
 
     return ok;
 }
@@ -2076,6 +2174,34 @@ bool FileJob::deleteDir(const QString &dir)
         return false;
     }
 
+#ifndef SW_LABEL
+    DLocalFileRemover remover;
+
+    remover.start(dir);
+
+    while (!remover.waitForFinished(100)) {
+        if (m_status == FileJob::Cancelled) {
+            remover.stop();
+            remover.waitForFinished();
+            emit result("cancelled");
+            return false;
+        }
+    }
+
+    if (remover.isRemoved()) {
+        return true;
+    }
+
+    for (const DLocalFileRemover::Error &e : remover.errors()) {
+        qDebug() << "Unable to remove:" << e.filePath << strerror(e.errorNumber);
+        m_noPermissonUrls << DUrl::fromLocalFile(e.filePath);
+    }
+
+    emit error("Unable to remove file");
+
+    return false;
+#else
+    // every file has to be checked by deleteFile
     QDir sourceDir(dir);
 
     sourceDir.setFilter(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System | QDir::AllDirs);
@@ -2110,6 +2236,7 @@ bool FileJob::deleteDir(const QString &dir)
     }
 
     return true;
+#endif
 }
 
 void FileJob::deleteEmptyDir(const QString &srcPath)
@@ -2187,7 +2314,7 @@ QString FileJob::getNotExistsTrashFileName(const QString &fileName)
     name.chop(suffix.size());
     name = name.left(200 - suffix.size());
 
-    while (QFile::exists(DFMStandardPaths::location(DFMStandardPaths::TrashFilesPath) + "/" + name + suffix)) {
+    while (QFile::exists(m_trashLoc + "/files/" + name + suffix)) {
         name = QCryptographicHash::hash(name, QCryptographicHash::Md5).toHex();
     }
 
@@ -2242,9 +2369,16 @@ bool FileJob::writeTrashInfo(const QString &fileBaseName, const QString &path, c
     }
 
     QByteArray data;
+    QString info_path = path;
+    const QString &top_dir = DFMStandardPaths::trashTopDir(m_trashLoc);
+
+    // the trash of a volume stores the paths relative to the top directory,
+    // so that they are still valid when the volume is mounted elsewhere
+    if (!top_dir.isEmpty() && path.startsWith(top_dir == "/" ? top_dir : top_dir + "/"))
+        info_path = path.mid(top_dir.size() + (top_dir == "/" ? 0 : 1));
 
     data.append("[Trash Info]\n");
-    data.append("Path=").append(path.toUtf8().toPercentEncoding("/")).append("\n");
+    data.append("Path=").append(info_path.toUtf8().toPercentEncoding("/")).append("\n");
     data.append("DeletionDate=").append(time).append("\n");
 
     // save the file tag info
@@ -153,6 +153,8 @@ public slots:
     DUrlList doMoveToTrash(const DUrlList &files);
 
     bool doTrashRestore(const QString &srcFilePath, const QString& tarFilePath);
+    // restore the files in one job, the restored source files are stored in restoredFiles
+    bool doTrashRestore(const QStringList &srcFilePaths, const QStringList &tarFilePaths, QStringList *restoredFiles = 0);
 
     void paused();
     void started();
@@ -220,8 +222,12 @@ private:
     bool moveDir(const QString &srcDir, const QString &tarDir, QString *targetPath = 0);
     bool handleMoveJob(const QString &srcPath, const QString &tarDir, QString *targetPath = 0);
     bool handleSymlinkFile(const QString &srcFile, const QString &tarDir, QString *targetPath = 0);
+    // moves or copies the files into destination without starting or finishing the job,
+    // returns false if the job was dropped. m_totalSize is counted only if countSize
+    bool moveCopyFiles(const DUrlList &files, const DUrl &destination, bool countSize, DUrlList *result);
 
     bool restoreTrashFile(const QString &srcFile, const QString &tarFile);
+    bool restoreTrashItem(const QString &srcFilePath, const QString &tarFilePath);
     bool deleteFile(const QString &file);
     bool deleteFileByGio(const QString &srcFile);
     bool deleteDir(const QString &dir);
@@ -23,16 +23,206 @@
  */
 
 #include "partition.h"
-#include "command.h"
 #include "readusagemanager.h"
+#include "superblockreader.h"
 #include <QString>
-#include <QJsonDocument>
-#include <QJsonArray>
-#include <QJsonObject>
-#include <QJsonParseError>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <sys/sysmacros.h>
 
 namespace PartMan {
 
+namespace {
+
+const char kSysClassBlock[] = "/sys/class/block";
+const char kUdevDataDir[] = "/run/udev/data";
+
+QByteArray readSysfsValue(const QString &path)
+{
+    QFile file(path);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+
+    return file.readAll().trimmed();
+}
+
+// Decodes "\x20" style escapes used by udev and "\040" style escapes
+// used by /proc/self/mounts.
+QString unescape(const QByteArray &value)
+{
+    QByteArray result;
+    result.reserve(value.size());
+
+    for (int i = 0; i < value.size(); ++i) {
+        if (value.at(i) == '\\' && i + 3 < value.size() && value.at(i + 1) == 'x') {
+            bool ok = false;
+            const char c = static_cast<char>(value.mid(i + 2, 2).toInt(&ok, 16));
+
+            if (ok) {
+                result.append(c);
+                i += 3;
+                continue;
+            }
+        } else if (value.at(i) == '\\' && i + 3 < value.size()) {
+            bool ok = false;
+            const char c = static_cast<char>(value.mid(i + 1, 3).toInt(&ok, 8));
+
+            if (ok) {
+                result.append(c);
+                i += 3;
+                continue;
+            }
+        }
+
+        result.append(value.at(i));
+    }
+
+    return QString::fromUtf8(result);
+}
+
+// Maps device numbers of mounted block devices to their first mount point.
+QHash<dev_t, QString> readMountPoints()
+{
+    QHash<dev_t, QString> mountPoints;
+    QFile file("/proc/self/mounts");
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return mountPoints;
+    }
+
+    for (const QByteArray &line : file.readAll().split('\n')) {
+        const QList<QByteArray> fields = line.split(' ');
+
+        if (fields.size() < 2 || !fields.first().startsWith("/dev/")) {
+            continue;
+        }
+
+        struct stat st;
+
+        if (::stat(unescape(fields.first()).toLocal8Bit().constData(), &st) != 0 || !S_ISBLK(st.st_mode)) {
+            continue;
+        }
+
+        if (!mountPoints.contains(st.st_rdev)) {
+            mountPoints.insert(st.st_rdev, unescape(fields.at(1)));
+        }
+    }
+
+    return mountPoints;
+}
+
+// Reads the "E:KEY=VALUE" properties udev stored for the block device.
+QHash<QByteArray, QByteArray> readUdevProperties(dev_t dev)
+{
+    QHash<QByteArray, QByteArray> properties;
+    QFile file(QString("%1/b%2:%3").arg(kUdevDataDir).arg(major(dev)).arg(minor(dev)));
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return properties;
+    }
+
+    for (const QByteArray &line : file.readAll().split('\n')) {
+        if (!line.startsWith("E:")) {
+            continue;
+        }
+
+        const int index = line.indexOf('=');
+
+        if (index > 2) {
+            properties.insert(line.mid(2, index - 2), line.mid(index + 1));
+        }
+    }
+
+    return properties;
+}
+
+void readPartitionUsage(Partition &p)
+{
+    if (p.fs().isEmpty()) {
+        return;
+    }
+
+    qlonglong freespace = 0;
+    qlonglong total = 0;
+    bool ret = false;
+
+    // a mounted filesystem already knows its usage, no need to touch the device
+    if (!p.mountPoint().isEmpty()) {
+        struct statvfs info;
+
+        if (::statvfs(p.mountPoint().toLocal8Bit().constData(), &info) == 0) {
+            total = static_cast<qlonglong>(info.f_blocks) * info.f_frsize;
+            freespace = static_cast<qlonglong>(info.f_bfree) * info.f_frsize;
+            ret = true;
+        }
+    }
+
+    if (!ret) {
+        ReadUsageManager readUsageManager;
+        ret = readUsageManager.readUsage(p.path(), p.fs(), freespace, total);
+    }
+
+    if (ret) {
+        p.setFreespace(freespace);
+        p.setTotal(total);
+    }
+}
+
+// Fills |p| from sysfs and the udev database, |sysPath| is the device
+// directory in /sys/class/block.
+bool readBlockDevice(const QString &sysPath, const QHash<dev_t, QString> &mountPoints, Partition &p)
+{
+    const QList<QByteArray> numbers = readSysfsValue(sysPath + "/dev").split(':');
+
+    if (numbers.size() != 2) {
+        return false;
+    }
+
+    const dev_t dev = makedev(numbers.first().toUInt(), numbers.last().toUInt());
+    const QFileInfo sysInfo(sysPath);
+    const QString canonicalSysPath = sysInfo.canonicalFilePath();
+
+    p.setName(QFileInfo(canonicalSysPath).fileName());
+
+    if (p.path().isEmpty()) {
+        p.setPath(QString("/dev/%1").arg(p.name()));
+    }
+
+    // partitions inherit the removable flag of the disk they belong to
+    const QString diskSysPath = QFile::exists(canonicalSysPath + "/partition")
+                                ? QFileInfo(canonicalSysPath).absolutePath()
+                                : canonicalSysPath;
+    p.setIsRemovable(readSysfsValue(diskSysPath + "/removable") == "1");
+
+    const QHash<QByteArray, QByteArray> properties = readUdevProperties(dev);
+
+    if (properties.isEmpty()) {
+        // no udev database (e.g. in a container), probe the superblock ourselves
+        p.setFs(SuperBlockReader(p.path()).probeFsType());
+    } else {
+        p.setFs(QString::fromUtf8(properties.value("ID_FS_TYPE")));
+        p.setUuid(QString::fromUtf8(properties.value("ID_FS_UUID")));
+
+        if (properties.contains("ID_FS_LABEL_ENC")) {
+            p.setLabel(unescape(properties.value("ID_FS_LABEL_ENC")));
+        } else {
+            p.setLabel(QString::fromUtf8(properties.value("ID_FS_LABEL")));
+        }
+    }
+
+    p.setMountPoint(mountPoints.value(dev));
+
+    return true;
+}
+
+}
 
 Partition::Partition()
 {
@@ -43,62 +233,45 @@ Partition Partition::getPartitionByDevicePath(const QString &devicePath)
 {
     Partition p;
     p.setPath(devicePath);
-    QString output;
-    QString err;
-
-    bool status = SpawnCmd("lsblk", {"-O", "-J", devicePath},
-                  output, err);
-    if(status){
-        QJsonParseError error;
-        QJsonDocument doc=QJsonDocument::fromJson(output.toLocal8Bit(),&error);
-        if (error.error == QJsonParseError::NoError){
-            QJsonObject devObj = doc.object();
-            foreach (QString key, devObj.keys()) {
-                if (key == "blockdevices"){
-                    QJsonObject obj = devObj.value(key).toArray().at(0).toObject();
-                    if (obj.contains("name")){
-                        p.setName(obj.value("name").toString());
-                    }
-                    if (obj.contains("fstype")){
-                        p.setFs(obj.value("fstype").toString());
-                    }
-                    if (obj.contains("label")){
-                        p.setLabel(obj.value("label").toString());
-                    }
-                    if (obj.contains("uuid")){
-                        p.setUuid(obj.value("uuid").toString());
-                    }
-                    if (obj.contains("mountpoint")){
-                        p.setMountPoint(obj.value("mountpoint").toString());
-                    }
-                    if(obj.contains("rm")){
-                        QString data = obj.value("rm").toString();
-                        if(data == "1")
-                            p.setIsRemovable(true);
-                        else
-                            p.setIsRemovable(false);
-                    }
-
-                    if (!p.fs().isEmpty()){
-                        ReadUsageManager readUsageManager;
-                        qlonglong freespace = 0;
-                        qlonglong total = 0;
-                        bool ret = readUsageManager.readUsage(p.path(), p.fs(), freespace, total);
-                        if (ret){
-                            p.setFreespace(freespace);
-                            p.setTotal(total);
-                        }
-                        qDebug() << "read usgae of" << p.path() << ret;
-                    }
-                }
+
+    struct stat st;
+
+    if (::stat(devicePath.toLocal8Bit().constData(), &st) != 0 || !S_ISBLK(st.st_mode)) {
+        qDebug() << "not a block device:" << devicePath;
+        return p;
+    }
+
+    const QString sysPath = QString("/sys/dev/block/%1:%2").arg(major(st.st_rdev)).arg(minor(st.st_rdev));
+
+    if (readBlockDevice(sysPath, readMountPoints(), p)) {
+        readPartitionUsage(p);
+        qDebug() << "read usgae of" << p.path() << p.total();
+    }
+
+    return p;
+}
+
+QList<Partition> Partition::getPartitions()
+{
+    QList<Partition> partitions;
+    const QHash<dev_t, QString> mountPoints = readMountPoints();
+    const QDir dir(kSysClassBlock);
+
+    for (const QString &name : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+        Partition p;
+
+        if (readBlockDevice(dir.absoluteFilePath(name), mountPoints, p)) {
+            // the usage of a mounted partition is a statvfs() call, for the others it
+            // means reading the device, which is left to getPartitionByDevicePath()
+            if (!p.mountPoint().isEmpty()) {
+                readPartitionUsage(p);
             }
-        }else{
-            qDebug() << error.errorString();
+
+            partitions << p;
         }
-    }else{
-        qDebug() << status << output << err;
     }
-    return p;
+
+    return partitions;
 }
 
 QString Partition::path() const
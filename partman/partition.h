@@ -41,6 +41,10 @@ public:
     Partition();
 
     static Partition getPartitionByDevicePath(const QString& devicePath);
+    // Lists every block device known to the kernel, like `lsblk -l` does,
+    // but from sysfs and the udev database without spawning any process.
+    // Only mounted partitions have their total and free space filled.
+    static QList<Partition> getPartitions();
 
     QString path() const;
     void setPath(const QString &path);
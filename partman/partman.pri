@@ -6,7 +6,8 @@ HEADERS += \
     $$PWD/partition.h \
     $$PWD/string_util.h \
     $$PWD/structs.h \
-    $$PWD/readusagemanager.h
+    $$PWD/readusagemanager.h \
+    $$PWD/superblockreader.h
 
 SOURCES += \
     $$PWD/command.cpp \
@@ -14,4 +15,5 @@ SOURCES += \
     $$PWD/partition.cpp \
     $$PWD/string_util.cpp \
     $$PWD/structs.cpp \
-    $$PWD/readusagemanager.cpp
+    $$PWD/readusagemanager.cpp \
+    $$PWD/superblockreader.cpp
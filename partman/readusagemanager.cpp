@@ -27,6 +27,7 @@
 #include "structs.h"
 #include "command.h"
 #include "partition.h"
+#include "superblockreader.h"
 #include <QMetaObject>
 #include <QMetaEnum>
 #include <QString>
@@ -69,6 +70,9 @@ bool ReadUsageManager::readUsage(const QString &path, qlonglong &freespace, qlon
     return readUsage(path, p.fs(), freespace, total);
 }
 
+// btrfs, ext, fat and ntfs are read from the superblock by SuperBlockReader
+// first. Their tools are still used for the layouts the reader does not know,
+// and when the device can not be opened by this process (e.g. without root).
 bool ReadUsageManager::readUsage(const QString &path, const QString &fs, qlonglong &freespace, qlonglong &total)
 {
     if (fs.isEmpty()){
@@ -105,6 +109,10 @@ bool ReadUsageManager::readUsage(const QString &path, const QString &fs, qlonglo
 
 bool ReadUsageManager::readBtrfsUsage(const QString &path, qlonglong &freespace, qlonglong &total)
 {
+    if (SuperBlockReader(path).readBtrfsUsage(freespace, total)) {
+        return true;
+    }
+
     QString output;
     if (!SpawnCmd("btrfs", {"filesystem", "show", path}, output)) {
         return false;
@@ -129,6 +137,10 @@ bool ReadUsageManager::readEfiUsage(const QString &path, qlonglong &freespace, q
 
 bool ReadUsageManager::readExt2Usage(const QString &path, qlonglong &freespace, qlonglong &total)
 {
+    if (SuperBlockReader(path).readExtUsage(freespace, total)) {
+        return true;
+    }
+
     QString output;
     if (!SpawnCmd("dumpe2fs", {"-h", path}, output)) {
         return false;
@@ -178,6 +190,10 @@ bool ReadUsageManager::readF2fsUsage(const QString &path, qlonglong &freespace,
 
 bool ReadUsageManager::readFat16Usage(const QString &path, qlonglong &freespace, qlonglong &total)
 {
+    if (SuperBlockReader(path).readFatUsage(freespace, total)) {
+        return true;
+    }
+
     QString output, err;
     SpawnCmd("dosfsck", {"-n", "-v", path}, output, err);
       // NOTE(xushaohua): `dosfsck` returns 1 on success, so we check its error
@@ -215,6 +231,11 @@ bool ReadUsageManager::readFat32Usage(const QString &path, qlonglong &freespace,
     return readFat16Usage(path, freespace, total);
 }
 
+bool ReadUsageManager::readExfatUsage(const QString &path, qlonglong &freespace, qlonglong &total)
+{
+    return SuperBlockReader(path).readExfatUsage(freespace, total);
+}
+
 bool ReadUsageManager::readHfsUsage(const QString &path, qlonglong &freespace, qlonglong &total)
 {
     qDebug() << "unsupport  Hfs fs type usage read";
@@ -300,6 +321,10 @@ bool ReadUsageManager::readNilfs2Usage(const QString &path, qlonglong &freespace
 
 bool ReadUsageManager::readNtfsUsage(const QString &path, qlonglong &freespace, qlonglong &total)
 {
+    if (SuperBlockReader(path).readNtfsUsage(freespace, total)) {
+        return true;
+    }
+
     QString output;
     if (!SpawnCmd("ntfsinfo", {"-mf", path}, output)) {
         return false;
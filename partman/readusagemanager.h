@@ -50,6 +50,7 @@ public slots:
     bool readF2fsUsage(const QString& path, qlonglong& freespace, qlonglong& total);
     bool readFat16Usage(const QString& path, qlonglong& freespace, qlonglong& total);
     bool readFat32Usage(const QString& path, qlonglong& freespace, qlonglong& total);
+    bool readExfatUsage(const QString& path, qlonglong& freespace, qlonglong& total);
     bool readHfsUsage(const QString& path, qlonglong& freespace, qlonglong& total);
     bool readHfsplusUsage(const QString& path, qlonglong& freespace, qlonglong& total);
     bool readJfsUsage(const QString& path, qlonglong& freespace, qlonglong& total);
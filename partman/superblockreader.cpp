@@ -0,0 +1,596 @@
+/*
+ * Copyright (C) 2016 ~ 2018 Deepin Technology Co., Ltd.
+ *               2016 ~ 2018 dragondjf
+ *
+ * Author:     dragondjf<dingjiangfeng@deepin.com>
+ *
+ * Maintainer: dragondjf<dingjiangfeng@deepin.com>
+ *             zccrs<zhangjide@deepin.com>
+ *             Tangtong<tangtong@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "superblockreader.h"
+
+#include <QByteArray>
+#include <QtEndian>
+#include <QtAlgorithms>
+#include <QDebug>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace PartMan {
+
+namespace {
+
+const qint64 kExtSuperBlockOffset = 1024;
+const quint16 kExtMagic = 0xEF53;
+const quint32 kExtCompatHasJournal = 0x0004;
+const quint32 kExtIncompatExtents = 0x0040;
+const quint32 kExtIncompat64Bit = 0x0080;
+const quint32 kExtIncompatFlexBg = 0x0200;
+
+const qint64 kBtrfsSuperBlockOffset = 0x10000;
+const char kBtrfsMagic[] = "_BHRfS_M";
+
+const quint32 kFatFsInfoLeadSig = 0x41615252;
+const quint32 kFatFsInfoStructSig = 0x61417272;
+
+// Size of one read request when walking allocation tables.
+const qint64 kScanChunkSize = 1024 * 1024;
+
+template<typename T>
+inline T le(const char *data)
+{
+    return qFromLittleEndian<T>(reinterpret_cast<const uchar *>(data));
+}
+
+inline bool isPowerOfTwo(quint64 value)
+{
+    return value && !(value & (value - 1));
+}
+
+// Counts set bits in the first |bits| bits of |data|.
+qlonglong countSetBits(const char *data, qint64 bits)
+{
+    qlonglong count = 0;
+    const qint64 bytes = bits / 8;
+
+    for (qint64 i = 0; i < bytes; ++i) {
+        count += qPopulationCount(static_cast<quint8>(data[i]));
+    }
+
+    if (bits % 8) {
+        const quint8 mask = static_cast<quint8>((1 << (bits % 8)) - 1);
+        count += qPopulationCount(static_cast<quint8>(data[bytes] & mask));
+    }
+
+    return count;
+}
+
+}
+
+SuperBlockReader::SuperBlockReader(const QString &devicePath)
+    : m_devicePath(devicePath)
+{
+    m_fd = ::open(devicePath.toLocal8Bit().constData(), O_RDONLY | O_CLOEXEC);
+
+    if (m_fd < 0) {
+        qDebug() << "open device failed:" << devicePath << strerror(errno);
+    }
+}
+
+SuperBlockReader::~SuperBlockReader()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+bool SuperBlockReader::isOpen() const
+{
+    return m_fd >= 0;
+}
+
+QString SuperBlockReader::probeFsType()
+{
+    char buf[512];
+
+    if (readAt(kExtSuperBlockOffset, buf, sizeof(buf)) && le<quint16>(buf + 0x38) == kExtMagic) {
+        const quint32 compat = le<quint32>(buf + 0x5C);
+        const quint32 incompat = le<quint32>(buf + 0x60);
+
+        if (incompat & (kExtIncompatExtents | kExtIncompat64Bit | kExtIncompatFlexBg)) {
+            return "ext4";
+        }
+
+        return (compat & kExtCompatHasJournal) ? "ext3" : "ext2";
+    }
+
+    if (readAt(kBtrfsSuperBlockOffset + 0x40, buf, 8) && qstrncmp(buf, kBtrfsMagic, 8) == 0) {
+        return "btrfs";
+    }
+
+    if (!readAt(0, buf, sizeof(buf))) {
+        return QString();
+    }
+
+    if (qstrncmp(buf + 3, "NTFS    ", 8) == 0) {
+        return "ntfs";
+    }
+
+    if (qstrncmp(buf + 3, "EXFAT   ", 8) == 0) {
+        return "exfat";
+    }
+
+    if (static_cast<quint8>(buf[510]) == 0x55 && static_cast<quint8>(buf[511]) == 0xAA
+            && (qstrncmp(buf + 0x36, "FAT", 3) == 0 || qstrncmp(buf + 0x52, "FAT", 3) == 0)) {
+        return "vfat";
+    }
+
+    return QString();
+}
+
+bool SuperBlockReader::readExtUsage(qlonglong &freespace, qlonglong &total)
+{
+    char sb[1024];
+
+    if (!readAt(kExtSuperBlockOffset, sb, sizeof(sb)) || le<quint16>(sb + 0x38) != kExtMagic) {
+        return false;
+    }
+
+    const quint32 logBlockSize = le<quint32>(sb + 0x18);
+
+    if (logBlockSize > 6) {
+        return false;
+    }
+
+    const qlonglong blockSize = 1024LL << logBlockSize;
+    quint64 totalBlocks = le<quint32>(sb + 0x04);
+    quint64 freeBlocks = le<quint32>(sb + 0x0C);
+
+    if (le<quint32>(sb + 0x60) & kExtIncompat64Bit) {
+        totalBlocks |= static_cast<quint64>(le<quint32>(sb + 0x150)) << 32;
+        freeBlocks |= static_cast<quint64>(le<quint32>(sb + 0x158)) << 32;
+    }
+
+    total = static_cast<qlonglong>(totalBlocks) * blockSize;
+    freespace = static_cast<qlonglong>(freeBlocks) * blockSize;
+
+    return true;
+}
+
+bool SuperBlockReader::readFatUsage(qlonglong &freespace, qlonglong &total)
+{
+    char bs[512];
+
+    if (!readAt(0, bs, sizeof(bs))) {
+        return false;
+    }
+
+    const quint16 bytesPerSector = le<quint16>(bs + 0x0B);
+    const quint8 sectorsPerCluster = static_cast<quint8>(bs[0x0D]);
+    const quint16 reservedSectors = le<quint16>(bs + 0x0E);
+    const quint8 numFats = static_cast<quint8>(bs[0x10]);
+    const quint16 rootEntries = le<quint16>(bs + 0x11);
+    const quint16 totalSectors16 = le<quint16>(bs + 0x13);
+    const quint16 fatSize16 = le<quint16>(bs + 0x16);
+    const quint32 totalSectors32 = le<quint32>(bs + 0x20);
+    const quint32 fatSize32 = le<quint32>(bs + 0x24);
+
+    if (bytesPerSector < 512 || !isPowerOfTwo(bytesPerSector)
+            || !isPowerOfTwo(sectorsPerCluster) || numFats == 0 || reservedSectors == 0) {
+        return false;
+    }
+
+    const quint64 rootDirSectors = (rootEntries * 32u + bytesPerSector - 1) / bytesPerSector;
+    const quint64 fatSize = fatSize16 ? fatSize16 : fatSize32;
+    const quint64 totalSectors = totalSectors16 ? totalSectors16 : totalSectors32;
+    const quint64 metaSectors = reservedSectors + numFats * fatSize + rootDirSectors;
+
+    if (fatSize == 0 || totalSectors <= metaSectors) {
+        return false;
+    }
+
+    const quint32 clusters = static_cast<quint32>((totalSectors - metaSectors) / sectorsPerCluster);
+    const qlonglong clusterSize = static_cast<qlonglong>(bytesPerSector) * sectorsPerCluster;
+    const int fatBits = clusters < 4085 ? 12 : (clusters < 65525 ? 16 : 32);
+    qlonglong freeClusters = -1;
+
+    // FAT32 keeps a free cluster hint in the FSInfo sector, use it when sane
+    // instead of walking the whole table.
+    if (fatBits == 32) {
+        const quint16 fsInfoSector = le<quint16>(bs + 0x30);
+        char fsInfo[512];
+
+        if (fsInfoSector != 0 && fsInfoSector != 0xFFFF
+                && readAt(static_cast<qint64>(fsInfoSector) * bytesPerSector, fsInfo, sizeof(fsInfo))
+                && le<quint32>(fsInfo) == kFatFsInfoLeadSig
+                && le<quint32>(fsInfo + 484) == kFatFsInfoStructSig) {
+            const quint32 hint = le<quint32>(fsInfo + 488);
+
+            if (hint <= clusters) {
+                freeClusters = hint;
+            }
+        }
+    }
+
+    if (freeClusters < 0) {
+        freeClusters = countFatFreeClusters(static_cast<qint64>(reservedSectors) * bytesPerSector, fatBits, clusters);
+    }
+
+    if (freeClusters < 0) {
+        return false;
+    }
+
+    total = clusters * clusterSize;
+    freespace = freeClusters * clusterSize;
+
+    return true;
+}
+
+bool SuperBlockReader::readExfatUsage(qlonglong &freespace, qlonglong &total)
+{
+    char bs[512];
+
+    if (!readAt(0, bs, sizeof(bs)) || qstrncmp(bs + 3, "EXFAT   ", 8) != 0) {
+        return false;
+    }
+
+    const quint32 fatOffset = le<quint32>(bs + 0x50);
+    const quint32 heapOffset = le<quint32>(bs + 0x58);
+    const quint32 clusterCount = le<quint32>(bs + 0x5C);
+    const quint32 rootCluster = le<quint32>(bs + 0x60);
+    const quint8 sectorShift = static_cast<quint8>(bs[0x6C]);
+    const quint8 clusterShift = static_cast<quint8>(bs[0x6D]);
+    const quint8 percentInUse = static_cast<quint8>(bs[0x70]);
+
+    if (sectorShift < 9 || sectorShift > 12 || sectorShift + clusterShift > 25) {
+        return false;
+    }
+
+    const qint64 sectorSize = 1LL << sectorShift;
+    const qint64 clusterSize = 1LL << (sectorShift + clusterShift);
+    const qint64 heapStart = heapOffset * sectorSize;
+    auto clusterOffset = [&] (quint32 cluster) {
+        return heapStart + static_cast<qint64>(cluster - 2) * clusterSize;
+    };
+    auto validCluster = [&] (quint32 cluster) {
+        return cluster >= 2 && cluster < clusterCount + 2;
+    };
+
+    total = clusterCount * clusterSize;
+
+    // Find the allocation bitmap entry in the first cluster of the root directory.
+    quint32 bitmapCluster = 0;
+    quint64 bitmapLength = 0;
+
+    if (validCluster(rootCluster)) {
+        QByteArray root(static_cast<int>(clusterSize), Qt::Uninitialized);
+
+        if (readAt(clusterOffset(rootCluster), root.data(), clusterSize)) {
+            for (int i = 0; i + 32 <= root.size(); i += 32) {
+                const quint8 type = static_cast<quint8>(root.at(i));
+
+                if (type == 0x00) {
+                    break;
+                }
+
+                if (type == 0x81) {
+                    bitmapCluster = le<quint32>(root.constData() + i + 20);
+                    bitmapLength = le<quint64>(root.constData() + i + 24);
+                    break;
+                }
+            }
+        }
+    }
+
+    if (validCluster(bitmapCluster)) {
+        QByteArray chunk(static_cast<int>(clusterSize), Qt::Uninitialized);
+        quint64 remainingBits = clusterCount;
+        quint64 remainingBytes = qMin<quint64>(bitmapLength, (clusterCount + 7) / 8);
+        qlonglong used = 0;
+        quint32 cluster = bitmapCluster;
+        quint32 guard = clusterCount;
+
+        while (remainingBytes > 0 && validCluster(cluster) && guard--) {
+            const qint64 size = qMin<qint64>(clusterSize, remainingBytes);
+
+            if (!readAt(clusterOffset(cluster), chunk.data(), size)) {
+                break;
+            }
+
+            const qint64 bits = qMin<qint64>(size * 8, remainingBits);
+
+            used += countSetBits(chunk.constData(), bits);
+            remainingBits -= bits;
+            remainingBytes -= size;
+
+            if (remainingBytes == 0) {
+                break;
+            }
+
+            char next[4];
+
+            if (!readAt(fatOffset * sectorSize + cluster * 4LL, next, sizeof(next))) {
+                break;
+            }
+
+            // exFAT may leave the FAT empty for contiguous allocations.
+            const quint32 nextCluster = le<quint32>(next);
+            cluster = nextCluster ? nextCluster : cluster + 1;
+        }
+
+        if (remainingBytes == 0) {
+            freespace = (clusterCount - used) * clusterSize;
+            return true;
+        }
+    }
+
+    if (percentInUse <= 100) {
+        freespace = total - total * percentInUse / 100;
+        return true;
+    }
+
+    return false;
+}
+
+bool SuperBlockReader::readNtfsUsage(qlonglong &freespace, qlonglong &total)
+{
+    char bs[512];
+
+    if (!readAt(0, bs, sizeof(bs)) || qstrncmp(bs + 3, "NTFS    ", 8) != 0) {
+        return false;
+    }
+
+    const quint16 bytesPerSector = le<quint16>(bs + 0x0B);
+    const quint8 rawSectorsPerCluster = static_cast<quint8>(bs[0x0D]);
+    const quint64 totalSectors = le<quint64>(bs + 0x28);
+    const quint64 mftCluster = le<quint64>(bs + 0x30);
+    const qint8 rawRecordSize = static_cast<qint8>(bs[0x40]);
+
+    if (bytesPerSector < 256 || !isPowerOfTwo(bytesPerSector)) {
+        return false;
+    }
+
+    const quint32 sectorsPerCluster = rawSectorsPerCluster > 0x80
+                                      ? 1u << (256 - rawSectorsPerCluster)
+                                      : rawSectorsPerCluster;
+
+    if (!isPowerOfTwo(sectorsPerCluster)) {
+        return false;
+    }
+
+    const qint64 clusterSize = static_cast<qint64>(bytesPerSector) * sectorsPerCluster;
+    const qint64 recordSize = rawRecordSize > 0 ? rawRecordSize * clusterSize : 1LL << -rawRecordSize;
+    const quint64 totalClusters = totalSectors / sectorsPerCluster;
+
+    if (recordSize < 512 || recordSize > 64 * 1024) {
+        return false;
+    }
+
+    total = static_cast<qlonglong>(totalClusters) * clusterSize;
+
+    // MFT record 6 is $Bitmap, its unnamed $DATA attribute holds one bit per cluster.
+    QByteArray record(static_cast<int>(recordSize), Qt::Uninitialized);
+
+    if (!readAt(static_cast<qint64>(mftCluster) * clusterSize + 6 * recordSize, record.data(), recordSize)
+            || qstrncmp(record.constData(), "FILE", 4) != 0) {
+        return false;
+    }
+
+    // Apply the update sequence fixups.
+    const quint16 usaOffset = le<quint16>(record.constData() + 0x04);
+    const quint16 usaCount = le<quint16>(record.constData() + 0x06);
+
+    if (usaCount == 0 || usaOffset + usaCount * 2 > recordSize || (usaCount - 1) * 512 > recordSize) {
+        return false;
+    }
+
+    char *rec = record.data();
+
+    for (int i = 1; i < usaCount; ++i) {
+        char *tail = rec + i * 512 - 2;
+
+        if (memcmp(tail, rec + usaOffset, 2) != 0) {
+            return false;
+        }
+
+        memcpy(tail, rec + usaOffset + i * 2, 2);
+    }
+
+    const char *runList = nullptr;
+    const char *runListEnd = nullptr;
+
+    for (qint64 pos = le<quint16>(rec + 0x14); pos + 16 <= recordSize;) {
+        const quint32 type = le<quint32>(rec + pos);
+        const quint32 length = le<quint32>(rec + pos + 4);
+
+        if (type == 0xFFFFFFFF || length == 0 || pos + length > recordSize) {
+            break;
+        }
+
+        // non-resident, unnamed $DATA
+        if (type == 0x80 && rec[pos + 8] == 1 && rec[pos + 9] == 0) {
+            runList = rec + pos + le<quint16>(rec + pos + 0x20);
+            runListEnd = rec + pos + length;
+            break;
+        }
+
+        pos += length;
+    }
+
+    if (!runList) {
+        return false;
+    }
+
+    QByteArray chunk(static_cast<int>(kScanChunkSize), Qt::Uninitialized);
+    quint64 remainingBits = totalClusters;
+    qlonglong used = 0;
+    qint64 lcn = 0;
+
+    while (runList < runListEnd && *runList && remainingBits > 0) {
+        const int lengthSize = *runList & 0x0F;
+        const int offsetSize = (*runList >> 4) & 0x0F;
+
+        if (lengthSize == 0 || lengthSize > 8 || offsetSize > 8
+                || runList + 1 + lengthSize + offsetSize > runListEnd) {
+            return false;
+        }
+
+        quint64 runLength = 0;
+        for (int i = lengthSize - 1; i >= 0; --i) {
+            runLength = (runLength << 8) | static_cast<quint8>(runList[1 + i]);
+        }
+
+        qint64 runOffset = offsetSize ? static_cast<qint8>(runList[lengthSize + offsetSize]) : 0;
+        for (int i = offsetSize - 2; i >= 0; --i) {
+            runOffset = (runOffset << 8) | static_cast<quint8>(runList[1 + lengthSize + i]);
+        }
+
+        runList += 1 + lengthSize + offsetSize;
+
+        quint64 runBytes = runLength * clusterSize;
+
+        // sparse run, all clusters covered by it are free
+        if (offsetSize == 0) {
+            remainingBits -= qMin<quint64>(remainingBits, runBytes * 8);
+            continue;
+        }
+
+        lcn += runOffset;
+        qint64 offset = lcn * clusterSize;
+
+        while (runBytes > 0 && remainingBits > 0) {
+            const qint64 size = qMin<qint64>(kScanChunkSize, qMin<quint64>(runBytes, (remainingBits + 7) / 8));
+
+            if (!readAt(offset, chunk.data(), size)) {
+                return false;
+            }
+
+            const qint64 bits = qMin<qint64>(size * 8, remainingBits);
+
+            used += countSetBits(chunk.constData(), bits);
+            remainingBits -= bits;
+            runBytes -= size;
+            offset += size;
+        }
+    }
+
+    freespace = (static_cast<qlonglong>(totalClusters) - used) * clusterSize;
+
+    return true;
+}
+
+bool SuperBlockReader::readBtrfsUsage(qlonglong &freespace, qlonglong &total)
+{
+    char sb[0x80];
+
+    if (!readAt(kBtrfsSuperBlockOffset, sb, sizeof(sb)) || qstrncmp(sb + 0x40, kBtrfsMagic, 8) != 0) {
+        return false;
+    }
+
+    const quint64 totalBytes = le<quint64>(sb + 0x70);
+    const quint64 usedBytes = le<quint64>(sb + 0x78);
+
+    if (usedBytes > totalBytes) {
+        return false;
+    }
+
+    total = static_cast<qlonglong>(totalBytes);
+    freespace = static_cast<qlonglong>(totalBytes - usedBytes);
+
+    return true;
+}
+
+bool SuperBlockReader::readAt(qint64 offset, char *data, qint64 size) const
+{
+    if (m_fd < 0) {
+        return false;
+    }
+
+    qint64 done = 0;
+
+    while (done < size) {
+        const ssize_t n = ::pread(m_fd, data + done, static_cast<size_t>(size - done), offset + done);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n <= 0) {
+            return false;
+        }
+
+        done += n;
+    }
+
+    return true;
+}
+
+qlonglong SuperBlockReader::countFatFreeClusters(qint64 fatOffset, int fatBits, quint32 clusters) const
+{
+    const quint64 lastCluster = static_cast<quint64>(clusters) + 2;
+    qlonglong freeClusters = 0;
+
+    if (fatBits == 12) {
+        // at most 4085 entries, read it in one go
+        QByteArray fat(static_cast<int>((lastCluster * 3 + 1) / 2 + 1), Qt::Uninitialized);
+
+        if (!readAt(fatOffset, fat.data(), fat.size())) {
+            return -1;
+        }
+
+        for (quint64 cluster = 2; cluster < lastCluster; ++cluster) {
+            quint16 value = le<quint16>(fat.constData() + cluster + cluster / 2);
+
+            value = (cluster & 1) ? (value >> 4) : (value & 0x0FFF);
+
+            if (value == 0) {
+                ++freeClusters;
+            }
+        }
+
+        return freeClusters;
+    }
+
+    const int entrySize = fatBits / 8;
+    const quint64 entriesPerChunk = kScanChunkSize / entrySize;
+    QByteArray chunk(static_cast<int>(kScanChunkSize), Qt::Uninitialized);
+
+    for (quint64 first = 0; first < lastCluster; first += entriesPerChunk) {
+        const quint64 count = qMin(entriesPerChunk, lastCluster - first);
+
+        if (!readAt(fatOffset + static_cast<qint64>(first) * entrySize, chunk.data(), count * entrySize)) {
+            return -1;
+        }
+
+        for (quint64 i = first < 2 ? 2 - first : 0; i < count; ++i) {
+            const char *entry = chunk.constData() + i * entrySize;
+            const quint32 value = entrySize == 2 ? le<quint16>(entry) : (le<quint32>(entry) & 0x0FFFFFFF);
+
+            if (value == 0) {
+                ++freeClusters;
+            }
+        }
+    }
+
+    return freeClusters;
+}
+
+}
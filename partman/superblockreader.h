@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2016 ~ 2018 Deepin Technology Co., Ltd.
+ *               2016 ~ 2018 dragondjf
+ *
+ * Author:     dragondjf<dingjiangfeng@deepin.com>
+ *
+ * Maintainer: dragondjf<dingjiangfeng@deepin.com>
+ *             zccrs<zhangjide@deepin.com>
+ *             Tangtong<tangtong@deepin.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SUPERBLOCKREADER_H
+#define SUPERBLOCKREADER_H
+
+#include <QString>
+
+namespace PartMan {
+
+// Reads filesystem size and free space straight from the on-disk metadata of
+// |devicePath| instead of spawning dumpe2fs/dosfsck/ntfsinfo/btrfs.
+// Only the superblock (and, where the filesystem keeps no free counter, the
+// allocation table) is read.
+class SuperBlockReader
+{
+public:
+    explicit SuperBlockReader(const QString &devicePath);
+    ~SuperBlockReader();
+
+    bool isOpen() const;
+
+    // Returns the lsblk style name of the filesystem found on the device
+    // ("ext4", "vfat", "exfat", "ntfs", "btrfs"), or an empty string.
+    QString probeFsType();
+
+    bool readExtUsage(qlonglong &freespace, qlonglong &total);
+    bool readFatUsage(qlonglong &freespace, qlonglong &total);
+    bool readExfatUsage(qlonglong &freespace, qlonglong &total);
+    bool readNtfsUsage(qlonglong &freespace, qlonglong &total);
+    bool readBtrfsUsage(qlonglong &freespace, qlonglong &total);
+
+private:
+    Q_DISABLE_COPY(SuperBlockReader)
+
+    bool readAt(qint64 offset, char *data, qint64 size) const;
+    qlonglong countFatFreeClusters(qint64 fatOffset, int fatBits, quint32 clusters) const;
+
+    QString m_devicePath;
+    int m_fd = -1;
+};
+
+}
+
+#endif // SUPERBLOCKREADER_H